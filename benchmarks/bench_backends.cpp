@@ -0,0 +1,211 @@
+// Copyright 2026 Sai Surya Sriramoju
+
+/**
+ * @file bench_backends.cpp
+ * @brief Latency and accuracy of every detector backend on one image set.
+ * @author Sai Surya Sriramoju
+ * @date 10/17/2026
+ *
+ * Set BENCH_IMAGES to a directory of images. Each iteration runs YOLO::infer()
+ * on the next image, so the time per iteration is the end-to-end latency
+ * (preprocessing, forward pass and decoding). Afterwards every image is
+ * detected once more and scored: "precision" and "recall" at IoU 0.5 against
+ * YOLO-format labels (<image stem>.txt: class cx cy w h, normalised) where
+ * they exist, and against YOLOv3 FP32 detections otherwise. Models missing
+ * from the models directory are reported as errors and skipped.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#include <opencv2/opencv.hpp>
+
+#include "YOLO.h"
+
+namespace {
+
+/**
+ * @brief A labelled box.
+ */
+struct Box {
+    cv::Rect2f rect;
+    int classId;
+};
+
+/**
+ * @brief One benchmark image and its reference boxes.
+ */
+struct Sample {
+    cv::Mat image;
+    std::vector<Box> truth;
+};
+
+/**
+ * @brief Copies detections into boxes.
+ */
+std::vector<Box> toBoxes(const Detections& detections) {
+    std::vector<Box> boxes;
+    for (size_t i = 0; i < detections.size(); ++i) {
+        boxes.push_back({cv::Rect2f(detections.x[i], detections.y[i],
+                                    detections.width[i], detections.height[i]),
+                         detections.classIds[i]});
+    }
+    return boxes;
+}
+
+/**
+ * @brief Reads YOLO-format labels next to @p imagePath, if there are any.
+ */
+bool readLabels(const std::string& imagePath, cv::Size size,
+                std::vector<Box>& boxes) {
+    const std::string stem = imagePath.substr(0, imagePath.find_last_of('.'));
+    std::ifstream file(stem + ".txt");
+    if (!file) {
+        return false;
+    }
+    int classId = 0;
+    float cx = 0, cy = 0, w = 0, h = 0;
+    while (file >> classId >> cx >> cy >> w >> h) {
+        boxes.push_back({cv::Rect2f((cx - w / 2) * size.width,
+                                    (cy - h / 2) * size.height,
+                                    w * size.width, h * size.height),
+                         classId});
+    }
+    return true;
+}
+
+/**
+ * @brief Loads BENCH_IMAGES once; images without labels are scored against
+ *        the YOLOv3 FP32 reference.
+ */
+const std::vector<Sample>& samples() {
+    static std::vector<Sample> loaded;
+    static bool done = false;
+    if (done) {
+        return loaded;
+    }
+    done = true;
+    const char* directory = std::getenv("BENCH_IMAGES");
+    if (directory == nullptr) {
+        return loaded;
+    }
+    std::vector<std::string> paths;
+    cv::glob(std::string(directory) + "/*.jpg", paths);
+    std::vector<std::string> png;
+    cv::glob(std::string(directory) + "/*.png", png);
+    paths.insert(paths.end(), png.begin(), png.end());
+
+    std::unique_ptr<YOLO> reference;
+    for (const std::string& path : paths) {
+        Sample sample;
+        sample.image = cv::imread(path);
+        if (sample.image.empty()) {
+            continue;
+        }
+        if (!readLabels(path, sample.image.size(), sample.truth)) {
+            if (!reference) {
+                reference.reset(new YOLO());
+            }
+            sample.truth = toBoxes(reference->infer(sample.image));
+        }
+        loaded.push_back(std::move(sample));
+    }
+    return loaded;
+}
+
+/**
+ * @brief Greedy same-class matching at IoU >= 0.5.
+ *
+ * @return std::pair<int, int> - True positives and detections.
+ */
+std::pair<int, int> score(const std::vector<Box>& truth,
+                          const std::vector<Box>& found) {
+    std::vector<bool> used(truth.size(), false);
+    int matched = 0;
+    for (const Box& box : found) {
+        for (size_t t = 0; t < truth.size(); ++t) {
+            if (used[t] || truth[t].classId != box.classId) {
+                continue;
+            }
+            const float inter = (truth[t].rect & box.rect).area();
+            const float iou = inter / (truth[t].rect.area() + box.rect.area() - inter);
+            if (iou >= 0.5f) {
+                used[t] = true;
+                ++matched;
+                break;
+            }
+        }
+    }
+    return {matched, static_cast<int>(found.size())};
+}
+
+/**
+ * @brief Times infer() with @p config and scores it on every sample.
+ */
+void BM_Backend(benchmark::State& state, BackendConfig config) {
+    const std::vector<Sample>& images = samples();
+    if (images.empty()) {
+        state.SkipWithError("set BENCH_IMAGES to a directory of images");
+        return;
+    }
+    std::unique_ptr<YOLO> yolo;
+    try {
+        yolo.reset(new YOLO(config));
+    } catch (const std::exception& e) {
+        state.SkipWithError(e.what());
+        return;
+    }
+    yolo->infer(images[0].image);  // First run allocates and packs weights.
+
+    size_t next = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(yolo->infer(images[next].image).size());
+        next = (next + 1) % images.size();
+    }
+
+    int matched = 0, found = 0, expected = 0;
+    for (const Sample& sample : images) {
+        const std::pair<int, int> result =
+            score(sample.truth, toBoxes(yolo->infer(sample.image)));
+        matched += result.first;
+        found += result.second;
+        expected += static_cast<int>(sample.truth.size());
+    }
+    state.counters["precision"] = found > 0 ? 1.0 * matched / found : 0.0;
+    state.counters["recall"] = expected > 0 ? 1.0 * matched / expected : 0.0;
+    state.SetLabel(yolo->backendName());
+}
+
+/**
+ * @brief Registers one benchmark per model and precision at start-up.
+ */
+const bool registered = [] {
+    const std::vector<std::pair<std::string, Precision>> variants = {
+        {"yolov3", Precision::FP32},      {"yolov3", Precision::FP16},
+        {"yolov3-tiny", Precision::FP32}, {"yolov5s", Precision::FP32},
+        {"yolov8n", Precision::FP32}};
+    for (const auto& variant : variants) {
+        BackendConfig config = BackendConfig::preset(variant.first);
+        config.precision = variant.second;
+        benchmark::RegisterBenchmark(
+            ("BM_Backend/" + variant.first + "/" + toString(variant.second)).c_str(),
+            BM_Backend, config)->Unit(benchmark::kMillisecond);
+    }
+    // INT8 quantised at load time from the benchmark images themselves.
+    if (const char* directory = std::getenv("BENCH_IMAGES")) {
+        BackendConfig config = BackendConfig::preset("yolov3");
+        config.precision = Precision::INT8;
+        config.calibration = std::string(directory) + "/*.jpg";
+        benchmark::RegisterBenchmark("BM_Backend/yolov3/int8", BM_Backend, config)
+            ->Unit(benchmark::kMillisecond);
+    }
+    return true;
+}();
+
+}  // namespace
@@ -0,0 +1,136 @@
+// Copyright 2026 Sai Surya Sriramoju
+
+/**
+ * @file bench_decode.cpp
+ * @brief Microbenchmarks for decoding YOLO output layers.
+ * @author Sai Surya Sriramoju
+ * @date 10/17/2026
+ *
+ * Every iteration decodes one synthetic YOLOv3-416 frame (507 + 2028 + 8112
+ * anchor rows), so the reported time is the decode time per frame.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <vector>
+#include <opencv2/opencv.hpp>
+
+#include "DecodeKernels.h"
+#include "DetectionDecoder.h"
+
+namespace {
+
+/**
+ * @brief Builds the three output layers of a YOLOv3-416 frame.
+ *
+ * Roughly one anchor in a hundred has a high objectness, which matches what
+ * the network produces on typical indoor scenes.
+ */
+std::vector<cv::Mat> makeFrameOutputs() {
+    cv::RNG rng(1234);
+    std::vector<cv::Mat> outputs;
+    for (int rows : {507, 2028, 8112}) {
+        cv::Mat output(rows, 85, CV_32F);
+        for (int j = 0; j < rows; ++j) {
+            float* data = output.ptr<float>(j);
+            data[0] = rng.uniform(0.0f, 1.0f);
+            data[1] = rng.uniform(0.0f, 1.0f);
+            data[2] = rng.uniform(0.02f, 0.3f);
+            data[3] = rng.uniform(0.05f, 0.6f);
+            data[4] = rng.uniform(0.0f, 1.0f) < 0.01f ? rng.uniform(0.5f, 1.0f)
+                                                      : rng.uniform(0.0f, 0.05f);
+            for (int c = 5; c < 85; ++c) {
+                data[c] = data[4] * rng.uniform(0.0f, 1.0f);
+            }
+        }
+        outputs.push_back(output);
+    }
+    return outputs;
+}
+
+/**
+ * @brief The original scan: minMaxLoc over a per-row Mat header for every row.
+ */
+void BM_DecodeMinMaxLoc(benchmark::State& state) {
+    const std::vector<cv::Mat> outputs = makeFrameOutputs();
+    for (auto _ : state) {
+        std::vector<cv::Rect> boxes;
+        std::vector<float> confidences;
+        std::vector<int> class_ids;
+        for (const cv::Mat& d : outputs) {
+            const float* data = reinterpret_cast<const float*>(d.data);
+            for (int j = 0; j < d.rows; ++j, data += d.cols) {
+                cv::Mat scores = d.row(j).colRange(5, d.cols);
+                cv::Point classIdPoint;
+                double confidence;
+                cv::minMaxLoc(scores, 0, &confidence, 0, &classIdPoint);
+                if (confidence > 0.5) {
+                    class_ids.push_back(classIdPoint.x);
+                    boxes.push_back(cv::Rect(static_cast<int>(data[0] * 640),
+                                             static_cast<int>(data[1] * 480),
+                                             static_cast<int>(data[2] * 640),
+                                             static_cast<int>(data[3] * 480)));
+                    confidences.push_back(static_cast<float>(confidence));
+                }
+            }
+        }
+        std::vector<int> indices;
+        cv::dnn::NMSBoxes(boxes, confidences, 0.2f, 0.2f, indices);
+        benchmark::DoNotOptimize(indices.data());
+    }
+}
+BENCHMARK(BM_DecodeMinMaxLoc);
+
+/**
+ * @brief DetectionDecoder with early reject and argmax over all classes.
+ */
+void BM_DecodeAllClasses(benchmark::State& state) {
+    const std::vector<cv::Mat> outputs = makeFrameOutputs();
+    DetectionDecoder decoder;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(
+            decoder.decode(outputs, cv::Size(640, 480)).size());
+    }
+    state.SetLabel(decodeKernelIsa());
+}
+BENCHMARK(BM_DecodeAllClasses);
+
+/**
+ * @brief DetectionDecoder restricted to the COCO person class.
+ */
+void BM_DecodePersonOnly(benchmark::State& state) {
+    const std::vector<cv::Mat> outputs = makeFrameOutputs();
+    DecoderConfig config;
+    config.classes = {0};
+    DetectionDecoder decoder(config);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(
+            decoder.decode(outputs, cv::Size(640, 480)).size());
+    }
+}
+BENCHMARK(BM_DecodePersonOnly);
+
+/**
+ * @brief Argmax over the 80 COCO class scores: dispatched kernel vs scalar.
+ */
+void BM_Argmax80(benchmark::State& state) {
+    const bool simd = state.range(0) != 0;
+    std::vector<float> scores(80);
+    cv::RNG rng(5);
+    for (float& score : scores) {
+        score = rng.uniform(0.0f, 1.0f);
+    }
+    float best = 0.0f;
+    for (auto _ : state) {
+        int index = simd ? argmaxScores(scores.data(), 80, &best)
+                         : argmaxScoresScalar(scores.data(), 80, &best);
+        benchmark::DoNotOptimize(index);
+        benchmark::DoNotOptimize(best);
+    }
+    state.SetLabel(simd ? decodeKernelIsa() : "scalar");
+}
+BENCHMARK(BM_Argmax80)->Arg(0)->Arg(1);
+
+}  // namespace
+
+BENCHMARK_MAIN();
@@ -0,0 +1,83 @@
+// Copyright 2026 Sai Surya Sriramoju
+
+/**
+ * @file bench_nms.cpp
+ * @brief Benchmarks of NMSEngine against cv::dnn::NMSBoxes.
+ * @author Sai Surya Sriramoju
+ * @date 10/17/2026
+ *
+ * The argument is the number of candidate boxes, spread over a crowded
+ * 1280 x 720 scene with three classes.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <vector>
+#include <opencv2/opencv.hpp>
+
+#include "Detections.h"
+#include "NMS.h"
+
+namespace {
+
+/**
+ * @brief Builds @p n clustered candidate boxes.
+ */
+Detections makeCandidates(int n) {
+    cv::RNG rng(99);
+    Detections candidates;
+    for (int i = 0; i < n; ++i) {
+        // Candidates cluster around a few dozen people, like real YOLO output.
+        const int person = rng.uniform(0, 40);
+        const float cx = 30.0f * (person % 40) + rng.uniform(-8.0f, 8.0f);
+        const float cy = 300.0f + 10.0f * (person % 7) + rng.uniform(-8.0f, 8.0f);
+        candidates.push(cx, cy, rng.uniform(40.0f, 60.0f),
+                        rng.uniform(100.0f, 140.0f), rng.uniform(0.2f, 1.0f),
+                        person % 3);
+    }
+    return candidates;
+}
+
+/**
+ * @brief OpenCV's class-agnostic NMSBoxes on integer rectangles.
+ */
+void BM_NMSBoxes(benchmark::State& state) {
+    const Detections candidates = makeCandidates(static_cast<int>(state.range(0)));
+    std::vector<cv::Rect> boxes;
+    for (size_t i = 0; i < candidates.size(); ++i) {
+        boxes.push_back(candidates.box(i));
+    }
+    std::vector<int> indices;
+    for (auto _ : state) {
+        cv::dnn::NMSBoxes(boxes, candidates.scores, 0.2f, 0.4f, indices);
+        benchmark::DoNotOptimize(indices.data());
+    }
+}
+BENCHMARK(BM_NMSBoxes)->RangeMultiplier(4)->Range(64, 4096);
+
+/**
+ * @brief NMSEngine in hard, soft linear and soft Gaussian mode.
+ */
+void BM_NMSEngine(benchmark::State& state, NMSMode mode, bool classAware) {
+    const Detections candidates = makeCandidates(static_cast<int>(state.range(0)));
+    NMSConfig config;
+    config.iouThreshold = 0.4f;
+    config.mode = mode;
+    config.classAware = classAware;
+    NMSEngine engine;
+    Detections kept;
+    for (auto _ : state) {
+        engine.run(candidates, config, kept);
+        benchmark::DoNotOptimize(kept.scores.data());
+    }
+}
+BENCHMARK_CAPTURE(BM_NMSEngine, HardAgnostic, NMSMode::Hard, false)
+    ->RangeMultiplier(4)->Range(64, 4096);
+BENCHMARK_CAPTURE(BM_NMSEngine, HardClassAware, NMSMode::Hard, true)
+    ->RangeMultiplier(4)->Range(64, 4096);
+BENCHMARK_CAPTURE(BM_NMSEngine, SoftLinear, NMSMode::SoftLinear, true)
+    ->RangeMultiplier(4)->Range(64, 4096);
+BENCHMARK_CAPTURE(BM_NMSEngine, SoftGaussian, NMSMode::SoftGaussian, true)
+    ->RangeMultiplier(4)->Range(64, 4096);
+
+}  // namespace
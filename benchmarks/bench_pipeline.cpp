@@ -0,0 +1,236 @@
+// Copyright 2026 Sai Surya Sriramoju
+
+/**
+ * @file bench_pipeline.cpp
+ * @brief Benchmarks of the per-frame stages and the whole frame loop.
+ * @author Sai Surya Sriramoju
+ * @date 10/17/2026
+ *
+ * Frames come from BENCH_IMAGES, a directory of recorded images (the first
+ * 16 .jpg/.png files, in name order), so runs on different builds see the
+ * same input. Without it a fixed synthetic 1080p scene is used. Every
+ * iteration processes the next frame. The YOLOv3 model must be present in
+ * the models directory for the forward pass, detection and frame loop
+ * benchmarks; they are reported as errors otherwise.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <vector>
+#include <opencv2/opencv.hpp>
+
+#include "CoordToWorld.h"
+#include "DetectorBackend.h"
+#include "OpenCVProcessor.h"
+#include "Preprocessor.h"
+#include "Tracker.h"
+#include "YOLO.h"
+
+namespace {
+/// Most recorded frames loaded from BENCH_IMAGES.
+const size_t kMaxFrames = 16;
+
+/**
+ * @brief A 1080p scene with a dozen person-sized blobs, shifted by @p step
+ *        pixels so consecutive frames differ like a slow pan.
+ */
+cv::Mat makeScene(int step) {
+    cv::Mat frame(1080, 1920, CV_8UC3);
+    cv::RNG rng(7);
+    rng.fill(frame, cv::RNG::UNIFORM, 0, 256);
+    cv::GaussianBlur(frame, frame, cv::Size(15, 15), 0);
+    for (int i = 0; i < 12; ++i) {
+        const cv::Rect person(150 * i + 4 * step, 400 + 20 * (i % 5), 80, 220);
+        cv::rectangle(frame, person, cv::Scalar(40 * (i % 6), 90, 200), cv::FILLED);
+    }
+    return frame;
+}
+
+/**
+ * @brief Loads the benchmark frames once.
+ */
+const std::vector<cv::Mat>& frames() {
+    static std::vector<cv::Mat> loaded;
+    if (!loaded.empty()) {
+        return loaded;
+    }
+    if (const char* directory = std::getenv("BENCH_IMAGES")) {
+        std::vector<std::string> paths;
+        cv::glob(std::string(directory) + "/*.jpg", paths);
+        std::vector<std::string> png;
+        cv::glob(std::string(directory) + "/*.png", png);
+        paths.insert(paths.end(), png.begin(), png.end());
+        std::sort(paths.begin(), paths.end());  // .jpg and .png interleaved.
+        for (const std::string& path : paths) {
+            const cv::Mat image = cv::imread(path);
+            if (!image.empty() && loaded.size() < kMaxFrames) {
+                loaded.push_back(image);
+            }
+        }
+    }
+    if (loaded.empty()) {
+        for (int step = 0; step < 4; ++step) {
+            loaded.push_back(makeScene(step));
+        }
+    }
+    return loaded;
+}
+
+/**
+ * @brief Loads the default YOLOv3 detector once.
+ *
+ * @param state Marked as errored if the model cannot be loaded.
+ * @return YOLO* - The detector, or nullptr.
+ */
+YOLO* detector(benchmark::State& state) {
+    static std::unique_ptr<YOLO> yolo;
+    static std::string error;
+    if (!yolo && error.empty()) {
+        try {
+            yolo.reset(new YOLO());
+            PostprocessOptions options;
+            options.print = false;  // Console I/O is not what is measured.
+            yolo->setPostprocessOptions(options);
+            yolo->infer(frames()[0]);  // First run allocates and packs weights.
+        } catch (const std::exception& e) {
+            error = e.what();
+        }
+    }
+    if (!yolo) {
+        state.SkipWithError(error.c_str());
+    }
+    return yolo.get();
+}
+
+/**
+ * @brief OpenCVProcessor::processImages() with the default options.
+ *
+ * Includes copying the frame, since processing works in place.
+ */
+void BM_ProcessImages(benchmark::State& state) {
+    const std::vector<cv::Mat>& images = frames();
+    OpenCVProcessor processor;
+    cv::Mat frame;
+    size_t next = 0;
+    for (auto _ : state) {
+        images[next].copyTo(frame);
+        processor.processImages(frame);
+        benchmark::DoNotOptimize(frame.data);
+        next = (next + 1) % images.size();
+    }
+}
+BENCHMARK(BM_ProcessImages)->Unit(benchmark::kMillisecond);
+
+/**
+ * @brief The network alone, on a preprocessed 416 x 416 blob.
+ */
+void BM_ForwardPass(benchmark::State& state) {
+    BackendConfig config;
+    config.model = YOLO::modelsDir + "/" + config.model;
+    config.config = YOLO::modelsDir + "/" + config.config;
+    std::unique_ptr<DetectorBackend> backend;
+    try {
+        backend = createBackend(config);
+    } catch (const std::exception& e) {
+        state.SkipWithError(e.what());
+        return;
+    }
+    Preprocessor preprocessor(static_cast<int>(InputMode::Balanced));
+    LetterboxTransform transform;
+    const cv::Mat blob = preprocessor.blobFromFrame(frames()[0], transform).clone();
+    std::vector<cv::Mat> outputs;
+    backend->forward(blob, outputs);  // Warm-up.
+    for (auto _ : state) {
+        backend->forward(blob, outputs);
+        benchmark::DoNotOptimize(outputs.data());
+    }
+    state.SetLabel(backend->describe());
+}
+BENCHMARK(BM_ForwardPass)->Unit(benchmark::kMillisecond);
+
+/**
+ * @brief YOLO::detect(): preprocessing, forward pass, decode, NMS and
+ *        annotation of one frame.
+ */
+void BM_Detect(benchmark::State& state) {
+    YOLO* yolo = detector(state);
+    if (yolo == nullptr) {
+        return;
+    }
+    const std::vector<cv::Mat>& images = frames();
+    cv::Mat frame;
+    size_t next = 0;
+    for (auto _ : state) {
+        images[next].copyTo(frame);
+        benchmark::DoNotOptimize(yolo->detect(frame).data());
+        next = (next + 1) % images.size();
+    }
+}
+BENCHMARK(BM_Detect)->Unit(benchmark::kMillisecond);
+
+/**
+ * @brief MultiObjectTracker::update() with 50 people walking.
+ */
+void BM_TrackerUpdate(benchmark::State& state) {
+    MultiObjectTracker tracker;
+    Detections detections;
+    int frame = 0;
+    for (auto _ : state) {
+        detections.clear();
+        for (int i = 0; i < 50; ++i) {
+            detections.push(36.0f * i + 2.0f * (frame % 100), 300.0f + 3.0f * (i % 7),
+                            30.0f, 90.0f, 0.9f, 0);
+        }
+        benchmark::DoNotOptimize(tracker.update(detections).data());
+        ++frame;
+    }
+}
+BENCHMARK(BM_TrackerUpdate)->Unit(benchmark::kMicrosecond);
+
+/**
+ * @brief MotionGate::evaluate() on consecutive frames.
+ */
+void BM_MotionGate(benchmark::State& state) {
+    const std::vector<cv::Mat>& images = frames();
+    MotionGate gate;
+    size_t next = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(gate.evaluate(images[next]).run);
+        next = (next + 1) % images.size();
+    }
+}
+BENCHMARK(BM_MotionGate)->Unit(benchmark::kMicrosecond);
+
+/**
+ * @brief One frame through every stage on one thread: detection,
+ *        OpenCV processing and back-projection, as Pipeline does per frame.
+ */
+void BM_FrameLoop(benchmark::State& state) {
+    YOLO* yolo = detector(state);
+    if (yolo == nullptr) {
+        return;
+    }
+    const std::vector<cv::Mat>& images = frames();
+    OpenCVProcessor processor;
+    CoordToWorld world;
+    WorldProjector projector(world.projection());
+    std::vector<double> worldCoords;
+    cv::Mat frame;
+    size_t next = 0;
+    for (auto _ : state) {
+        images[next].copyTo(frame);
+        const std::vector<double> pixels = yolo->detect(frame);
+        processor.processImages(frame);
+        projector.project(pixels, worldCoords);
+        benchmark::DoNotOptimize(worldCoords.data());
+        next = (next + 1) % images.size();
+    }
+    state.counters["fps"] = benchmark::Counter(
+        static_cast<double>(state.iterations()), benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_FrameLoop)->Unit(benchmark::kMillisecond);
+}  // namespace
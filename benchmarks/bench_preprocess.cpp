@@ -0,0 +1,116 @@
+// Copyright 2026 Sai Surya Sriramoju
+
+/**
+ * @file bench_preprocess.cpp
+ * @brief Benchmarks of the separate and fused network preprocessing paths.
+ * @author Sai Surya Sriramoju
+ * @date 10/17/2026
+ *
+ * Every benchmark turns a 1920 x 1080 BGR frame into a 416 x 416 network
+ * blob. Besides the time, each reports "traffic", an estimate of the bytes
+ * its passes read and write: the source frame once per pass that reads it,
+ * plus every intermediate image written and read back, plus the blob.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <opencv2/opencv.hpp>
+
+#include "OpenCVProcessor.h"
+#include "Preprocessor.h"
+
+namespace {
+
+const int kSide = 416;
+const double kFrameBytes = 1920.0 * 1080 * 3;
+const double kImageBytes = static_cast<double>(kSide) * kSide * 3;
+const double kBlobBytes = kImageBytes * sizeof(float);
+
+/**
+ * @brief A 1080p frame with some structure, as a camera would deliver.
+ */
+cv::Mat makeFrame() {
+    cv::Mat frame(1080, 1920, CV_8UC3);
+    cv::RNG rng(3);
+    rng.fill(frame, cv::RNG::UNIFORM, 0, 256);
+    cv::GaussianBlur(frame, frame, cv::Size(15, 15), 0);
+    return frame;
+}
+
+/**
+ * @brief Records the estimated memory traffic per frame.
+ */
+void setTraffic(benchmark::State& state, double bytes) {
+    state.counters["traffic"] =
+        benchmark::Counter(bytes, benchmark::Counter::kIsIterationInvariantRate,
+                           benchmark::Counter::kIs1024);
+}
+
+/**
+ * @brief The original path: full-frame blur then stretching blobFromImage.
+ *
+ * Blur reads and writes the frame; blobFromImage resizes (read frame, write
+ * image), swaps channels and converts (read image, write float image) and
+ * splits into planes (read float image, write blob).
+ */
+void BM_OriginalBlurAndBlob(benchmark::State& state) {
+    const cv::Mat source = makeFrame();
+    cv::Mat frame = source.clone();
+    OpenCVProcessor processor;
+    cv::Mat blob;
+    for (auto _ : state) {
+        processor.processImages(frame);
+        cv::dnn::blobFromImage(frame, blob, 1/255.0, cv::Size(kSide, kSide),
+                               cv::Scalar(), true, false);
+        benchmark::DoNotOptimize(blob.data);
+    }
+    setTraffic(state, 2 * kFrameBytes + kFrameBytes + 2 * kImageBytes +
+                      2 * kBlobBytes + kBlobBytes);
+}
+BENCHMARK(BM_OriginalBlurAndBlob)->Unit(benchmark::kMicrosecond);
+
+/**
+ * @brief Separate letterbox + blobFromImage, optionally blurring the frame.
+ */
+void BM_SeparateLetterbox(benchmark::State& state) {
+    const bool blur = state.range(0) != 0;
+    cv::Mat frame = makeFrame();
+    ProcessingOptions processing;
+    processing.gaussianBlur = blur;
+    OpenCVProcessor processor(processing);
+    Preprocessor preprocessor(kSide);
+    PreprocessOptions options;
+    options.fused = false;
+    preprocessor.setOptions(options);
+    LetterboxTransform transform;
+    for (auto _ : state) {
+        processor.processImages(frame);
+        benchmark::DoNotOptimize(preprocessor.blobFromFrame(frame, transform).data);
+    }
+    setTraffic(state, (blur ? 2 * kFrameBytes : 0.0) + kFrameBytes +
+                      2 * kImageBytes + kImageBytes + 2 * kBlobBytes +
+                      kBlobBytes);
+}
+BENCHMARK(BM_SeparateLetterbox)->Arg(0)->Arg(1)->Unit(benchmark::kMicrosecond);
+
+/**
+ * @brief The fused pass, optionally blurring at network resolution.
+ *
+ * Reads the source rows once and writes the blob once; the blur works on
+ * row tiles that stay in cache.
+ */
+void BM_FusedLetterbox(benchmark::State& state) {
+    const cv::Mat frame = makeFrame();
+    Preprocessor preprocessor(kSide);
+    PreprocessOptions options;
+    options.gaussianBlur = state.range(0) != 0;
+    preprocessor.setOptions(options);
+    LetterboxTransform transform;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(preprocessor.blobFromFrame(frame, transform).data);
+    }
+    setTraffic(state, kFrameBytes + kBlobBytes);
+}
+BENCHMARK(BM_FusedLetterbox)->Arg(0)->Arg(1)->Unit(benchmark::kMicrosecond);
+
+}  // namespace
@@ -0,0 +1,64 @@
+// Copyright 2026 Sai Surya Sriramoju
+
+/**
+ * @file bench_projection.cpp
+ * @brief Benchmarks of per-point and batched pixel to world back-projection.
+ * @author Sai Surya Sriramoju
+ * @date 10/17/2026
+ *
+ * The argument is the number of pixels projected per iteration.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <vector>
+
+#include "CoordToWorld.h"
+
+namespace {
+
+/**
+ * @brief Builds @p n interleaved (u, v) pixels spread over a 1080p frame.
+ */
+std::vector<double> makePixels(int n) {
+    std::vector<double> pixels;
+    pixels.reserve(2 * n);
+    for (int i = 0; i < n; ++i) {
+        pixels.push_back((i * 37) % 1920);
+        pixels.push_back((i * 61) % 1080);
+    }
+    return pixels;
+}
+
+/**
+ * @brief The original path: transMat() and worldPoints() on every frame.
+ */
+void BM_WorldPoints(benchmark::State& state) {
+    CoordToWorld world;
+    const std::vector<double> pixels = makePixels(static_cast<int>(state.range(0)));
+    for (auto _ : state) {
+        const MatrixXf T = world.transMat();
+        std::vector<double> result = world.worldPoints(T, pixels);
+        benchmark::DoNotOptimize(result.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_WorldPoints)->RangeMultiplier(10)->Range(1000, 100000);
+
+/**
+ * @brief WorldProjector with the cached inverse and reused output buffer.
+ */
+void BM_WorldProjector(benchmark::State& state) {
+    CoordToWorld world;
+    WorldProjector projector(world.projection());
+    const std::vector<double> pixels = makePixels(static_cast<int>(state.range(0)));
+    std::vector<double> result;
+    for (auto _ : state) {
+        projector.project(pixels, result);
+        benchmark::DoNotOptimize(result.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_WorldProjector)->RangeMultiplier(10)->Range(1000, 100000);
+
+}  // namespace
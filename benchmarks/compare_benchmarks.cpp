@@ -0,0 +1,119 @@
+// Copyright 2026 Sai Surya Sriramoju
+
+/**
+ * @file compare_benchmarks.cpp
+ * @brief Compares a runBenchmarks JSON report against a stored baseline.
+ * @author Sai Surya Sriramoju
+ * @date 10/17/2026
+ *
+ * Usage: compareBenchmarks <baseline.json> <current.json> [tolerance %]
+ *
+ * Both files are Google Benchmark JSON reports (--benchmark_out=<file>
+ * --benchmark_out_format=json). Benchmarks present in both are compared on
+ * real time; with repetitions only the median is compared. A benchmark more
+ * than the tolerance (default 10 %) slower than its baseline is a regression
+ * and makes the exit status 1, so the check can gate a deployment.
+ */
+
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <opencv2/opencv.hpp>
+
+namespace {
+
+/**
+ * @brief Nanoseconds per unit of a Google Benchmark "time_unit".
+ */
+double nanoseconds(const std::string& unit) {
+    if (unit == "us") {
+        return 1e3;
+    }
+    if (unit == "ms") {
+        return 1e6;
+    }
+    if (unit == "s") {
+        return 1e9;
+    }
+    return 1.0;
+}
+
+/**
+ * @brief Reads the real time in ns of every comparable benchmark in @p path.
+ *
+ * Errored runs and the mean/stddev/cv aggregates are left out.
+ */
+std::map<std::string, double> readReport(const std::string& path) {
+    cv::FileStorage file(path, cv::FileStorage::READ | cv::FileStorage::FORMAT_JSON);
+    if (!file.isOpened()) {
+        throw std::runtime_error("Cannot read " + path);
+    }
+    std::map<std::string, double> times;
+    const cv::FileNode benchmarks = file["benchmarks"];
+    for (size_t i = 0; i < benchmarks.size(); ++i) {
+        const cv::FileNode entry = benchmarks[static_cast<int>(i)];
+        const cv::FileNode failed = entry["error_occurred"];
+        if (!failed.empty() && static_cast<int>(failed) != 0) {
+            continue;
+        }
+        const cv::FileNode aggregate = entry["aggregate_name"];
+        if (!aggregate.empty() && aggregate.string() != "median") {
+            continue;
+        }
+        times[entry["name"].string()] =
+            entry["real_time"].real() * nanoseconds(entry["time_unit"].string());
+    }
+    return times;
+}
+}  // namespace
+
+/**
+ * @brief Prints the comparison and returns 1 if anything regressed.
+ *
+ * @param argc Number of command line arguments.
+ * @param argv Baseline report, current report and optional tolerance in %.
+ * @return int - 0 if nothing regressed, 1 on a regression, 2 on bad input.
+ */
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        std::cerr << "Usage: " << argv[0]
+                  << " <baseline.json> <current.json> [tolerance %]\n";
+        return 2;
+    }
+    const double tolerance = argc > 3 ? std::atof(argv[3]) : 10.0;
+    std::map<std::string, double> baseline, current;
+    try {
+        baseline = readReport(argv[1]);
+        current = readReport(argv[2]);
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << "\n";
+        return 2;
+    }
+
+    int regressions = 0;
+    std::cout << std::fixed << std::setprecision(1);
+    for (const auto& run : current) {
+        const auto base = baseline.find(run.first);
+        if (base == baseline.end()) {
+            std::cout << "  new         " << run.first << "\n";
+            continue;
+        }
+        const double change = 100.0 * (run.second / base->second - 1.0);
+        const bool regressed = change > tolerance;
+        regressions += regressed ? 1 : 0;
+        std::cout << (regressed ? "  REGRESSION " : "  ok         ")
+                  << std::setw(7) << std::showpos << change << std::noshowpos
+                  << "%  " << run.first << "  (" << base->second / 1e3
+                  << " -> " << run.second / 1e3 << " us)\n";
+    }
+    for (const auto& base : baseline) {
+        if (current.find(base.first) == current.end()) {
+            std::cout << "  missing     " << base.first << "\n";
+        }
+    }
+    std::cout << regressions << " regression(s) beyond " << tolerance << "%\n";
+    return regressions > 0 ? 1 : 0;
+}
@@ -0,0 +1,210 @@
+// Copyright 2026 Sai Surya Sriramoju
+
+/**
+ * @file sweep_placement.cpp
+ * @brief Measures detector throughput and latency for every placement of
+ *        placementSweep() and reports the best one.
+ * @author Sai Surya Sriramoju
+ * @date 10/17/2026
+ *
+ * Usage: sweepPlacement [seconds per placement] [max instances]
+ *
+ * Every placement (instances x OpenCV threads x unpinned/compact/spread)
+ * runs the default YOLOv3 detector on an AsyncDetector for the given time
+ * (default 3 s), keeping two frames per instance in flight. Frames come
+ * from BENCH_IMAGES as for runBenchmarks, or a synthetic 1080p scene. The
+ * fastest placement is printed as PerceptionModule options. Build with
+ * -D WANT_COVERAGE=OFF -D CMAKE_BUILD_TYPE=Release and keep the machine
+ * otherwise idle.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <deque>
+#include <future>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+#include <opencv2/opencv.hpp>
+
+#include "Affinity.h"
+#include "AsyncDetector.h"
+#include "Metrics.h"
+#include "YOLO.h"
+
+namespace {
+/// Most recorded frames loaded from BENCH_IMAGES.
+const size_t kMaxFrames = 16;
+
+/**
+ * @brief What one placement achieved.
+ */
+struct Result {
+    Placement placement;   ///< What was measured.
+    double fps = 0.0;      ///< Frames per second.
+    double p50Ms = 0.0;    ///< Median submit-to-result latency.
+    double p95Ms = 0.0;    ///< 95th percentile latency.
+};
+
+/**
+ * @brief Loads up to kMaxFrames images from BENCH_IMAGES, or makes a 1080p
+ *        scene with person-sized blobs.
+ */
+std::vector<cv::Mat> loadFrames() {
+    std::vector<cv::Mat> frames;
+    if (const char* directory = std::getenv("BENCH_IMAGES")) {
+        std::vector<std::string> paths;
+        cv::glob(std::string(directory) + "/*.jpg", paths);
+        for (const std::string& path : paths) {
+            const cv::Mat image = cv::imread(path);
+            if (!image.empty() && frames.size() < kMaxFrames) {
+                frames.push_back(image);
+            }
+        }
+    }
+    if (frames.empty()) {
+        cv::Mat frame(1080, 1920, CV_8UC3);
+        cv::RNG rng(7);
+        rng.fill(frame, cv::RNG::UNIFORM, 0, 256);
+        cv::GaussianBlur(frame, frame, cv::Size(15, 15), 0);
+        for (int i = 0; i < 12; ++i) {
+            const cv::Rect person(150 * i, 400 + 20 * (i % 5), 80, 220);
+            cv::rectangle(frame, person, cv::Scalar(40 * (i % 6), 90, 200),
+                          cv::FILLED);
+        }
+        frames.push_back(frame);
+    }
+    return frames;
+}
+
+/**
+ * @brief Formats a placement as PerceptionModule options.
+ */
+std::string options(const Placement& placement) {
+    std::string text = "--detectors=" + std::to_string(placement.instances) +
+                       " --threads-per-detector=" +
+                       std::to_string(placement.threads);
+    if (!placement.cpus.empty()) {
+        text += " --pin-inference='";
+        for (size_t i = 0; i < placement.cpus.size(); ++i) {
+            text += (i > 0 ? ";" : "") + formatCpuList(placement.cpus[i]);
+        }
+        text += "'";
+    }
+    return text;
+}
+
+/**
+ * @brief Runs @p placement for @p seconds on @p prototype and its copies.
+ */
+Result measure(YOLO& prototype, const Placement& placement,
+               const std::vector<cv::Mat>& frames, double seconds) {
+    // AsyncDetector leaves the count alone for 0 threads, and an earlier
+    // placement changed it; -1 restores OpenCV's default.
+    cv::setNumThreads(placement.threads > 0 ? placement.threads : -1);
+    AsyncConfig config;
+    config.instances = placement.instances;
+    config.threadsPerInstance = placement.threads;
+    config.cpus = placement.cpus;
+    AsyncDetector detector(prototype, config);
+
+    struct Pending {
+        std::future<Detections> result;
+        std::chrono::steady_clock::time_point submitted;
+    };
+    std::deque<Pending> pending;
+    Histogram latency;
+    const size_t depth = 2 * static_cast<size_t>(placement.instances);
+    const auto start = std::chrono::steady_clock::now();
+    const auto end = start + std::chrono::duration_cast<
+        std::chrono::steady_clock::duration>(std::chrono::duration<double>(seconds));
+    size_t next = 0;
+    uint64_t done = 0;
+    while (std::chrono::steady_clock::now() < end || !pending.empty()) {
+        if (pending.size() < depth && std::chrono::steady_clock::now() < end) {
+            Pending request;
+            request.submitted = std::chrono::steady_clock::now();
+            request.result = detector.submit(frames[next]);
+            next = (next + 1) % frames.size();
+            pending.push_back(std::move(request));
+            continue;
+        }
+        pending.front().result.get();
+        latency.record(std::chrono::steady_clock::now() -
+                       pending.front().submitted);
+        pending.pop_front();
+        ++done;
+    }
+    const double elapsed = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - start).count();
+
+    Result result;
+    result.placement = placement;
+    result.fps = done / elapsed;
+    const HistogramSnapshot snapshot = latency.snapshot();
+    result.p50Ms = snapshot.quantile(0.50) * 1e3;
+    result.p95Ms = snapshot.quantile(0.95) * 1e3;
+    return result;
+}
+}  // namespace
+
+int main(int argc, char** argv) {
+    const double seconds = argc > 1 ? std::atof(argv[1]) : 3.0;
+    const int maxInstances = argc > 2 ? std::atoi(argv[2]) : 0;
+    if (seconds <= 0.0) {
+        std::cerr << "Usage: " << argv[0]
+                  << " [seconds per placement] [max instances]\n";
+        return 2;
+    }
+
+    const CpuList cpus = allowedCpus();
+    std::vector<CpuList> nodes;
+    for (int node = 0; node < numaNodeCount(); ++node) {
+        nodes.push_back(numaNodeCpus(node));
+    }
+    std::cout << cpus.size() << " CPUs (" << formatCpuList(cpus) << ") on "
+              << nodes.size() << " NUMA node(s)\n";
+    for (size_t node = 0; node < nodes.size(); ++node) {
+        std::cout << "  node" << node << ": " << formatCpuList(nodes[node]) << "\n";
+    }
+
+    const std::vector<cv::Mat> frames = loadFrames();
+    std::unique_ptr<YOLO> prototype;
+    try {
+        prototype.reset(new YOLO());
+        PostprocessOptions postprocess;
+        postprocess.print = false;
+        prototype->setPostprocessOptions(postprocess);
+        prototype->infer(frames[0]);  // First run allocates and packs weights.
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << "\n";
+        return 1;
+    }
+
+    std::vector<Result> results;
+    std::cout << std::fixed << std::setprecision(1);
+    for (const Placement& placement : placementSweep(cpus, nodes, maxInstances)) {
+        results.push_back(measure(*prototype, placement, frames, seconds));
+        const Result& r = results.back();
+        std::cout << std::setw(9) << r.placement.name << " " << std::setw(3)
+                  << r.placement.instances << " x " << std::setw(2)
+                  << r.placement.threads << " threads  " << std::setw(7)
+                  << r.fps << " fps  p50 " << std::setw(7) << r.p50Ms
+                  << " ms  p95 " << std::setw(7) << r.p95Ms << " ms\n";
+    }
+
+    const auto fastest = std::max_element(
+        results.begin(), results.end(),
+        [](const Result& a, const Result& b) { return a.fps < b.fps; });
+    const auto quickest = std::min_element(
+        results.begin(), results.end(),
+        [](const Result& a, const Result& b) { return a.p95Ms < b.p95Ms; });
+    std::cout << "Best throughput (" << fastest->fps << " fps): "
+              << options(fastest->placement) << "\n"
+              << "Best p95 latency (" << quickest->p95Ms << " ms): "
+              << options(quickest->placement) << "\n";
+    return 0;
+}
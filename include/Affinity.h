@@ -0,0 +1,121 @@
+// Copyright 2026 Sai Surya Sriramoju
+
+/**
+ * @file Affinity.h
+ * @brief Declaration of the CPU list, NUMA topology and thread pinning
+ *        helpers, and of the placements the sweep benchmark tries.
+ * @author Sai Surya Sriramoju
+ * @date 10/17/2026
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/// Logical CPU numbers, sorted and without duplicates.
+using CpuList = std::vector<int>;
+
+/**
+ * @brief Parses a CPU list such as "0-3,8,10-11" or "node1".
+ *
+ * Ranges and single CPUs may be mixed with "node<N>", which stands for all
+ * CPUs of NUMA node N. An empty text gives an empty list, which means
+ * "not pinned" everywhere a CpuList is taken.
+ *
+ * @throws std::invalid_argument on malformed text or an unknown node.
+ */
+CpuList parseCpuList(const std::string& text);
+
+/**
+ * @brief Parses ';' separated CPU lists, e.g. "node0;node1" for one list
+ *        per detector instance or source.
+ *
+ * @throws std::invalid_argument if one of the lists is malformed.
+ */
+std::vector<CpuList> parseCpuLists(const std::string& text);
+
+/**
+ * @brief Formats @p cpus the way parseCpuList() reads them, e.g. "0-3,8".
+ */
+std::string formatCpuList(const CpuList& cpus);
+
+/**
+ * @brief Returns entry @p index of @p lists; indices past the end get the
+ *        last entry, and an empty @p lists gives an empty (unpinned) list.
+ */
+const CpuList& cpusFor(const std::vector<CpuList>& lists, size_t index);
+
+/**
+ * @brief Returns the CPUs this process may run on.
+ */
+CpuList allowedCpus();
+
+/**
+ * @brief Returns the number of NUMA nodes, 1 where the kernel reports none.
+ */
+int numaNodeCount();
+
+/**
+ * @brief Returns the CPUs of NUMA node @p node, empty if there is no such
+ *        node. Without NUMA information node 0 has every allowed CPU.
+ */
+CpuList numaNodeCpus(int node);
+
+/**
+ * @brief Restricts the calling thread to @p cpus.
+ *
+ * Threads started by the pinned thread afterwards inherit the mask, which
+ * is how OpenCV's worker threads follow the thread that first runs a
+ * parallel region. Memory the thread touches first is placed on its NUMA
+ * node, so buffers allocated and filled after pinning are node-local.
+ *
+ * @return bool - True if pinned, or if @p cpus is empty (nothing to do);
+ *         false if the system refused or does not support pinning.
+ */
+bool pinCurrentThread(const CpuList& cpus);
+
+/**
+ * @brief Where the pipeline's threads run; empty lists are not pinned.
+ */
+struct AffinityConfig {
+    CpuList capture;     ///< Capture stage (the Camera or the set matcher).
+    /// One list per detector instance, the last repeating. A single
+    /// instance runs on the inference stage thread, which uses the first.
+    std::vector<CpuList> inference;
+    CpuList projection;  ///< Projection stage.
+    /// The thread calling Pipeline::run(), once the other stages have
+    /// started; its previous mask is restored when run() returns.
+    CpuList output;
+};
+
+/**
+ * @brief One inference configuration tried by the placement sweep.
+ */
+struct Placement {
+    std::string name;   ///< "unpinned", "compact" or "spread".
+    int instances = 1;  ///< Network instances.
+    /// OpenCV threads per forward pass; 0 keeps OpenCV's default.
+    int threads = 1;
+    /// CPUs per instance, as for AffinityConfig::inference.
+    std::vector<CpuList> cpus;
+};
+
+/**
+ * @brief Lists the placements worth measuring on a machine.
+ *
+ * Instance and thread counts go up in powers of two as long as
+ * instances x threads fits @p cpus. Each combination is tried unpinned,
+ * "compact" (instances on consecutive CPUs of the lowest nodes) and, with
+ * more than one node, "spread" (instances dealt round-robin to the nodes,
+ * each instance within one node). A single unpinned instance with OpenCV's
+ * default thread count comes first as the baseline.
+ *
+ * @param cpus CPUs available, e.g. allowedCpus().
+ * @param nodes CPUs of every NUMA node, e.g. from numaNodeCpus().
+ * @param maxInstances Upper bound on instances, 0 for no bound.
+ */
+std::vector<Placement> placementSweep(const CpuList& cpus,
+                                      const std::vector<CpuList>& nodes,
+                                      int maxInstances = 0);
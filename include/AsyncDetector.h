@@ -0,0 +1,150 @@
+// Copyright 2026 Sai Surya Sriramoju
+
+/**
+ * @file AsyncDetector.h
+ * @brief Declaration of the AsyncDetector class running several YOLO instances.
+ * @author Sai Surya Sriramoju
+ * @date 10/17/2026
+ */
+
+#pragma once
+
+#include <atomic>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <opencv2/opencv.hpp>
+
+#include "Affinity.h"
+#include "BoundedQueue.h"
+#include "Detections.h"
+#include "YOLO.h"
+
+/**
+ * @brief Tunables for AsyncDetector.
+ */
+struct AsyncConfig {
+    int instances = 2;  ///< Network instances, each with its own thread.
+    /// OpenCV worker threads for each forward pass; 0 keeps OpenCV's default.
+    /// OpenCV's thread pool is process-wide and serves one parallel region at
+    /// a time, so with several instances 1 (one core per instance) scales
+    /// best. This calls cv::setNumThreads() and so affects the whole process.
+    int threadsPerInstance = 1;
+    /// CPUs of each instance's thread, the last list repeating; empty lists
+    /// leave the threads unpinned. OpenCV's workers follow the mask of the
+    /// thread that starts them, see pinCurrentThread().
+    std::vector<CpuList> cpus;
+    /// Requests queued before submit() blocks; 0 means twice the instances.
+    size_t maxPending = 0;
+    /// Warm up the instances created here (see YOLO::warmUp()) in parallel
+    /// before they take requests.
+    bool warmUp = true;
+    /// Input sizes to warm them up at besides the current one, e.g. those a
+    /// latency budget may switch to; pass what the prototype was warmed at.
+    std::vector<int> warmSizes;
+};
+
+/**
+ * @class AsyncDetector
+ * @brief Runs independent forward passes on several network instances.
+ *
+ * A single forward pass does not scale linearly with OpenCV's internal
+ * threading on many-core machines; several single-threaded passes in
+ * parallel use the cores far better. submit() queues a frame and returns a
+ * future; a free instance picks it up. Frames handled by different
+ * instances may finish out of order, so wait on the futures in the order
+ * you need the results.
+ */
+class AsyncDetector {
+ public:
+    /**
+     * @brief Creates @p config.instances detectors like @p prototype.
+     *
+     * The prototype becomes the first instance; the others load the same
+     * model with the same preprocessing, decoding (including a pending
+     * YOLO::setNMSConfig()) and input size. The
+     * prototype must outlive this object and must not run inference itself
+     * while it exists.
+     *
+     * @throws std::invalid_argument if @p config.instances is not positive.
+     * @throws std::runtime_error if a model instance cannot be loaded.
+     */
+    AsyncDetector(YOLO& prototype, const AsyncConfig& config = AsyncConfig());
+
+    /**
+     * @brief Finishes the queued requests and joins the worker threads.
+     */
+    ~AsyncDetector();
+
+    AsyncDetector(const AsyncDetector&) = delete;
+    AsyncDetector& operator=(const AsyncDetector&) = delete;
+
+    /**
+     * @brief Queues @p frame for detection; blocks while the queue is full.
+     *
+     * Only the cv::Mat header is queued, so the pixels must stay untouched
+     * until the future is ready.
+     *
+     * @param frame The BGR frame, or a region of one.
+     * @param tiling Tile grid to detect on, see YOLO::inferTiled(); the
+     *        default runs on the whole frame at once.
+     * @return std::future<Detections> - The detections in @p frame pixels,
+     *         or the exception the detector threw.
+     * @throws std::runtime_error after shutdown().
+     */
+    std::future<Detections> submit(const cv::Mat& frame,
+                                   const TilingConfig& tiling = TilingConfig());
+
+    /**
+     * @brief Changes the input size of every instance from its next frame.
+     */
+    void setInputSize(int size);
+
+    /**
+     * @brief Changes the NMS settings of every instance from its next frame;
+     *        safe while requests run, see YOLO::setNMSConfig().
+     */
+    void setNMSConfig(const NMSConfig& config);
+
+    /**
+     * @brief Returns the number of network instances.
+     */
+    size_t instances() const { return detectors.size(); }
+
+    /**
+     * @brief Returns the number of requests queued or running.
+     */
+    size_t pending() const { return inFlight.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Stops accepting requests; queued ones still complete.
+     */
+    void shutdown();
+
+ private:
+    /**
+     * @brief A queued frame and the promise for its detections.
+     */
+    struct Request {
+        cv::Mat frame;
+        TilingConfig tiling;
+        std::promise<Detections> result;
+    };
+
+    /**
+     * @brief Worker loop of instance @p index.
+     */
+    void work(size_t index, bool warmUp, CpuList cpus);
+
+    std::vector<std::unique_ptr<YOLO>> owned;  ///< Instances created here.
+    std::vector<YOLO*> detectors;              ///< All instances.
+    std::vector<int> warmSizes;                ///< See AsyncConfig::warmSizes.
+    /// Keeps concurrent setInputSize()/setNMSConfig() calls from leaving the
+    /// instances with different settings.
+    std::mutex settingsGuard;
+    BoundedQueue<Request> requests;            ///< Frames waiting for a worker.
+    std::atomic<size_t> inFlight{0};           ///< Queued or running requests.
+    std::vector<std::thread> workers;          ///< One thread per instance.
+};
@@ -0,0 +1,200 @@
+// Copyright 2026 Sai Surya Sriramoju
+
+/**
+ * @file BatchProcessor.h
+ * @brief Declaration of the BatchProcessor class for offline footage.
+ * @author Sai Surya Sriramoju
+ * @date 10/17/2026
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <future>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#include <opencv2/opencv.hpp>
+
+#include "AsyncDetector.h"
+#include "BoundedQueue.h"
+#include "CaptureManager.h"
+#include "CoordToWorld.h"
+#include "DetectionStream.h"
+#include "YOLO.h"
+
+/**
+ * @brief Tunables for BatchProcessor.
+ */
+struct BatchConfig {
+    int decoders = 0;  ///< Decode threads; 0 for one per core.
+    /// Videos with at least twice this many frames are split into chunks
+    /// that separate decoders seek to and decode concurrently.
+    int minChunkFrames = 500;
+    size_t queueCapacity = 32;  ///< Decoded frames waiting for a detector.
+    AsyncConfig detectors;      ///< Network instances running in parallel.
+    /// Tile grid per input, as PipelineConfig::tiling per source.
+    std::vector<TilingConfig> tiling;
+    std::string outputDir = ".";  ///< Where the detection files are written.
+    /// Interval between progress reports; zero disables them.
+    std::chrono::milliseconds reportInterval{5000};
+    std::ostream* log = &std::cout;  ///< Progress output; nullptr silences it.
+};
+
+/**
+ * @brief What a batch run did.
+ */
+struct BatchSummary {
+    uint64_t frames = 0;       ///< Frames decoded and detected.
+    uint64_t detections = 0;   ///< Detections written.
+    size_t failedInputs = 0;   ///< Inputs that could not be opened.
+    double seconds = 0.0;      ///< Wall-clock time of the run.
+    std::vector<std::string> outputs;  ///< Detection file of every input.
+
+    /**
+     * @brief Returns the overall throughput in frames per second.
+     */
+    double fps() const { return seconds > 0.0 ? frames / seconds : 0.0; }
+};
+
+/**
+ * @class BatchProcessor
+ * @brief Runs the detector over recorded video files and image directories
+ *        as fast as the machine allows.
+ *
+ * Unlike Pipeline, nothing here is paced by a camera: decode threads work
+ * through the inputs (long videos are split into chunks that are decoded
+ * in parallel) and never drop a frame, an AsyncDetector keeps several
+ * network instances busy, and the detections of every input are written
+ * to "<outputDir>/<input name>.dets" in the DetectionStream format, in
+ * frame order, with the frame index as the sequence number and the video
+ * position as the timestamp.
+ */
+class BatchProcessor {
+ public:
+    /**
+     * @brief Creates the processor.
+     *
+     * @param yolo Configured detector; replicated for the extra instances.
+     * @param world Calibration used for the world coordinates.
+     * @param config Decode, detector and output tunables.
+     */
+    BatchProcessor(YOLO& yolo, const CoordToWorld& world,
+                   const BatchConfig& config = BatchConfig());
+
+    /**
+     * @brief Processes every input and returns when all are written.
+     *
+     * @param inputs Video files and image directories.
+     * @return BatchSummary - Frame counts, throughput and output files.
+     * @throws std::invalid_argument if an input is a camera.
+     * @throws std::runtime_error if an output file cannot be written.
+     */
+    BatchSummary run(const std::vector<SourceSpec>& inputs);
+
+    /**
+     * @brief Returns the frames detected so far by run().
+     */
+    uint64_t framesDone() const { return done.load(std::memory_order_relaxed); }
+
+ private:
+    /**
+     * @brief A contiguous range of frames of one input, decoded by one thread.
+     */
+    struct Chunk {
+        size_t input = 0;    ///< Index into the inputs.
+        int64_t begin = 0;   ///< First frame (or file) index.
+        int64_t end = -1;    ///< One past the last; -1 for "until the end".
+    };
+
+    /**
+     * @brief A decoded frame on its way to the detector, or, without an
+     *        image, frames of the input that will never come.
+     */
+    struct DecodedFrame {
+        size_t input = 0;       ///< Index into the inputs.
+        uint64_t index = 0;     ///< Frame or file index within the input.
+        double positionMs = 0;  ///< Video position, 0 for images.
+        cv::Mat image;          ///< The decoded frame.
+        /// Without @p image: frames [index, index + skipped) failed to
+        /// decode and are not written.
+        uint64_t skipped = 0;
+    };
+
+    /**
+     * @brief A frame whose detections are being computed.
+     */
+    struct InFlight {
+        size_t input = 0;                ///< Index into the inputs.
+        uint64_t index = 0;              ///< Frame index within the input.
+        double positionMs = 0;           ///< Video position.
+        std::future<Detections> result;  ///< Detections once ready.
+    };
+
+    /**
+     * @brief Output file of one input and the frames waiting to be written.
+     */
+    struct Output {
+        std::unique_ptr<DetectionStreamWriter> writer;  ///< The .dets file.
+        uint64_t next = 0;  ///< Index of the frame to write next.
+        /// Finished frames ahead of @p next, by frame index.
+        std::map<uint64_t, std::pair<StreamFrameHeader,
+                                     std::vector<StreamRecord>>> held;
+        /// Frames that failed to decode, as first index -> one past the last;
+        /// drain() steps over them.
+        std::map<uint64_t, uint64_t> skipped;
+    };
+
+    /**
+     * @brief Splits the inputs into chunks for the decode threads.
+     *
+     * Lists the files of image directories into @p files. Inputs that cannot
+     * be opened get no chunk and are counted in @p summary.
+     */
+    std::vector<Chunk> planChunks(const std::vector<SourceSpec>& inputs,
+                                  int decoders, BatchSummary& summary);
+
+    /**
+     * @brief Decode thread: decodes chunks until none are left.
+     */
+    void decodeLoop(const std::vector<SourceSpec>& inputs,
+                    const std::vector<Chunk>& chunks);
+
+    /**
+     * @brief Waits for the oldest in-flight frame and hands it to its output.
+     */
+    void complete(InFlight& frame, BatchSummary& summary);
+
+    /**
+     * @brief Records frames of an input that failed to decode, so that the
+     *        frames after them are not held forever.
+     */
+    void skip(const DecodedFrame& frame);
+
+    /**
+     * @brief Writes the held frames of @p output that are next in order,
+     *        stepping over skipped ones.
+     *
+     * @param flush Write everything held, skipping gaps (input finished).
+     */
+    void drain(Output& output, bool flush);
+
+    YOLO& yolo;                  ///< Prototype detector.
+    WorldProjector projector;    ///< Pixel to world projection.
+    BatchConfig config;          ///< Tunables.
+    /// Image file lists of ImageDirectory inputs, by input index.
+    std::vector<std::vector<std::string>> files;
+    std::vector<Output> outputs;              ///< One per input.
+    std::unique_ptr<BoundedQueue<DecodedFrame>> decoded;  ///< To the detector.
+    std::atomic<size_t> nextChunk{0};         ///< Next chunk to decode.
+    std::atomic<int> activeDecoders{0};       ///< Closes @p decoded at zero.
+    std::atomic<uint64_t> done{0};            ///< Frames detected.
+    std::vector<double> pixels;               ///< Reused (u, v) pairs.
+    std::vector<double> worldCoords;          ///< Reused (x, y, z) triples.
+    std::vector<StreamRecord> records;        ///< Reused records.
+};
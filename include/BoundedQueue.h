@@ -0,0 +1,144 @@
+// Copyright 2026 Sai Surya Sriramoju
+
+/**
+ * @file BoundedQueue.h
+ * @brief Declaration of the BoundedQueue class used between pipeline stages.
+ * @author Sai Surya Sriramoju
+ * @date 10/17/2026
+ */
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <utility>
+
+/**
+ * @brief Behaviour of BoundedQueue::push when the queue is full.
+ */
+enum class OverflowPolicy {
+    Block,      ///< Wait until a consumer makes room.
+    DropOldest  ///< Discard the oldest queued item to make room.
+};
+
+/**
+ * @class BoundedQueue
+ * @brief Fixed-capacity, thread-safe FIFO connecting two pipeline stages.
+ *
+ * With OverflowPolicy::DropOldest a slow consumer never stalls its producer;
+ * stale items are discarded instead, which keeps end-to-end latency bounded.
+ *
+ * @tparam T Item type, moved in and out of the queue.
+ */
+template <typename T>
+class BoundedQueue {
+ public:
+    /**
+     * @brief Creates a queue holding at most @p capacity items.
+     * @param capacity Maximum number of queued items (at least 1).
+     * @param policy What push() does when the queue is full.
+     */
+    explicit BoundedQueue(size_t capacity,
+                          OverflowPolicy policy = OverflowPolicy::DropOldest)
+        : maxItems(capacity == 0 ? 1 : capacity), policy(policy) {}
+
+    /**
+     * @brief Pushes an item, blocking or dropping according to the policy.
+     * @param item The item to enqueue.
+     * @return bool - False if the queue was closed before the item was queued.
+     */
+    bool push(T item) {
+        std::unique_lock<std::mutex> lock(guard);
+        if (policy == OverflowPolicy::Block) {
+            notFull.wait(lock, [this] {
+                return closed || items.size() < maxItems;
+            });
+        }
+        if (closed) {
+            return false;
+        }
+        if (items.size() >= maxItems) {
+            items.pop_front();
+            ++droppedCount;
+        }
+        items.push_back(std::move(item));
+        lock.unlock();
+        notEmpty.notify_one();
+        return true;
+    }
+
+    /**
+     * @brief Pops the oldest item, waiting up to @p timeout for one to arrive.
+     * @param item Receives the popped item.
+     * @param timeout Maximum time to wait.
+     * @return bool - False on timeout or when the queue is closed and drained.
+     */
+    template <typename Rep, typename Period>
+    bool pop(T& item, const std::chrono::duration<Rep, Period>& timeout) {
+        std::unique_lock<std::mutex> lock(guard);
+        if (!notEmpty.wait_for(lock, timeout, [this] {
+                return closed || !items.empty();
+            }) || items.empty()) {
+            return false;
+        }
+        item = std::move(items.front());
+        items.pop_front();
+        lock.unlock();
+        notFull.notify_one();
+        return true;
+    }
+
+    /**
+     * @brief Closes the queue, waking every blocked producer and consumer.
+     */
+    void close() {
+        {
+            std::lock_guard<std::mutex> lock(guard);
+            closed = true;
+        }
+        notEmpty.notify_all();
+        notFull.notify_all();
+    }
+
+    /**
+     * @brief Returns the number of queued items.
+     */
+    size_t size() const {
+        std::lock_guard<std::mutex> lock(guard);
+        return items.size();
+    }
+
+    /**
+     * @brief Returns true once the queue is closed and every item was popped.
+     */
+    bool drained() const {
+        std::lock_guard<std::mutex> lock(guard);
+        return closed && items.empty();
+    }
+
+    /**
+     * @brief Returns how many items have been discarded by DropOldest.
+     */
+    size_t dropped() const {
+        std::lock_guard<std::mutex> lock(guard);
+        return droppedCount;
+    }
+
+    /**
+     * @brief Returns the maximum number of queued items.
+     */
+    size_t capacity() const { return maxItems; }
+
+ private:
+    const size_t maxItems;             ///< Maximum number of queued items.
+    const OverflowPolicy policy;       ///< Behaviour when full.
+    mutable std::mutex guard;          ///< Guards every member below.
+    std::condition_variable notEmpty;  ///< Signalled after a push.
+    std::condition_variable notFull;   ///< Signalled after a pop.
+    std::deque<T> items;               ///< Queued items, oldest first.
+    size_t droppedCount = 0;           ///< Items discarded by DropOldest.
+    bool closed = false;               ///< Set once close() is called.
+};
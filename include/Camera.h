@@ -9,6 +9,7 @@
 
 #pragma once
 
+#include <string>
 #include <opencv2/opencv.hpp>
 
 /**
@@ -23,10 +24,83 @@ class Camera {
     /**
      * @brief Default constructor for the Camera class.
      * 
-     * Initializes the camera. If the camera fails to open, an error message is displayed.
+     * Opens the default camera (index 0).
+     * 
+     * @throws std::runtime_error if the camera cannot be opened.
      */
     Camera();
 
+    /**
+     * @brief Opens the camera device with the given index.
+     * 
+     * @param index Device index as understood by cv::VideoCapture.
+     * @throws std::runtime_error if the device cannot be opened.
+     */
+    explicit Camera(int index);
+
+    /**
+     * @brief Opens a video file, image sequence pattern or stream URL.
+     * 
+     * @param uri Anything cv::VideoCapture::open accepts as a file name.
+     * @throws std::runtime_error if the source cannot be opened.
+     */
+    explicit Camera(const std::string& uri);
+
+    /**
+     * @brief Returns true while the underlying capture is open.
+     */
+    bool isOpened() const;
+
+    /**
+     * @brief Latches the next frame without decoding it.
+     * 
+     * Splitting grab() from retrieve() keeps the moment a frame is taken
+     * close to the grab call, which matters when several cameras are
+     * synchronised.
+     * 
+     * @return bool - False if no frame could be grabbed.
+     */
+    bool grab();
+
+    /**
+     * @brief Decodes the frame latched by the last grab().
+     * 
+     * @param frame Receives the decoded frame; its buffer is reused.
+     * @return bool - False if there was nothing to decode.
+     */
+    bool retrieve(cv::Mat& frame);
+
+    /**
+     * @brief Grabs MJPEG from the device and decodes it at a reduced scale.
+     * 
+     * The device is asked for MJPEG and the backend for the compressed
+     * payload instead of a BGR frame. retrieve() and read() then decode
+     * each payload at 1/2, 1/4 or 1/8 scale, the smallest whose long side
+     * stays at or above @p decodeSide, and keep the payload in encoded()
+     * for a full-resolution decode on demand. Devices or backends that
+     * still deliver BGR frames are read as before.
+     * 
+     * @param decodeSide Long side to decode to, e.g. the network input
+     *        size; 0 turns compressed capture off.
+     * @return bool - False if the backend refused to hand over payloads.
+     */
+    bool setCompressedCapture(int decodeSide);
+
+    /**
+     * @brief Returns full-resolution pixels per pixel of the last frame;
+     *        above 1 after a reduced decode.
+     */
+    double scale() const { return frameScale; }
+
+    /**
+     * @brief Returns the compressed payload of the last frame, empty unless
+     *        it was decoded from MJPEG.
+     * 
+     * Every frame gets a new buffer, so the payload can be kept, e.g. to
+     * record it without re-encoding.
+     */
+    const cv::Mat& encoded() const { return payload; }
+
     /**
      * @brief Captures an image from the camera.
      * 
@@ -36,15 +110,26 @@ class Camera {
      */
     cv::Mat captureImage();
 
+    /**
+     * @brief Decodes the next frame into @p frame, reusing its buffer.
+     * 
+     * Used with a FramePool buffer this decodes without any allocation.
+     * 
+     * @param frame Destination; reallocated only if the frame size changed.
+     * @return bool - False if no frame could be read.
+     */
+    bool read(cv::Mat& frame);
+
     /**
      * @brief Releases the camera.
      * 
      * This method releases the camera, freeing up any resources associated with it.
      */
-
-
     void release();
 
  private:
     cv::VideoCapture cap;  ///< Video capture object for accessing the camera.
+    int decodeSide = 0;        ///< Reduced decode target, 0 for BGR frames.
+    cv::Mat payload;           ///< MJPEG payload of the last frame.
+    double frameScale = 1.0;   ///< Full-resolution pixels per frame pixel.
 };
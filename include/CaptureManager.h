@@ -0,0 +1,301 @@
+// Copyright 2026 Sai Surya Sriramoju
+
+/**
+ * @file CaptureManager.h
+ * @brief Declaration of the CaptureManager class for multi-camera capture.
+ * @author Sai Surya Sriramoju
+ * @date 10/17/2026
+ */
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <opencv2/opencv.hpp>
+
+#include "Affinity.h"
+#include "FramePool.h"
+
+/**
+ * @brief Kind of frame source a CaptureManager reads from.
+ */
+enum class SourceKind {
+    Device,          ///< A camera, opened by index.
+    Video,           ///< A video file, image sequence pattern or stream URL.
+    ImageDirectory,  ///< A directory of images, read in file name order.
+    Recording        ///< One source of a recording made with --record.
+};
+
+/**
+ * @brief Where one source of a CaptureManager gets its frames.
+ */
+struct SourceSpec {
+    SourceKind kind = SourceKind::Device;  ///< How to open the source.
+    int device = 0;                        ///< Device index for Device.
+    std::string path;                      ///< File, URL or directory.
+    bool loop = false;  ///< Restart file sources at the end.
+    int stream = 0;     ///< Source index inside a Recording.
+    /// Replay a Recording at its recorded pace instead of as fast as the
+    /// consumer takes frames.
+    bool realtime = true;
+    /// Decode JPEG frames (MJPEG from a Device, JPEG files of an
+    /// ImageDirectory or Recording) at 1/2, 1/4 or 1/8 scale, keeping the
+    /// long side at or above this; 0 decodes in full. See decodeReduced().
+    int decodeSide = 0;
+    /// CPUs the grab thread runs on, empty for anywhere. Decoded frames are
+    /// first written there and so live in the memory of its NUMA node.
+    CpuList cpus;
+
+    /**
+     * @brief Builds a spec from text: a number is a device, an existing
+     *        directory an image directory, "<file>.prec" or
+     *        "<file>.prec#<stream>" a recording and anything else a video.
+     *
+     * @throws std::invalid_argument if a recording stream is not a number.
+     */
+    static SourceSpec parse(const std::string& uri);
+
+    /**
+     * @brief Human readable name used in logs and errors.
+     */
+    std::string name() const;
+};
+
+/**
+ * @brief Life cycle of a single source.
+ */
+enum class SourceState {
+    Opening,   ///< Not opened yet, or reopening after an error.
+    Running,   ///< Delivering frames.
+    Finished,  ///< Reached the end of a file source.
+    Failed     ///< Could not be opened or read; will not recover.
+};
+
+/**
+ * @brief One captured frame and when it was grabbed.
+ */
+struct TimedFrame {
+    cv::Mat image;  ///< Decoded frame; empty if the source had nothing.
+    /// Pooled buffer @p image points into; keeps it from being recycled.
+    FrameHandle buffer;
+    std::chrono::steady_clock::time_point timestamp;  ///< Time of grab().
+    uint64_t index = 0;  ///< Frame number within its source.
+    /// Full-resolution pixels per image pixel; above 1 after a reduced decode.
+    double scale = 1.0;
+    /// The JPEG @p image was decoded from, when kept for a full-resolution
+    /// decode on demand; empty otherwise.
+    cv::Mat encoded;
+};
+
+/**
+ * @brief Frames of every source captured at (about) the same time.
+ */
+struct FrameSet {
+    uint64_t sequence = 0;  ///< Set number, counting from 0.
+    /// Reference time the frames were matched against.
+    std::chrono::steady_clock::time_point timestamp;
+    /// One entry per source in construction order; the image is empty for
+    /// sources that had failed, finished or no frame within tolerance.
+    std::vector<TimedFrame> frames;
+
+    /**
+     * @brief Returns true if every source contributed a frame.
+     */
+    bool complete() const;
+};
+
+/**
+ * @brief How CaptureManager matches frames of different sources.
+ */
+enum class SyncMode {
+    Timestamp,  ///< Frames whose grab times lie within the tolerance.
+    Index       ///< The n-th frame of every source; lockstep for files.
+};
+
+/**
+ * @brief Tunables for CaptureManager.
+ */
+struct CaptureConfig {
+    SyncMode sync = SyncMode::Timestamp;  ///< Frame matching strategy.
+    /// Largest grab time difference between frames of one set.
+    std::chrono::milliseconds tolerance{20};
+    size_t bufferDepth = 4;  ///< Frames buffered per source.
+    /// Let grab threads overwrite the oldest buffered frame instead of
+    /// waiting for the consumer. Right for live cameras, wrong for files.
+    bool dropOldest = true;
+    int maxReopenAttempts = 3;  ///< Reopens after a read error before Failed.
+    std::chrono::milliseconds reopenDelay{500};  ///< Pause before a reopen.
+};
+
+/**
+ * @class CaptureManager
+ * @brief Captures from several sources on their own threads and emits
+ *        time-synchronised frame sets.
+ *
+ * Every source gets a grab thread that calls grab(), takes the timestamp,
+ * then retrieve()s and buffers the frame, so a slow decode on one camera
+ * does not delay the others. nextSet() matches the buffered frames into
+ * sets. A source that cannot be opened or keeps failing is marked Failed
+ * and simply leaves a gap in the sets; it never stops the other sources.
+ *
+ * Every source decodes into a FramePool of its own, whose buffers are first
+ * written on its grab thread (and so on that thread's NUMA node when it is
+ * pinned). The manager must outlive the frames it handed out.
+ */
+class CaptureManager {
+ public:
+    /**
+     * @brief Creates the manager; no source is opened until start().
+     *
+     * @param sources Sources in the order their frames appear in a FrameSet.
+     * @param config Synchronisation and buffering tunables.
+     * @throws std::invalid_argument if @p sources is empty.
+     */
+    explicit CaptureManager(const std::vector<SourceSpec>& sources,
+                            const CaptureConfig& config = CaptureConfig());
+
+    /**
+     * @brief Stops and joins the grab threads.
+     */
+    ~CaptureManager();
+
+    CaptureManager(const CaptureManager&) = delete;
+    CaptureManager& operator=(const CaptureManager&) = delete;
+
+    /**
+     * @brief Creates the frame pools and starts one grab thread per source.
+     *
+     * @param framesHeld Frames of each source the consumer may keep besides
+     *        the last set, e.g. in its queues. A source whose buffers are all
+     *        taken waits for one to come back.
+     */
+    void start(size_t framesHeld = 0);
+
+    /**
+     * @brief Stops the grab threads and wakes any waiting consumer.
+     */
+    void stop();
+
+    /**
+     * @brief Waits for the next synchronised frame set.
+     *
+     * @param set Receives the frames; its buffers are reused.
+     * @param timeout How long to wait for the live sources.
+     * @return bool - False on timeout, after stop(), or once every source
+     *         has ended and no buffered frame is left.
+     */
+    bool nextSet(FrameSet& set, std::chrono::milliseconds timeout);
+
+    /**
+     * @brief Returns true once every source ended and all frames were taken.
+     */
+    bool finished() const;
+
+    /**
+     * @brief Returns the number of sources.
+     */
+    size_t sourceCount() const { return sources.size(); }
+
+    /**
+     * @brief Returns the current state of source @p i.
+     */
+    SourceState state(size_t i) const;
+
+    /**
+     * @brief Returns the last error of source @p i, empty if none.
+     */
+    std::string lastError(size_t i) const;
+
+    /**
+     * @brief Returns how many frames source @p i has dropped.
+     */
+    uint64_t dropped(size_t i) const;
+
+ private:
+    /**
+     * @brief Per-source capture state, guarded by CaptureManager::guard.
+     */
+    struct Source {
+        SourceSpec spec;                 ///< Where frames come from.
+        SourceState state = SourceState::Opening;  ///< Life cycle.
+        std::string error;               ///< Last error message.
+        std::deque<TimedFrame> frames;   ///< Grabbed, not yet consumed.
+        uint64_t grabbed = 0;            ///< Frames grabbed so far.
+        uint64_t droppedFrames = 0;      ///< Frames overwritten unconsumed.
+        std::unique_ptr<FramePool> pool;  ///< Buffers; created by start().
+    };
+
+    /**
+     * @brief Grab thread body for source @p i.
+     */
+    void grabLoop(size_t i);
+
+    /**
+     * @brief Takes a buffer of source @p i, waiting for one if all are in use.
+     * @return bool - False if the manager is stopping.
+     */
+    bool acquireBuffer(size_t i, FrameHandle& buffer);
+
+    /**
+     * @brief Buffers one frame of source @p i, waiting or dropping when full.
+     * @return bool - False if the manager is stopping.
+     */
+    bool deliver(size_t i, TimedFrame& frame);
+
+    /**
+     * @brief Moves source @p i to @p state, recording @p error if not empty.
+     */
+    void setState(size_t i, SourceState state, const std::string& error = "");
+
+    /**
+     * @brief Sleeps for the reopen delay unless stop() is called.
+     * @return bool - False if the manager is stopping.
+     */
+    bool waitBeforeReopen();
+
+    /**
+     * @brief Sleeps until @p until unless stop() is called.
+     * @return bool - False if the manager is stopping.
+     */
+    bool sleepUntil(std::chrono::steady_clock::time_point until);
+
+    /**
+     * @brief Tries to build a set from the buffered frames; needs the lock.
+     *
+     * @param set Receives the frames.
+     * @param force Build a partial set instead of waiting for live sources.
+     * @return bool - True if @p set was filled.
+     */
+    bool trySet(FrameSet& set, bool force);
+
+    /**
+     * @brief Moves the head frame of source @p i into @p out; needs the lock.
+     */
+    void take(size_t i, TimedFrame& out);
+
+    /**
+     * @brief Returns true if source @p i may still produce frames.
+     */
+    bool live(size_t i) const;
+
+    /**
+     * @brief finished() for callers that hold the lock.
+     */
+    bool finishedLocked() const;
+
+    CaptureConfig config;                          ///< Tunables.
+    std::vector<std::unique_ptr<Source>> sources;  ///< One per source.
+    mutable std::mutex guard;              ///< Protects all source state.
+    std::condition_variable frameReady;    ///< A frame or end was posted.
+    std::condition_variable spaceReady;    ///< A buffered frame was taken.
+    std::vector<std::thread> grabbers;     ///< One grab thread per source.
+    uint64_t setCount = 0;                 ///< Sets emitted so far.
+    bool stopping = false;                 ///< Set by stop().
+};
@@ -21,6 +21,11 @@
 using Eigen::MatrixXf;
 using cv::Mat;
 
+/**
+ * @brief 3x4 camera projection matrix in double precision.
+ */
+using ProjectionMatrix = Eigen::Matrix<double, 3, 4>;
+
 /**
  * @brief Class for converting pixel coordinates to world coordinates.
  *
@@ -47,16 +52,26 @@ public:
      */
     MatrixXf transMat();
 
+    /**
+     * @brief Computes the projection matrix in double precision.
+     *
+     * Same matrix as transMat(), in the type WorldProjector works with.
+     *
+     * @return ProjectionMatrix - The computed projection matrix.
+     */
+    ProjectionMatrix projection() const;
+
     /**
      * @brief Computes world coordinates from pixel coordinates.
      *
      * This method takes a projection matrix and a vector of pixel coordinates, and computes the corresponding world coordinates.
+     * It inverts @p T on every call; use WorldProjector when projecting repeatedly with the same calibration.
      *
      * @param T - The projection matrix.
      * @param coorValues - A vector of pixel coordinates.
      * @return std::vector<double> - A vector of computed world coordinates in XYZ format.
      */
-    std::vector<double> worldPoints(MatrixXf T, std::vector<double> coorValues);
+    std::vector<double> worldPoints(const MatrixXf& T, const std::vector<double>& coorValues);
 
 private:
     /**
@@ -64,3 +79,55 @@ private:
      */
     static double focalLen;
 };
+
+/**
+ * @brief Back-projects batches of pixels with a cached pseudo-inverse.
+ *
+ * The pseudo-inverse of the projection matrix is computed once per
+ * calibration. A batch of N (u, v) pixels is then mapped with a single
+ * 4x3 by 3xN matrix product followed by the homogeneous division, writing
+ * into buffers that are only reallocated when a larger batch arrives.
+ * Everything is in double precision, like the pixel and world vectors.
+ */
+class WorldProjector {
+public:
+    /**
+     * @brief Creates a projector for the given calibration.
+     *
+     * @param projection - The 3x4 camera projection matrix.
+     */
+    explicit WorldProjector(const ProjectionMatrix& projection);
+
+    /**
+     * @brief Replaces the calibration and recomputes the pseudo-inverse.
+     *
+     * @param projection - The new 3x4 camera projection matrix.
+     */
+    void setProjection(const ProjectionMatrix& projection);
+
+    /**
+     * @brief Returns the cached 4x3 pseudo-inverse.
+     */
+    const Eigen::Matrix<double, 4, 3>& pseudoInverse() const { return inverse; }
+
+    /**
+     * @brief Projects (u, v) pixel pairs to (x, y, z) world triples.
+     *
+     * @param pixels - Pixel coordinates as u0, v0, u1, v1, ...
+     * @param world - Receives x0, y0, z0, x1, ...; its capacity is reused.
+     */
+    void project(const std::vector<double>& pixels, std::vector<double>& world);
+
+    /**
+     * @brief Projects @p count pixels from @p pixels into @p world.
+     *
+     * @param pixels - 2 x count values, (u, v) interleaved.
+     * @param count - Number of pixels.
+     * @param world - Room for 3 x count values, (x, y, z) interleaved.
+     */
+    void project(const double* pixels, size_t count, double* world);
+
+private:
+    Eigen::Matrix<double, 4, 3> inverse;  ///< Cached pseudo-inverse.
+    std::vector<double> homogeneous;      ///< Reused 4 x N product.
+};
@@ -0,0 +1,322 @@
+// Copyright 2026 Sai Surya Sriramoju
+
+/**
+ * @file DeadlineScheduler.h
+ * @brief Declaration of the DeadlineScheduler class that shares the
+ *        inference budget between camera streams.
+ * @author Sai Surya Sriramoju
+ * @date 10/17/2026
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Rate and priority of one stream.
+ */
+struct StreamPolicy {
+    double targetFps = 10.0;  ///< Inferences per second the stream should get.
+    double priority = 1.0;    ///< Weight against other streams, above 0.
+};
+
+/**
+ * @brief Tunables for DeadlineScheduler.
+ */
+struct SchedulerConfig {
+    /// Policy per stream index; streams past the end use the last entry, an
+    /// empty list the StreamPolicy defaults.
+    std::vector<StreamPolicy> streams;
+    /// Weight multiplier for a stream with recent detections or motion.
+    double activityBoost = 2.0;
+    /// How long markActivity() keeps a stream boosted.
+    std::chrono::milliseconds activityHold{1000};
+    /// Frames older than this are skipped instead of run, e.g. the last
+    /// frame of a stream that stopped delivering; zero keeps them. A newer
+    /// frame of the same stream replaces a pending one regardless.
+    std::chrono::milliseconds staleAfter{500};
+};
+
+/**
+ * @brief What the scheduler did for one stream.
+ */
+struct StreamStats {
+    StreamPolicy policy;      ///< Target rate and priority.
+    uint64_t offered = 0;     ///< Frames pushed.
+    uint64_t served = 0;      ///< Frames handed to the detector.
+    uint64_t skipped = 0;     ///< Frames replaced by a newer one or stale.
+    uint64_t missed = 0;      ///< Target periods that passed without a frame.
+    double achievedFps = 0.0;  ///< Served frames per second since the first.
+};
+
+/**
+ * @class DeadlineScheduler
+ * @brief Picks which camera stream gets the next inference.
+ *
+ * Each stream holds at most one pending frame: a newer frame replaces the
+ * one waiting, so under load the detector always sees the latest picture
+ * and load is shed by skipping, never by queueing. A stream is due once a
+ * period (1 / targetFps) has passed since its last frame was served, and
+ * its deadline is missed for every further period that passes. pop() serves
+ * due streams first, the one the most periods behind after weighting by
+ * priority (and activityBoost while the stream has recent detections or
+ * motion), so missed deadlines fall on the least important streams. Spare
+ * budget goes to streams that are not due yet, by the same weighting.
+ *
+ * The interface mirrors BoundedQueue so a pipeline stage can use either.
+ *
+ * @tparam T Item type, moved in and out of the scheduler.
+ */
+template <typename T>
+class DeadlineScheduler {
+ public:
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * @brief Creates a scheduler with the given stream policies.
+     */
+    explicit DeadlineScheduler(const SchedulerConfig& config = SchedulerConfig())
+        : config(config) {}
+
+    /**
+     * @brief Offers a frame of @p stream, replacing its pending frame.
+     *
+     * @param stream Index of the stream.
+     * @param item The frame.
+     * @param arrival Capture time, used for staleness.
+     * @return bool - False if the scheduler is closed.
+     */
+    bool push(size_t stream, T item, Clock::time_point arrival) {
+        {
+            std::lock_guard<std::mutex> lock(guard);
+            if (closed) {
+                return false;
+            }
+            Stream& entry = streamState(stream);
+            ++entry.stats.offered;
+            if (entry.pending) {
+                ++entry.stats.skipped;  // Never served; the newer one wins.
+            }
+            if (entry.stats.offered == 1) {
+                entry.first = arrival;
+                entry.lastServed = arrival - period(entry);  // One behind.
+            }
+            entry.item = std::move(item);
+            entry.arrival = arrival;
+            entry.pending = true;
+        }
+        ready.notify_one();
+        return true;
+    }
+
+    /**
+     * @brief Takes the frame that should be detected next, waiting up to
+     *        @p timeout for one.
+     *
+     * @param item Receives the frame.
+     * @param stream Receives its stream index.
+     * @param timeout Maximum time to wait.
+     * @return bool - False on timeout or when closed and drained.
+     */
+    template <typename Rep, typename Period>
+    bool pop(T& item, size_t& stream,
+             const std::chrono::duration<Rep, Period>& timeout) {
+        std::unique_lock<std::mutex> lock(guard);
+        const auto until = Clock::now() + timeout;
+        while (true) {
+            if (select(item, stream, Clock::now())) {
+                return true;
+            }
+            if (closed || ready.wait_until(lock, until) == std::cv_status::timeout) {
+                return select(item, stream, Clock::now());
+            }
+        }
+    }
+
+    /**
+     * @brief Takes the frame that should be detected at @p now, if any.
+     */
+    bool tryPop(T& item, size_t& stream, Clock::time_point now) {
+        std::lock_guard<std::mutex> lock(guard);
+        return select(item, stream, now);
+    }
+
+    /**
+     * @brief Boosts @p stream for SchedulerConfig::activityHold, e.g. after
+     *        it had detections or motion.
+     */
+    void markActivity(size_t stream, Clock::time_point now = Clock::now()) {
+        std::lock_guard<std::mutex> lock(guard);
+        streamState(stream).activeUntil = now + config.activityHold;
+    }
+
+    /**
+     * @brief Closes the scheduler, waking every waiting consumer.
+     */
+    void close() {
+        {
+            std::lock_guard<std::mutex> lock(guard);
+            closed = true;
+        }
+        ready.notify_all();
+    }
+
+    /**
+     * @brief Returns true once closed and every pending frame was taken.
+     */
+    bool drained() const {
+        std::lock_guard<std::mutex> lock(guard);
+        return closed && pendingCount() == 0;
+    }
+
+    /**
+     * @brief Returns the number of pending frames, at most one per stream.
+     */
+    size_t size() const {
+        std::lock_guard<std::mutex> lock(guard);
+        return pendingCount();
+    }
+
+    /**
+     * @brief Returns how many frames were skipped over all streams.
+     */
+    size_t dropped() const {
+        std::lock_guard<std::mutex> lock(guard);
+        size_t total = 0;
+        for (const Stream& entry : entries) {
+            total += static_cast<size_t>(entry.stats.skipped);
+        }
+        return total;
+    }
+
+    /**
+     * @brief Returns the statistics of every stream seen so far.
+     *
+     * @param now Time the achieved rates are computed at.
+     */
+    std::vector<StreamStats> stats(Clock::time_point now = Clock::now()) const {
+        std::lock_guard<std::mutex> lock(guard);
+        std::vector<StreamStats> all;
+        for (const Stream& entry : entries) {
+            StreamStats stats = entry.stats;
+            const double seconds =
+                std::chrono::duration<double>(now - entry.first).count();
+            stats.achievedFps = seconds > 0.0 ? stats.served / seconds : 0.0;
+            all.push_back(stats);
+        }
+        return all;
+    }
+
+ private:
+    /**
+     * @brief Scheduling state of one stream.
+     */
+    struct Stream {
+        StreamStats stats;                  ///< Counters and policy.
+        T item;                             ///< Pending frame.
+        bool pending = false;               ///< Whether @p item is set.
+        Clock::time_point arrival;          ///< Capture time of @p item.
+        Clock::time_point first;            ///< First arrival.
+        Clock::time_point lastServed;       ///< When a frame was last served.
+        Clock::time_point activeUntil;      ///< End of the activity boost.
+    };
+
+    /**
+     * @brief Returns the state of @p stream, creating it on first use.
+     */
+    Stream& streamState(size_t stream) {
+        while (entries.size() <= stream) {
+            entries.emplace_back();
+            StreamPolicy policy;
+            if (!config.streams.empty()) {
+                policy = config.streams[std::min(entries.size() - 1,
+                                                 config.streams.size() - 1)];
+            }
+            policy.targetFps = std::max(policy.targetFps, 1e-3);
+            policy.priority = std::max(policy.priority, 1e-3);
+            entries.back().stats.policy = policy;
+        }
+        return entries[stream];
+    }
+
+    /**
+     * @brief Returns the target period of @p entry.
+     */
+    static Clock::duration period(const Stream& entry) {
+        return std::chrono::duration_cast<Clock::duration>(
+            std::chrono::duration<double>(1.0 / entry.stats.policy.targetFps));
+    }
+
+    /**
+     * @brief Returns the number of pending frames; the lock must be held.
+     */
+    size_t pendingCount() const {
+        return static_cast<size_t>(std::count_if(
+            entries.begin(), entries.end(),
+            [](const Stream& entry) { return entry.pending; }));
+    }
+
+    /**
+     * @brief Drops stale frames and takes the most urgent pending one; the
+     *        lock must be held.
+     */
+    bool select(T& item, size_t& stream, Clock::time_point now) {
+        Stream* best = nullptr;
+        bool bestDue = false;
+        double bestUrgency = 0.0;
+        for (Stream& entry : entries) {
+            if (!entry.pending) {
+                continue;
+            }
+            if (config.staleAfter.count() > 0 &&
+                now - entry.arrival > config.staleAfter) {
+                entry.pending = false;
+                entry.item = T();
+                ++entry.stats.skipped;
+                continue;
+            }
+            const double periods =
+                std::chrono::duration<double>(now - entry.lastServed).count() *
+                entry.stats.policy.targetFps;
+            const bool due = entry.stats.served == 0 || periods >= 1.0;
+            const double weight = entry.stats.policy.priority *
+                (now < entry.activeUntil ? config.activityBoost : 1.0);
+            const double urgency = periods * weight;
+            if (best == nullptr || (due && !bestDue) ||
+                (due == bestDue && urgency > bestUrgency)) {
+                best = &entry;
+                bestDue = due;
+                bestUrgency = urgency;
+            }
+        }
+        if (best == nullptr) {
+            return false;
+        }
+        const double periods =
+            std::chrono::duration<double>(now - best->lastServed).count() *
+            best->stats.policy.targetFps;
+        if (best->stats.served > 0 && periods >= 2.0) {
+            best->stats.missed += static_cast<uint64_t>(periods) - 1;
+        }
+        ++best->stats.served;
+        best->lastServed = now;
+        best->pending = false;
+        item = std::move(best->item);
+        best->item = T();
+        stream = static_cast<size_t>(best - entries.data());
+        return true;
+    }
+
+    const SchedulerConfig config;      ///< Policies and tunables.
+    mutable std::mutex guard;          ///< Guards every member below.
+    std::condition_variable ready;     ///< Signalled after a push.
+    std::vector<Stream> entries;       ///< State per stream index.
+    bool closed = false;               ///< Set by close().
+};
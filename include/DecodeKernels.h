@@ -0,0 +1,64 @@
+// Copyright 2026 Sai Surya Sriramoju
+
+/**
+ * @file DecodeKernels.h
+ * @brief Declaration of the vectorised kernels used to decode YOLO outputs.
+ * @author Sai Surya Sriramoju
+ * @date 10/17/2026
+ *
+ * Each kernel has an AVX2 (x86, selected at runtime), NEON (AArch64) and a
+ * portable scalar implementation; the scalar one is exported as the reference
+ * for tests and benchmarks.
+ */
+
+#pragma once
+
+/**
+ * @brief Finds the first maximum of @p n scores.
+ *
+ * Matches cv::minMaxLoc on a 1 x n row: on ties the lowest index wins.
+ *
+ * @param scores Pointer to @p n contiguous floats, n >= 1.
+ * @param n Number of scores.
+ * @param best Receives the maximum score.
+ * @return int - Index of the first occurrence of the maximum.
+ */
+int argmaxScores(const float* scores, int n, float* best);
+
+/**
+ * @brief Portable reference implementation of argmaxScores().
+ */
+int argmaxScoresScalar(const float* scores, int n, float* best);
+
+/**
+ * @brief Computes the IoU of one box against @p n boxes stored as SoA.
+ *
+ * Boxes are given as corners (x1, y1, x2, y2) plus a precomputed area. Pairs
+ * with an empty union get an IoU of 0.
+ *
+ * @param box Corners and area of the reference box: {x1, y1, x2, y2, area}.
+ * @param x1 Left edges of the other boxes.
+ * @param y1 Top edges of the other boxes.
+ * @param x2 Right edges of the other boxes.
+ * @param y2 Bottom edges of the other boxes.
+ * @param area Areas of the other boxes.
+ * @param n Number of other boxes.
+ * @param iou Receives the @p n IoU values.
+ */
+void iouOneToMany(const float box[5], const float* x1, const float* y1,
+                  const float* x2, const float* y2, const float* area, int n,
+                  float* iou);
+
+/**
+ * @brief Portable reference implementation of iouOneToMany().
+ */
+void iouOneToManyScalar(const float box[5], const float* x1, const float* y1,
+                        const float* x2, const float* y2, const float* area,
+                        int n, float* iou);
+
+/**
+ * @brief Returns the instruction set the kernels dispatch to.
+ *
+ * @return const char* - "AVX2", "NEON" or "scalar".
+ */
+const char* decodeKernelIsa();
@@ -0,0 +1,180 @@
+// Copyright 2026 Sai Surya Sriramoju
+
+/**
+ * @file DetectionDecoder.h
+ * @brief Declaration of the DetectionDecoder class for YOLO output decoding.
+ * @author Sai Surya Sriramoju
+ * @date 10/17/2026
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <utility>
+#include <vector>
+#include <opencv2/opencv.hpp>
+
+#include "Detections.h"
+#include "Metrics.h"
+#include "NMS.h"
+#include "Preprocessor.h"
+
+/**
+ * @brief How a YOLO model lays out its output layers.
+ */
+enum class OutputLayout {
+    /// Darknet region layers: rows x (5 + classes), normalised boxes, class
+    /// scores already multiplied by objectness (YOLOv3, YOLOv3-tiny).
+    Darknet,
+    /// YOLOv5-style ONNX export: 1 x rows x (5 + classes), boxes in network
+    /// input pixels, class scores not yet multiplied by objectness.
+    YoloV5,
+    /// YOLOv8-style ONNX export: 1 x (4 + classes) x rows, boxes in network
+    /// input pixels and no objectness column.
+    YoloV8
+};
+
+/**
+ * @brief Thresholds used while decoding YOLO outputs.
+ */
+struct DecoderConfig {
+    float confThreshold = 0.5f;  ///< Minimum class score of a candidate.
+    /// Class ids to detect, e.g. {0} for COCO person; empty means all classes.
+    std::vector<int> classes;
+    NMSConfig nms;               ///< Non-maximum suppression settings.
+};
+
+/**
+ * @class DetectionDecoder
+ * @brief Turns raw YOLO output layers into NMS-filtered Detections.
+ *
+ * The decoder owns every buffer it needs (candidate arrays, the NMSEngine
+ * workspace and the result) and reuses them from frame to frame, so
+ * after the first few frames have grown them to their working size decode()
+ * performs no heap allocations.
+ *
+ * Rows are rejected on the objectness column before any class score is
+ * looked at: a class score times objectness can never exceed objectness
+ * (OpenCV's region layer stores the product, YOLOv5 exports the factors),
+ * so a row whose objectness is below the threshold can never pass. The
+ * surviving rows are reduced with the SIMD argmaxScores() kernel,
+ * restricted to the configured class columns. YOLOv8 rows have no
+ * objectness and go straight to the kernel.
+ */
+class DetectionDecoder {
+ public:
+    /**
+     * @brief Creates a decoder with room for @p capacity candidates up front.
+     */
+    explicit DetectionDecoder(const DecoderConfig& config = DecoderConfig(),
+                              size_t capacity = 1024);
+
+    /**
+     * @brief Decodes the output layers of one frame.
+     *
+     * The outputs are CV_32F in the layout set by setLayout(). Darknet
+     * outputs are rows x (5 + classes) matrices whose rows hold the
+     * normalised centre, size, objectness and objectness-weighted class
+     * scores of one anchor. YoloV5 outputs are 1 x rows x (5 + classes) with
+     * the box in network input pixels and raw class scores; YoloV8 outputs
+     * are 1 x (4 + classes) x rows, one column per anchor, with no
+     * objectness column.
+     *
+     * @param outputs The output layers of one forward pass for one frame.
+     * @param transform Maps network input pixels back onto the frame.
+     * @return const Detections& - The surviving detections in frame pixels,
+     *         valid until the next call.
+     */
+    const Detections& decode(const std::vector<cv::Mat>& outputs,
+                             const LetterboxTransform& transform);
+
+    /**
+     * @brief Decodes outputs computed on a frame stretched to the input size.
+     *
+     * @param outputs The output layers of one forward pass for one frame.
+     * @param frameSize Size of the frame the boxes are scaled to.
+     * @return const Detections& - The surviving detections.
+     */
+    const Detections& decode(const std::vector<cv::Mat>& outputs,
+                             cv::Size frameSize) {
+        return decode(outputs, LetterboxTransform::identity(frameSize));
+    }
+
+    /**
+     * @brief Returns the detections produced by the last decode() call.
+     */
+    const Detections& result() const { return detections; }
+
+    /**
+     * @brief Returns the thresholds in use.
+     */
+    const DecoderConfig& config() const { return settings; }
+
+    /**
+     * @brief Replaces the thresholds and class filter.
+     *
+     * A setNMSConfig() still pending, possibly from another thread, is kept
+     * and wins over @p config's NMS settings. Must not be called
+     * concurrently with decode().
+     */
+    void configure(const DecoderConfig& config);
+
+    /**
+     * @brief Sets the output layout of the model being decoded.
+     *
+     * Must not be called concurrently with decode().
+     */
+    void setLayout(OutputLayout layout) { outputLayout = layout; }
+
+    /**
+     * @brief Returns the output layout being decoded.
+     */
+    OutputLayout layout() const { return outputLayout; }
+
+    /**
+     * @brief Replaces the NMS settings; safe to call while decoding.
+     *
+     * The new settings take effect at the start of the next decode().
+     */
+    void setNMSConfig(const NMSConfig& config);
+
+    /**
+     * @brief Returns the NMS settings of the next decode(): the pending ones
+     *        from setNMSConfig(), if any, else those in use.
+     */
+    NMSConfig nmsConfig() const;
+
+    /**
+     * @brief Times candidate collection and NMS into the given histograms.
+     *
+     * Either may be nullptr to leave that step untimed. Must not be called
+     * concurrently with decode().
+     */
+    void setTimers(Histogram* decode, Histogram* suppression) {
+        decodeTimer = decode;
+        nmsTimer = suppression;
+    }
+
+ private:
+    /**
+     * @brief Appends every row of @p output that passes the score threshold.
+     */
+    void collectCandidates(const cv::Mat& output,
+                           const LetterboxTransform& transform);
+
+    DecoderConfig settings;         ///< Decoding thresholds.
+    OutputLayout outputLayout = OutputLayout::Darknet;  ///< Model output format.
+    cv::Mat transposed;             ///< Reused row-major copy of YoloV8 outputs.
+    /// Configured classes as sorted, merged [begin, end) column ranges.
+    std::vector<std::pair<int, int>> classRanges;
+    Detections candidates;          ///< Rows that passed the score threshold.
+    Detections detections;          ///< Candidates that survived NMS.
+    NMSEngine nms;                  ///< Suppression workspace.
+    mutable std::mutex pendingGuard;  ///< Guards pendingNms and settings.nms.
+    NMSConfig pendingNms;           ///< Settings from setNMSConfig().
+    std::atomic<bool> nmsChanged{false};  ///< Set when pendingNms is new.
+    Histogram* decodeTimer = nullptr;  ///< Candidate collection latency.
+    Histogram* nmsTimer = nullptr;     ///< NMS latency.
+};
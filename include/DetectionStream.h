@@ -0,0 +1,190 @@
+// Copyright 2026 Sai Surya Sriramoju
+
+/**
+ * @file DetectionStream.h
+ * @brief Declaration of the binary detection record stream.
+ * @author Sai Surya Sriramoju
+ * @date 10/17/2026
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Detections.h"
+#include "Tracker.h"
+
+/// "PMDS" in little-endian order; starts every frame of the stream.
+const uint32_t kStreamMagic = 0x53444D50;
+/// Version of the frame and record layout below.
+const uint16_t kStreamVersion = 1;
+
+/**
+ * @brief Header written before the records of one frame.
+ *
+ * All fields are in host (little-endian) byte order, with no padding.
+ */
+struct StreamFrameHeader {
+    uint32_t magic = kStreamMagic;      ///< kStreamMagic.
+    uint16_t version = kStreamVersion;  ///< kStreamVersion.
+    uint16_t source = 0;                ///< Camera/source index.
+    uint32_t count = 0;                 ///< Records that follow.
+    uint32_t reserved = 0;              ///< Zero.
+    uint64_t sequence = 0;              ///< Capture sequence number.
+    int64_t timestampNs = 0;            ///< Capture time, ns since the epoch.
+};
+static_assert(sizeof(StreamFrameHeader) == 32, "frame header must be packed");
+
+/**
+ * @brief One detection or track.
+ */
+struct StreamRecord {
+    int32_t trackId = -1;      ///< Persistent track id, -1 without tracking.
+    int32_t classId = 0;       ///< COCO class id.
+    float x = 0.0f;            ///< Box left edge in frame pixels.
+    float y = 0.0f;            ///< Box top edge in frame pixels.
+    float width = 0.0f;        ///< Box width in frame pixels.
+    float height = 0.0f;       ///< Box height in frame pixels.
+    float confidence = 0.0f;   ///< Detection score.
+    float worldX = 0.0f;       ///< World coordinates of the box.
+    float worldY = 0.0f;
+    float worldZ = 0.0f;
+};
+static_assert(sizeof(StreamRecord) == 40, "record must be packed");
+
+/**
+ * @brief Converts raw detections into stream records.
+ *
+ * @param detections Detections of one frame.
+ * @param worldCoords Their world coordinates as (x, y, z) triples, in the
+ *        same order; missing entries are written as zero.
+ * @param records Receives one record per detection; reused.
+ * @param scale Multiplies the boxes, e.g. FrameTask::scale to report
+ *        full-resolution pixels for a frame decoded at a reduced scale.
+ */
+void makeRecords(const Detections& detections,
+                 const std::vector<double>& worldCoords,
+                 std::vector<StreamRecord>& records, double scale = 1.0);
+
+/**
+ * @brief Converts tracks into stream records.
+ *
+ * @param tracks Tracks reported for one frame.
+ * @param worldCoords Their world coordinates as (x, y, z) triples.
+ * @param records Receives one record per track; reused.
+ * @param scale Multiplies the boxes, like for detections.
+ */
+void makeRecords(const std::vector<Track>& tracks,
+                 const std::vector<double>& worldCoords,
+                 std::vector<StreamRecord>& records, double scale = 1.0);
+
+/**
+ * @class DetectionStreamWriter
+ * @brief Writes frames of detection records to a file, pipe or Unix socket.
+ *
+ * Each frame is one StreamFrameHeader followed by its StreamRecord array,
+ * written with a single call, so a 1080p frame with ten people costs
+ * 432 bytes instead of a console line per person and a GUI round trip.
+ */
+class DetectionStreamWriter {
+ public:
+    /**
+     * @brief Opens the destination.
+     *
+     * @param target "-" for stdout, "unix:<path>" to connect to a listening
+     *        Unix stream socket, otherwise a file or named pipe path, which
+     *        is created or truncated.
+     * @throws std::runtime_error if the destination cannot be opened.
+     */
+    explicit DetectionStreamWriter(const std::string& target);
+
+    /**
+     * @brief Closes the destination unless it is stdout.
+     */
+    ~DetectionStreamWriter();
+
+    DetectionStreamWriter(const DetectionStreamWriter&) = delete;
+    DetectionStreamWriter& operator=(const DetectionStreamWriter&) = delete;
+
+    /**
+     * @brief Writes the records of one captured frame.
+     *
+     * @param source Camera/source index.
+     * @param sequence Capture sequence number.
+     * @param captured Capture time; converted to wall-clock time.
+     * @param records The records of the frame.
+     * @return bool - False once the destination failed, e.g. the reader went
+     *         away; see error().
+     */
+    bool write(size_t source, uint64_t sequence,
+               std::chrono::steady_clock::time_point captured,
+               const std::vector<StreamRecord>& records);
+
+    /**
+     * @brief Writes one frame of records.
+     *
+     * @param header Frame header; count is filled in from @p records.
+     * @param records The records of the frame.
+     * @return bool - False once the destination failed.
+     */
+    bool write(StreamFrameHeader header, const std::vector<StreamRecord>& records);
+
+    /**
+     * @brief Returns the number of frames written.
+     */
+    uint64_t frames() const { return written; }
+
+    /**
+     * @brief Returns why writing stopped, empty while it works.
+     */
+    const std::string& error() const { return failure; }
+
+ private:
+    int fd = -1;                  ///< Destination descriptor.
+    bool ownsFd = true;           ///< False for stdout.
+    bool isSocket = false;        ///< Use send() with MSG_NOSIGNAL.
+    /// Offset from steady_clock to system_clock, fixed at construction.
+    std::chrono::nanoseconds epochOffset{0};
+    std::vector<char> buffer;  ///< Reused serialisation buffer.
+    uint64_t written = 0;      ///< Frames written.
+    std::string failure;       ///< First write error.
+};
+
+/**
+ * @class DetectionStreamReader
+ * @brief Reads a stream produced by DetectionStreamWriter.
+ */
+class DetectionStreamReader {
+ public:
+    /**
+     * @brief Opens a stream file or named pipe; "-" reads stdin.
+     *
+     * @throws std::runtime_error if it cannot be opened.
+     */
+    explicit DetectionStreamReader(const std::string& path);
+
+    /**
+     * @brief Closes the file unless it is stdin.
+     */
+    ~DetectionStreamReader();
+
+    DetectionStreamReader(const DetectionStreamReader&) = delete;
+    DetectionStreamReader& operator=(const DetectionStreamReader&) = delete;
+
+    /**
+     * @brief Reads the next frame.
+     *
+     * @param header Receives the frame header.
+     * @param records Receives the frame's records.
+     * @return bool - False at the end of the stream.
+     * @throws std::runtime_error on a corrupt or truncated frame.
+     */
+    bool next(StreamFrameHeader& header, std::vector<StreamRecord>& records);
+
+ private:
+    int fd = -1;          ///< Source descriptor.
+    bool ownsFd = true;   ///< False for stdin.
+};
@@ -0,0 +1,100 @@
+// Copyright 2026 Sai Surya Sriramoju
+
+/**
+ * @file Detections.h
+ * @brief Declaration of the structure-of-arrays detection result type.
+ * @author Sai Surya Sriramoju
+ * @date 10/17/2026
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+#include <opencv2/opencv.hpp>
+
+/**
+ * @struct Detections
+ * @brief Detected boxes stored as a structure of arrays.
+ *
+ * Element i of every array describes detection i. Keeping each field in its
+ * own contiguous array lets NMS and projection loops stream through exactly
+ * the data they need, and clear() keeps the capacity so a Detections object
+ * that is reused frame after frame stops allocating once it has grown to the
+ * largest detection count seen.
+ */
+struct Detections {
+    std::vector<float> x;       ///< Left edge of each box in frame pixels.
+    std::vector<float> y;       ///< Top edge of each box in frame pixels.
+    std::vector<float> width;   ///< Width of each box in frame pixels.
+    std::vector<float> height;  ///< Height of each box in frame pixels.
+    std::vector<float> scores;  ///< Confidence of each detection.
+    std::vector<int> classIds;  ///< COCO class id of each detection.
+
+    /**
+     * @brief Returns the number of detections.
+     */
+    size_t size() const { return scores.size(); }
+
+    /**
+     * @brief Returns true if there are no detections.
+     */
+    bool empty() const { return scores.empty(); }
+
+    /**
+     * @brief Removes every detection while keeping the allocated capacity.
+     */
+    void clear() {
+        x.clear();
+        y.clear();
+        width.clear();
+        height.clear();
+        scores.clear();
+        classIds.clear();
+    }
+
+    /**
+     * @brief Reserves room for @p n detections in every array.
+     */
+    void reserve(size_t n) {
+        x.reserve(n);
+        y.reserve(n);
+        width.reserve(n);
+        height.reserve(n);
+        scores.reserve(n);
+        classIds.reserve(n);
+    }
+
+    /**
+     * @brief Appends one detection.
+     */
+    void push(float left, float top, float w, float h, float score,
+              int classId) {
+        x.push_back(left);
+        y.push_back(top);
+        width.push_back(w);
+        height.push_back(h);
+        scores.push_back(score);
+        classIds.push_back(classId);
+    }
+
+    /**
+     * @brief Moves every box by (@p dx, @p dy), e.g. from crop to frame pixels.
+     */
+    void offset(float dx, float dy) {
+        for (float& left : x) {
+            left += dx;
+        }
+        for (float& top : y) {
+            top += dy;
+        }
+    }
+
+    /**
+     * @brief Returns detection @p i as an integer rectangle.
+     */
+    cv::Rect box(size_t i) const {
+        return cv::Rect(static_cast<int>(x[i]), static_cast<int>(y[i]),
+                        static_cast<int>(width[i]), static_cast<int>(height[i]));
+    }
+};
@@ -0,0 +1,142 @@
+// Copyright 2026 Sai Surya Sriramoju
+
+/**
+ * @file DetectorBackend.h
+ * @brief Declaration of the inference backend interface behind YOLO.
+ * @author Sai Surya Sriramoju
+ * @date 10/17/2026
+ */
+
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include <opencv2/opencv.hpp>
+
+#include "DetectionDecoder.h"
+
+/**
+ * @brief Numeric precision the network is executed in.
+ */
+enum class Precision {
+    FP32,  ///< Full precision, the reference.
+    FP16,  ///< Half precision; needs OpenCV >= 4.9 and only pays off on ARM.
+    INT8   ///< 8-bit quantised, either pre-quantised or calibrated at load.
+};
+
+/**
+ * @brief Parses "fp32", "fp16" or "int8".
+ *
+ * @throws std::invalid_argument for any other name.
+ */
+Precision parsePrecision(const std::string& name);
+
+/**
+ * @brief Returns the lower case name of @p precision.
+ */
+std::string toString(Precision precision);
+
+/**
+ * @brief Which model to run, how and on what.
+ *
+ * Relative model and cfg paths are resolved against YOLO::modelsDir. The
+ * model format is taken from the extension: ".onnx" files are ONNX, anything
+ * else is read as Darknet weights together with @ref config.
+ */
+struct BackendConfig {
+    std::string engine = "opencv";        ///< Backend, see createBackend().
+    std::string model = "yolov3.weights";  ///< Weights or ONNX file.
+    std::string config = "yolov3.cfg";     ///< Darknet .cfg; unused for ONNX.
+    OutputLayout layout = OutputLayout::Darknet;  ///< Output format.
+    Precision precision = Precision::FP32;        ///< Execution precision.
+    /// Input side the model was exported with; 0 if the network accepts any
+    /// multiple of 32 (Darknet models).
+    int inputSize = 0;
+    /// Image directory or glob pattern used to calibrate INT8 quantisation at
+    /// load time; empty if the model file is already quantised.
+    std::string calibration;
+    int calibrationFrames = 16;  ///< Calibration images used at most.
+
+    /**
+     * @brief Returns true if @ref model is an ONNX file.
+     */
+    bool isOnnx() const;
+
+    /**
+     * @brief Returns a built-in configuration.
+     *
+     * Known names are "yolov3" (the default), "yolov3-tiny", "yolov5s" and
+     * "yolov8n"; the ONNX ones expect 640 x 640 exports in modelsDir.
+     *
+     * @throws std::invalid_argument for an unknown name.
+     */
+    static BackendConfig preset(const std::string& name);
+
+    /**
+     * @brief Reads a configuration from a YAML or JSON file.
+     *
+     * Missing keys keep their defaults; "preset" picks the starting point.
+     *
+     * @throws std::runtime_error if the file cannot be read or is invalid.
+     */
+    static BackendConfig load(const std::string& path);
+};
+
+/**
+ * @class DetectorBackend
+ * @brief Runs a detection network on preprocessed input blobs.
+ *
+ * YOLO owns the preprocessing and the decoding; a backend only turns an
+ * NCHW float blob into the raw output layers, so a new runtime needs just
+ * this one class.
+ */
+class DetectorBackend {
+ public:
+    virtual ~DetectorBackend() = default;
+
+    /**
+     * @brief Runs the network on @p blob.
+     *
+     * @param blob N x 3 x S x S CV_32F input in [0, 1], RGB.
+     * @param outputs Receives one matrix per output layer; reused.
+     */
+    virtual void forward(const cv::Mat& blob, std::vector<cv::Mat>& outputs) = 0;
+
+    /**
+     * @brief Returns a short description such as "opencv onnx int8".
+     */
+    virtual std::string describe() const = 0;
+};
+
+/**
+ * @brief Creates a backend for a config and optional INT8 calibration blobs.
+ */
+using BackendFactory = std::function<std::unique_ptr<DetectorBackend>(
+    const BackendConfig&, const std::vector<cv::Mat>&)>;
+
+/**
+ * @brief Makes @p factory available as BackendConfig::engine @p engine.
+ *
+ * Replaces any factory registered under the same name; "opencv" is built in
+ * but can be overridden too. Safe to call from any thread.
+ */
+void registerBackend(const std::string& engine, BackendFactory factory);
+
+/**
+ * @brief Creates the backend named by @p config.engine.
+ *
+ * "opencv" runs Darknet and ONNX models with OpenCV's DNN module on the CPU;
+ * other names must have been registered with registerBackend().
+ *
+ * @param config The model and precision; paths must already be resolved.
+ * @param calibration Preprocessed blobs used to quantise when INT8 is asked
+ *        for and the model is not quantised yet.
+ * @throws std::invalid_argument for an unknown engine.
+ * @throws std::runtime_error if the model cannot be loaded or the precision
+ *         is not supported by this OpenCV build.
+ */
+std::unique_ptr<DetectorBackend> createBackend(
+    const BackendConfig& config,
+    const std::vector<cv::Mat>& calibration = std::vector<cv::Mat>());
@@ -0,0 +1,144 @@
+// Copyright 2026 Sai Surya Sriramoju
+
+/**
+ * @file FramePool.h
+ * @brief Declaration of the FramePool class and its ref-counted FrameHandle.
+ * @author Sai Surya Sriramoju
+ * @date 10/17/2026
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <opencv2/opencv.hpp>
+
+class FramePool;
+
+/**
+ * @brief One reusable frame buffer of a FramePool.
+ */
+struct FrameSlot {
+    cv::Mat image;               ///< The buffer; reallocated only on size change.
+    std::atomic<int> refs{0};    ///< Live FrameHandle instances.
+    FramePool* pool = nullptr;   ///< Pool the slot returns to.
+};
+
+/**
+ * @class FrameHandle
+ * @brief Shared, ref-counted reference to a pooled frame.
+ *
+ * Copying a handle only bumps a counter; the buffer goes back to its pool
+ * when the last handle is destroyed or reset. cv::Mat headers taken from
+ * image() do not keep the slot alive, so hold on to the handle for as long
+ * as the pixels are used.
+ */
+class FrameHandle {
+ public:
+    FrameHandle() = default;
+    FrameHandle(const FrameHandle& other);
+    FrameHandle(FrameHandle&& other) noexcept;
+    FrameHandle& operator=(FrameHandle other) noexcept;
+    ~FrameHandle();
+
+    /**
+     * @brief Returns true if the handle refers to a frame.
+     */
+    explicit operator bool() const { return slot != nullptr; }
+
+    /**
+     * @brief Returns the pooled image; the handle must not be empty.
+     */
+    cv::Mat& image() const { return slot->image; }
+
+    /**
+     * @brief Drops this reference, recycling the frame if it was the last.
+     */
+    void reset();
+
+    /**
+     * @brief Returns how many handles share the frame, 0 if empty.
+     */
+    int useCount() const;
+
+ private:
+    friend class FramePool;
+
+    /**
+     * @brief Adopts @p slot, whose count the pool already set to one.
+     */
+    explicit FrameHandle(FrameSlot* slot) : slot(slot) {}
+
+    FrameSlot* slot = nullptr;  ///< Referenced slot, or nullptr.
+};
+
+/**
+ * @class FramePool
+ * @brief Fixed set of frame buffers recycled between captures.
+ *
+ * Decoding every frame into a fresh cv::Mat costs a large malloc/free and,
+ * for 1080p frames, fresh pages that fault in on first touch. The pool
+ * allocates its buffers once (optionally up front and pre-faulted) and
+ * hands them out as FrameHandle instances, so a frame flows from capture
+ * through inference to output without being copied or reallocated. The
+ * pool must outlive every handle it gave out.
+ */
+class FramePool {
+ public:
+    /**
+     * @brief Creates a pool of @p capacity frames.
+     *
+     * @param capacity Number of buffers; bounds the frames in flight.
+     * @param size If not empty, buffers are allocated and touched now.
+     * @param type OpenCV type of the pre-allocated buffers.
+     * @throws std::invalid_argument if @p capacity is zero.
+     */
+    explicit FramePool(size_t capacity, cv::Size size = cv::Size(),
+                       int type = CV_8UC3);
+
+    FramePool(const FramePool&) = delete;
+    FramePool& operator=(const FramePool&) = delete;
+
+    /**
+     * @brief Takes a free buffer, waiting up to @p timeout for one.
+     *
+     * @return FrameHandle - Sole reference to the buffer, or an empty handle
+     *         if every buffer is still in use after @p timeout.
+     */
+    FrameHandle acquire(std::chrono::milliseconds timeout =
+                            std::chrono::milliseconds(0));
+
+    /**
+     * @brief Returns the number of buffers.
+     */
+    size_t capacity() const { return slots.size(); }
+
+    /**
+     * @brief Returns the number of buffers not currently handed out.
+     */
+    size_t available() const;
+
+    /**
+     * @brief Returns how many acquire() calls found no free buffer.
+     */
+    uint64_t exhausted() const;
+
+ private:
+    friend class FrameHandle;
+
+    /**
+     * @brief Puts a slot whose last handle went away back on the free list.
+     */
+    void recycle(FrameSlot* slot);
+
+    std::vector<std::unique_ptr<FrameSlot>> slots;  ///< All buffers.
+    std::vector<FrameSlot*> freeSlots;   ///< Buffers ready for acquire().
+    mutable std::mutex guard;            ///< Protects freeSlots and misses.
+    std::condition_variable slotFreed;   ///< Signalled by recycle().
+    uint64_t misses = 0;                 ///< acquire() calls that failed.
+};
@@ -0,0 +1,60 @@
+// Copyright 2026 Sai Surya Sriramoju
+
+/**
+ * @file JpegDecode.h
+ * @brief Declaration of helpers that decode JPEG and MJPEG frames at a
+ *        reduced scale close to the network input size.
+ * @author Sai Surya Sriramoju
+ * @date 10/17/2026
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <opencv2/opencv.hpp>
+
+/**
+ * @brief Reads the frame size from a JPEG header without decoding.
+ *
+ * @param data Start of the JPEG bytes.
+ * @param size Number of bytes.
+ * @param frame Receives the full-resolution size.
+ * @return bool - False if the bytes are not a baseline or progressive JPEG.
+ */
+bool jpegSize(const uchar* data, size_t size, cv::Size& frame);
+
+/**
+ * @brief Returns the largest JPEG scale denominator (1, 2, 4 or 8) that
+ *        keeps the long side of @p frame at or above @p targetSide.
+ *
+ * The network letterboxes the long side to its input size, so decoding a
+ * 1920 x 1080 frame at 1/4 (480 x 270) for a 416 input loses nothing it
+ * would have kept. A @p targetSide of 0 or less returns 1.
+ */
+int jpegReduction(cv::Size frame, int targetSide);
+
+/**
+ * @brief Decodes a JPEG in the DCT domain at the reduction picked by
+ *        jpegReduction(); other image formats are decoded in full.
+ *
+ * Scaled decoding skips most of the inverse DCT and colour conversion, so
+ * a 1/4 decode costs a fraction of a full one.
+ *
+ * @param encoded The compressed image as a 1 x N byte matrix.
+ * @param targetSide Long side to stay at or above, 0 for a full decode.
+ * @param frame Receives the BGR image; its buffer is reused when the size
+ *        does not change.
+ * @param scale Receives full-resolution pixels per decoded pixel.
+ * @return bool - False if @p encoded could not be decoded; @p frame may
+ *         then still hold an earlier image.
+ */
+bool decodeReduced(const cv::Mat& encoded, int targetSide, cv::Mat& frame,
+                   double& scale);
+
+/**
+ * @brief Reads a whole file into a 1 x N byte matrix for decodeReduced().
+ *
+ * @return cv::Mat - The bytes; empty if the file cannot be read.
+ */
+cv::Mat readEncoded(const std::string& path);
@@ -0,0 +1,56 @@
+// Copyright 2026 Sai Surya Sriramoju
+
+/**
+ * @file MappedFile.h
+ * @brief Declaration of the MappedFile class, a read-only memory mapping.
+ * @author Sai Surya Sriramoju
+ * @date 10/17/2026
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+/**
+ * @class MappedFile
+ * @brief Maps a whole file read-only into memory.
+ *
+ * Parsers can read the mapping directly, so the file is never copied into
+ * a stream buffer and pages come straight from the page cache; a second
+ * process start with a warm cache costs no disk I/O at all.
+ */
+class MappedFile {
+ public:
+    /**
+     * @brief Maps @p path.
+     *
+     * @param path The file to map.
+     * @param sequential Hint that the file will be read front to back, so
+     *        the kernel reads ahead aggressively.
+     * @throws std::runtime_error if the file cannot be opened or mapped.
+     */
+    explicit MappedFile(const std::string& path, bool sequential = true);
+
+    /**
+     * @brief Unmaps the file.
+     */
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /**
+     * @brief Returns the first byte of the mapping.
+     */
+    const char* data() const { return bytes; }
+
+    /**
+     * @brief Returns the file size in bytes.
+     */
+    size_t size() const { return length; }
+
+ private:
+    const char* bytes = nullptr;  ///< Start of the mapping.
+    size_t length = 0;            ///< Mapped bytes.
+};
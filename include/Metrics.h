@@ -0,0 +1,256 @@
+// Copyright 2026 Sai Surya Sriramoju
+
+/**
+ * @file Metrics.h
+ * @brief Declaration of latency histograms, scoped timers and the metrics
+ *        registry with its Prometheus text exporter.
+ * @author Sai Surya Sriramoju
+ * @date 10/17/2026
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief A point-in-time copy of a Histogram.
+ */
+struct HistogramSnapshot {
+    std::vector<uint64_t> counts;  ///< Per bucket, overflow bucket last.
+    uint64_t count = 0;            ///< Number of recorded values.
+    double sumSeconds = 0.0;       ///< Sum of the recorded values.
+
+    /**
+     * @brief Estimates the @p q quantile (0..1) in seconds, interpolating
+     *        linearly within the bucket it falls into.
+     */
+    double quantile(double q) const;
+};
+
+/**
+ * @class Histogram
+ * @brief Lock-free latency histogram with log-linear buckets.
+ *
+ * Buckets run from 1 us to about 67 s with four buckets per power of two,
+ * so a quantile is off by at most 25 %. Each recording thread writes to its
+ * own shard of relaxed atomic counters (threads are spread over kShards
+ * shards in the order they first record), so the hot path never takes a
+ * lock and threads do not share cache lines; snapshot() adds the shards up.
+ */
+class Histogram {
+ public:
+    /// Shards; more recording threads than this share shards, still lock-free.
+    static const size_t kShards = 8;
+
+    /**
+     * @brief Returns the upper bounds of the buckets in microseconds, in
+     *        ascending order; values above the last go to an overflow bucket.
+     */
+    static const std::vector<uint64_t>& bounds();
+
+    Histogram();
+
+    /**
+     * @brief Records one duration.
+     */
+    void record(std::chrono::steady_clock::duration elapsed);
+
+    /**
+     * @brief Adds up the shards.
+     */
+    HistogramSnapshot snapshot() const;
+
+ private:
+    /// Upper bound on the number of buckets, overflow included.
+    static const size_t kMaxBuckets = 112;
+
+    /**
+     * @brief The counters of one group of threads, padded to its own lines.
+     */
+    struct Shard {
+        std::array<std::atomic<uint64_t>, kMaxBuckets> counts;  ///< Per bucket.
+        std::atomic<uint64_t> sumNs{0};  ///< Sum of the recorded values.
+        char padding[64];                ///< Keeps the next shard apart.
+    };
+
+    std::unique_ptr<Shard[]> shards;  ///< kShards shards.
+};
+
+/**
+ * @class ScopedTimer
+ * @brief Records the lifetime of a scope into a Histogram.
+ *
+ * Uses the monotonic steady_clock. A null histogram makes the timer a no-op
+ * that does not even read the clock, so instrumented code costs nothing
+ * while metrics are off.
+ */
+class ScopedTimer {
+ public:
+    /**
+     * @brief Starts timing if @p histogram is set.
+     */
+    explicit ScopedTimer(Histogram* histogram) : target(histogram) {
+        if (target != nullptr) {
+            begin = std::chrono::steady_clock::now();
+        }
+    }
+
+    /**
+     * @brief Records the elapsed time.
+     */
+    ~ScopedTimer() {
+        if (target != nullptr) {
+            target->record(std::chrono::steady_clock::now() - begin);
+        }
+    }
+
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+ private:
+    Histogram* target;                            ///< Where to record.
+    std::chrono::steady_clock::time_point begin;  ///< Start of the scope.
+};
+
+/**
+ * @class Metrics
+ * @brief Registry of histograms and sampled counters and gauges.
+ *
+ * Series are registered at start-up (under a lock) and recorded without one.
+ * Series with the same name form one metric family and are told apart by
+ * their labels, e.g. name "perception_stage_seconds" with labels
+ * "stage=\"forward\"". Counters and gauges are sampled from callbacks when
+ * a report is made, so existing counters such as queue drop counts do not
+ * have to be duplicated.
+ */
+class Metrics {
+ public:
+    /**
+     * @brief Returns the histogram @p name{@p labels}, creating it if needed.
+     *
+     * @return Histogram& - Valid for the registry's lifetime.
+     */
+    Histogram& histogram(const std::string& name, const std::string& labels,
+                         const std::string& help);
+
+    /**
+     * @brief Registers a monotonically increasing value sampled from @p read.
+     */
+    void counter(const std::string& name, const std::string& labels,
+                 const std::string& help, std::function<double()> read);
+
+    /**
+     * @brief Registers a value that goes up and down, sampled from @p read.
+     */
+    void gauge(const std::string& name, const std::string& labels,
+               const std::string& help, std::function<double()> read);
+
+    /**
+     * @brief Formats p50/p95/p99 and counts of every histogram, one per line.
+     */
+    std::string summary() const;
+
+    /**
+     * @brief Formats every series in the Prometheus text exposition format.
+     */
+    std::string prometheus() const;
+
+ private:
+    /**
+     * @brief What kind of metric a series is.
+     */
+    enum class Kind { Histogram, Counter, Gauge };
+
+    /**
+     * @brief One registered series.
+     */
+    struct Series {
+        std::string name;                      ///< Family name.
+        std::string labels;                    ///< Label pairs, may be empty.
+        std::string help;                      ///< HELP text of the family.
+        Kind kind = Kind::Gauge;               ///< Type of the family.
+        std::unique_ptr<Histogram> histogram;  ///< For Kind::Histogram.
+        std::function<double()> read;          ///< For counters and gauges.
+    };
+
+    /**
+     * @brief Adds a sampled series.
+     */
+    void add(const std::string& name, const std::string& labels,
+             const std::string& help, Kind kind, std::function<double()> read);
+
+    mutable std::mutex guard;                     ///< Protects series.
+    std::vector<std::unique_ptr<Series>> series;  ///< In registration order.
+};
+
+/**
+ * @brief Where and how often MetricsExporter publishes.
+ */
+struct ExporterConfig {
+    /// File rewritten with the Prometheus text on every interval, e.g. for
+    /// node_exporter's textfile collector; empty for none.
+    std::string file;
+    /// Port of an HTTP endpoint on 127.0.0.1 serving the Prometheus text on
+    /// any path; 0 for none.
+    int port = 0;
+    std::chrono::milliseconds interval{5000};  ///< File rewrite interval.
+};
+
+/**
+ * @class MetricsExporter
+ * @brief Publishes a Metrics registry from a background thread.
+ */
+class MetricsExporter {
+ public:
+    /**
+     * @brief Opens the endpoint, if any, and starts the thread.
+     *
+     * @throws std::runtime_error if the port cannot be bound.
+     */
+    MetricsExporter(const Metrics& metrics, const ExporterConfig& config);
+
+    /**
+     * @brief Writes the file one last time and stops the thread.
+     */
+    ~MetricsExporter();
+
+    MetricsExporter(const MetricsExporter&) = delete;
+    MetricsExporter& operator=(const MetricsExporter&) = delete;
+
+    /**
+     * @brief Returns the port the endpoint listens on, 0 without one.
+     */
+    int port() const { return boundPort; }
+
+ private:
+    /**
+     * @brief Writes the file atomically (temporary file and rename).
+     */
+    void writeFile() const;
+
+    /**
+     * @brief Answers one pending HTTP request.
+     */
+    void serve() const;
+
+    /**
+     * @brief Thread body: serves requests and rewrites the file until stopped.
+     */
+    void run();
+
+    const Metrics& metrics;          ///< What to publish.
+    ExporterConfig config;           ///< Where and how often.
+    int listener = -1;               ///< Listening socket, -1 without one.
+    int boundPort = 0;               ///< Port actually bound.
+    std::atomic<bool> stopping{false};  ///< Set by the destructor.
+    std::thread worker;              ///< Runs run().
+};
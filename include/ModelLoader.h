@@ -0,0 +1,88 @@
+// Copyright 2026 Sai Surya Sriramoju
+
+/**
+ * @file ModelLoader.h
+ * @brief Declaration of the ModelLoader class for background detector loading.
+ * @author Sai Surya Sriramoju
+ * @date 10/17/2026
+ */
+
+#pragma once
+
+#include <chrono>
+#include <functional>
+#include <future>
+#include <memory>
+
+#include "YOLO.h"
+
+/**
+ * @brief How long the stages of a background load took.
+ */
+struct LoadTimes {
+    double loadMs = 0.0;     ///< Reading and parsing the model.
+    double prepareMs = 0.0;  ///< Configuration and warm-up.
+};
+
+/**
+ * @class ModelLoader
+ * @brief Loads and warms up a YOLO detector on a background thread.
+ *
+ * Loading a large model takes seconds; starting it first lets the cameras
+ * open, the windows appear and the capture pipeline fill while the weights
+ * are parsed. ready() is the readiness signal, get() hands the detector
+ * over once it is.
+ */
+class ModelLoader {
+ public:
+    /**
+     * @brief Hook run on the loader thread after the model is loaded, e.g.
+     *        to configure the detector and call YOLO::warmUp().
+     */
+    using Prepare = std::function<void(YOLO&)>;
+
+    /**
+     * @brief Starts loading @p config on a new thread.
+     *
+     * @param config The detector backend to load.
+     * @param prepare Optional hook run after loading, on the same thread.
+     */
+    explicit ModelLoader(const BackendConfig& config, Prepare prepare = Prepare());
+
+    /**
+     * @brief Waits for the load to finish if the detector was never taken.
+     */
+    ~ModelLoader();
+
+    ModelLoader(const ModelLoader&) = delete;
+    ModelLoader& operator=(const ModelLoader&) = delete;
+
+    /**
+     * @brief Returns true once the detector is loaded and prepared (or
+     *        loading failed); never blocks.
+     */
+    bool ready() const;
+
+    /**
+     * @brief Waits up to @p timeout for ready().
+     */
+    bool waitFor(std::chrono::milliseconds timeout) const;
+
+    /**
+     * @brief Waits for and takes the detector.
+     *
+     * @return std::unique_ptr<YOLO> - The detector; only the first call
+     *         returns it.
+     * @throws Whatever loading or the prepare hook threw.
+     */
+    std::unique_ptr<YOLO> get();
+
+    /**
+     * @brief Returns the load and prepare times; valid once ready().
+     */
+    LoadTimes times() const { return timings; }
+
+ private:
+    LoadTimes timings;                         ///< Written by the loader.
+    std::future<std::unique_ptr<YOLO>> result;  ///< The loader thread.
+};
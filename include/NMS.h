@@ -0,0 +1,103 @@
+// Copyright 2026 Sai Surya Sriramoju
+
+/**
+ * @file NMS.h
+ * @brief Declaration of the NMSEngine class for non-maximum suppression.
+ * @author Sai Surya Sriramoju
+ * @date 10/17/2026
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "Detections.h"
+
+/**
+ * @brief Suppression strategy used by NMSEngine.
+ */
+enum class NMSMode {
+    Hard,         ///< Drop boxes overlapping a kept box (classic greedy NMS).
+    SoftLinear,   ///< Scale overlapping scores by (1 - IoU) above the threshold.
+    SoftGaussian  ///< Scale overlapping scores by exp(-IoU^2 / sigma).
+};
+
+/**
+ * @brief Thresholds and mode for non-maximum suppression.
+ */
+struct NMSConfig {
+    float scoreThreshold = 0.2f;  ///< Boxes at or below this score are dropped.
+    float iouThreshold = 0.2f;    ///< Overlap above which boxes interact.
+    bool classAware = true;       ///< Only boxes of the same class interact.
+    NMSMode mode = NMSMode::Hard;  ///< Hard or soft suppression.
+    float sigma = 0.5f;           ///< Gaussian width for SoftGaussian.
+};
+
+/**
+ * @class NMSEngine
+ * @brief Non-maximum suppression over structure-of-arrays boxes.
+ *
+ * Candidates are sorted once by (class, score) and copied into contiguous
+ * corner/area arrays in that order. With classAware each class is then an
+ * independent segment, so the quadratic part only runs within a class, and
+ * the overlap of a kept box with the rest of its segment is computed by the
+ * vectorised iouOneToMany() kernel in a single streaming pass. All working
+ * buffers are kept between calls.
+ */
+class NMSEngine {
+ public:
+    /**
+     * @brief Creates an engine with room for @p capacity candidates.
+     */
+    explicit NMSEngine(size_t capacity = 1024);
+
+    /**
+     * @brief Suppresses overlapping candidates.
+     *
+     * @param candidates Boxes to filter.
+     * @param config Thresholds and mode.
+     * @param kept Receives the surviving boxes by descending score within
+     *        each class (with SoftLinear/SoftGaussian, with decayed scores).
+     */
+    void run(const Detections& candidates, const NMSConfig& config,
+             Detections& kept);
+
+ private:
+    /**
+     * @brief Greedy hard NMS over the sorted range [begin, end).
+     */
+    void hardSegment(int begin, int end, const NMSConfig& config,
+                     Detections& kept);
+
+    /**
+     * @brief Soft-NMS over the sorted range [begin, end).
+     */
+    void softSegment(int begin, int end, const NMSConfig& config,
+                     Detections& kept);
+
+    /**
+     * @brief Appends sorted box @p i to @p kept.
+     */
+    void keep(int i, Detections& kept) const;
+
+    /**
+     * @brief Copies sorted box @p from over sorted box @p to.
+     */
+    void moveBox(int from, int to);
+
+    /**
+     * @brief Exchanges sorted boxes @p a and @p b.
+     */
+    void swapBoxes(int a, int b);
+
+    std::vector<int> order;      ///< Candidate indices sorted by class, score.
+    std::vector<float> x1;       ///< Sorted left edges.
+    std::vector<float> y1;       ///< Sorted top edges.
+    std::vector<float> x2;       ///< Sorted right edges.
+    std::vector<float> y2;       ///< Sorted bottom edges.
+    std::vector<float> area;     ///< Sorted areas.
+    std::vector<float> scores;   ///< Sorted, possibly decayed, scores.
+    std::vector<int> classIds;   ///< Sorted class ids.
+    std::vector<float> iou;      ///< Scratch IoU values for one kept box.
+};
@@ -9,8 +9,108 @@
 
 #pragma once
 
+#include <atomic>
+#include <cstdint>
+#include <vector>
 #include <opencv2/opencv.hpp>
 
+/**
+ * @brief Tunables for MotionGate.
+ */
+struct MotionGateConfig {
+    int downscale = 4;            ///< Motion is measured at 1/downscale size.
+    double diffThreshold = 25.0;  ///< Grey level change that counts as motion.
+    /// Fraction of pixels that must change before the network runs.
+    double minChangedFraction = 0.002;
+    int padding = 32;       ///< Margin added around the motion box, in pixels.
+    /// Motion boxes covering more than this fraction of the frame run on the
+    /// whole frame instead of a crop.
+    double maxCropFraction = 0.6;
+    /// Run on the whole frame at least every N frames so objects that stop
+    /// moving are still refreshed; 0 disables it.
+    int refreshEvery = 30;
+    /// Use a MOG2 background model instead of differencing consecutive frames.
+    bool backgroundSubtraction = false;
+};
+
+/**
+ * @brief Outcome of MotionGate::evaluate() for one frame.
+ */
+struct GateDecision {
+    bool run = true;  ///< Whether the network should run on this frame.
+    cv::Rect roi;     ///< Region to run it on; empty for the whole frame.
+};
+
+/**
+ * @brief Snapshot of MotionGate counters.
+ */
+struct GateStats {
+    uint64_t hits = 0;     ///< Frames the network ran on.
+    uint64_t skips = 0;    ///< Frames skipped as unchanged.
+    uint64_t cropped = 0;  ///< Hits that ran on a region of interest only.
+};
+
+/**
+ * @brief Processing steps OpenCVProcessor applies to each frame.
+ */
+struct ProcessingOptions {
+    bool gaussianBlur = true;  ///< 5x5 Gaussian blur (sigma derived from size).
+    bool motionGate = false;   ///< Gate inference on motion (see MotionGate).
+    MotionGateConfig gate;     ///< Motion gate tunables.
+};
+
+/**
+ * @class MotionGate
+ * @brief Decides from cheap frame differencing whether, and where, to run
+ *        the network.
+ *
+ * Each frame is shrunk and converted to grey, compared with the previous
+ * one (or with a MOG2 background model) and thresholded. Too few changed
+ * pixels and the frame is skipped; otherwise the bounding box of the motion,
+ * grown to include any given track regions and padded, is returned as the
+ * region to run on. Intended for static cameras, one gate per camera.
+ */
+class MotionGate {
+ public:
+    /**
+     * @brief Creates a gate; the first frame always runs.
+     */
+    explicit MotionGate(const MotionGateConfig& config = MotionGateConfig());
+
+    /**
+     * @brief Decides whether and where to run the network on @p frame.
+     *
+     * @param frame The BGR frame.
+     * @param regions Regions that must be covered if the network runs,
+     *        such as current track boxes, in frame pixels.
+     * @return GateDecision - Whether to run and the region of interest.
+     */
+    GateDecision evaluate(const cv::Mat& frame,
+                          const std::vector<cv::Rect>& regions = std::vector<cv::Rect>());
+
+    /**
+     * @brief Returns the hit, skip and crop counters; safe from any thread.
+     */
+    GateStats stats() const;
+
+    /**
+     * @brief Forgets the reference frame so the next frame runs.
+     */
+    void reset();
+
+ private:
+    MotionGateConfig config;      ///< Tunables.
+    cv::Mat small;                ///< Current frame, shrunk and grey.
+    cv::Mat previous;             ///< Previous shrunk grey frame.
+    cv::Mat mask;                 ///< Changed pixels.
+    cv::Mat points;               ///< Locations of changed pixels.
+    cv::Ptr<cv::BackgroundSubtractorMOG2> background;  ///< MOG2 model.
+    int sinceRefresh = 0;         ///< Frames since the last full-frame run.
+    std::atomic<uint64_t> hitCount{0};   ///< Frames run.
+    std::atomic<uint64_t> skipCount{0};  ///< Frames skipped.
+    std::atomic<uint64_t> cropCount{0};  ///< Frames run on a crop.
+};
+
 /**
  * @class OpenCVProcessor
  * @brief Handles image processing operations using OpenCV.
@@ -21,6 +121,25 @@
  */
 class OpenCVProcessor {
  public:
+    /**
+     * @brief Creates a processor applying the given steps.
+     */
+    explicit OpenCVProcessor(const ProcessingOptions& options = ProcessingOptions())
+        : enabled(options) {}
+
+    /**
+     * @brief Returns the enabled processing steps.
+     */
+    const ProcessingOptions& options() const { return enabled; }
+
+    /**
+     * @brief Replaces the enabled processing steps.
+     * 
+     * Used to hand a step over to the fused network preprocessing pass (see
+     * Preprocessor) so it is not applied a second time on the full frame.
+     */
+    void setOptions(const ProcessingOptions& options) { enabled = options; }
+
     /**
      * @brief Processes the given frame using OpenCV functions.
      * 
@@ -31,4 +150,7 @@ class OpenCVProcessor {
      * @param frame The input frame (image) to be processed.
      */
     void processImages(const cv::Mat& frame);
+
+ private:
+    ProcessingOptions enabled;  ///< Steps applied by processImages().
 };
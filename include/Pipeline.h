@@ -0,0 +1,410 @@
+// Copyright 2026 Sai Surya Sriramoju
+
+/**
+ * @file Pipeline.h
+ * @brief Declaration of the multi-stage, multi-threaded perception pipeline.
+ * @author Sai Surya Sriramoju
+ * @date 10/17/2026
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <opencv2/opencv.hpp>
+
+#include "Affinity.h"
+#include "AsyncDetector.h"
+#include "BoundedQueue.h"
+#include "Camera.h"
+#include "CaptureManager.h"
+#include "CoordToWorld.h"
+#include "DeadlineScheduler.h"
+#include "FramePool.h"
+#include "Metrics.h"
+#include "OpenCVProcessor.h"
+#include "Recording.h"
+#include "Tracker.h"
+#include "YOLO.h"
+
+/**
+ * @brief A frame travelling through the pipeline together with its results.
+ */
+struct FrameTask {
+    uint64_t sequence = 0;                           ///< Capture order.
+    size_t source = 0;  ///< Index of the CaptureManager source, 0 for Camera.
+    std::chrono::steady_clock::time_point captured;  ///< Capture time.
+    cv::Mat frame;                        ///< Captured (and annotated) image.
+    /// Full-resolution pixels per @p frame pixel; above 1 when the frame was
+    /// decoded at a reduced scale (see SourceSpec::decodeSide).
+    double scale = 1.0;
+    /// JPEG @p frame was decoded from, if kept; recorded as it is.
+    cv::Mat encoded;
+    /// Pooled buffer @p frame points into; keeps it from being recycled.
+    FrameHandle buffer;
+    /// Detections behind pixelCoords, in the same order, without tracking.
+    Detections detections;
+    /// Detections as (u, v) pairs in frame pixels, scaled to full-resolution
+    /// pixels by the projection stage.
+    std::vector<double> pixelCoords;
+    std::vector<double> worldCoords;      ///< Detections as (x, y, z) triples.
+    /// Tracks behind pixelCoords, in the same order, when tracking is on.
+    std::vector<Track> tracks;
+};
+
+/**
+ * @brief Tunables for the pipeline.
+ */
+struct PipelineConfig {
+    size_t queueCapacity = 2;  ///< Capacity of every inter-stage queue.
+    /// What a stage does when its downstream queue is full.
+    OverflowPolicy overflow = OverflowPolicy::DropOldest;
+    /// Interval between throughput reports; zero disables them.
+    std::chrono::milliseconds reportInterval{5000};
+    /// Target inference time per frame. When non-zero the network input is
+    /// stepped down (608 -> 416 -> 320) while frames take longer and back up
+    /// to the starting size while they take less than half of it.
+    std::chrono::milliseconds inferenceBudget{0};
+    /// Frame buffers the camera decodes into, or that each CaptureManager
+    /// source keeps for the pipeline besides its own buffering; 0 sizes the
+    /// pool for the worst case of every queue full and every stage holding
+    /// a frame.
+    size_t framePoolSize = 0;
+    /// Report tracks with persistent ids instead of raw detections.
+    bool tracking = false;
+    /// With tracking, run the detector on every Nth frame of a source only
+    /// and let the tracker's motion model fill in the frames between.
+    int detectEvery = 1;
+    TrackerConfig tracker;  ///< Association and track life cycle tunables.
+    /// Network instances running in parallel; above 1 the inference stage
+    /// keeps that many frames in flight on an AsyncDetector.
+    int detectorInstances = 1;
+    /// OpenCV threads per forward pass (see AsyncConfig::threadsPerInstance);
+    /// 0 picks one per instance when detectorInstances > 1 and OpenCV's
+    /// default, usually one per core, for a single instance.
+    int threadsPerDetector = 0;
+    /// CPUs the stage threads and detector instances run on. Frames are
+    /// first written by the thread that captures them (this capture stage
+    /// for a Camera, each source's grab thread, see SourceSpec::cpus), so
+    /// pinning it to a node also places the frames in that node's memory.
+    AffinityConfig affinity;
+    /// Let a DeadlineScheduler pick which source's frame is detected next,
+    /// by target rate and priority, instead of taking frames in arrival
+    /// order; each source then has at most one frame waiting.
+    bool schedule = false;
+    SchedulerConfig scheduler;  ///< Per-source rates and priorities.
+    /// Tile grid per source (index = FrameTask::source) for high-resolution
+    /// cameras, see YOLO::inferTiled(); sources past the end use the last
+    /// entry, and an empty list disables tiling.
+    std::vector<TilingConfig> tiling;
+    /// Draw detections and tracks in the output stage, just before the
+    /// output handler, instead of on the inference thread. Turn YOLO's own
+    /// annotation (PostprocessOptions::annotate) off along with it.
+    bool annotateInOutput = false;
+    /// Where throughput reports and input size changes are printed; nullptr
+    /// silences them, e.g. when stdout carries the detection stream.
+    std::ostream* log = &std::cout;
+    /// Registry that receives per-stage latency histograms, queue depths and
+    /// drop counts; nullptr turns the instrumentation off. Must outlive the
+    /// pipeline, and so must anything exporting it while it runs.
+    Metrics* metrics = nullptr;
+    /// Receives every captured frame as it leaves the capture stage, for
+    /// replay through a SourceKind::Recording source; nullptr records
+    /// nothing. Must outlive the pipeline.
+    RecordingWriter* recorder = nullptr;
+    /// Polled by run() while it waits for frames; setting it stops the
+    /// pipeline even when no frame reaches the output, e.g. from a signal
+    /// handler. nullptr for none. Must outlive the pipeline.
+    const std::atomic<bool>* stopFlag = nullptr;
+};
+
+/**
+ * @class StageStats
+ * @brief Lock-free throughput counters for a single pipeline stage.
+ */
+class StageStats {
+ public:
+    /**
+     * @brief Creates the counters for the stage called @p name.
+     */
+    explicit StageStats(const std::string& name) : stageName(name) {}
+
+    /**
+     * @brief Records one processed frame that kept the stage busy for @p busy.
+     */
+    void record(std::chrono::steady_clock::duration busy) {
+        frameCount.fetch_add(1, std::memory_order_relaxed);
+        busyNs.fetch_add(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(busy).count(),
+            std::memory_order_relaxed);
+        if (latency != nullptr) {
+            latency->record(busy);
+        }
+    }
+
+    /**
+     * @brief Also records every frame's busy time into @p histogram.
+     *
+     * Must be called before the stage runs.
+     */
+    void attach(Histogram* histogram) { latency = histogram; }
+
+    const std::string& name() const { return stageName; }
+    uint64_t frames() const { return frameCount.load(std::memory_order_relaxed); }
+    /// Total time spent processing frames, in seconds.
+    double busySeconds() const {
+        return busyNs.load(std::memory_order_relaxed) * 1e-9;
+    }
+
+ private:
+    std::string stageName;                ///< Stage name used in reports.
+    std::atomic<uint64_t> frameCount{0};  ///< Frames processed so far.
+    std::atomic<uint64_t> busyNs{0};      ///< Busy time in nanoseconds.
+    Histogram* latency = nullptr;         ///< Per-frame latency, if attached.
+};
+
+/**
+ * @class Pipeline
+ * @brief Runs capture, inference, world projection and output concurrently.
+ *
+ * Capture, inference and projection each run on their own thread and are
+ * connected by BoundedQueue instances; the output stage runs on the thread
+ * that calls run(), so that GUI calls such as cv::imshow stay on it. While
+ * YOLO is busy with one frame the camera is already grabbing the next one.
+ */
+class Pipeline {
+ public:
+    /**
+     * @brief Callback for the output stage; return false to stop the pipeline.
+     */
+    using OutputHandler = std::function<bool(FrameTask&)>;
+
+    /**
+     * @brief Creates a pipeline over the given, already initialised, components.
+     *
+     * The components must outlive the pipeline and are each used from a
+     * single pipeline thread only.
+     */
+    Pipeline(Camera& camera, YOLO& yolo, OpenCVProcessor& processor,
+             CoordToWorld& world, const PipelineConfig& config = PipelineConfig());
+
+    /**
+     * @brief Creates a pipeline fed by every source of a CaptureManager.
+     *
+     * The capture stage starts @p capture and forwards each frame of every
+     * synchronised set, tagged with FrameTask::source; frames of one set
+     * share the set's sequence number.
+     */
+    Pipeline(CaptureManager& capture, YOLO& yolo, OpenCVProcessor& processor,
+             CoordToWorld& world, const PipelineConfig& config = PipelineConfig());
+
+    /**
+     * @brief Stops and joins all stage threads.
+     */
+    ~Pipeline();
+
+    Pipeline(const Pipeline&) = delete;
+    Pipeline& operator=(const Pipeline&) = delete;
+
+    /**
+     * @brief Starts the worker stages and runs the output stage on this thread.
+     *
+     * Returns when @p output returns false, stop() is called,
+     * PipelineConfig::stopFlag is set, or the camera stops delivering frames
+     * and every queued frame has been handed out.
+     *
+     * @param output Called once for every frame that made it through.
+     */
+    void run(const OutputHandler& output);
+
+    /**
+     * @brief Asks every stage to finish; safe to call from any thread.
+     */
+    void stop();
+
+    /**
+     * @brief Formats frames/s, utilisation and drops for every stage.
+     *
+     * The stage with the highest utilisation is the bottleneck.
+     *
+     * @return std::string - Multi-line human readable report.
+     */
+    std::string throughputReport() const;
+
+    /**
+     * @brief Returns the per-stage counters in pipeline order.
+     */
+    const std::vector<const StageStats*>& stages() const { return stageList; }
+
+ private:
+    void captureLoop();
+    void captureSetsLoop();
+
+    /**
+     * @brief Passes a captured frame on to inference.
+     */
+    bool pushCaptured(FrameTask task);
+
+    /**
+     * @brief Empties a frame the output stage is done with and keeps it, with
+     *        the capacity of its vectors, for the capture stage to refill.
+     */
+    void recycle(FrameTask& task);
+
+    /**
+     * @brief Takes the next frame for inference.
+     */
+    bool popCaptured(FrameTask& task, std::chrono::milliseconds wait);
+
+    /**
+     * @brief Returns true once no captured frame is left.
+     */
+    bool capturedDrained() const;
+
+    /**
+     * @brief Closes the capture -> inference hand-over.
+     */
+    void closeCaptured();
+
+    void inferenceLoop();
+    void projectionLoop();
+    void join();
+
+    /**
+     * @brief What the inference stage keeps about one source between frames.
+     */
+    struct DetectionState {
+        explicit DetectionState(const TrackerConfig& tracking) : tracker(tracking) {}
+
+        MultiObjectTracker tracker;  ///< Tracks of this source.
+        uint64_t frames = 0;         ///< Frames seen so far.
+        Detections last;             ///< Last detections, shown on gated frames.
+        std::unique_ptr<MotionGate> gate;  ///< Motion gate, if enabled.
+    };
+
+    /**
+     * @brief Returns the state of @p source, creating it on first use.
+     */
+    DetectionState& detectionState(size_t source);
+
+    /**
+     * @brief Returns the motion gate counters summed over the sources; safe
+     *        to call from any thread.
+     */
+    GateStats gateStats() const;
+
+    /**
+     * @brief A frame whose detections are being computed by the AsyncDetector.
+     */
+    struct InFlight {
+        FrameTask task;                  ///< The frame.
+        bool detect = false;             ///< Whether a request was submitted.
+        cv::Rect roi;                    ///< Region it was submitted for.
+        std::future<Detections> result;  ///< Detections within @p roi.
+        std::chrono::steady_clock::time_point begin;  ///< Stage entry time.
+    };
+
+    /**
+     * @brief Runs the inference stage with frames in flight on asyncDetector.
+     */
+    void asyncInferenceLoop();
+
+    /**
+     * @brief Runs the detector, gated by motion if enabled, on one frame.
+     *
+     * Fills the task's pixel coordinates and, with tracking, its tracks.
+     *
+     * @return bool - True if the detector ran.
+     */
+    bool detectFrame(FrameTask& task);
+
+    /**
+     * @brief Decides whether, and on which region, to detect on a frame.
+     *
+     * @param task The frame.
+     * @param roi Receives the region to run on; empty for the whole frame.
+     * @return bool - True if the detector should run.
+     */
+    bool planDetection(const FrameTask& task, cv::Rect& roi);
+
+    /**
+     * @brief Turns a frame's detections into tracks and pixel coordinates.
+     *
+     * @param task The frame; receives the results and annotations.
+     * @param detections Detections in frame pixels, or nullptr if the
+     *        detector did not run on this frame.
+     */
+    void finishDetection(FrameTask& task, const Detections* detections);
+
+    /**
+     * @brief Runs YOLO on @p roi of @p frame, or the whole frame if empty,
+     *        tiled as configured for @p source.
+     *
+     * @return const Detections& - Detections in frame pixels.
+     */
+    const Detections& inferRegion(const cv::Mat& frame, const cv::Rect& roi,
+                                  size_t source);
+
+    /**
+     * @brief Returns the tile grid of @p source.
+     */
+    const TilingConfig& tilingFor(size_t source) const;
+
+    /**
+     * @brief Adjusts the YOLO input size to keep inference within budget.
+     */
+    void adaptInputSize(std::chrono::steady_clock::duration inferenceTime);
+
+    /**
+     * @brief Registers the stage histograms, queue gauges and drop counters
+     *        with config.metrics, if set.
+     */
+    void registerMetrics();
+
+    Camera* camera = nullptr;            ///< Single frame source, or
+    CaptureManager* capture = nullptr;   ///< synchronised multi-source capture.
+    YOLO& yolo;                   ///< Detector.
+    OpenCVProcessor& processor;   ///< Post-detection image processing.
+    CoordToWorld& world;          ///< Pixel to world projection.
+    PipelineConfig config;        ///< Pipeline tunables.
+
+    FramePool framePool;                     ///< Buffers for Camera frames.
+    BoundedQueue<FrameTask> capturedQueue;   ///< Capture -> inference.
+    /// Replaces capturedQueue when PipelineConfig::schedule is set.
+    std::unique_ptr<DeadlineScheduler<FrameTask>> scheduler;
+    BoundedQueue<FrameTask> detectedQueue;   ///< Inference -> projection.
+    BoundedQueue<FrameTask> projectedQueue;  ///< Projection -> output.
+    BoundedQueue<FrameTask> spareTasks;      ///< Output -> capture, for reuse.
+
+    StageStats captureStats{"capture"};
+    StageStats inferenceStats{"inference"};
+    StageStats projectionStats{"projection"};
+    StageStats outputStats{"output"};
+    std::vector<const StageStats*> stageList;  ///< Stats in pipeline order.
+
+    std::vector<DetectionState> sources;  ///< Detection state, by source index.
+    std::unique_ptr<AsyncDetector> asyncDetector;  ///< Parallel instances.
+    Detections shifted;                ///< Crop detections in frame pixels.
+    std::vector<cv::Rect> gateRegions;  ///< Track boxes for the motion gate.
+    /// Taken to add sources or gates, and by gateStats() to read them.
+    mutable std::mutex sourcesGuard;
+    Histogram* frameLatency = nullptr;   ///< Capture to output, if measured.
+
+    double averageInferenceMs = 0.0;  ///< Moving average of inference time.
+    int framesSinceResize = 0;        ///< Frames since the last size change.
+    int maxInputSize = 0;             ///< Input size when run() started.
+
+    std::atomic<bool> stopping{false};               ///< Set by stop().
+    std::chrono::steady_clock::time_point started;  ///< When run() began.
+    std::vector<std::thread> workers;  ///< Capture, inference, projection.
+};
@@ -0,0 +1,169 @@
+// Copyright 2026 Sai Surya Sriramoju
+
+/**
+ * @file Preprocessor.h
+ * @brief Declaration of the Preprocessor class that builds network input blobs.
+ * @author Sai Surya Sriramoju
+ * @date 10/17/2026
+ */
+
+#pragma once
+
+#include <vector>
+#include <opencv2/opencv.hpp>
+
+/**
+ * @brief Maps network input pixels back to frame pixels.
+ *
+ * A frame pixel is (net - pad) / scale on each axis. Letterboxing uses the
+ * same scale on both axes; a plain stretch uses different ones and no pad.
+ */
+struct LetterboxTransform {
+    cv::Size inputSize;   ///< Network input size the outputs refer to.
+    float scaleX = 1.0f;  ///< Horizontal frame -> network scale.
+    float scaleY = 1.0f;  ///< Vertical frame -> network scale.
+    float padX = 0.0f;    ///< Left padding in network pixels.
+    float padY = 0.0f;    ///< Top padding in network pixels.
+
+    /**
+     * @brief Transform for outputs computed on @p frameSize itself.
+     */
+    static LetterboxTransform identity(cv::Size frameSize) {
+        LetterboxTransform transform;
+        transform.inputSize = frameSize;
+        return transform;
+    }
+};
+
+/**
+ * @brief Named network input resolutions trading accuracy for latency.
+ */
+enum class InputMode {
+    Fast = 320,      ///< Lowest latency, for when the CPU is saturated.
+    Balanced = 416,  ///< The YOLOv3 default.
+    Accurate = 608   ///< Best small-object recall, highest latency.
+};
+
+/**
+ * @brief How Preprocessor builds the network input.
+ */
+struct PreprocessOptions {
+    /// Build the blob in one fused pass instead of resize + blobFromImage.
+    bool fused = true;
+    /// Apply the OpenCVProcessor 5x5 Gaussian blur inside the fused pass, at
+    /// network resolution. Only honoured when fused is set.
+    bool gaussianBlur = false;
+};
+
+/**
+ * @class Preprocessor
+ * @brief Letterboxes frames into the network input size and packs them as blobs.
+ *
+ * The frame is scaled to fit the square input while keeping its aspect
+ * ratio and the remaining border is filled with grey, so boxes are not
+ * distorted as they are with a plain resize. The letterbox image and the
+ * blob are members reused across frames.
+ *
+ * In fused mode (the default) the bilinear resize, BGR to RGB swap, 1/255
+ * scaling, optional blur and HWC to CHW packing all happen in a single pass
+ * that reads the source rows it needs once and writes each blob element
+ * once, split into row tiles processed in parallel. The separate path
+ * (letterbox() followed by cv::dnn::blobFromImage) is kept as a reference.
+ */
+class Preprocessor {
+ public:
+    /**
+     * @brief Creates a preprocessor for a @p inputSize x @p inputSize network.
+     */
+    explicit Preprocessor(int inputSize = static_cast<int>(InputMode::Balanced));
+
+    /**
+     * @brief Changes the network input size.
+     *
+     * @param size Side of the square input; a positive multiple of 32.
+     * @throws std::invalid_argument if @p size is not a positive multiple of 32.
+     */
+    void setInputSize(int size);
+
+    /**
+     * @brief Returns the side of the square network input.
+     */
+    int inputSize() const { return side; }
+
+    /**
+     * @brief Selects the fused or separate path and the fused filters.
+     */
+    void setOptions(const PreprocessOptions& options) { settings = options; }
+
+    /**
+     * @brief Returns the preprocessing options in use.
+     */
+    const PreprocessOptions& options() const { return settings; }
+
+    /**
+     * @brief Computes the letterbox mapping of a @p frameSize frame.
+     */
+    LetterboxTransform computeTransform(cv::Size frameSize) const;
+
+    /**
+     * @brief Letterboxes @p frame into @p dst at the current input size.
+     *
+     * @param frame The BGR frame to letterbox.
+     * @param dst Receives the input-size image; reused if already allocated.
+     * @return LetterboxTransform - How to map outputs back onto @p frame.
+     */
+    LetterboxTransform letterbox(const cv::Mat& frame, cv::Mat& dst) const;
+
+    /**
+     * @brief Builds the 1 x 3 x S x S RGB blob for one frame.
+     *
+     * @param frame The BGR frame.
+     * @param transform Receives the mapping back onto @p frame.
+     * @return const cv::Mat& - The blob, valid until the next call.
+     */
+    const cv::Mat& blobFromFrame(const cv::Mat& frame,
+                                 LetterboxTransform& transform);
+
+    /**
+     * @brief Builds the N x 3 x S x S RGB blob for several frames.
+     *
+     * @param frames The BGR frames; they may have different sizes.
+     * @param transforms Receives one mapping per frame.
+     * @return const cv::Mat& - The blob, valid until the next call.
+     */
+    const cv::Mat& blobFromFrames(const std::vector<cv::Mat>& frames,
+                                  std::vector<LetterboxTransform>& transforms);
+
+    /**
+     * @brief Letterboxes a CV_8UC3 frame straight into a planar RGB float tensor.
+     *
+     * @param frame The BGR frame.
+     * @param transform Mapping from computeTransform(frame.size()).
+     * @param dst The 3 x S x S destination planes (R, G, B), values in [0, 1].
+     */
+    void fusedLetterbox(const cv::Mat& frame, const LetterboxTransform& transform,
+                        float* dst);
+
+ private:
+    /**
+     * @brief Rebuilds the horizontal sampling tables for a new frame width.
+     */
+    void buildColumnTables(int frameWidth, int innerWidth);
+
+    /**
+     * @brief Writes image rows [begin, end) of the fused pass.
+     */
+    void fusedRows(const cv::Mat& frame, const LetterboxTransform& transform,
+                   int begin, int end, float* scratch, float* dst) const;
+
+    int side;                          ///< Network input side in pixels.
+    PreprocessOptions settings;        ///< Fused or separate path.
+    std::vector<cv::Mat> letterboxed;  ///< Reused letterbox images.
+    cv::Mat blob;                      ///< Reused network input blob.
+    int tableFrameWidth = 0;           ///< Frame width the tables are for.
+    int tableInnerWidth = 0;           ///< Letterbox width the tables are for.
+    std::vector<int> columnOffset0;    ///< Left source byte offset per column.
+    std::vector<int> columnOffset1;    ///< Right source byte offset per column.
+    std::vector<float> columnWeight;   ///< Weight of the right source pixel.
+    std::vector<float> scratch;        ///< Blurred rows, one block per stripe.
+};
@@ -0,0 +1,356 @@
+// Copyright 2026 Sai Surya Sriramoju
+
+/**
+ * @file Recording.h
+ * @brief Declaration of the indexed record/replay file format for frames
+ *        and detections.
+ * @author Sai Surya Sriramoju
+ * @date 10/17/2026
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <opencv2/opencv.hpp>
+
+#include "BoundedQueue.h"
+#include "DetectionStream.h"
+#include "MappedFile.h"
+
+/// "PREC" in little-endian order; starts the file.
+const uint32_t kRecordingMagic = 0x43455250;
+/// "PRCD"; starts every record, so a file without index can be scanned.
+const uint32_t kRecordMagic = 0x44435250;
+/// "PIDX"; ends an index written by RecordingWriter::close().
+const uint32_t kIndexMagic = 0x58444950;
+/// Version of the layout below.
+const uint32_t kRecordingVersion = 1;
+/// Records start on this boundary, so raw pixels are cache-line aligned.
+const size_t kRecordAlignment = 64;
+
+/**
+ * @brief What a record holds.
+ */
+enum class RecordKind : uint16_t {
+    Frame = 1,      ///< One image.
+    Detections = 2  ///< StreamRecord array of one frame.
+};
+
+/**
+ * @brief How a frame payload is stored.
+ */
+enum class FrameEncoding : uint16_t {
+    Raw = 0,  ///< Rows of pixels, tightly packed; readable in place.
+    Jpeg = 1  ///< JPEG bytes, decoded on read.
+};
+
+/**
+ * @brief Start of the file. Host (little-endian) byte order throughout.
+ */
+struct RecordingHeader {
+    uint32_t magic = kRecordingMagic;      ///< kRecordingMagic.
+    uint32_t version = kRecordingVersion;  ///< kRecordingVersion.
+    int64_t startNs = 0;   ///< Wall-clock time of timestamp 0, ns since epoch.
+    uint64_t reserved[6] = {};  ///< Zero; pads to kRecordAlignment.
+};
+static_assert(sizeof(RecordingHeader) == kRecordAlignment,
+              "recording header must fill one alignment unit");
+
+/**
+ * @brief Header of one record; the payload follows it directly and the
+ *        next record starts on the next kRecordAlignment boundary.
+ */
+struct RecordHeader {
+    uint32_t magic = kRecordMagic;  ///< kRecordMagic.
+    uint16_t kind = 0;              ///< RecordKind.
+    uint16_t source = 0;            ///< Camera/source index.
+    uint64_t sequence = 0;          ///< Capture sequence number.
+    int64_t timestampNs = 0;        ///< Capture time since the recording start.
+    uint64_t payloadSize = 0;       ///< Bytes of payload.
+    uint16_t encoding = 0;          ///< FrameEncoding of a frame.
+    uint16_t type = 0;              ///< OpenCV type of a raw frame, e.g. CV_8UC3.
+    int32_t width = 0;              ///< Frame width in pixels.
+    int32_t height = 0;             ///< Frame height in pixels.
+    uint32_t reserved[5] = {};      ///< Zero.
+};
+static_assert(sizeof(RecordHeader) == kRecordAlignment,
+              "record header must fill one alignment unit");
+
+/**
+ * @brief One entry of the index at the end of the file.
+ */
+struct IndexEntry {
+    uint64_t offset = 0;      ///< File offset of the RecordHeader.
+    int64_t timestampNs = 0;  ///< Copy of the record's timestamp.
+    uint64_t sequence = 0;    ///< Copy of the record's sequence number.
+    uint16_t kind = 0;        ///< Copy of the record's kind.
+    uint16_t source = 0;      ///< Copy of the record's source.
+    uint32_t reserved = 0;    ///< Zero.
+};
+static_assert(sizeof(IndexEntry) == 32, "index entry must be packed");
+
+/**
+ * @brief Last bytes of a closed file, after the index entries.
+ */
+struct IndexTrailer {
+    uint64_t indexOffset = 0;   ///< File offset of the first IndexEntry.
+    uint64_t count = 0;         ///< Number of entries.
+    uint32_t magic = kIndexMagic;  ///< kIndexMagic.
+    uint32_t reserved[3] = {};  ///< Zero.
+};
+static_assert(sizeof(IndexTrailer) == 32, "index trailer must be packed");
+
+/**
+ * @brief How RecordingWriter stores frames.
+ */
+struct RecorderConfig {
+    /// Raw frames replay without decoding but take ~6 MB per 1080p frame.
+    FrameEncoding encoding = FrameEncoding::Jpeg;
+    int jpegQuality = 90;  ///< 0..100, for FrameEncoding::Jpeg.
+    /// Records waiting for the writer thread; beyond this the oldest
+    /// waiting one is dropped and counted.
+    size_t queueCapacity = 16;
+};
+
+/**
+ * @class RecordingWriter
+ * @brief Appends frames and detections to a recording file.
+ *
+ * Records are only ever appended; close() appends the index. A file that
+ * was never closed (e.g. after a crash) has no index and is scanned by
+ * RecordingReader instead, up to the last complete record. The writer may
+ * be shared by the capture and output threads.
+ *
+ * The write calls only queue a record: a thread of the writer encodes it
+ * and puts it on disk, so a slow disk or JPEG encode never holds up the
+ * callers. When the queue is full the oldest waiting record is dropped
+ * and counted by dropped().
+ */
+class RecordingWriter {
+ public:
+    /**
+     * @brief Creates or truncates @p path and writes the file header.
+     *
+     * @throws std::runtime_error if the file cannot be created.
+     */
+    explicit RecordingWriter(const std::string& path,
+                             const RecorderConfig& config = RecorderConfig());
+
+    /**
+     * @brief Writes the index and closes the file.
+     */
+    ~RecordingWriter();
+
+    RecordingWriter(const RecordingWriter&) = delete;
+    RecordingWriter& operator=(const RecordingWriter&) = delete;
+
+    /**
+     * @brief Queues one frame; its pixels are copied, so the caller may draw
+     *        on it afterwards.
+     *
+     * @param source Camera/source index.
+     * @param sequence Capture sequence number.
+     * @param captured Capture time.
+     * @param frame The image; any type for Raw, 8-bit 1 or 3 channels for Jpeg.
+     * @return bool - False once writing failed; see error().
+     */
+    bool writeFrame(size_t source, uint64_t sequence,
+                    std::chrono::steady_clock::time_point captured,
+                    const cv::Mat& frame);
+
+    /**
+     * @brief Queues one frame that is already JPEG-compressed, e.g. an
+     *        MJPEG payload, to be stored without decoding or re-encoding it.
+     *
+     * @param jpeg The JPEG bytes as a continuous byte matrix. The buffer is
+     *        referenced, not copied, and must not be overwritten afterwards.
+     * @return bool - False once writing failed or if @p jpeg is not a JPEG.
+     */
+    bool writeEncodedFrame(size_t source, uint64_t sequence,
+                           std::chrono::steady_clock::time_point captured,
+                           const cv::Mat& jpeg);
+
+    /**
+     * @brief Queues the detections of one frame.
+     *
+     * @return bool - False once writing failed; see error().
+     */
+    bool writeDetections(size_t source, uint64_t sequence,
+                         std::chrono::steady_clock::time_point captured,
+                         const std::vector<StreamRecord>& records);
+
+    /**
+     * @brief Writes the queued records, appends the index and closes the
+     *        file; further writes fail.
+     */
+    void close();
+
+    /**
+     * @brief Returns the number of records written so far; after close()
+     *        every record that was not dropped.
+     */
+    uint64_t records() const;
+
+    /**
+     * @brief Returns the number of records dropped because the writer
+     *        thread fell behind.
+     */
+    size_t dropped() const { return queue.dropped(); }
+
+    /**
+     * @brief Returns why writing stopped, empty while it works.
+     */
+    std::string error() const;
+
+ private:
+    /**
+     * @brief A record waiting for the writer thread.
+     */
+    struct Pending {
+        RecordHeader header;                           ///< Without timestamp.
+        std::chrono::steady_clock::time_point captured;  ///< Capture time.
+        /// Copied pixels to store raw or encode, or the JPEG bytes.
+        cv::Mat image;
+        bool encode = false;                 ///< JPEG-encode @ref image.
+        std::vector<StreamRecord> records;   ///< Payload of detections.
+    };
+
+    /**
+     * @brief Queues @p item unless writing has stopped.
+     */
+    bool enqueue(Pending item);
+
+    /**
+     * @brief Writer thread: encodes and appends queued records.
+     */
+    void writeLoop();
+
+    /**
+     * @brief Appends a record; the lock must be held.
+     */
+    bool append(RecordHeader header,
+                std::chrono::steady_clock::time_point captured,
+                const char* payload);
+
+    /**
+     * @brief Writes @p size bytes at the end of the file; the lock must be held.
+     */
+    bool writeAll(const void* data, size_t size);
+
+    RecorderConfig config;            ///< Frame encoding.
+    mutable std::mutex guard;         ///< Guards the file, index and failure.
+    int fd = -1;                      ///< The file, -1 once closed.
+    uint64_t offset = 0;              ///< Current end of the file.
+    std::chrono::steady_clock::time_point origin;  ///< Timestamp 0.
+    std::vector<IndexEntry> index;    ///< Entries of the records so far.
+    std::vector<uchar> encoded;       ///< JPEG buffer of the writer thread.
+    std::string failure;              ///< First error.
+    std::atomic<bool> failed{false};  ///< Set once @ref failure is.
+    BoundedQueue<Pending> queue;      ///< Records for the writer thread.
+    std::mutex spareGuard;            ///< Guards @ref spare.
+    /// Pixel buffers the writer thread is done with, reused for copies.
+    std::vector<cv::Mat> spare;
+    std::thread writer;               ///< Runs writeLoop().
+};
+
+/**
+ * @brief A record as found by RecordingReader.
+ */
+struct RecordView {
+    const RecordHeader* header = nullptr;  ///< Header inside the mapping.
+    const char* payload = nullptr;         ///< Payload inside the mapping.
+};
+
+/**
+ * @class RecordingReader
+ * @brief Memory-maps a recording for replay, seeking and inspection.
+ *
+ * Nothing is read through a stream buffer: payloads are accessed where
+ * they lie in the page cache. Raw frames are returned as cv::Mat headers
+ * over the mapping without a copy; JPEG frames are decoded straight from
+ * it. Frames are numbered in file order.
+ */
+class RecordingReader {
+ public:
+    /**
+     * @brief Maps @p path and loads or rebuilds its index.
+     *
+     * @throws std::runtime_error if the file is not a recording.
+     */
+    explicit RecordingReader(const std::string& path);
+
+    /**
+     * @brief Returns true if the index was read from the file rather than
+     *        rebuilt by scanning an unclosed one.
+     */
+    bool indexed() const { return hadIndex; }
+
+    /**
+     * @brief Returns the number of frames of every source.
+     */
+    size_t frameCount() const { return frameRecords.size(); }
+
+    /**
+     * @brief Returns frame @p i's header and payload.
+     */
+    const RecordView& frameRecord(size_t i) const { return frameRecords.at(i); }
+
+    /**
+     * @brief Returns frame @p i.
+     *
+     * A raw frame is a read-only view of the mapping, valid while the reader
+     * lives; clone() it before drawing on it. A JPEG frame is decoded.
+     */
+    cv::Mat frame(size_t i) const;
+
+    /**
+     * @brief Copies the detections recorded for frame @p i into @p records.
+     *
+     * @return bool - False if none were recorded for it.
+     */
+    bool detections(size_t i, std::vector<StreamRecord>& records) const;
+
+    /**
+     * @brief Returns the first frame at or after @p timestampNs (since the
+     *        recording start), or frameCount() if there is none, in
+     *        O(log frameCount()).
+     */
+    size_t seek(int64_t timestampNs) const;
+
+    /**
+     * @brief Returns the wall-clock time of timestamp 0, ns since the epoch.
+     */
+    int64_t startNs() const { return header->startNs; }
+
+ private:
+    /**
+     * @brief Reads the index written by close(); false if there is none.
+     */
+    bool readIndex();
+
+    /**
+     * @brief Rebuilds the index by walking the records from the start.
+     */
+    void scan();
+
+    /**
+     * @brief Adds the record at @p offset to the lookup tables; false if no
+     *        complete record starts there.
+     */
+    bool add(uint64_t offset);
+
+    MappedFile file;                       ///< The mapping.
+    const RecordingHeader* header = nullptr;  ///< Start of the mapping.
+    bool hadIndex = false;                 ///< Index read, not rebuilt.
+    std::vector<RecordView> frameRecords;  ///< Frames in file order.
+    /// Detections record per (source, sequence).
+    std::map<std::pair<uint16_t, uint64_t>, RecordView> detectionRecords;
+};
@@ -0,0 +1,212 @@
+// Copyright 2026 Sai Surya Sriramoju
+
+/**
+ * @file SharedRing.h
+ * @brief Declaration of the shared-memory ring that publishes frames and
+ *        detection records to other processes.
+ * @author Sai Surya Sriramoju
+ * @date 10/17/2026
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <opencv2/opencv.hpp>
+
+#include "DetectionStream.h"
+
+/// "PRNG" in little-endian order; starts the segment.
+const uint32_t kRingMagic = 0x474E5250;
+/// Version of the segment layout below.
+const uint32_t kRingVersion = 1;
+
+static_assert(ATOMIC_LLONG_LOCK_FREE == 2,
+              "ring counters must be lock-free to live in shared memory");
+
+/**
+ * @brief Start of the segment, written once by the publisher.
+ */
+struct RingHeader {
+    uint32_t magic = kRingMagic;      ///< kRingMagic.
+    uint32_t version = kRingVersion;  ///< kRingVersion.
+    uint32_t slots = 0;               ///< Number of slots.
+    uint32_t maxRecords = 0;          ///< Records a slot holds.
+    uint64_t slotSize = 0;            ///< Bytes per slot, header included.
+    uint64_t frameBytes = 0;          ///< Pixel bytes a slot holds.
+    int64_t publisherPid = 0;         ///< Process that owns the segment.
+    /// Messages published so far; message n lives in slot n % slots.
+    std::atomic<uint64_t> published{0};
+    uint64_t reserved[2] = {};        ///< Zero; pads to 64 bytes.
+};
+static_assert(sizeof(RingHeader) == 64, "ring header must fill a cache line");
+
+/**
+ * @brief Start of every slot; the records and then the pixels follow.
+ */
+struct SlotHeader {
+    /// Sequence lock: odd while the publisher rewrites the slot, bumped by
+    /// two per message, so a reader that saw the same even value before
+    /// and after reading knows it read one whole message.
+    std::atomic<uint64_t> lock{0};
+    uint64_t message = 0;     ///< Ring sequence number of the content.
+    StreamFrameHeader frame;  ///< Source, sequence, time and record count.
+    int32_t width = 0;        ///< Frame width, 0 if no pixels were published.
+    int32_t height = 0;       ///< Frame height.
+    int32_t type = 0;         ///< OpenCV type of the frame.
+    uint32_t reserved = 0;    ///< Zero.
+};
+static_assert(sizeof(SlotHeader) == 64, "slot header must fill a cache line");
+
+/**
+ * @brief Size of a ring, fixed when the publisher creates it.
+ */
+struct RingConfig {
+    uint32_t slots = 8;  ///< Messages kept; readers further behind lose some.
+    /// Pixel bytes per slot; larger frames are published without pixels.
+    /// The default holds one 1080p BGR frame.
+    uint64_t frameBytes = 1920ull * 1080 * 3;
+    uint32_t maxRecords = 256;  ///< Records per slot; the rest are cut.
+};
+
+/**
+ * @class RingPublisher
+ * @brief Publishes frames and detection records into a POSIX shared-memory
+ *        ring for any number of local readers.
+ *
+ * There is a single writer and it never waits for readers: a slow reader
+ * is lapped and skips what was overwritten, so a stalled logger cannot
+ * slow perception down. Readers keep no state in the segment, so they can
+ * come and go at any time.
+ */
+class RingPublisher {
+ public:
+    /**
+     * @brief Creates (or replaces) the segment @p name, e.g. "/perception".
+     *
+     * @throws std::runtime_error if the segment cannot be created.
+     */
+    explicit RingPublisher(const std::string& name,
+                           const RingConfig& config = RingConfig());
+
+    /**
+     * @brief Unmaps and unlinks the segment; mapped readers keep theirs.
+     */
+    ~RingPublisher();
+
+    RingPublisher(const RingPublisher&) = delete;
+    RingPublisher& operator=(const RingPublisher&) = delete;
+
+    /**
+     * @brief Publishes one frame and its records.
+     *
+     * @param source Camera/source index.
+     * @param sequence Capture sequence number.
+     * @param captured Capture time.
+     * @param frame Image to publish, empty for records only; published
+     *        without pixels if larger than RingConfig::frameBytes.
+     * @param records The frame's detections or tracks.
+     * @return uint64_t - Ring sequence number of the message.
+     */
+    uint64_t publish(size_t source, uint64_t sequence,
+                     std::chrono::steady_clock::time_point captured,
+                     const cv::Mat& frame,
+                     const std::vector<StreamRecord>& records);
+
+    /**
+     * @brief Returns the number of messages published.
+     */
+    uint64_t published() const;
+
+ private:
+    std::string name;                ///< Segment name.
+    RingHeader* header = nullptr;    ///< Start of the mapping.
+    size_t length = 0;               ///< Mapped bytes.
+    std::chrono::nanoseconds epochOffset{0};  ///< steady_clock to epoch.
+};
+
+/**
+ * @brief A message read in place from the ring.
+ *
+ * Valid only until the publisher laps the reader; check
+ * RingSubscriber::valid() after using it.
+ */
+struct RingView {
+    uint64_t message = 0;           ///< Ring sequence number.
+    uint64_t lock = 0;              ///< Slot lock value when acquired.
+    const SlotHeader* slot = nullptr;  ///< Slot inside the mapping.
+    StreamFrameHeader frame;        ///< Copy of the frame header.
+    const StreamRecord* records = nullptr;  ///< frame.count records in place.
+    cv::Mat image;  ///< Read-only view of the pixels; empty if none.
+};
+
+/**
+ * @class RingSubscriber
+ * @brief Reads the messages of a RingPublisher from another process.
+ */
+class RingSubscriber {
+ public:
+    /**
+     * @brief Maps the segment @p name read-only.
+     *
+     * @param name Segment name given to the publisher.
+     * @param fromStart Read the messages still in the ring first instead of
+     *        starting with the next one published.
+     * @throws std::runtime_error if there is no such ring.
+     */
+    explicit RingSubscriber(const std::string& name, bool fromStart = false);
+
+    /**
+     * @brief Unmaps the segment.
+     */
+    ~RingSubscriber();
+
+    RingSubscriber(const RingSubscriber&) = delete;
+    RingSubscriber& operator=(const RingSubscriber&) = delete;
+
+    /**
+     * @brief Waits up to @p timeout for the next message and points @p view
+     *        at it without copying.
+     *
+     * @return bool - False on timeout.
+     */
+    bool acquire(RingView& view, std::chrono::microseconds timeout);
+
+    /**
+     * @brief Returns true if the message of @p view was not overwritten
+     *        since acquire(), i.e. whatever was read from it is consistent.
+     */
+    bool valid(const RingView& view) const;
+
+    /**
+     * @brief Copies the next message out of the ring.
+     *
+     * @param frame Receives the frame header.
+     * @param records Receives the records; reused.
+     * @param image Receives the pixels, if any were published; reused.
+     * @param timeout Maximum time to wait.
+     * @return bool - False on timeout.
+     */
+    bool next(StreamFrameHeader& frame, std::vector<StreamRecord>& records,
+              cv::Mat& image, std::chrono::microseconds timeout);
+
+    /**
+     * @brief Returns how many messages were overwritten before they were read.
+     */
+    uint64_t lost() const { return lostMessages; }
+
+    /**
+     * @brief Returns the size the publisher gave the ring.
+     */
+    RingConfig config() const;
+
+ private:
+    const RingHeader* header = nullptr;  ///< Start of the mapping.
+    size_t length = 0;                   ///< Mapped bytes.
+    uint64_t nextMessage = 0;            ///< Next message to read.
+    uint64_t lostMessages = 0;           ///< Messages skipped.
+};
@@ -0,0 +1,112 @@
+// Copyright 2026 Sai Surya Sriramoju
+
+/**
+ * @file Tiling.h
+ * @brief Declaration of the tile planning and cross-tile box merging used
+ *        for tiled inference on high-resolution frames.
+ * @author Sai Surya Sriramoju
+ * @date 10/17/2026
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <opencv2/opencv.hpp>
+
+#include "Detections.h"
+#include "NMS.h"
+
+/**
+ * @brief How a frame is split into tiles for YOLO::inferTiled().
+ *
+ * Squashing a 4K or panoramic frame into a 416 x 416 input leaves distant
+ * people a few pixels tall. Tiling runs the network on overlapping
+ * sub-images at close to their native resolution instead, at the cost of
+ * one batched forward pass over columns x rows (+1) images.
+ */
+struct TilingConfig {
+    int columns = 1;  ///< Tiles across; 1 x 1 disables tiling.
+    int rows = 1;     ///< Tiles down.
+    /// Fraction of a tile shared with its neighbour, so that an object on a
+    /// border is seen whole by at least one tile when it is small enough.
+    float overlap = 0.2f;
+    /// Also run on the whole frame, so objects larger than a tile are found.
+    bool fullFrame = true;
+    /// Tiles are not made narrower or shorter than this many pixels; the
+    /// grid is reduced instead, so small frames and crops are not tiled.
+    int minTileSide = 416;
+    /// Intersection over the smaller box above which two boxes from
+    /// different tiles, one cut off by a tile border, are one object.
+    float mergeOverlap = 0.6f;
+
+    /**
+     * @brief Returns true if more than one tile is requested.
+     */
+    bool enabled() const { return columns * rows > 1; }
+
+    /**
+     * @brief Parses a grid such as "3x2" (columns x rows); "1x1" is off.
+     *
+     * @throws std::invalid_argument if @p grid is malformed.
+     */
+    static TilingConfig parse(const std::string& grid);
+};
+
+/**
+ * @brief Splits @p frame into the overlapping tile grid of @p config.
+ *
+ * Tiles have equal sizes; the last row and column end on the frame edge.
+ *
+ * @param frame Size of the frame or region to tile.
+ * @param config Grid, overlap and minimum tile side.
+ * @param tiles Receives the tiles, row by row; a single tile covering the
+ *        frame if it is not worth tiling.
+ */
+void planTiles(cv::Size frame, const TilingConfig& config,
+               std::vector<cv::Rect>& tiles);
+
+/**
+ * @class TileMerger
+ * @brief Merges per-tile detections into one set for the whole frame.
+ *
+ * Each tile has already been through NMS on its own. Across tiles two
+ * cases remain: an object inside an overlap is found whole by both tiles
+ * (ordinary duplicates, resolved by IoU like NMS), and an object crossing
+ * a border is found as two partial boxes whose IoU is low. The partial
+ * boxes are recognised by an edge lying on the inner border of their
+ * tile and a high intersection over the smaller box; they are replaced by
+ * their union with the higher score. Buffers are reused across calls.
+ */
+class TileMerger {
+ public:
+    /**
+     * @brief Merges the detections of all tiles of one frame.
+     *
+     * @param tiles Detections of each region, already in frame pixels.
+     * @param regions The region each entry of @p tiles was detected on.
+     * @param frame Size of the frame; its edges are not tile borders.
+     * @param config Merge threshold.
+     * @param nms IoU threshold and class awareness for duplicates.
+     * @param merged Receives the merged detections, best score first.
+     */
+    void merge(const std::vector<Detections>& tiles,
+               const std::vector<cv::Rect>& regions, cv::Size frame,
+               const TilingConfig& config, const NMSConfig& nms,
+               Detections& merged);
+
+ private:
+    /**
+     * @brief One candidate box with where it came from.
+     */
+    struct Candidate {
+        cv::Rect2f box;       ///< Box in frame pixels, grown by merging.
+        float score = 0.0f;   ///< Best score of the merged boxes.
+        int classId = 0;      ///< Class id.
+        size_t tile = 0;      ///< Index of the region it was detected on.
+        bool cut = false;     ///< Touches an inner border of its region.
+        bool merged = false;  ///< Absorbed into a better candidate.
+    };
+
+    std::vector<Candidate> candidates;  ///< Reused candidate list.
+};
@@ -0,0 +1,142 @@
+// Copyright 2026 Sai Surya Sriramoju
+
+/**
+ * @file Tracker.h
+ * @brief Declaration of the SORT-style MultiObjectTracker.
+ * @author Sai Surya Sriramoju
+ * @date 10/17/2026
+ */
+
+#pragma once
+
+#include <Eigen/Dense>
+#include <vector>
+#include <opencv2/opencv.hpp>
+
+#include "Detections.h"
+
+/**
+ * @brief A tracked object as reported to downstream consumers.
+ */
+struct Track {
+    int id = 0;            ///< Persistent id, unique for the tracker's life.
+    int classId = 0;       ///< Class of the detections it was built from.
+    float score = 0.0f;    ///< Score of the last matched detection.
+    cv::Rect2f box;        ///< Current (possibly predicted) box in pixels.
+    cv::Point2f velocity;  ///< Box centre velocity in pixels per frame.
+    int age = 0;           ///< Frames since the track was created.
+    int hits = 0;          ///< Detections matched so far.
+};
+
+/**
+ * @brief Tunables for MultiObjectTracker.
+ */
+struct TrackerConfig {
+    float iouThreshold = 0.3f;  ///< Minimum IoU to associate a detection.
+    int minHits = 2;    ///< Matches before a track is reported.
+    int maxMisses = 2;  ///< Detection rounds a track may go unmatched.
+    bool classAware = true;  ///< Only associate detections of the same class.
+};
+
+/**
+ * @brief Solves the rectangular linear assignment problem (Hungarian method).
+ *
+ * @param cost Row-major @p rows x @p cols cost matrix.
+ * @param rows Number of rows (e.g. tracks).
+ * @param cols Number of columns (e.g. detections).
+ * @return std::vector<int> - For every row the assigned column, or -1 when
+ *         there are more rows than columns; the total cost is minimal.
+ */
+std::vector<int> solveAssignment(const std::vector<double>& cost, int rows,
+                                 int cols);
+
+/**
+ * @class MultiObjectTracker
+ * @brief SORT tracker: a constant-velocity Kalman filter per object and
+ *        Hungarian assignment on IoU.
+ *
+ * Each track's filter state is the box centre, area and aspect ratio plus
+ * the velocities of the first three. Call update() on frames that ran the
+ * detector and predict() on the frames in between, so the detector only
+ * has to run every N frames while the tracks keep moving and keep their ids.
+ */
+class MultiObjectTracker {
+ public:
+    /**
+     * @brief Creates a tracker with no tracks.
+     */
+    explicit MultiObjectTracker(const TrackerConfig& config = TrackerConfig());
+
+    /**
+     * @brief Advances every track one frame and associates @p detections.
+     *
+     * @param detections Detections of the current frame.
+     * @return const std::vector<Track>& - Confirmed tracks matched in this
+     *         round, valid until the next call.
+     */
+    const std::vector<Track>& update(const Detections& detections);
+
+    /**
+     * @brief Advances every track one frame without detections.
+     *
+     * @return const std::vector<Track>& - The confirmed tracks at their
+     *         predicted positions, valid until the next call.
+     */
+    const std::vector<Track>& predict();
+
+    /**
+     * @brief Returns the tracks reported by the last update() or predict().
+     */
+    const std::vector<Track>& tracks() const { return visible; }
+
+    /**
+     * @brief Drops every track; ids keep counting up.
+     */
+    void reset();
+
+ private:
+    using State = Eigen::Matrix<double, 7, 1>;
+    using Covariance = Eigen::Matrix<double, 7, 7>;
+
+    /**
+     * @brief Filter and bookkeeping of one track.
+     */
+    struct Target {
+        State x;        ///< [cx, cy, area, aspect, vcx, vcy, varea].
+        Covariance P;   ///< State covariance.
+        Track track;    ///< Public view, refreshed after every step.
+        int misses = 0;  ///< Consecutive detection rounds without a match.
+    };
+
+    /**
+     * @brief Kalman prediction step of every target.
+     */
+    void step();
+
+    /**
+     * @brief Kalman correction of @p target with detection @p i.
+     */
+    void correct(Target& target, const Detections& detections, size_t i) const;
+
+    /**
+     * @brief Starts a target from detection @p i.
+     */
+    void spawn(const Detections& detections, size_t i);
+
+    /**
+     * @brief Refreshes the public box and velocity from the filter state.
+     */
+    static void refresh(Target& target);
+
+    /**
+     * @brief Rebuilds the list of reported tracks.
+     */
+    void publish();
+
+    TrackerConfig config;         ///< Tunables.
+    std::vector<Target> targets;  ///< Live tracks.
+    std::vector<Track> visible;   ///< Reported tracks.
+    std::vector<double> cost;     ///< Reused association cost matrix.
+    std::vector<bool> matched;    ///< Reused per-detection match flags.
+    int nextId = 1;               ///< Id of the next new track.
+};
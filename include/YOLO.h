@@ -9,16 +9,46 @@
 
 #pragma once
 
+#include <atomic>
+#include <memory>
 #include <string>
+#include <vector>
 #include <opencv2/opencv.hpp>
 
+#include "DetectionDecoder.h"
+#include "DetectorBackend.h"
+#include "Detections.h"
+#include "Metrics.h"
+#include "Preprocessor.h"
+#include "Tiling.h"
+
+/**
+ * @brief What YOLO::postprocess() does besides collecting pixel coordinates.
+ */
+struct PostprocessOptions {
+    bool print = true;     ///< Print the detection count to std::cout.
+    bool annotate = true;  ///< Draw boxes and labels onto the frame.
+};
+
+/**
+ * @brief Histograms YOLO::infer() records its steps into; nullptr entries
+ *        are not timed.
+ */
+struct InferenceTimers {
+    Histogram* preprocess = nullptr;  ///< Letterbox and blob construction.
+    Histogram* forward = nullptr;     ///< The backend's forward pass.
+    Histogram* decode = nullptr;      ///< Candidate collection.
+    Histogram* nms = nullptr;         ///< Non-maximum suppression.
+};
+
 /**
  * @class YOLO
  * @brief Handles object detection and classification using the YOLO model.
  * 
  * This class provides an interface to interact with the YOLO (You Only Look Once) model 
- * using OpenCV's DNN module. It allows for object detection and classification on 
- * frames (images) captured from a camera or any other source.
+ * through a DetectorBackend (OpenCV's DNN module by default). It allows for object
+ * detection and classification on frames (images) captured from a camera or any
+ * other source.
  */
 class YOLO {
  public:
@@ -32,6 +62,81 @@ class YOLO {
      */
     YOLO();
 
+    /**
+     * @brief Loads the model described by @p config.
+     * 
+     * Relative model and cfg paths are resolved against modelsDir. For INT8
+     * with a calibration directory, up to config.calibrationFrames of its
+     * images are preprocessed and used to quantise the network.
+     * 
+     * @param config Backend, model, output layout and precision.
+     * @throws std::runtime_error if the model cannot be loaded.
+     * @throws std::invalid_argument if the configuration is invalid.
+     */
+    explicit YOLO(const BackendConfig& config);
+
+    /**
+     * @brief Returns the configuration the model was loaded with.
+     */
+    const BackendConfig& backendConfig() const { return settings; }
+
+    /**
+     * @brief Returns a description of the backend, e.g. "opencv onnx fp32".
+     */
+    std::string backendName() const { return backend->describe(); }
+
+    /**
+     * @brief Returns true if the model only accepts its export input size.
+     */
+    bool fixedInputSize() const { return settings.inputSize > 0; }
+
+    /**
+     * @brief Runs the network on a frame and returns the decoded detections.
+     * 
+     * Unlike detect(), this neither prints nor annotates the frame. All
+     * buffers are owned by the detector and reused, so steady-state calls do
+     * not allocate on the decode path.
+     * 
+     * @param frame The input frame (image) in which objects are to be detected.
+     * @return const Detections& - Detections in frame pixels, valid until the
+     *         next call on this detector.
+     */
+    const Detections& infer(const cv::Mat& frame);
+
+    /**
+     * @brief Runs the network on overlapping tiles of a frame.
+     * 
+     * The tiles (plus the whole frame with TilingConfig::fullFrame) go
+     * through one batched forward pass, are decoded per tile and merged
+     * across tile borders by a TileMerger. Frames too small for the grid
+     * (see TilingConfig::minTileSide) are detected as by infer(). Models
+     * with a fixed input size are assumed to have a fixed batch of one as
+     * well and run the tiles one after another.
+     * 
+     * @param frame The input frame, or a region of one.
+     * @param tiling Grid and merge settings.
+     * @return const Detections& - Detections in frame pixels, valid until the
+     *         next call on this detector.
+     */
+    const Detections& inferTiled(const cv::Mat& frame, const TilingConfig& tiling);
+
+    /**
+     * @brief Runs the network on a blank frame to get first-frame costs out
+     *        of the way.
+     * 
+     * The first pass at a given input size allocates every layer's buffers,
+     * packs the convolution weights and grows the decoder workspace, which
+     * makes it several times slower than the following ones. Warming up
+     * every size the pipeline may switch to lets the first real frame meet
+     * its latency budget. The requested input size is restored afterwards.
+     * 
+     * @param sizes Input sizes to warm up; empty for the current one only.
+     * @param frameSize Size of the blank frame, ideally the camera's.
+     * @return double - Time spent, in milliseconds.
+     */
+    double warmUp(const std::vector<int>& sizes = std::vector<int>(),
+                  cv::Size frameSize = cv::Size(640, 480));
+
     /**
      * @brief Detects objects in the given frame using the YOLO model.
      * 
@@ -42,6 +147,156 @@ class YOLO {
      */
     std::vector<double> detect(const cv::Mat& frame);
 
+    /**
+     * @brief Detects objects in several frames with one batched forward pass.
+     * 
+     * Packs the frames into a single NCHW blob, runs the network once and
+     * splits the outputs back per frame. Useful when several cameras deliver
+     * frames at the same time, as one large batch uses the CPU far better
+     * than several single-image passes. Models with a fixed input size are
+     * assumed to have a fixed batch of one and run the frames one by one.
+     * 
+     * @param frames The input frames; each one is annotated like in detect().
+     * @return std::vector<std::vector<double>> - Pixel coordinates per frame.
+     */
+    std::vector<std::vector<double>> detectBatch(
+        const std::vector<cv::Mat>& frames);
+
+    /**
+     * @brief Changes the network input resolution at runtime.
+     * 
+     * Safe to call from any thread; the next frame is letterboxed to the new
+     * size. Smaller inputs (320) cut latency roughly quadratically at the
+     * cost of small-object recall; larger ones (608) do the opposite.
+     * 
+     * @param size Side of the square input; a positive multiple of 32.
+     * @throws std::invalid_argument if @p size is not a positive multiple of
+     *         32, or differs from the size of a fixed-input model.
+     */
+    void setInputSize(int size);
+
+    /**
+     * @brief Switches to one of the named latency/accuracy input sizes.
+     * 
+     * @param mode InputMode::Fast (320), Balanced (416) or Accurate (608).
+     */
+    void setMode(InputMode mode);
+
+    /**
+     * @brief Returns the requested network input size.
+     */
+    int inputSize() const;
+
+    /**
+     * @brief Selects the fused or separate preprocessing path.
+     * 
+     * Must not be called while another thread is inside infer() or detect().
+     * 
+     * @param options The preprocessing options.
+     */
+    void setPreprocessOptions(const PreprocessOptions& options);
+
+    /**
+     * @brief Replaces the decoding thresholds and class filter.
+     * 
+     * Must not be called while another thread is inside infer() or detect().
+     * 
+     * @param config The new decoder configuration.
+     */
+    void setDecoderConfig(const DecoderConfig& config);
+
+    /**
+     * @brief Returns the preprocessing options in use.
+     */
+    const PreprocessOptions& preprocessOptions() const {
+        return preprocessor.options();
+    }
+
+    /**
+     * @brief Returns the decoding thresholds and class filter in use.
+     */
+    const DecoderConfig& decoderConfig() const { return decoder.config(); }
+
+    /**
+     * @brief Times the steps of infer() into @p timers.
+     * 
+     * The histograms may be shared between detectors running on different
+     * threads. Must not be called while another thread is inside infer().
+     * 
+     * @param timers The histograms; default-constructed to stop timing.
+     */
+    void setTimers(const InferenceTimers& timers);
+
+    /**
+     * @brief Returns the histograms infer() records into.
+     */
+    const InferenceTimers& timers() const { return stepTimers; }
+
+    /**
+     * @brief Changes the NMS thresholds and mode at runtime.
+     * 
+     * Safe to call from any thread; applies from the next decoded frame.
+     * 
+     * @param config The new NMS settings.
+     */
+    void setNMSConfig(const NMSConfig& config);
+
+    /**
+     * @brief Returns the NMS settings the next decoded frame will use,
+     *        including a setNMSConfig() not applied yet.
+     */
+    NMSConfig nmsConfig() const { return decoder.nmsConfig(); }
+
+    /**
+     * @brief Chooses whether postprocess() prints and annotates.
+     * 
+     * Headless deployments turn both off so no console I/O or drawing is
+     * left on the per-frame path. Must not be called while another thread
+     * is inside postprocess().
+     * 
+     * @param options The postprocessing options.
+     */
+    void setPostprocessOptions(const PostprocessOptions& options) {
+        reporting = options;
+    }
+
+    /**
+     * @brief Returns the postprocessing options in use.
+     */
+    const PostprocessOptions& postprocessOptions() const { return reporting; }
+
+    /**
+     * @brief Prints, annotates and returns the pixel coordinates of detections.
+     * 
+     * This is what detect() does after infer(); callers that obtained
+     * detections another way (e.g. on a crop) use it to report them alike.
+     * Printing and annotation follow setPostprocessOptions().
+     * 
+     * @param detections Detections in @p frame pixels.
+     * @param frame The frame to annotate in place.
+     * @return std::vector<double> - (u, v) pixel coordinates of every detection.
+     */
+    std::vector<double> postprocess(const Detections& detections,
+                                    const cv::Mat& frame);
+
+    /**
+     * @brief Like postprocess() above, but fills @p pixelCoords, reusing its
+     *        capacity, so that a caller keeping the vector does not allocate.
+     */
+    void postprocess(const Detections& detections, const cv::Mat& frame,
+                     std::vector<double>& pixelCoords);
+
+    /**
+     * @brief Draws boxes and labels for @p detections onto @p frame.
+     * 
+     * Independent of the postprocessing options and of the detector state,
+     * so it can run on another thread, e.g. a pipeline's output stage.
+     * 
+     * @param detections Detections in @p frame pixels.
+     * @param frame The frame to annotate in place.
+     */
+    static void annotate(const Detections& detections, const cv::Mat& frame);
+
     /**
      * @brief Classifies objects in the given frame.
      * 
@@ -53,6 +308,32 @@ class YOLO {
     void classify(const cv::Mat& frame);
 
  private:
-    cv::dnn::Net net;  // Adjusted spaces between code and comment
+    /**
+     * @brief Applies a pending setInputSize() to the preprocessor.
+     */
+    void applyInputSize();
+
+    /**
+     * @brief Returns the rows of a (possibly batched) output layer for image @p n.
+     */
+    static cv::Mat batchSlice(const cv::Mat& output, int n, int batchSize);
+
+    BackendConfig settings;                   ///< Model and precision.
+    std::unique_ptr<DetectorBackend> backend;  ///< Runs the network.
+    Preprocessor preprocessor;             ///< Letterbox and blob buffers.
+    /// Input size requested by setInputSize(), applied on the next frame.
+    std::atomic<int> requestedInputSize{static_cast<int>(InputMode::Balanced)};
+    LetterboxTransform transform;          ///< Mapping of the last frame.
+    std::vector<LetterboxTransform> batchTransforms;  ///< Per-frame mappings.
+    std::vector<cv::Mat> outputs;          ///< Reused network outputs.
+    std::vector<cv::Mat> slices;           ///< Per-image views of a batch.
+    DetectionDecoder decoder;              ///< Reused decode workspace.
+    PostprocessOptions reporting;          ///< Printing and annotation.
+    InferenceTimers stepTimers;            ///< Per-step latency histograms.
+    std::vector<cv::Rect> tileRegions;     ///< Regions of the tiled frame.
+    std::vector<cv::Mat> tileViews;        ///< Headers over those regions.
+    std::vector<Detections> tileDetections;  ///< Per-region detections.
+    TileMerger tileMerger;                 ///< Cross-tile merge workspace.
+    Detections tiled;                      ///< Result of inferTiled().
 };
 
@@ -0,0 +1,376 @@
+// Copyright 2026 Sai Surya Sriramoju
+
+/**
+ * @file Affinity.cpp
+ * @brief Implementation of the CPU list, NUMA and thread pinning helpers.
+ * @author Sai Surya Sriramoju
+ * @date 10/17/2026
+ */
+
+#include "Affinity.h"
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+namespace {
+/// Where Linux describes the NUMA nodes, followed by the node number.
+const char* kNodeRoot = "/sys/devices/system/node/node";
+/// Largest CPU number accepted in a list.
+const int kMaxCpu = 4095;
+
+/**
+ * @brief Parses a non-negative decimal number no larger than kMaxCpu.
+ */
+bool parseNumber(const std::string& text, int& value) {
+    if (text.empty() || text.size() > 4) {
+        return false;
+    }
+    value = 0;
+    for (char c : text) {
+        if (!std::isdigit(static_cast<unsigned char>(c))) {
+            return false;
+        }
+        value = 10 * value + (c - '0');
+    }
+    return value <= kMaxCpu;
+}
+
+/**
+ * @brief Removes surrounding blanks.
+ */
+std::string trim(const std::string& text) {
+    const size_t begin = text.find_first_not_of(" \t\r\n");
+    if (begin == std::string::npos) {
+        return std::string();
+    }
+    return text.substr(begin, text.find_last_not_of(" \t\r\n") - begin + 1);
+}
+
+/**
+ * @brief Appends one "a" or "a-b" item to @p cpus.
+ */
+bool appendRange(const std::string& item, CpuList& cpus) {
+    const size_t dash = item.find('-');
+    int first = 0;
+    int last = 0;
+    if (dash == std::string::npos) {
+        if (!parseNumber(item, first)) {
+            return false;
+        }
+        last = first;
+    } else if (!parseNumber(item.substr(0, dash), first) ||
+               !parseNumber(item.substr(dash + 1), last) || last < first) {
+        return false;
+    }
+    for (int cpu = first; cpu <= last; ++cpu) {
+        cpus.push_back(cpu);
+    }
+    return true;
+}
+
+/**
+ * @brief Sorts @p cpus and drops duplicates.
+ */
+void normalise(CpuList& cpus) {
+    std::sort(cpus.begin(), cpus.end());
+    cpus.erase(std::unique(cpus.begin(), cpus.end()), cpus.end());
+}
+
+/**
+ * @brief Reads the kernel's CPU list of @p node.
+ *
+ * @return bool - False if the node is not described.
+ */
+bool readNodeCpus(int node, CpuList& cpus) {
+    std::ifstream in(kNodeRoot + std::to_string(node) + "/cpulist");
+    std::string text;
+    if (!in || !std::getline(in, text)) {
+        return false;
+    }
+    cpus.clear();
+    std::stringstream items(text);
+    std::string item;
+    while (std::getline(items, item, ',')) {
+        item = trim(item);
+        if (!item.empty() && !appendRange(item, cpus)) {
+            return false;
+        }
+    }
+    normalise(cpus);
+    return true;
+}
+
+/**
+ * @brief Returns @p cpus[first, first + count) as a sorted list.
+ */
+CpuList slice(const CpuList& cpus, size_t first, size_t count) {
+    CpuList part(cpus.begin() + first, cpus.begin() + first + count);
+    normalise(part);
+    return part;
+}
+}  // namespace
+
+/**
+ * @brief Parses ranges, single CPUs and "node<N>" items.
+ *
+ * @param text The list, e.g. "0-3,8" or "node0,16".
+ * @return CpuList - Sorted CPUs; empty for an empty text.
+ */
+CpuList parseCpuList(const std::string& text) {
+    CpuList cpus;
+    std::stringstream items(text);
+    std::string item;
+    while (std::getline(items, item, ',')) {
+        item = trim(item);
+        if (item.empty()) {
+            continue;
+        }
+        if (item.compare(0, 4, "node") == 0) {
+            int node = 0;
+            if (!parseNumber(item.substr(4), node)) {
+                throw std::invalid_argument("Bad NUMA node '" + item + "'");
+            }
+            const CpuList nodeCpus = numaNodeCpus(node);
+            if (nodeCpus.empty()) {
+                throw std::invalid_argument("No NUMA node " + std::to_string(node));
+            }
+            cpus.insert(cpus.end(), nodeCpus.begin(), nodeCpus.end());
+        } else if (!appendRange(item, cpus)) {
+            throw std::invalid_argument("Bad CPU list item '" + item + "' in '" +
+                                        text + "'");
+        }
+    }
+    normalise(cpus);
+    return cpus;
+}
+
+/**
+ * @brief Parses ';' separated CPU lists.
+ *
+ * @param text The lists, e.g. "0-3;4-7".
+ * @return std::vector<CpuList> - One entry per list; empty for an empty text.
+ */
+std::vector<CpuList> parseCpuLists(const std::string& text) {
+    std::vector<CpuList> lists;
+    std::stringstream items(text);
+    std::string item;
+    while (std::getline(items, item, ';')) {
+        lists.push_back(parseCpuList(item));
+    }
+    return lists;
+}
+
+/**
+ * @brief Formats consecutive CPUs as ranges.
+ *
+ * @param cpus Sorted CPUs.
+ * @return std::string - E.g. "0-3,8"; empty for an empty list.
+ */
+std::string formatCpuList(const CpuList& cpus) {
+    std::string text;
+    for (size_t i = 0; i < cpus.size();) {
+        size_t j = i;
+        while (j + 1 < cpus.size() && cpus[j + 1] == cpus[j] + 1) {
+            ++j;
+        }
+        if (!text.empty()) {
+            text += ',';
+        }
+        text += std::to_string(cpus[i]);
+        if (j > i) {
+            text += '-' + std::to_string(cpus[j]);
+        }
+        i = j + 1;
+    }
+    return text;
+}
+
+/**
+ * @brief Picks the list of one instance or source.
+ *
+ * @param lists Lists by index.
+ * @param index The instance or source.
+ * @return const CpuList& - Its CPUs; empty if there are no lists.
+ */
+const CpuList& cpusFor(const std::vector<CpuList>& lists, size_t index) {
+    static const CpuList none;
+    if (lists.empty()) {
+        return none;
+    }
+    return lists[std::min(index, lists.size() - 1)];
+}
+
+/**
+ * @brief Reads the affinity mask of the process.
+ *
+ * @return CpuList - CPUs the scheduler may use for this process.
+ */
+CpuList allowedCpus() {
+    CpuList cpus;
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+        for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+            if (CPU_ISSET(cpu, &set)) {
+                cpus.push_back(cpu);
+            }
+        }
+    }
+#endif
+    if (cpus.empty()) {
+        const int count = std::max(1u, std::thread::hardware_concurrency());
+        for (int cpu = 0; cpu < count; ++cpu) {
+            cpus.push_back(cpu);
+        }
+    }
+    return cpus;
+}
+
+/**
+ * @brief Counts the NUMA nodes the kernel describes.
+ *
+ * @return int - Number of nodes, at least 1.
+ */
+int numaNodeCount() {
+    CpuList cpus;
+    int count = 0;
+    while (readNodeCpus(count, cpus)) {
+        ++count;
+    }
+    return std::max(count, 1);
+}
+
+/**
+ * @brief Returns the CPUs of one NUMA node.
+ *
+ * @param node Node number.
+ * @return CpuList - Its CPUs; empty if there is no such node.
+ */
+CpuList numaNodeCpus(int node) {
+    CpuList cpus;
+    if (readNodeCpus(node, cpus)) {
+        return cpus;
+    }
+    if (node == 0) {
+        return allowedCpus();  // No NUMA information: one node with everything.
+    }
+    return CpuList();
+}
+
+/**
+ * @brief Sets the affinity of the calling thread.
+ *
+ * @param cpus CPUs to run on; empty leaves the thread alone.
+ * @return bool - False if pinning failed or is not supported.
+ */
+bool pinCurrentThread(const CpuList& cpus) {
+    if (cpus.empty()) {
+        return true;
+    }
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int cpu : cpus) {
+        if (cpu < 0 || cpu >= CPU_SETSIZE) {
+            return false;
+        }
+        CPU_SET(cpu, &set);
+    }
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+    return false;
+#endif
+}
+
+/**
+ * @brief Lists instance, thread and placement combinations to measure.
+ *
+ * @param cpus CPUs available.
+ * @param nodes CPUs of every NUMA node.
+ * @param maxInstances Upper bound on instances, 0 for none.
+ * @return std::vector<Placement> - The baseline first, then by instances
+ *         and threads.
+ */
+std::vector<Placement> placementSweep(const CpuList& cpus,
+                                      const std::vector<CpuList>& nodes,
+                                      int maxInstances) {
+    CpuList usable = cpus;
+    normalise(usable);
+
+    // Usable CPUs per node, and all of them ordered node by node so that
+    // "compact" fills the lowest node first.
+    std::vector<CpuList> available;
+    CpuList ordered;
+    for (const CpuList& node : nodes) {
+        CpuList mine;
+        for (int cpu : node) {
+            if (std::binary_search(usable.begin(), usable.end(), cpu)) {
+                mine.push_back(cpu);
+            }
+        }
+        normalise(mine);
+        if (!mine.empty()) {
+            available.push_back(mine);
+            ordered.insert(ordered.end(), mine.begin(), mine.end());
+        }
+    }
+    for (int cpu : usable) {  // CPUs no node claims go last.
+        if (std::find(ordered.begin(), ordered.end(), cpu) == ordered.end()) {
+            ordered.push_back(cpu);
+        }
+    }
+
+    std::vector<Placement> sweep;
+    Placement baseline;
+    baseline.name = "unpinned";
+    baseline.threads = 0;
+    sweep.push_back(baseline);
+    const size_t total = ordered.size();
+    for (size_t instances = 1; instances <= total; instances *= 2) {
+        if (maxInstances > 0 && instances > static_cast<size_t>(maxInstances)) {
+            break;
+        }
+        for (size_t threads = 1; instances * threads <= total; threads *= 2) {
+            Placement placement;
+            placement.instances = static_cast<int>(instances);
+            placement.threads = static_cast<int>(threads);
+            placement.name = "unpinned";
+            sweep.push_back(placement);
+
+            placement.name = "compact";
+            for (size_t i = 0; i < instances; ++i) {
+                placement.cpus.push_back(slice(ordered, i * threads, threads));
+            }
+            sweep.push_back(placement);
+
+            if (available.size() < 2 || instances < 2) {
+                continue;  // Spreading one instance or one node is compact.
+            }
+            placement.name = "spread";
+            placement.cpus.clear();
+            for (size_t i = 0; i < instances; ++i) {
+                const CpuList& node = available[i % available.size()];
+                const size_t first = (i / available.size()) * threads;
+                if (first + threads > node.size()) {
+                    placement.cpus.clear();  // An instance would cross nodes.
+                    break;
+                }
+                placement.cpus.push_back(slice(node, first, threads));
+            }
+            if (!placement.cpus.empty()) {
+                sweep.push_back(placement);
+            }
+        }
+    }
+    return sweep;
+}
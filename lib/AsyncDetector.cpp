@@ -0,0 +1,156 @@
+// Copyright 2026 Sai Surya Sriramoju
+
+/**
+ * @file AsyncDetector.cpp
+ * @brief Implementation of the AsyncDetector class.
+ * @author Sai Surya Sriramoju
+ * @date 10/17/2026
+ */
+
+#include "AsyncDetector.h"
+
+#include <exception>
+#include <stdexcept>
+#include <utility>
+
+namespace {
+/// How long an idle worker waits before re-checking for shutdown.
+const std::chrono::milliseconds kPollInterval(50);
+
+/**
+ * @brief Queue depth for @p config.
+ */
+size_t queueDepth(const AsyncConfig& config) {
+    return config.maxPending > 0 ? config.maxPending
+                                 : 2 * static_cast<size_t>(config.instances);
+}
+}  // namespace
+
+/**
+ * @brief Constructor; loads the extra instances and starts one thread each.
+ *
+ * @param prototype Detector whose model and settings are replicated.
+ * @param config Number of instances, threads and queue depth.
+ */
+AsyncDetector::AsyncDetector(YOLO& prototype, const AsyncConfig& config)
+    : warmSizes(config.warmSizes),
+      requests(queueDepth(config), OverflowPolicy::Block) {
+    if (config.instances <= 0) {
+        throw std::invalid_argument("AsyncDetector needs at least one instance");
+    }
+    if (config.threadsPerInstance > 0) {
+        cv::setNumThreads(config.threadsPerInstance);
+    }
+    detectors.push_back(&prototype);
+    // The prototype may not have decoded since its last setNMSConfig().
+    DecoderConfig decoding = prototype.decoderConfig();
+    decoding.nms = prototype.nmsConfig();
+    for (int i = 1; i < config.instances; ++i) {
+        owned.emplace_back(new YOLO(prototype.backendConfig()));
+        YOLO& yolo = *owned.back();
+        yolo.setPreprocessOptions(prototype.preprocessOptions());
+        yolo.setDecoderConfig(decoding);
+        yolo.setTimers(prototype.timers());
+        yolo.setInputSize(prototype.inputSize());
+        detectors.push_back(&yolo);
+    }
+    for (size_t i = 0; i < detectors.size(); ++i) {
+        workers.emplace_back(&AsyncDetector::work, this, i,
+                             config.warmUp && i > 0, cpusFor(config.cpus, i));
+    }
+}
+
+/**
+ * @brief Destructor; drains the queue and joins the workers.
+ */
+AsyncDetector::~AsyncDetector() {
+    shutdown();
+    for (auto& worker : workers) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+}
+
+/**
+ * @brief Queues a frame for the next free instance.
+ *
+ * @param frame The frame to detect objects in.
+ * @param tiling Tile grid to detect on.
+ * @return std::future<Detections> - Becomes ready when the frame is done.
+ */
+std::future<Detections> AsyncDetector::submit(const cv::Mat& frame,
+                                              const TilingConfig& tiling) {
+    Request request;
+    request.frame = frame;
+    request.tiling = tiling;
+    std::future<Detections> result = request.result.get_future();
+    inFlight.fetch_add(1, std::memory_order_relaxed);
+    if (!requests.push(std::move(request))) {
+        inFlight.fetch_sub(1, std::memory_order_relaxed);
+        throw std::runtime_error("AsyncDetector has been shut down");
+    }
+    return result;
+}
+
+/**
+ * @brief Forwards an input size change to every instance.
+ *
+ * @param size Side of the square network input.
+ */
+void AsyncDetector::setInputSize(int size) {
+    std::lock_guard<std::mutex> lock(settingsGuard);
+    for (YOLO* detector : detectors) {
+        detector->setInputSize(size);  // Atomic; applied on the next frame.
+    }
+}
+
+/**
+ * @brief Forwards an NMS settings change to every instance.
+ *
+ * @param config The new NMS settings.
+ */
+void AsyncDetector::setNMSConfig(const NMSConfig& config) {
+    std::lock_guard<std::mutex> lock(settingsGuard);
+    for (YOLO* detector : detectors) {
+        detector->setNMSConfig(config);  // Applied on the next decode.
+    }
+}
+
+/**
+ * @brief Closes the queue; workers exit once it is drained.
+ */
+void AsyncDetector::shutdown() {
+    requests.close();
+}
+
+/**
+ * @brief Runs queued frames on one instance until the queue is drained.
+ *
+ * @param index The instance this thread owns.
+ * @param warmUp Warm the instance up first, at warmSizes and its own size.
+ * @param cpus CPUs to run on, empty for anywhere.
+ */
+void AsyncDetector::work(size_t index, bool warmUp, CpuList cpus) {
+    pinCurrentThread(cpus);  // Before the instance touches its buffers.
+    YOLO& detector = *detectors[index];
+    if (warmUp) {
+        detector.warmUp(warmSizes);
+    }
+    Request request;
+    while (!requests.drained()) {
+        if (!requests.pop(request, kPollInterval)) {
+            continue;
+        }
+        try {
+            request.result.set_value(
+                request.tiling.enabled()
+                    ? detector.inferTiled(request.frame, request.tiling)
+                    : detector.infer(request.frame));
+        } catch (...) {
+            request.result.set_exception(std::current_exception());
+        }
+        request.frame.release();
+        inFlight.fetch_sub(1, std::memory_order_relaxed);
+    }
+}
@@ -0,0 +1,379 @@
+// Copyright 2026 Sai Surya Sriramoju
+
+/**
+ * @file BatchProcessor.cpp
+ * @brief Implementation of the BatchProcessor class.
+ * @author Sai Surya Sriramoju
+ * @date 10/17/2026
+ */
+
+#include "BatchProcessor.h"
+
+#include <sys/stat.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <deque>
+#include <set>
+#include <stdexcept>
+#include <thread>
+
+namespace {
+/// How long an idle consumer waits before re-checking for the end.
+const std::chrono::milliseconds kPollInterval(50);
+
+/**
+ * @brief Returns the last path component of @p path, ignoring trailing '/'.
+ */
+std::string baseName(std::string path) {
+    while (path.size() > 1 && path.back() == '/') {
+        path.pop_back();
+    }
+    const size_t slash = path.find_last_of('/');
+    return slash == std::string::npos ? path : path.substr(slash + 1);
+}
+
+/**
+ * @brief Creates @p dir unless it already exists.
+ */
+void makeDirectory(const std::string& dir) {
+    if (::mkdir(dir.c_str(), 0755) != 0 && errno != EEXIST) {
+        throw std::runtime_error("Cannot create " + dir + ": " +
+                                 std::strerror(errno));
+    }
+}
+}  // namespace
+
+/**
+ * @brief Constructor.
+ *
+ * @param yolo Configured detector.
+ * @param world Calibration used for the world coordinates.
+ * @param config Decode, detector and output tunables.
+ */
+BatchProcessor::BatchProcessor(YOLO& yolo, const CoordToWorld& world,
+                               const BatchConfig& config)
+    : yolo(yolo), projector(world.projection()), config(config) {}
+
+/**
+ * @brief Processes every input and returns when all are written.
+ *
+ * The calling thread submits decoded frames to the detector and writes the
+ * results while the decode threads and network instances run.
+ *
+ * @param inputs Video files and image directories.
+ * @return BatchSummary - Frame counts, throughput and output files.
+ */
+BatchSummary BatchProcessor::run(const std::vector<SourceSpec>& inputs) {
+    const auto started = std::chrono::steady_clock::now();
+    BatchSummary summary;
+    const int decoders = config.decoders > 0
+        ? config.decoders
+        : std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    const std::vector<Chunk> chunks = planChunks(inputs, decoders, summary);
+
+    makeDirectory(config.outputDir);
+    outputs.clear();
+    outputs.resize(inputs.size());
+    std::set<std::string> names;
+    for (size_t i = 0; i < inputs.size(); ++i) {
+        const bool planned = std::any_of(chunks.begin(), chunks.end(),
+                                         [i](const Chunk& c) { return c.input == i; });
+        if (!planned) {
+            summary.outputs.push_back("");
+            continue;
+        }
+        // Same-named inputs from different directories must not collide.
+        std::string name = baseName(inputs[i].path);
+        if (!names.insert(name).second) {
+            name += "-" + std::to_string(i);
+            names.insert(name);
+        }
+        const std::string path = config.outputDir + "/" + name + ".dets";
+        outputs[i].writer.reset(new DetectionStreamWriter(path));
+        summary.outputs.push_back(path);
+    }
+
+    decoded.reset(new BoundedQueue<DecodedFrame>(config.queueCapacity,
+                                                 OverflowPolicy::Block));
+    nextChunk = 0;
+    done = 0;
+    AsyncDetector detector(yolo, config.detectors);
+    const size_t threads = std::min(static_cast<size_t>(decoders), chunks.size());
+    activeDecoders = static_cast<int>(threads);
+    if (threads == 0) {
+        decoded->close();
+    }
+    std::vector<std::thread> workers;
+    for (size_t i = 0; i < threads; ++i) {
+        workers.emplace_back(&BatchProcessor::decodeLoop, this,
+                             std::cref(inputs), std::cref(chunks));
+    }
+
+    // Enough frames in flight to keep every instance busy while the oldest
+    // result is written.
+    const size_t window = 2 * detector.instances();
+    const TilingConfig untiled;
+    std::deque<InFlight> inFlight;
+    auto lastReport = started;
+    try {
+        DecodedFrame frame;
+        while (!decoded->drained()) {
+            if (decoded->pop(frame, kPollInterval)) {
+                if (frame.image.empty()) {
+                    skip(frame);
+                    continue;
+                }
+                InFlight next;
+                next.input = frame.input;
+                next.index = frame.index;
+                next.positionMs = frame.positionMs;
+                next.result = detector.submit(
+                    frame.image,
+                    config.tiling.empty()
+                        ? untiled
+                        : config.tiling[std::min(frame.input,
+                                                 config.tiling.size() - 1)]);
+                frame.image.release();
+                inFlight.push_back(std::move(next));
+                while (inFlight.size() >= window) {
+                    complete(inFlight.front(), summary);
+                    inFlight.pop_front();
+                }
+            }
+            const auto now = std::chrono::steady_clock::now();
+            if (config.log != nullptr && config.reportInterval.count() > 0 &&
+                now - lastReport >= config.reportInterval) {
+                const double elapsed =
+                    std::chrono::duration<double>(now - started).count();
+                *config.log << "Batch: " << framesDone() << " frames, "
+                            << framesDone() / elapsed << " fps\n";
+                lastReport = now;
+            }
+        }
+        while (!inFlight.empty()) {
+            complete(inFlight.front(), summary);
+            inFlight.pop_front();
+        }
+    } catch (...) {
+        decoded->close();  // Unblocks the decoders.
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        throw;
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    // Frames that never decoded leave gaps; write what is held around them.
+    for (Output& output : outputs) {
+        drain(output, true);
+    }
+    outputs.clear();  // Closes the files.
+    summary.seconds = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - started).count();
+    return summary;
+}
+
+/**
+ * @brief Splits the inputs into chunks for the decode threads.
+ *
+ * Image directories are split evenly, since every image decodes on its
+ * own. Videos are split only when long enough for the seek at the start
+ * of a chunk to be negligible; the last chunk runs to the end of the file
+ * in case the frame count reported by the container is low.
+ *
+ * @param inputs Video files and image directories.
+ * @param decoders Number of decode threads.
+ * @param summary Receives the number of inputs that cannot be opened.
+ * @return std::vector<Chunk> - Chunks in input order.
+ */
+std::vector<BatchProcessor::Chunk> BatchProcessor::planChunks(
+    const std::vector<SourceSpec>& inputs, int decoders,
+    BatchSummary& summary) {
+    std::vector<Chunk> chunks;
+    files.assign(inputs.size(), std::vector<std::string>());
+    for (size_t i = 0; i < inputs.size(); ++i) {
+        const SourceSpec& spec = inputs[i];
+        if (spec.kind == SourceKind::Device) {
+            throw std::invalid_argument("Batch mode reads files, " +
+                                        spec.name() + " is a camera");
+        }
+        if (spec.kind == SourceKind::Recording) {
+            throw std::invalid_argument("Batch mode reads videos and images; "
+                                        "replay " + spec.name() +
+                                        " with --replay-fast instead");
+        }
+        int64_t count = 0;
+        int64_t pieces = 1;
+        if (spec.kind == SourceKind::ImageDirectory) {
+            cv::glob(spec.path, files[i]);
+            count = static_cast<int64_t>(files[i].size());
+            pieces = std::max<int64_t>(1, std::min<int64_t>(decoders, count));
+        } else {
+            cv::VideoCapture capture(spec.path);
+            if (!capture.isOpened()) {
+                ++summary.failedInputs;
+                if (config.log != nullptr) {
+                    *config.log << "Cannot open " << spec.path << ", skipped\n";
+                }
+                continue;
+            }
+            count = static_cast<int64_t>(capture.get(cv::CAP_PROP_FRAME_COUNT));
+            const int64_t minChunk = std::max(1, config.minChunkFrames);
+            if (count >= 2 * minChunk) {
+                pieces = std::min<int64_t>(decoders, count / minChunk);
+            }
+        }
+        const int64_t size = pieces > 1 ? (count + pieces - 1) / pieces : count;
+        for (int64_t p = 0; p < pieces; ++p) {
+            Chunk chunk;
+            chunk.input = i;
+            chunk.begin = p * size;
+            chunk.end = std::min(count, (p + 1) * size);
+            if (spec.kind == SourceKind::Video && p == pieces - 1) {
+                chunk.end = -1;
+            }
+            chunks.push_back(chunk);
+        }
+    }
+    return chunks;
+}
+
+/**
+ * @brief Decode thread: decodes chunks until none are left.
+ *
+ * Blocks while the detector is behind instead of dropping frames. The last
+ * thread to finish closes the queue.
+ *
+ * @param inputs Video files and image directories.
+ * @param chunks The planned chunks.
+ */
+void BatchProcessor::decodeLoop(const std::vector<SourceSpec>& inputs,
+                                const std::vector<Chunk>& chunks) {
+    bool open = true;
+    while (open) {
+        const size_t next = nextChunk.fetch_add(1);
+        if (next >= chunks.size()) {
+            break;
+        }
+        const Chunk& chunk = chunks[next];
+        const SourceSpec& spec = inputs[chunk.input];
+        if (spec.kind == SourceKind::ImageDirectory) {
+            for (int64_t i = chunk.begin; open && i < chunk.end; ++i) {
+                DecodedFrame frame;
+                frame.input = chunk.input;
+                frame.index = static_cast<uint64_t>(i);
+                frame.image = cv::imread(files[chunk.input][i]);
+                if (frame.image.empty()) {
+                    frame.skipped = 1;  // Unreadable; the writer steps over it.
+                }
+                open = decoded->push(std::move(frame));
+            }
+            continue;
+        }
+        cv::VideoCapture capture(spec.path);
+        if (chunk.begin > 0) {
+            capture.set(cv::CAP_PROP_POS_FRAMES, static_cast<double>(chunk.begin));
+        }
+        for (int64_t i = chunk.begin; open && (chunk.end < 0 || i < chunk.end);
+             ++i) {
+            DecodedFrame frame;
+            frame.input = chunk.input;
+            frame.index = static_cast<uint64_t>(i);
+            if (!capture.read(frame.image) || frame.image.empty()) {
+                if (chunk.end >= 0) {
+                    // The rest of this chunk is lost, but the next chunk's
+                    // frames must still be written.
+                    frame.image.release();
+                    frame.skipped = static_cast<uint64_t>(chunk.end - i);
+                    decoded->push(std::move(frame));
+                }
+                break;
+            }
+            frame.positionMs = capture.get(cv::CAP_PROP_POS_MSEC);
+            open = decoded->push(std::move(frame));
+        }
+    }
+    if (activeDecoders.fetch_sub(1) == 1) {
+        decoded->close();
+    }
+}
+
+/**
+ * @brief Waits for a frame's detections, projects and queues them for writing.
+ *
+ * @param frame The oldest in-flight frame.
+ * @param summary Receives the frame and detection counts.
+ */
+void BatchProcessor::complete(InFlight& frame, BatchSummary& summary) {
+    const Detections detections = frame.result.get();
+    pixels.clear();
+    for (size_t i = 0; i < detections.size(); ++i) {
+        const cv::Rect box = detections.box(i);
+        pixels.push_back(box.x);
+        pixels.push_back(box.y);
+    }
+    projector.project(pixels, worldCoords);
+    makeRecords(detections, worldCoords, records);
+
+    StreamFrameHeader header;
+    header.source = static_cast<uint16_t>(frame.input);
+    header.sequence = frame.index;
+    header.timestampNs = static_cast<int64_t>(frame.positionMs * 1e6);
+    Output& output = outputs[frame.input];
+    if (frame.index == output.next) {
+        if (!output.writer->write(header, records)) {
+            throw std::runtime_error(output.writer->error());
+        }
+        ++output.next;
+        drain(output, false);
+    } else {
+        // Another chunk of the same input finished first; hold on to the
+        // records (not the frame) until the frames before it are written.
+        output.held.emplace(frame.index, std::make_pair(header, records));
+    }
+
+    ++summary.frames;
+    summary.detections += detections.size();
+    done.fetch_add(1, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Records frames that failed to decode and writes what they held up.
+ *
+ * @param frame A frame without image; covers frame.skipped frames.
+ */
+void BatchProcessor::skip(const DecodedFrame& frame) {
+    Output& output = outputs[frame.input];
+    output.skipped[frame.index] = frame.index + frame.skipped;
+    drain(output, false);
+}
+
+/**
+ * @brief Writes the held frames of @p output that are next in order.
+ *
+ * @param output The input's output file, held and skipped frames.
+ * @param flush Write everything held, skipping gaps.
+ */
+void BatchProcessor::drain(Output& output, bool flush) {
+    while (true) {
+        const auto gap = output.skipped.find(output.next);
+        if (gap != output.skipped.end()) {
+            output.next = gap->second;
+            output.skipped.erase(gap);
+            continue;
+        }
+        if (output.held.empty() ||
+            (!flush && output.held.begin()->first != output.next)) {
+            break;
+        }
+        auto first = output.held.begin();
+        if (!output.writer->write(first->second.first, first->second.second)) {
+            throw std::runtime_error(output.writer->error());
+        }
+        output.next = first->first + 1;
+        output.held.erase(first);
+    }
+}
@@ -9,27 +9,124 @@
 
 #include "Camera.h"
 
+#include <stdexcept>
+
+#include "JpegDecode.h"
+
+/**
+ * @brief Constructor for the Camera class. Initializes the default camera.
+ */
+Camera::Camera() : Camera(0) {}
+
 /**
- * @brief Constructor for the Camera class. Initializes the camera.
+ * @brief Opens the camera device with the given index.
+ *
+ * @param index Device index.
  */
-Camera::Camera() {
-    cap.open(0);  // Open the default camera (index 0)
+Camera::Camera(int index) {
+    cap.open(index);
     if (!cap.isOpened()) {
-        std::cerr << "Error opening camera" << std::endl;
-        exit(-1);
+        throw std::runtime_error("Error opening camera " + std::to_string(index));
     }
 }
 
+/**
+ * @brief Opens a video file, image sequence or stream.
+ *
+ * @param uri File name or URL.
+ */
+Camera::Camera(const std::string& uri) {
+    cap.open(uri);
+    if (!cap.isOpened()) {
+        throw std::runtime_error("Error opening video source " + uri);
+    }
+}
+
+/**
+ * @brief Returns true while the capture is open.
+ * @return bool - Whether frames can be read.
+ */
+bool Camera::isOpened() const {
+    return cap.isOpened();
+}
+
+/**
+ * @brief Latches the next frame.
+ * @return bool - False at the end of the stream or on a device error.
+ */
+bool Camera::grab() {
+    return cap.grab();
+}
+
+/**
+ * @brief Decodes the latched frame.
+ * @param frame Receives the frame.
+ * @return bool - False if nothing was latched.
+ */
+bool Camera::retrieve(cv::Mat& frame) {
+    if (decodeSide <= 0) {
+        return cap.retrieve(frame);
+    }
+    payload = cv::Mat();  // A fresh buffer; the last one may still be in use.
+    if (!cap.retrieve(payload)) {
+        return false;
+    }
+    cv::Size full;
+    if (payload.rows == 1 && payload.type() == CV_8UC1 &&
+        jpegSize(payload.data, payload.total(), full)) {
+        return decodeReduced(payload, decodeSide, frame, frameScale);
+    }
+    // The backend decoded anyway; stop asking for payloads.
+    payload.copyTo(frame);
+    payload.release();
+    decodeSide = 0;
+    frameScale = 1.0;
+    cap.set(cv::CAP_PROP_CONVERT_RGB, 1);
+    return true;
+}
+
+/**
+ * @brief Switches the device to MJPEG with reduced-scale decoding.
+ * @param side Long side to decode to, 0 to turn it off.
+ * @return bool - False if the backend keeps decoding frames itself.
+ */
+bool Camera::setCompressedCapture(int side) {
+    decodeSide = 0;
+    frameScale = 1.0;
+    payload.release();
+    if (side <= 0) {
+        return cap.set(cv::CAP_PROP_CONVERT_RGB, 1);
+    }
+    cap.set(cv::CAP_PROP_FOURCC, cv::VideoWriter::fourcc('M', 'J', 'P', 'G'));
+    if (!cap.set(cv::CAP_PROP_CONVERT_RGB, 0)) {
+        return false;
+    }
+    decodeSide = side;
+    return true;
+}
+
 /**
  * @brief Captures an image using the camera.
  * @return cv::Mat - The captured frame.
  */
 cv::Mat Camera::captureImage() {
     cv::Mat frame;
-    cap >> frame;  // Capture a frame from the camera
+    read(frame);  // Capture a frame from the camera
     return frame;
 }
 
+/**
+ * @brief Decodes the next frame into an existing buffer.
+ * @param frame Receives the frame.
+ * @return bool - False at the end of the stream or on a device error.
+ */
+bool Camera::read(cv::Mat& frame) {
+    if (decodeSide > 0) {
+        return cap.grab() && retrieve(frame);
+    }
+    return cap.read(frame);
+}
+
 /**
  * @brief Releases the camera.
  */
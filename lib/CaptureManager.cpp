@@ -0,0 +1,642 @@
+// Copyright 2026 Sai Surya Sriramoju
+
+/**
+ * @file CaptureManager.cpp
+ * @brief Implementation of the CaptureManager class.
+ * @author Sai Surya Sriramoju
+ * @date 10/17/2026
+ */
+
+#include "CaptureManager.h"
+
+#include <sys/stat.h>
+
+#include <algorithm>
+#include <cctype>
+#include <stdexcept>
+#include <utility>
+
+#include "Camera.h"
+#include "JpegDecode.h"
+#include "Recording.h"
+
+namespace {
+/// File name extension of recordings written by RecordingWriter.
+const char kRecordingExtension[] = ".prec";
+/// How long a grab thread waits for a buffer before checking for stop().
+const std::chrono::milliseconds kBufferWait(100);
+
+/**
+ * @brief Returns true if @p text is a non-empty run of digits.
+ */
+bool isNumber(const std::string& text) {
+    return !text.empty() && std::all_of(text.begin(), text.end(), [](char c) {
+        return std::isdigit(static_cast<unsigned char>(c)) != 0;
+    });
+}
+
+/**
+ * @brief Returns where the recording path in @p uri ends, i.e. the end of
+ *        a ".prec" followed by nothing or "#<source>", or npos.
+ */
+size_t recordingEnd(const std::string& uri) {
+    const size_t length = sizeof(kRecordingExtension) - 1;
+    size_t at = uri.find(kRecordingExtension);
+    while (at != std::string::npos) {
+        const size_t end = at + length;
+        if (end == uri.size() || uri[end] == '#') {
+            return end;
+        }
+        at = uri.find(kRecordingExtension, at + 1);
+    }
+    return std::string::npos;
+}
+
+/**
+ * @brief Returns true if @p path names an existing directory.
+ */
+bool isDirectory(const std::string& path) {
+    struct stat info;
+    return stat(path.c_str(), &info) == 0 && S_ISDIR(info.st_mode);
+}
+
+/**
+ * @brief Absolute difference of two time points.
+ */
+std::chrono::steady_clock::duration distance(
+    std::chrono::steady_clock::time_point a,
+    std::chrono::steady_clock::time_point b) {
+    return a > b ? a - b : b - a;
+}
+}  // namespace
+
+/**
+ * @brief Builds a spec from a device number, directory or file name.
+ *
+ * @param uri The text to interpret.
+ * @return SourceSpec - The source description.
+ */
+SourceSpec SourceSpec::parse(const std::string& uri) {
+    SourceSpec spec;
+    if (isNumber(uri)) {
+        spec.kind = SourceKind::Device;
+        spec.device = std::stoi(uri);
+    } else if (recordingEnd(uri) != std::string::npos) {
+        const size_t end = recordingEnd(uri);
+        spec.kind = SourceKind::Recording;
+        spec.path = uri.substr(0, end);
+        if (end < uri.size()) {
+            const std::string stream = uri.substr(end + 1);
+            if (!isNumber(stream)) {
+                throw std::invalid_argument(
+                    "Recording source must be a number: " + uri);
+            }
+            spec.stream = std::stoi(stream);
+        }
+    } else if (isDirectory(uri)) {
+        spec.kind = SourceKind::ImageDirectory;
+        spec.path = uri;
+    } else {
+        spec.kind = SourceKind::Video;
+        spec.path = uri;
+    }
+    return spec;
+}
+
+/**
+ * @brief Names the source for logs.
+ *
+ * @return std::string - "camera N", the path or "<recording>#<source>".
+ */
+std::string SourceSpec::name() const {
+    if (kind == SourceKind::Device) {
+        return "camera " + std::to_string(device);
+    }
+    if (kind == SourceKind::Recording) {
+        return path + "#" + std::to_string(stream);
+    }
+    return path;
+}
+
+/**
+ * @brief Returns true if no entry of the set is empty.
+ *
+ * @return bool - Whether every source contributed.
+ */
+bool FrameSet::complete() const {
+    return std::none_of(frames.begin(), frames.end(), [](const TimedFrame& f) {
+        return f.image.empty();
+    });
+}
+
+/**
+ * @brief Constructor; records the sources without opening them.
+ */
+CaptureManager::CaptureManager(const std::vector<SourceSpec>& specs,
+                               const CaptureConfig& config)
+    : config(config) {
+    if (specs.empty()) {
+        throw std::invalid_argument("CaptureManager needs at least one source");
+    }
+    for (const SourceSpec& spec : specs) {
+        sources.emplace_back(new Source());
+        sources.back()->spec = spec;
+    }
+}
+
+/**
+ * @brief Destructor; stops and joins the grab threads.
+ */
+CaptureManager::~CaptureManager() {
+    stop();
+}
+
+/**
+ * @brief Creates the frame pools and starts one grab thread per source;
+ *        does nothing if already started.
+ *
+ * @param framesHeld Frames of each source the consumer may keep besides
+ *        its last set.
+ */
+void CaptureManager::start(size_t framesHeld) {
+    if (!grabbers.empty()) {
+        return;
+    }
+    // A full buffer, the frame being grabbed and the consumer's last set.
+    const size_t poolSize = config.bufferDepth + 2 + framesHeld;
+    for (size_t i = 0; i < sources.size(); ++i) {
+        sources[i]->pool.reset(new FramePool(poolSize));
+    }
+    for (size_t i = 0; i < sources.size(); ++i) {
+        grabbers.emplace_back(&CaptureManager::grabLoop, this, i);
+    }
+}
+
+/**
+ * @brief Signals the grab threads to finish and joins them.
+ */
+void CaptureManager::stop() {
+    {
+        std::lock_guard<std::mutex> lock(guard);
+        stopping = true;
+    }
+    frameReady.notify_all();
+    spaceReady.notify_all();
+    for (auto& grabber : grabbers) {
+        if (grabber.joinable()) {
+            grabber.join();
+        }
+    }
+}
+
+/**
+ * @brief Grab thread: opens the source, then grabs, stamps and buffers frames.
+ *
+ * Errors reopen the source up to maxReopenAttempts times in a row before it
+ * is marked Failed; the end of a file source marks it Finished.
+ *
+ * @param i Index of the source.
+ */
+void CaptureManager::grabLoop(size_t i) {
+    const SourceSpec spec = sources[i]->spec;  // Immutable after construction.
+    pinCurrentThread(spec.cpus);  // Before the first frame is allocated.
+    std::unique_ptr<Camera> camera;
+    std::unique_ptr<RecordingReader> recording;
+    std::vector<std::string> files;
+    size_t nextFile = 0;
+    size_t nextRecord = 0;
+    // Replay pace: recorded time lapStartNs is shown at wall time lapStart.
+    int64_t lapStartNs = -1;
+    std::chrono::steady_clock::time_point lapStart;
+    uint64_t index = 0;
+    int attempts = 0;
+
+    while (true) {
+        try {
+            if (!camera && !recording && files.empty()) {
+                if (spec.kind == SourceKind::Recording) {
+                    recording.reset(new RecordingReader(spec.path));
+                    nextRecord = 0;
+                    lapStartNs = -1;
+                } else if (spec.kind == SourceKind::ImageDirectory) {
+                    cv::glob(spec.path, files);
+                    if (files.empty()) {
+                        throw std::runtime_error("No images in " + spec.path);
+                    }
+                    nextFile = 0;
+                } else if (spec.kind == SourceKind::Device) {
+                    camera.reset(new Camera(spec.device));
+                    if (spec.decodeSide > 0) {
+                        camera->setCompressedCapture(spec.decodeSide);
+                    }
+                } else {
+                    camera.reset(new Camera(spec.path));
+                }
+                setState(i, SourceState::Running);
+            }
+
+            TimedFrame frame;
+            if (!acquireBuffer(i, frame.buffer)) {
+                return;
+            }
+            // Decoded in place: the buffer is reused unless the size changes.
+            cv::Mat& pixels = frame.buffer.image();
+            bool ok = false;
+            if (spec.kind == SourceKind::ImageDirectory) {
+                // Skip files that are not images; stop after one empty lap.
+                int laps = 0;
+                while (!ok) {
+                    if (nextFile == files.size()) {
+                        if (!spec.loop || index == 0 || ++laps > 1) {
+                            break;
+                        }
+                        nextFile = 0;
+                    }
+                    frame.timestamp = std::chrono::steady_clock::now();
+                    // A decodeSide of 0 decodes in full, like cv::imread().
+                    frame.encoded = readEncoded(files[nextFile++]);
+                    ok = !frame.encoded.empty() &&
+                         decodeReduced(frame.encoded, spec.decodeSide, pixels,
+                                       frame.scale);
+                    cv::Size full;
+                    if (spec.decodeSide <= 0 ||
+                        (ok && !jpegSize(frame.encoded.data,
+                                         frame.encoded.total(), full))) {
+                        frame.encoded.release();  // Only reduced JPEGs are kept.
+                    }
+                }
+                if (!ok) {
+                    if (index == 0) {
+                        throw std::runtime_error("No readable images in " + spec.path);
+                    }
+                    setState(i, SourceState::Finished);
+                    return;
+                }
+            } else if (spec.kind == SourceKind::Recording) {
+                // Frames of the other sources are skipped by the index only.
+                const size_t count = recording->frameCount();
+                while (nextRecord < count &&
+                       recording->frameRecord(nextRecord).header->source !=
+                           spec.stream) {
+                    ++nextRecord;
+                }
+                if (nextRecord == count) {
+                    if (index == 0) {
+                        throw std::runtime_error("No frames of source " +
+                                                 std::to_string(spec.stream) +
+                                                 " in " + spec.path);
+                    }
+                    if (!spec.loop) {
+                        setState(i, SourceState::Finished);
+                        return;
+                    }
+                    nextRecord = 0;
+                    lapStartNs = -1;
+                    continue;
+                }
+                const size_t n = nextRecord++;
+                const RecordHeader& record = *recording->frameRecord(n).header;
+                if (spec.realtime) {
+                    if (lapStartNs < 0) {
+                        lapStartNs = record.timestampNs;
+                        lapStart = std::chrono::steady_clock::now();
+                    }
+                    if (!sleepUntil(lapStart + std::chrono::nanoseconds(
+                                                   record.timestampNs - lapStartNs))) {
+                        return;
+                    }
+                }
+                frame.timestamp = std::chrono::steady_clock::now();
+                if (static_cast<FrameEncoding>(record.encoding) ==
+                    FrameEncoding::Jpeg) {
+                    const cv::Mat encoded(
+                        1, static_cast<int>(record.payloadSize), CV_8U,
+                        const_cast<char*>(recording->frameRecord(n).payload));
+                    ok = decodeReduced(encoded, spec.decodeSide, pixels,
+                                       frame.scale);
+                } else {
+                    // The pipeline draws on its frames and the mapping is
+                    // read-only, so raw frames are copied exactly once here.
+                    const cv::Mat raw = recording->frame(n);
+                    ok = !raw.empty();
+                    if (ok) {
+                        raw.copyTo(pixels);
+                    }
+                }
+                if (!ok) {
+                    throw std::runtime_error("Corrupt frame " + std::to_string(n) +
+                                             " in " + spec.path);
+                }
+            } else {
+                ok = camera->grab();
+                frame.timestamp = std::chrono::steady_clock::now();
+                ok = ok && camera->retrieve(pixels);
+                frame.scale = camera->scale();
+                frame.encoded = camera->encoded();
+                if (!ok) {
+                    if (spec.kind == SourceKind::Device) {
+                        throw std::runtime_error("Frame grab failed on " + spec.name());
+                    }
+                    if (!spec.loop || index == 0) {
+                        setState(i, SourceState::Finished);
+                        return;
+                    }
+                    camera.reset();  // Reopened from the start next round.
+                    continue;
+                }
+            }
+            frame.image = pixels;  // Header only, no pixel copy.
+            frame.index = index++;
+            attempts = 0;
+            if (!deliver(i, frame)) {
+                return;
+            }
+        } catch (const std::exception& e) {
+            camera.reset();
+            recording.reset();
+            files.clear();
+            if (++attempts > config.maxReopenAttempts) {
+                setState(i, SourceState::Failed, e.what());
+                return;
+            }
+            setState(i, SourceState::Opening, e.what());
+            if (!waitBeforeReopen()) {
+                return;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Takes a free buffer from the pool of a source.
+ *
+ * Every buffer may be downstream; the grab thread then waits for one to
+ * come back rather than allocating.
+ *
+ * @param i Index of the source.
+ * @param buffer Receives the buffer.
+ * @return bool - False if the manager is stopping.
+ */
+bool CaptureManager::acquireBuffer(size_t i, FrameHandle& buffer) {
+    while (true) {
+        buffer = sources[i]->pool->acquire(kBufferWait);
+        std::lock_guard<std::mutex> lock(guard);
+        if (stopping) {
+            buffer.reset();
+            return false;
+        }
+        if (buffer) {
+            return true;
+        }
+    }
+}
+
+/**
+ * @brief Buffers a frame, dropping the oldest or waiting when full.
+ *
+ * @param i Index of the source.
+ * @param frame The frame to buffer; moved from.
+ * @return bool - False if the manager is stopping.
+ */
+bool CaptureManager::deliver(size_t i, TimedFrame& frame) {
+    std::unique_lock<std::mutex> lock(guard);
+    Source& source = *sources[i];
+    if (!config.dropOldest) {
+        spaceReady.wait(lock, [&] {
+            return stopping || source.frames.size() < config.bufferDepth;
+        });
+    }
+    if (stopping) {
+        return false;
+    }
+    if (source.frames.size() >= config.bufferDepth) {
+        source.frames.pop_front();
+        ++source.droppedFrames;
+    }
+    source.frames.push_back(std::move(frame));
+    ++source.grabbed;
+    lock.unlock();
+    frameReady.notify_all();
+    return true;
+}
+
+/**
+ * @brief Updates the state of a source and wakes the consumer.
+ *
+ * @param i Index of the source.
+ * @param state The new state.
+ * @param error Error message to record; ignored if empty.
+ */
+void CaptureManager::setState(size_t i, SourceState state,
+                              const std::string& error) {
+    {
+        std::lock_guard<std::mutex> lock(guard);
+        sources[i]->state = state;
+        if (!error.empty()) {
+            sources[i]->error = error;
+        }
+    }
+    frameReady.notify_all();
+}
+
+/**
+ * @brief Waits the reopen delay, returning early on stop().
+ *
+ * @return bool - False if the manager is stopping.
+ */
+bool CaptureManager::waitBeforeReopen() {
+    return sleepUntil(std::chrono::steady_clock::now() + config.reopenDelay);
+}
+
+/**
+ * @brief Waits until a point in time, returning early on stop().
+ *
+ * @param until When to wake up.
+ * @return bool - False if the manager is stopping.
+ */
+bool CaptureManager::sleepUntil(std::chrono::steady_clock::time_point until) {
+    std::unique_lock<std::mutex> lock(guard);
+    return !spaceReady.wait_until(lock, until, [this] { return stopping; });
+}
+
+/**
+ * @brief Waits until the buffered frames can be matched into a set.
+ *
+ * When the timeout expires with some frames buffered, a partial set is
+ * emitted so that one stalled source cannot hold up the others.
+ *
+ * @param set Receives the frames.
+ * @param timeout Maximum time to wait.
+ * @return bool - True if @p set was filled.
+ */
+bool CaptureManager::nextSet(FrameSet& set, std::chrono::milliseconds timeout) {
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    std::unique_lock<std::mutex> lock(guard);
+    while (!stopping) {
+        if (trySet(set, false)) {
+            return true;
+        }
+        if (finishedLocked()) {
+            return false;
+        }
+        if (frameReady.wait_until(lock, deadline) == std::cv_status::timeout) {
+            return !stopping && trySet(set, true);
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Matches the buffered frames of all sources into one set.
+ *
+ * The reference time is the newest head frame over all sources. In
+ * Timestamp mode every source contributes its buffered frame closest to
+ * the reference, older frames being skipped, provided it lies within the
+ * tolerance. In Index mode every source contributes its head frame.
+ *
+ * @param set Receives the frames.
+ * @param force Emit what is available instead of waiting for live sources.
+ * @return bool - True if @p set was filled.
+ */
+bool CaptureManager::trySet(FrameSet& set, bool force) {
+    bool any = false;
+    std::chrono::steady_clock::time_point reference;
+    for (size_t i = 0; i < sources.size(); ++i) {
+        const Source& source = *sources[i];
+        if (!source.frames.empty()) {
+            reference = any ? std::max(reference, source.frames.front().timestamp)
+                            : source.frames.front().timestamp;
+            any = true;
+        } else if (live(i) && !force) {
+            return false;
+        }
+    }
+    if (!any) {
+        return false;
+    }
+
+    std::vector<bool> use(sources.size(), false);
+    for (size_t i = 0; i < sources.size(); ++i) {
+        Source& source = *sources[i];
+        if (source.frames.empty()) {
+            continue;
+        }
+        if (config.sync == SyncMode::Index) {
+            use[i] = true;
+            continue;
+        }
+        while (source.frames.size() > 1 &&
+               distance(source.frames[1].timestamp, reference) <=
+                   distance(source.frames[0].timestamp, reference)) {
+            source.frames.pop_front();
+            ++source.droppedFrames;
+        }
+        const auto stamp = source.frames.front().timestamp;
+        if (distance(stamp, reference) <= config.tolerance) {
+            use[i] = true;
+        } else if (stamp < reference) {
+            if (live(i) && !force) {
+                return false;  // A newer frame of this source is on its way.
+            }
+            source.frames.pop_front();  // Stale; leave a gap instead.
+            ++source.droppedFrames;
+        }
+    }
+
+    set.sequence = setCount++;
+    set.timestamp = reference;
+    set.frames.resize(sources.size());
+    for (size_t i = 0; i < sources.size(); ++i) {
+        if (use[i]) {
+            take(i, set.frames[i]);
+        } else {
+            set.frames[i].image.release();
+            set.frames[i].buffer.reset();
+            set.frames[i].encoded.release();
+            set.frames[i].scale = 1.0;
+            set.frames[i].index = 0;
+            set.frames[i].timestamp = std::chrono::steady_clock::time_point();
+        }
+    }
+    spaceReady.notify_all();
+    return true;
+}
+
+/**
+ * @brief Moves the oldest buffered frame of a source into @p out.
+ *
+ * @param i Index of the source.
+ * @param out Receives the frame.
+ */
+void CaptureManager::take(size_t i, TimedFrame& out) {
+    out = std::move(sources[i]->frames.front());
+    sources[i]->frames.pop_front();
+}
+
+/**
+ * @brief Returns true if a source is open or still trying to open.
+ *
+ * @param i Index of the source.
+ * @return bool - Whether more frames may arrive.
+ */
+bool CaptureManager::live(size_t i) const {
+    const SourceState state = sources[i]->state;
+    return state == SourceState::Opening || state == SourceState::Running;
+}
+
+/**
+ * @brief Returns true once all sources ended and every frame was taken.
+ *
+ * @return bool - Whether nextSet() can never succeed again.
+ */
+bool CaptureManager::finished() const {
+    std::lock_guard<std::mutex> lock(guard);
+    return finishedLocked();
+}
+
+/**
+ * @brief finished() without taking the lock.
+ *
+ * @return bool - Whether nextSet() can never succeed again.
+ */
+bool CaptureManager::finishedLocked() const {
+    for (size_t i = 0; i < sources.size(); ++i) {
+        if (live(i) || !sources[i]->frames.empty()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Returns the state of a source.
+ *
+ * @param i Index of the source.
+ * @return SourceState - Its current state.
+ */
+SourceState CaptureManager::state(size_t i) const {
+    std::lock_guard<std::mutex> lock(guard);
+    return sources.at(i)->state;
+}
+
+/**
+ * @brief Returns the last error message of a source.
+ *
+ * @param i Index of the source.
+ * @return std::string - The message, empty if none.
+ */
+std::string CaptureManager::lastError(size_t i) const {
+    std::lock_guard<std::mutex> lock(guard);
+    return sources.at(i)->error;
+}
+
+/**
+ * @brief Returns how many frames of a source were dropped unconsumed.
+ *
+ * @param i Index of the source.
+ * @return uint64_t - Dropped frame count.
+ */
+uint64_t CaptureManager::dropped(size_t i) const {
+    std::lock_guard<std::mutex> lock(guard);
+    return sources.at(i)->droppedFrames;
+}
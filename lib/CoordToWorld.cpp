@@ -42,6 +42,19 @@ MatrixXf CoordToWorld::transMat() {
   return T;
 }
 
+/**
+ * @brief Computes the projection matrix in double precision.
+ *
+ * @return ProjectionMatrix - The computed projection matrix.
+ */
+ProjectionMatrix CoordToWorld::projection() const {
+  Eigen::Matrix3d intrinsic;
+  intrinsic << focalLen, 0, 0, 0, focalLen, 0, 0, 0, 1;
+  ProjectionMatrix extrinsic;
+  extrinsic << 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 1;
+  return intrinsic * extrinsic;
+}
+
 /**
  * @brief Converts pixel coordinates to real world coordinates.
  *
@@ -53,7 +66,8 @@ MatrixXf CoordToWorld::transMat() {
  * @param coordValues - A vector of pixel coordinates.
  * @return std::vector<double> - A vector of computed world coordinates in XYZ format.
  */
-std::vector<double> CoordToWorld::worldPoints(MatrixXf T, std::vector<double> coordValues) {
+std::vector<double> CoordToWorld::worldPoints(const MatrixXf& T,
+                                              const std::vector<double>& coordValues) {
 
     std::vector<double> actual_world;
     MatrixXf pseudo_T(4,3);
@@ -81,3 +95,62 @@ std::vector<double> CoordToWorld::worldPoints(MatrixXf T, std::vector<double> co
     }
     return actual_world;
 }
+
+/**
+ * @brief Creates a projector and caches the pseudo-inverse of @p projection.
+ *
+ * @param projection - The 3x4 camera projection matrix.
+ */
+WorldProjector::WorldProjector(const ProjectionMatrix& projection) {
+    setProjection(projection);
+}
+
+/**
+ * @brief Recomputes the cached pseudo-inverse for a new calibration.
+ *
+ * @param projection - The 3x4 camera projection matrix.
+ */
+void WorldProjector::setProjection(const ProjectionMatrix& projection) {
+    inverse = projection.completeOrthogonalDecomposition().pseudoInverse();
+}
+
+/**
+ * @brief Projects interleaved pixel pairs into interleaved world triples.
+ *
+ * @param pixels - Pixel coordinates as u0, v0, u1, v1, ...
+ * @param world - Receives the world coordinates as x0, y0, z0, x1, ...
+ */
+void WorldProjector::project(const std::vector<double>& pixels,
+                             std::vector<double>& world) {
+    const size_t count = pixels.size() / 2;
+    world.resize(3 * count);
+    project(pixels.data(), count, world.data());
+}
+
+/**
+ * @brief Projects a batch of pixels with one matrix product.
+ *
+ * The homogeneous pixel [u v 1] never has to be built: the product is the
+ * first two columns of the inverse times the 2xN pixel block plus the third
+ * column, after which x, y and z are divided by the fourth row.
+ *
+ * @param pixels - 2 x count values, (u, v) interleaved.
+ * @param count - Number of pixels.
+ * @param world - Room for 3 x count values, (x, y, z) interleaved.
+ */
+void WorldProjector::project(const double* pixels, size_t count, double* world) {
+    if (count == 0) {
+        return;
+    }
+    const Eigen::Index n = static_cast<Eigen::Index>(count);
+    if (homogeneous.size() < 4 * count) {
+        homogeneous.resize(4 * count);
+    }
+    Eigen::Map<const Eigen::Matrix<double, 2, Eigen::Dynamic>> uv(pixels, 2, n);
+    Eigen::Map<Eigen::Matrix<double, 4, Eigen::Dynamic>> h(homogeneous.data(), 4, n);
+    Eigen::Map<Eigen::Matrix<double, 3, Eigen::Dynamic>> xyz(world, 3, n);
+
+    h.noalias() = inverse.leftCols<2>() * uv;
+    h.colwise() += inverse.col(2);
+    xyz.array() = h.topRows<3>().array().rowwise() / h.row(3).array();
+}
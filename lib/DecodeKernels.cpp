@@ -0,0 +1,249 @@
+// Copyright 2026 Sai Surya Sriramoju
+
+/**
+ * @file DecodeKernels.cpp
+ * @brief Implementation of the vectorised YOLO decode kernels.
+ * @author Sai Surya Sriramoju
+ * @date 10/17/2026
+ */
+
+#include "DecodeKernels.h"
+
+#include <algorithm>
+
+#if (defined(__x86_64__) || defined(__i386__)) && \
+    (defined(__GNUC__) || defined(__clang__))
+#define DECODE_KERNELS_X86 1
+#include <immintrin.h>
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#define DECODE_KERNELS_NEON 1
+#include <arm_neon.h>
+#endif
+
+/**
+ * @brief Scalar argmax; the reference every SIMD path must agree with.
+ */
+int argmaxScoresScalar(const float* scores, int n, float* best) {
+    int index = 0;
+    float value = scores[0];
+    for (int i = 1; i < n; ++i) {
+        if (scores[i] > value) {
+            value = scores[i];
+            index = i;
+        }
+    }
+    *best = value;
+    return index;
+}
+
+/**
+ * @brief Scalar IoU of one box against many; the reference for SIMD paths.
+ */
+void iouOneToManyScalar(const float box[5], const float* x1, const float* y1,
+                        const float* x2, const float* y2, const float* area,
+                        int n, float* iou) {
+    for (int j = 0; j < n; ++j) {
+        const float w = std::max(0.0f, std::min(box[2], x2[j]) -
+                                       std::max(box[0], x1[j]));
+        const float h = std::max(0.0f, std::min(box[3], y2[j]) -
+                                       std::max(box[1], y1[j]));
+        const float inter = w * h;
+        const float unionArea = box[4] + area[j] - inter;
+        iou[j] = unionArea > 0.0f ? inter / unionArea : 0.0f;
+    }
+}
+
+namespace {
+
+#if defined(DECODE_KERNELS_X86)
+/**
+ * @brief AVX2 argmax: a vertical max pass followed by a compare-and-mask
+ * search for the first lane holding that maximum.
+ */
+__attribute__((target("avx2")))
+int argmaxScoresAvx2(const float* scores, int n, float* best) {
+    if (n < 16) {
+        return argmaxScoresScalar(scores, n, best);
+    }
+    __m256 vmax = _mm256_loadu_ps(scores);
+    int i = 8;
+    for (; i + 8 <= n; i += 8) {
+        vmax = _mm256_max_ps(vmax, _mm256_loadu_ps(scores + i));
+    }
+    // Horizontal max of the eight lanes.
+    __m128 m = _mm_max_ps(_mm256_castps256_ps128(vmax),
+                          _mm256_extractf128_ps(vmax, 1));
+    m = _mm_max_ps(m, _mm_movehl_ps(m, m));
+    m = _mm_max_ss(m, _mm_shuffle_ps(m, m, 1));
+    float value = _mm_cvtss_f32(m);
+    for (int t = i; t < n; ++t) {
+        if (scores[t] > value) {
+            value = scores[t];
+        }
+    }
+
+    const __m256 target = _mm256_set1_ps(value);
+    for (int k = 0; k + 8 <= n; k += 8) {
+        const int mask = _mm256_movemask_ps(
+            _mm256_cmp_ps(_mm256_loadu_ps(scores + k), target, _CMP_EQ_OQ));
+        if (mask != 0) {
+            *best = value;
+            return k + __builtin_ctz(mask);
+        }
+    }
+    for (int t = n & ~7; t < n; ++t) {
+        if (scores[t] == value) {
+            *best = value;
+            return t;
+        }
+    }
+    // Only reachable if the maximum is NaN; defer to the reference.
+    return argmaxScoresScalar(scores, n, best);
+}
+
+/**
+ * @brief AVX2 IoU of one box against eight boxes per iteration.
+ */
+__attribute__((target("avx2")))
+void iouOneToManyAvx2(const float box[5], const float* x1, const float* y1,
+                      const float* x2, const float* y2, const float* area,
+                      int n, float* iou) {
+    const __m256 bx1 = _mm256_set1_ps(box[0]);
+    const __m256 by1 = _mm256_set1_ps(box[1]);
+    const __m256 bx2 = _mm256_set1_ps(box[2]);
+    const __m256 by2 = _mm256_set1_ps(box[3]);
+    const __m256 barea = _mm256_set1_ps(box[4]);
+    const __m256 zero = _mm256_setzero_ps();
+    int j = 0;
+    for (; j + 8 <= n; j += 8) {
+        const __m256 w = _mm256_max_ps(zero, _mm256_sub_ps(
+            _mm256_min_ps(bx2, _mm256_loadu_ps(x2 + j)),
+            _mm256_max_ps(bx1, _mm256_loadu_ps(x1 + j))));
+        const __m256 h = _mm256_max_ps(zero, _mm256_sub_ps(
+            _mm256_min_ps(by2, _mm256_loadu_ps(y2 + j)),
+            _mm256_max_ps(by1, _mm256_loadu_ps(y1 + j))));
+        const __m256 inter = _mm256_mul_ps(w, h);
+        const __m256 unionArea = _mm256_sub_ps(
+            _mm256_add_ps(barea, _mm256_loadu_ps(area + j)), inter);
+        const __m256 valid = _mm256_cmp_ps(unionArea, zero, _CMP_GT_OQ);
+        _mm256_storeu_ps(iou + j, _mm256_and_ps(
+            valid, _mm256_div_ps(inter, unionArea)));
+    }
+    iouOneToManyScalar(box, x1 + j, y1 + j, x2 + j, y2 + j, area + j, n - j,
+                       iou + j);
+}
+
+/**
+ * @brief True if the running CPU supports AVX2.
+ */
+bool cpuHasAvx2() {
+    static const bool hasAvx2 = __builtin_cpu_supports("avx2");
+    return hasAvx2;
+}
+#endif
+
+#if defined(DECODE_KERNELS_NEON)
+/**
+ * @brief NEON argmax with the same two-pass structure as the AVX2 kernel.
+ */
+int argmaxScoresNeon(const float* scores, int n, float* best) {
+    if (n < 8) {
+        return argmaxScoresScalar(scores, n, best);
+    }
+    float32x4_t vmax = vld1q_f32(scores);
+    int i = 4;
+    for (; i + 4 <= n; i += 4) {
+        vmax = vmaxq_f32(vmax, vld1q_f32(scores + i));
+    }
+    float value = vmaxvq_f32(vmax);
+    for (int t = i; t < n; ++t) {
+        if (scores[t] > value) {
+            value = scores[t];
+        }
+    }
+    for (int t = 0; t < n; ++t) {
+        if (scores[t] == value) {
+            *best = value;
+            return t;
+        }
+    }
+    return argmaxScoresScalar(scores, n, best);
+}
+
+/**
+ * @brief NEON IoU of one box against four boxes per iteration.
+ */
+void iouOneToManyNeon(const float box[5], const float* x1, const float* y1,
+                      const float* x2, const float* y2, const float* area,
+                      int n, float* iou) {
+    const float32x4_t bx1 = vdupq_n_f32(box[0]);
+    const float32x4_t by1 = vdupq_n_f32(box[1]);
+    const float32x4_t bx2 = vdupq_n_f32(box[2]);
+    const float32x4_t by2 = vdupq_n_f32(box[3]);
+    const float32x4_t barea = vdupq_n_f32(box[4]);
+    const float32x4_t zero = vdupq_n_f32(0.0f);
+    int j = 0;
+    for (; j + 4 <= n; j += 4) {
+        const float32x4_t w = vmaxq_f32(zero, vsubq_f32(
+            vminq_f32(bx2, vld1q_f32(x2 + j)), vmaxq_f32(bx1, vld1q_f32(x1 + j))));
+        const float32x4_t h = vmaxq_f32(zero, vsubq_f32(
+            vminq_f32(by2, vld1q_f32(y2 + j)), vmaxq_f32(by1, vld1q_f32(y1 + j))));
+        const float32x4_t inter = vmulq_f32(w, h);
+        const float32x4_t unionArea = vsubq_f32(
+            vaddq_f32(barea, vld1q_f32(area + j)), inter);
+        const uint32x4_t valid = vcgtq_f32(unionArea, zero);
+        vst1q_f32(iou + j, vreinterpretq_f32_u32(vandq_u32(
+            valid, vreinterpretq_u32_f32(vdivq_f32(inter, unionArea)))));
+    }
+    iouOneToManyScalar(box, x1 + j, y1 + j, x2 + j, y2 + j, area + j, n - j,
+                       iou + j);
+}
+#endif
+
+}  // namespace
+
+/**
+ * @brief Dispatches to the best argmax kernel for this CPU.
+ */
+int argmaxScores(const float* scores, int n, float* best) {
+#if defined(DECODE_KERNELS_X86)
+    if (cpuHasAvx2()) {
+        return argmaxScoresAvx2(scores, n, best);
+    }
+#elif defined(DECODE_KERNELS_NEON)
+    return argmaxScoresNeon(scores, n, best);
+#endif
+    return argmaxScoresScalar(scores, n, best);
+}
+
+/**
+ * @brief Dispatches to the best IoU kernel for this CPU.
+ */
+void iouOneToMany(const float box[5], const float* x1, const float* y1,
+                  const float* x2, const float* y2, const float* area, int n,
+                  float* iou) {
+#if defined(DECODE_KERNELS_X86)
+    if (cpuHasAvx2()) {
+        iouOneToManyAvx2(box, x1, y1, x2, y2, area, n, iou);
+        return;
+    }
+#elif defined(DECODE_KERNELS_NEON)
+    iouOneToManyNeon(box, x1, y1, x2, y2, area, n, iou);
+    return;
+#endif
+    iouOneToManyScalar(box, x1, y1, x2, y2, area, n, iou);
+}
+
+/**
+ * @brief Names the instruction set the kernels dispatch to.
+ */
+const char* decodeKernelIsa() {
+#if defined(DECODE_KERNELS_X86)
+    if (cpuHasAvx2()) {
+        return "AVX2";
+    }
+#elif defined(DECODE_KERNELS_NEON)
+    return "NEON";
+#endif
+    return "scalar";
+}
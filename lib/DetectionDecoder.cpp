@@ -0,0 +1,178 @@
+// Copyright 2026 Sai Surya Sriramoju
+
+/**
+ * @file DetectionDecoder.cpp
+ * @brief Implementation of the DetectionDecoder class.
+ * @author Sai Surya Sriramoju
+ * @date 10/17/2026
+ */
+
+#include "DetectionDecoder.h"
+
+#include <algorithm>
+
+#include "DecodeKernels.h"
+
+/**
+ * @brief Constructor; reserves every working buffer up front.
+ *
+ * @param config Decoding thresholds.
+ * @param capacity Expected maximum number of candidates per frame.
+ */
+DetectionDecoder::DetectionDecoder(const DecoderConfig& config, size_t capacity)
+    : nms(capacity) {
+    configure(config);
+    candidates.reserve(capacity);
+    detections.reserve(capacity);
+}
+
+/**
+ * @brief Replaces the thresholds and precomputes the class column ranges.
+ *
+ * NMS settings queued by setNMSConfig() and not yet applied stay queued,
+ * so they replace @p config's at the next decode().
+ *
+ * @param config New decoding thresholds and class filter.
+ */
+void DetectionDecoder::configure(const DecoderConfig& config) {
+    {
+        std::lock_guard<std::mutex> lock(pendingGuard);
+        settings = config;
+    }
+    std::vector<int> classes = config.classes;
+    std::sort(classes.begin(), classes.end());
+    classes.erase(std::unique(classes.begin(), classes.end()), classes.end());
+    classRanges.clear();
+    for (int id : classes) {
+        if (id < 0) {
+            continue;
+        }
+        if (!classRanges.empty() && classRanges.back().second == id) {
+            classRanges.back().second = id + 1;
+        } else {
+            classRanges.emplace_back(id, id + 1);
+        }
+    }
+}
+
+/**
+ * @brief Queues new NMS settings for the next decode().
+ *
+ * @param config New NMS thresholds and mode.
+ */
+void DetectionDecoder::setNMSConfig(const NMSConfig& config) {
+    std::lock_guard<std::mutex> lock(pendingGuard);
+    pendingNms = config;
+    nmsChanged.store(true, std::memory_order_release);
+}
+
+/**
+ * @brief Returns the NMS settings the next decode() will use.
+ *
+ * @return NMSConfig - The pending settings, or those in use.
+ */
+NMSConfig DetectionDecoder::nmsConfig() const {
+    std::lock_guard<std::mutex> lock(pendingGuard);
+    return nmsChanged.load(std::memory_order_relaxed) ? pendingNms
+                                                      : settings.nms;
+}
+
+/**
+ * @brief Decodes the output layers of one frame into detections.
+ *
+ * @param outputs The output layers of one forward pass for one frame.
+ * @param transform Maps network input pixels back onto the frame.
+ * @return const Detections& - The surviving detections.
+ */
+const Detections& DetectionDecoder::decode(const std::vector<cv::Mat>& outputs,
+                                           const LetterboxTransform& transform) {
+    if (nmsChanged.load(std::memory_order_acquire)) {
+        std::lock_guard<std::mutex> lock(pendingGuard);
+        settings.nms = pendingNms;
+        nmsChanged.store(false, std::memory_order_relaxed);
+    }
+    {
+        ScopedTimer timer(decodeTimer);
+        candidates.clear();
+        for (const cv::Mat& output : outputs) {
+            collectCandidates(output, transform);
+        }
+    }
+    ScopedTimer timer(nmsTimer);
+    nms.run(candidates, settings.nms, detections);
+    return detections;
+}
+
+/**
+ * @brief Scans the rows of one output layer and keeps confident candidates.
+ *
+ * Rows are first rejected on objectness, which discards the vast majority of
+ * anchors with a single compare. For the rest the class score is the
+ * maximum over the configured class columns, found with argmaxScores(); the
+ * row pointer is read directly so no per-row cv::Mat header is created.
+ * YoloV8 outputs have one column per anchor, so they are transposed into a
+ * reused buffer first.
+ *
+ * @param output One output layer in the configured layout.
+ * @param transform Maps network input pixels back onto the frame.
+ */
+void DetectionDecoder::collectCandidates(const cv::Mat& output,
+                                         const LetterboxTransform& transform) {
+    cv::Mat rows = output;
+    if (output.dims == 3) {  // 1 x rows x cols from an ONNX export.
+        rows = cv::Mat(output.size[1], output.size[2], CV_32F,
+                       const_cast<float*>(output.ptr<float>()));
+    }
+    if (outputLayout == OutputLayout::YoloV8) {
+        cv::transpose(rows, transposed);
+        rows = transposed;
+    }
+    const bool hasObjectness = outputLayout != OutputLayout::YoloV8;
+    const int firstClass = hasObjectness ? 5 : 4;
+    const int numClasses = rows.cols - firstClass;
+    const float threshold = settings.confThreshold;
+    // Network coordinates (normalised for Darknet, pixels otherwise) -> frame
+    // pixels.
+    const bool normalised = outputLayout == OutputLayout::Darknet;
+    const float kx = (normalised ? transform.inputSize.width : 1) / transform.scaleX;
+    const float ky = (normalised ? transform.inputSize.height : 1) / transform.scaleY;
+    const float offsetX = transform.padX / transform.scaleX;
+    const float offsetY = transform.padY / transform.scaleY;
+    for (int j = 0; j < rows.rows; ++j) {
+        const float* data = rows.ptr<float>(j);
+        if (hasObjectness && data[4] <= threshold) {
+            continue;  // Class scores are bounded by objectness.
+        }
+        const float* scores = data + firstClass;
+        int classId = 0;
+        float confidence = 0.0f;
+        if (classRanges.empty()) {
+            classId = argmaxScores(scores, numClasses, &confidence);
+        } else {
+            confidence = -1.0f;
+            for (const auto& range : classRanges) {
+                if (range.first >= numClasses) {
+                    break;
+                }
+                const int end = std::min(range.second, numClasses);
+                float value = 0.0f;
+                const int index = range.first + argmaxScores(
+                    scores + range.first, end - range.first, &value);
+                if (value > confidence) {
+                    confidence = value;
+                    classId = index;
+                }
+            }
+        }
+        if (outputLayout == OutputLayout::YoloV5) {
+            confidence *= data[4];
+        }
+        if (confidence > threshold) {
+            const float width = data[2] * kx;
+            const float height = data[3] * ky;
+            candidates.push(data[0] * kx - offsetX - width / 2,
+                            data[1] * ky - offsetY - height / 2,
+                            width, height, confidence, classId);
+        }
+    }
+}
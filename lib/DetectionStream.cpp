@@ -0,0 +1,292 @@
+// Copyright 2026 Sai Surya Sriramoju
+
+/**
+ * @file DetectionStream.cpp
+ * @brief Implementation of the detection stream writer and reader.
+ * @author Sai Surya Sriramoju
+ * @date 10/17/2026
+ */
+
+#include "DetectionStream.h"
+
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+namespace {
+const char kUnixPrefix[] = "unix:";
+
+/**
+ * @brief Fills in the world coordinates of record @p i from @p worldCoords.
+ */
+void setWorld(StreamRecord& record, const std::vector<double>& worldCoords,
+              size_t i) {
+    if (3 * i + 2 < worldCoords.size()) {
+        record.worldX = static_cast<float>(worldCoords[3 * i]);
+        record.worldY = static_cast<float>(worldCoords[3 * i + 1]);
+        record.worldZ = static_cast<float>(worldCoords[3 * i + 2]);
+    }
+}
+
+/**
+ * @brief Connects a stream socket to the Unix socket at @p path.
+ */
+int connectUnix(const std::string& path) {
+    sockaddr_un address;
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(address.sun_path)) {
+        throw std::runtime_error("Unix socket path too long: " + path);
+    }
+    std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+    const int fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        throw std::runtime_error(std::string("Cannot create socket: ") +
+                                 std::strerror(errno));
+    }
+    if (::connect(fd, reinterpret_cast<const sockaddr*>(&address),
+                  sizeof(address)) != 0) {
+        const int error = errno;
+        ::close(fd);
+        throw std::runtime_error("Cannot connect to " + path + ": " +
+                                 std::strerror(error));
+    }
+    return fd;
+}
+
+/**
+ * @brief Reads exactly @p size bytes unless the stream ends first.
+ *
+ * @return size_t - Bytes read; less than @p size only at the end.
+ */
+size_t readFully(int fd, void* data, size_t size) {
+    char* out = static_cast<char*>(data);
+    size_t done = 0;
+    while (done < size) {
+        const ssize_t n = ::read(fd, out + done, size - done);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n < 0) {
+            throw std::runtime_error(std::string("Cannot read stream: ") +
+                                     std::strerror(errno));
+        }
+        if (n == 0) {
+            break;
+        }
+        done += static_cast<size_t>(n);
+    }
+    return done;
+}
+}  // namespace
+
+/**
+ * @brief Converts raw detections into stream records.
+ *
+ * @param detections Detections of one frame.
+ * @param worldCoords Their world coordinates as (x, y, z) triples.
+ * @param records Receives one record per detection.
+ * @param scale Multiplies the boxes.
+ */
+void makeRecords(const Detections& detections,
+                 const std::vector<double>& worldCoords,
+                 std::vector<StreamRecord>& records, double scale) {
+    records.resize(detections.size());
+    for (size_t i = 0; i < detections.size(); ++i) {
+        StreamRecord& record = records[i];
+        record = StreamRecord();
+        record.classId = detections.classIds[i];
+        record.x = static_cast<float>(detections.x[i] * scale);
+        record.y = static_cast<float>(detections.y[i] * scale);
+        record.width = static_cast<float>(detections.width[i] * scale);
+        record.height = static_cast<float>(detections.height[i] * scale);
+        record.confidence = detections.scores[i];
+        setWorld(record, worldCoords, i);
+    }
+}
+
+/**
+ * @brief Converts tracks into stream records.
+ *
+ * @param tracks Tracks reported for one frame.
+ * @param worldCoords Their world coordinates as (x, y, z) triples.
+ * @param records Receives one record per track.
+ * @param scale Multiplies the boxes.
+ */
+void makeRecords(const std::vector<Track>& tracks,
+                 const std::vector<double>& worldCoords,
+                 std::vector<StreamRecord>& records, double scale) {
+    records.resize(tracks.size());
+    for (size_t i = 0; i < tracks.size(); ++i) {
+        const Track& track = tracks[i];
+        StreamRecord& record = records[i];
+        record = StreamRecord();
+        record.trackId = track.id;
+        record.classId = track.classId;
+        record.x = static_cast<float>(track.box.x * scale);
+        record.y = static_cast<float>(track.box.y * scale);
+        record.width = static_cast<float>(track.box.width * scale);
+        record.height = static_cast<float>(track.box.height * scale);
+        record.confidence = track.score;
+        setWorld(record, worldCoords, i);
+    }
+}
+
+/**
+ * @brief Constructor; opens the destination.
+ *
+ * @param target "-", "unix:<path>" or a file or named pipe path.
+ */
+DetectionStreamWriter::DetectionStreamWriter(const std::string& target) {
+    using namespace std::chrono;
+    // Capture times are steady_clock readings; one offset taken here turns
+    // them into wall-clock time without a clock call per frame.
+    epochOffset = duration_cast<nanoseconds>(
+        system_clock::now().time_since_epoch() -
+        steady_clock::now().time_since_epoch());
+    if (target == "-") {
+        fd = STDOUT_FILENO;
+        ownsFd = false;
+    } else if (target.compare(0, sizeof(kUnixPrefix) - 1, kUnixPrefix) == 0) {
+        fd = connectUnix(target.substr(sizeof(kUnixPrefix) - 1));
+        isSocket = true;
+    } else {
+        // Opening a FIFO blocks until a reader attaches, which is what a
+        // downstream consumer started after us expects.
+        fd = ::open(target.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC,
+                    0644);
+        if (fd < 0) {
+            throw std::runtime_error("Cannot open " + target + ": " +
+                                     std::strerror(errno));
+        }
+    }
+}
+
+/**
+ * @brief Destructor; closes the destination unless it is stdout.
+ */
+DetectionStreamWriter::~DetectionStreamWriter() {
+    if (ownsFd && fd >= 0) {
+        ::close(fd);
+    }
+}
+
+/**
+ * @brief Writes the records of one captured frame.
+ *
+ * @param source Camera/source index.
+ * @param sequence Capture sequence number.
+ * @param captured Capture time.
+ * @param records The records of the frame.
+ * @return bool - False once the destination failed.
+ */
+bool DetectionStreamWriter::write(size_t source, uint64_t sequence,
+                                  std::chrono::steady_clock::time_point captured,
+                                  const std::vector<StreamRecord>& records) {
+    StreamFrameHeader header;
+    header.source = static_cast<uint16_t>(source);
+    header.sequence = sequence;
+    header.timestampNs =
+        (captured.time_since_epoch() + epochOffset).count();
+    return write(header, records);
+}
+
+/**
+ * @brief Writes one frame of records with a single system call.
+ *
+ * @param header Frame header.
+ * @param records The records of the frame.
+ * @return bool - False once the destination failed.
+ */
+bool DetectionStreamWriter::write(StreamFrameHeader header,
+                                  const std::vector<StreamRecord>& records) {
+    if (!failure.empty()) {
+        return false;
+    }
+    header.count = static_cast<uint32_t>(records.size());
+    const size_t payload = records.size() * sizeof(StreamRecord);
+    buffer.resize(sizeof(header) + payload);
+    std::memcpy(buffer.data(), &header, sizeof(header));
+    if (payload > 0) {
+        std::memcpy(buffer.data() + sizeof(header), records.data(), payload);
+    }
+    size_t done = 0;
+    while (done < buffer.size()) {
+        // MSG_NOSIGNAL turns a vanished socket reader into EPIPE instead of
+        // SIGPIPE; pipes and stdout rely on the caller ignoring SIGPIPE.
+        const ssize_t n =
+            isSocket ? ::send(fd, buffer.data() + done, buffer.size() - done,
+                              MSG_NOSIGNAL)
+                     : ::write(fd, buffer.data() + done, buffer.size() - done);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n < 0) {
+            failure = std::string("Cannot write detection stream: ") +
+                      std::strerror(errno);
+            return false;
+        }
+        done += static_cast<size_t>(n);
+    }
+    ++written;
+    return true;
+}
+
+/**
+ * @brief Constructor; opens the stream.
+ *
+ * @param path A stream file or named pipe, "-" for stdin.
+ */
+DetectionStreamReader::DetectionStreamReader(const std::string& path) {
+    if (path == "-") {
+        fd = STDIN_FILENO;
+        ownsFd = false;
+        return;
+    }
+    fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        throw std::runtime_error("Cannot open " + path + ": " +
+                                 std::strerror(errno));
+    }
+}
+
+/**
+ * @brief Destructor; closes the stream unless it is stdin.
+ */
+DetectionStreamReader::~DetectionStreamReader() {
+    if (ownsFd && fd >= 0) {
+        ::close(fd);
+    }
+}
+
+/**
+ * @brief Reads the next frame.
+ *
+ * @param header Receives the frame header.
+ * @param records Receives the frame's records.
+ * @return bool - False at the end of the stream.
+ */
+bool DetectionStreamReader::next(StreamFrameHeader& header,
+                                 std::vector<StreamRecord>& records) {
+    const size_t got = readFully(fd, &header, sizeof(header));
+    if (got == 0) {
+        return false;
+    }
+    if (got < sizeof(header)) {
+        throw std::runtime_error("Truncated detection stream header");
+    }
+    if (header.magic != kStreamMagic || header.version != kStreamVersion) {
+        throw std::runtime_error("Not a detection stream (bad magic/version)");
+    }
+    records.resize(header.count);
+    const size_t payload = records.size() * sizeof(StreamRecord);
+    if (readFully(fd, records.data(), payload) < payload) {
+        throw std::runtime_error("Truncated detection stream records");
+    }
+    return true;
+}
@@ -0,0 +1,307 @@
+// Copyright 2026 Sai Surya Sriramoju
+
+/**
+ * @file DetectorBackend.cpp
+ * @brief Implementation of BackendConfig and the OpenCV DNN backend.
+ * @author Sai Surya Sriramoju
+ * @date 10/17/2026
+ */
+
+#include "DetectorBackend.h"
+
+#include "MappedFile.h"
+
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <utility>
+
+// Net::quantize() first shipped with OpenCV 4.5.4, DNN_TARGET_CPU_FP16 with 4.9.
+#if CV_VERSION_MAJOR > 4 || (CV_VERSION_MAJOR == 4 && CV_VERSION_MINOR > 5) || \
+    (CV_VERSION_MAJOR == 4 && CV_VERSION_MINOR == 5 && CV_VERSION_REVISION >= 4)
+#define DETECTOR_BACKEND_QUANTIZE 1
+#endif
+#if CV_VERSION_MAJOR > 4 || (CV_VERSION_MAJOR == 4 && CV_VERSION_MINOR >= 9)
+#define DETECTOR_BACKEND_CPU_FP16 1
+#endif
+
+namespace {
+/**
+ * @brief Parses "darknet", "yolov5" or "yolov8".
+ */
+OutputLayout parseLayout(const std::string& name) {
+    if (name == "darknet") {
+        return OutputLayout::Darknet;
+    }
+    if (name == "yolov5") {
+        return OutputLayout::YoloV5;
+    }
+    if (name == "yolov8") {
+        return OutputLayout::YoloV8;
+    }
+    throw std::invalid_argument("Unknown output layout: " + name);
+}
+
+/**
+ * @class OpenCVBackend
+ * @brief Runs Darknet or ONNX models with cv::dnn on the CPU.
+ */
+class OpenCVBackend : public DetectorBackend {
+ public:
+    OpenCVBackend(const BackendConfig& config,
+                  const std::vector<cv::Mat>& calibration);
+
+    void forward(const cv::Mat& blob, std::vector<cv::Mat>& outputs) override {
+        net.setInput(blob);
+        net.forward(outputs, outputNames);
+    }
+
+    std::string describe() const override { return description; }
+
+ private:
+    cv::dnn::Net net;                      ///< The loaded network.
+    std::vector<std::string> outputNames;  ///< Cached output layer names.
+    std::string description;               ///< What describe() reports.
+};
+
+/**
+ * @brief Loads the network and applies the requested precision.
+ */
+OpenCVBackend::OpenCVBackend(const BackendConfig& config,
+                             const std::vector<cv::Mat>& calibration) {
+    // Parse straight from mappings of the files: no stream buffers and no
+    // intermediate copy of the weights before they land in the layer blobs.
+    try {
+        const MappedFile model(config.model);
+        if (config.isOnnx()) {
+            net = cv::dnn::readNetFromONNX(model.data(), model.size());
+        } else {
+            const MappedFile cfg(config.config);
+            net = cv::dnn::readNetFromDarknet(cfg.data(), cfg.size(),
+                                              model.data(), model.size());
+        }
+    } catch (const std::runtime_error& e) {
+        throw std::runtime_error("Error loading YOLO model: " +
+                                 std::string(e.what()));
+    }
+    if (net.empty()) {
+        throw std::runtime_error("Error loading YOLO model " + config.model);
+    }
+    net.setPreferableBackend(cv::dnn::DNN_BACKEND_OPENCV);
+    net.setPreferableTarget(cv::dnn::DNN_TARGET_CPU);
+
+    switch (config.precision) {
+    case Precision::FP32:
+        break;
+    case Precision::FP16:
+#ifdef DETECTOR_BACKEND_CPU_FP16
+        // Falls back to FP32 kernels on CPUs without FP16 arithmetic.
+        net.setPreferableTarget(cv::dnn::DNN_TARGET_CPU_FP16);
+#else
+        throw std::runtime_error("FP16 CPU inference needs OpenCV 4.9 or newer, "
+                                 "this is " CV_VERSION);
+#endif
+        break;
+    case Precision::INT8:
+        // Without calibration data the model must already be quantised
+        // (e.g. a QDQ ONNX export), which readNet() loads as is.
+        if (!calibration.empty()) {
+#ifdef DETECTOR_BACKEND_QUANTIZE
+            // Float in and out, so preprocessing and decoding stay the same.
+            net = net.quantize(calibration, CV_32F, CV_32F);
+            net.setPreferableBackend(cv::dnn::DNN_BACKEND_OPENCV);
+            net.setPreferableTarget(cv::dnn::DNN_TARGET_CPU);
+#else
+            throw std::runtime_error("INT8 calibration needs OpenCV 4.5.4 or "
+                                     "newer, this is " CV_VERSION);
+#endif
+        }
+        break;
+    }
+    outputNames = net.getUnconnectedOutLayersNames();
+    description = "opencv " + std::string(config.isOnnx() ? "onnx" : "darknet") +
+                  " " + toString(config.precision);
+}
+
+/**
+ * @brief Factories added with registerBackend(), by engine name.
+ */
+std::map<std::string, BackendFactory>& registry() {
+    static std::map<std::string, BackendFactory> factories;
+    return factories;
+}
+
+std::mutex registryGuard;  ///< Protects registry().
+}  // namespace
+
+/**
+ * @brief Parses a precision name.
+ *
+ * @param name "fp32", "fp16" or "int8".
+ * @return Precision - The matching precision.
+ */
+Precision parsePrecision(const std::string& name) {
+    if (name == "fp32") {
+        return Precision::FP32;
+    }
+    if (name == "fp16") {
+        return Precision::FP16;
+    }
+    if (name == "int8") {
+        return Precision::INT8;
+    }
+    throw std::invalid_argument("Unknown precision: " + name);
+}
+
+/**
+ * @brief Names a precision.
+ *
+ * @param precision The precision.
+ * @return std::string - "fp32", "fp16" or "int8".
+ */
+std::string toString(Precision precision) {
+    switch (precision) {
+    case Precision::FP16:
+        return "fp16";
+    case Precision::INT8:
+        return "int8";
+    default:
+        return "fp32";
+    }
+}
+
+/**
+ * @brief Tells ONNX models from Darknet ones by their extension.
+ *
+ * @return bool - True if the model file ends in ".onnx".
+ */
+bool BackendConfig::isOnnx() const {
+    const std::string extension = ".onnx";
+    return model.size() >= extension.size() &&
+           model.compare(model.size() - extension.size(), extension.size(),
+                         extension) == 0;
+}
+
+/**
+ * @brief Returns one of the built-in model configurations.
+ *
+ * @param name Preset name.
+ * @return BackendConfig - The configuration, FP32 on OpenCV.
+ */
+BackendConfig BackendConfig::preset(const std::string& name) {
+    BackendConfig config;
+    if (name == "yolov3") {
+        return config;
+    }
+    if (name == "yolov3-tiny") {
+        config.model = "yolov3-tiny.weights";
+        config.config = "yolov3-tiny.cfg";
+        return config;
+    }
+    if (name == "yolov5s" || name == "yolov8n") {
+        config.model = name + ".onnx";
+        config.config.clear();
+        config.layout = name == "yolov5s" ? OutputLayout::YoloV5
+                                          : OutputLayout::YoloV8;
+        config.inputSize = 640;
+        return config;
+    }
+    throw std::invalid_argument("Unknown backend preset: " + name);
+}
+
+/**
+ * @brief Reads a backend configuration file.
+ *
+ * Recognised keys are preset, engine, model, config, layout (darknet,
+ * yolov5, yolov8), precision, input_size, calibration and
+ * calibration_frames.
+ *
+ * @param path YAML or JSON file.
+ * @return BackendConfig - The configuration.
+ */
+BackendConfig BackendConfig::load(const std::string& path) {
+    cv::FileStorage file(path, cv::FileStorage::READ);
+    if (!file.isOpened()) {
+        throw std::runtime_error("Cannot read backend config " + path);
+    }
+    try {
+        const cv::FileNode presetNode = file["preset"];
+        BackendConfig config = presetNode.empty()
+                                   ? BackendConfig()
+                                   : preset(presetNode.string());
+        const cv::FileNode engine = file["engine"];
+        if (!engine.empty()) {
+            config.engine = engine.string();
+        }
+        const cv::FileNode model = file["model"];
+        if (!model.empty()) {
+            config.model = model.string();
+            config.config.clear();  // A new model needs its own cfg.
+        }
+        const cv::FileNode cfg = file["config"];
+        if (!cfg.empty()) {
+            config.config = cfg.string();
+        }
+        const cv::FileNode layout = file["layout"];
+        if (!layout.empty()) {
+            config.layout = parseLayout(layout.string());
+        }
+        const cv::FileNode precision = file["precision"];
+        if (!precision.empty()) {
+            config.precision = parsePrecision(precision.string());
+        }
+        const cv::FileNode inputSize = file["input_size"];
+        if (!inputSize.empty()) {
+            config.inputSize = static_cast<int>(inputSize);
+        }
+        const cv::FileNode calibration = file["calibration"];
+        if (!calibration.empty()) {
+            config.calibration = calibration.string();
+        }
+        const cv::FileNode frames = file["calibration_frames"];
+        if (!frames.empty()) {
+            config.calibrationFrames = static_cast<int>(frames);
+        }
+        return config;
+    } catch (const std::invalid_argument& e) {
+        throw std::runtime_error(path + ": " + e.what());
+    }
+}
+
+/**
+ * @brief Registers a backend factory under an engine name.
+ *
+ * @param engine Name used in BackendConfig::engine.
+ * @param factory Creates the backend.
+ */
+void registerBackend(const std::string& engine, BackendFactory factory) {
+    std::lock_guard<std::mutex> lock(registryGuard);
+    registry()[engine] = std::move(factory);
+}
+
+/**
+ * @brief Creates a backend by engine name.
+ *
+ * @param config The model, precision and engine.
+ * @param calibration INT8 calibration blobs, may be empty.
+ * @return std::unique_ptr<DetectorBackend> - The loaded backend.
+ */
+std::unique_ptr<DetectorBackend> createBackend(
+    const BackendConfig& config, const std::vector<cv::Mat>& calibration) {
+    BackendFactory factory;
+    {
+        std::lock_guard<std::mutex> lock(registryGuard);
+        const auto found = registry().find(config.engine);
+        if (found != registry().end()) {
+            factory = found->second;
+        }
+    }
+    if (factory) {
+        return factory(config, calibration);
+    }
+    if (config.engine == "opencv") {
+        return std::unique_ptr<DetectorBackend>(
+            new OpenCVBackend(config, calibration));
+    }
+    throw std::invalid_argument("Unknown inference engine: " + config.engine);
+}
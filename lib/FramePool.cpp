@@ -0,0 +1,137 @@
+// Copyright 2026 Sai Surya Sriramoju
+
+/**
+ * @file FramePool.cpp
+ * @brief Implementation of the FramePool and FrameHandle classes.
+ * @author Sai Surya Sriramoju
+ * @date 10/17/2026
+ */
+
+#include "FramePool.h"
+
+#include <stdexcept>
+#include <utility>
+
+/**
+ * @brief Copy constructor; shares the frame.
+ */
+FrameHandle::FrameHandle(const FrameHandle& other) : slot(other.slot) {
+    if (slot != nullptr) {
+        slot->refs.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+/**
+ * @brief Move constructor; takes over the reference.
+ */
+FrameHandle::FrameHandle(FrameHandle&& other) noexcept : slot(other.slot) {
+    other.slot = nullptr;
+}
+
+/**
+ * @brief Copy and move assignment through a by-value parameter.
+ */
+FrameHandle& FrameHandle::operator=(FrameHandle other) noexcept {
+    std::swap(slot, other.slot);
+    return *this;
+}
+
+/**
+ * @brief Destructor; releases the reference.
+ */
+FrameHandle::~FrameHandle() {
+    reset();
+}
+
+/**
+ * @brief Releases the reference, recycling the slot if it was the last one.
+ */
+void FrameHandle::reset() {
+    if (slot != nullptr &&
+        slot->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        slot->pool->recycle(slot);
+    }
+    slot = nullptr;
+}
+
+/**
+ * @brief Returns the number of handles sharing the frame.
+ *
+ * @return int - Reference count, 0 for an empty handle.
+ */
+int FrameHandle::useCount() const {
+    return slot != nullptr ? slot->refs.load(std::memory_order_relaxed) : 0;
+}
+
+/**
+ * @brief Constructor; creates the slots and optionally pre-faults them.
+ */
+FramePool::FramePool(size_t capacity, cv::Size size, int type) {
+    if (capacity == 0) {
+        throw std::invalid_argument("FramePool capacity must be positive");
+    }
+    slots.reserve(capacity);
+    freeSlots.reserve(capacity);
+    for (size_t i = 0; i < capacity; ++i) {
+        slots.emplace_back(new FrameSlot());
+        slots.back()->pool = this;
+        if (!size.empty()) {
+            // Touch every page now rather than on the first capture.
+            slots.back()->image.create(size, type);
+            slots.back()->image.setTo(cv::Scalar::all(0));
+        }
+        freeSlots.push_back(slots.back().get());
+    }
+}
+
+/**
+ * @brief Hands out a free buffer, waiting for one if necessary.
+ *
+ * @param timeout Maximum time to wait when every buffer is in use.
+ * @return FrameHandle - The buffer, or an empty handle on timeout.
+ */
+FrameHandle FramePool::acquire(std::chrono::milliseconds timeout) {
+    std::unique_lock<std::mutex> lock(guard);
+    if (freeSlots.empty() &&
+        !slotFreed.wait_for(lock, timeout, [this] { return !freeSlots.empty(); })) {
+        ++misses;
+        return FrameHandle();
+    }
+    FrameSlot* slot = freeSlots.back();  // Most recently used: still in cache.
+    freeSlots.pop_back();
+    slot->refs.store(1, std::memory_order_relaxed);
+    return FrameHandle(slot);
+}
+
+/**
+ * @brief Returns the number of free buffers.
+ *
+ * @return size_t - Buffers acquire() can hand out without waiting.
+ */
+size_t FramePool::available() const {
+    std::lock_guard<std::mutex> lock(guard);
+    return freeSlots.size();
+}
+
+/**
+ * @brief Returns the number of failed acquire() calls.
+ *
+ * @return uint64_t - Times the pool was exhausted.
+ */
+uint64_t FramePool::exhausted() const {
+    std::lock_guard<std::mutex> lock(guard);
+    return misses;
+}
+
+/**
+ * @brief Puts a slot back on the free list and wakes one waiter.
+ *
+ * @param slot The slot whose last handle was released.
+ */
+void FramePool::recycle(FrameSlot* slot) {
+    {
+        std::lock_guard<std::mutex> lock(guard);
+        freeSlots.push_back(slot);
+    }
+    slotFreed.notify_one();
+}
@@ -0,0 +1,172 @@
+// Copyright 2026 Sai Surya Sriramoju
+
+/**
+ * @file JpegDecode.cpp
+ * @brief Implementation of the reduced-scale JPEG decode helpers.
+ * @author Sai Surya Sriramoju
+ * @date 10/17/2026
+ */
+
+#include "JpegDecode.h"
+
+#include <algorithm>
+#include <fstream>
+
+namespace {
+/**
+ * @brief Reads a big-endian 16-bit value.
+ */
+int be16(const uchar* p) {
+    return (p[0] << 8) | p[1];
+}
+
+/**
+ * @brief Returns true if @p marker starts a frame header (SOF0..SOF15),
+ *        which holds the image size.
+ */
+bool isFrameHeader(uchar marker) {
+    // C4 (DHT), C8 (JPG) and CC (DAC) share the range but are not SOFs.
+    return marker >= 0xC0 && marker <= 0xCF && marker != 0xC4 &&
+           marker != 0xC8 && marker != 0xCC;
+}
+}  // namespace
+
+/**
+ * @brief Walks the marker segments up to the frame header.
+ *
+ * @param data Start of the JPEG bytes.
+ * @param size Number of bytes.
+ * @param frame Receives the size.
+ * @return bool - False if no frame header was found.
+ */
+bool jpegSize(const uchar* data, size_t size, cv::Size& frame) {
+    if (size < 4 || data[0] != 0xFF || data[1] != 0xD8) {
+        return false;  // No SOI marker.
+    }
+    size_t i = 2;
+    while (i + 4 <= size) {
+        if (data[i] != 0xFF) {
+            return false;
+        }
+        const uchar marker = data[i + 1];
+        if (marker == 0xFF) {
+            ++i;  // Fill byte.
+            continue;
+        }
+        if (marker == 0x01 || (marker >= 0xD0 && marker <= 0xD7)) {
+            i += 2;  // Stand-alone markers have no length.
+            continue;
+        }
+        if (marker == 0xD9 || marker == 0xDA) {
+            return false;  // End of image or scan data before any SOF.
+        }
+        const size_t length = static_cast<size_t>(be16(data + i + 2));
+        if (isFrameHeader(marker)) {
+            if (length < 7 || i + 2 + length > size) {
+                return false;
+            }
+            frame.height = be16(data + i + 5);
+            frame.width = be16(data + i + 7);
+            return frame.width > 0 && frame.height > 0;
+        }
+        i += 2 + length;
+    }
+    return false;
+}
+
+/**
+ * @brief Picks the DCT scale denominator for a target long side.
+ *
+ * @param frame Full-resolution size.
+ * @param targetSide Long side to stay at or above.
+ * @return int - 1, 2, 4 or 8.
+ */
+int jpegReduction(cv::Size frame, int targetSide) {
+    if (targetSide <= 0) {
+        return 1;
+    }
+    const int longSide = std::max(frame.width, frame.height);
+    int reduction = 1;
+    while (reduction < 8 && longSide / (2 * reduction) >= targetSide) {
+        reduction *= 2;
+    }
+    return reduction;
+}
+
+/**
+ * @brief Decodes at a reduced scale when the input is a JPEG.
+ *
+ * imdecode() into an existing Mat may leave it untouched when it fails, so
+ * a JPEG's result is checked against the size its header announces, and
+ * other formats are decoded into a temporary first.
+ *
+ * @param encoded The compressed image.
+ * @param targetSide Long side to stay at or above.
+ * @param frame Receives the image.
+ * @param scale Receives full-resolution pixels per decoded pixel.
+ * @return bool - False if nothing could be decoded.
+ */
+bool decodeReduced(const cv::Mat& encoded, int targetSide, cv::Mat& frame,
+                   double& scale) {
+    cv::Size full;
+    if (!encoded.isContinuous() ||
+        !jpegSize(encoded.data, encoded.total() * encoded.elemSize(), full)) {
+        const cv::Mat decoded = cv::imdecode(encoded, cv::IMREAD_COLOR);
+        if (decoded.empty()) {
+            return false;
+        }
+        decoded.copyTo(frame);
+        scale = 1.0;
+        return true;
+    }
+    const int reduction = jpegReduction(full, targetSide);
+    int flags = cv::IMREAD_COLOR;
+    switch (reduction) {
+    case 2:
+        flags = cv::IMREAD_REDUCED_COLOR_2;
+        break;
+    case 4:
+        flags = cv::IMREAD_REDUCED_COLOR_4;
+        break;
+    case 8:
+        flags = cv::IMREAD_REDUCED_COLOR_8;
+        break;
+    default:
+        break;
+    }
+    const cv::Mat decoded = cv::imdecode(encoded, flags, &frame);
+    // libjpeg rounds scaled sizes up; EXIF orientation may swap the sides.
+    const cv::Size expected((full.width + reduction - 1) / reduction,
+                            (full.height + reduction - 1) / reduction);
+    if (decoded.empty() || (frame.size() != expected &&
+                            frame.size() != cv::Size(expected.height,
+                                                     expected.width))) {
+        return false;
+    }
+    scale = static_cast<double>(std::max(full.width, full.height)) /
+            std::max(frame.cols, frame.rows);
+    return true;
+}
+
+/**
+ * @brief Reads a file into a byte matrix.
+ *
+ * @param path The file.
+ * @return cv::Mat - 1 x N CV_8U bytes; empty on error.
+ */
+cv::Mat readEncoded(const std::string& path) {
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    if (!in) {
+        return cv::Mat();
+    }
+    const std::streamsize size = in.tellg();
+    if (size <= 0) {
+        return cv::Mat();
+    }
+    cv::Mat bytes(1, static_cast<int>(size), CV_8U);
+    in.seekg(0);
+    if (!in.read(reinterpret_cast<char*>(bytes.data), size)) {
+        return cv::Mat();
+    }
+    return bytes;
+}
@@ -0,0 +1,65 @@
+// Copyright 2026 Sai Surya Sriramoju
+
+/**
+ * @file MappedFile.cpp
+ * @brief Implementation of the MappedFile class.
+ * @author Sai Surya Sriramoju
+ * @date 10/17/2026
+ */
+
+#include "MappedFile.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+/**
+ * @brief Constructor; opens, maps and closes the file descriptor.
+ *
+ * @param path The file to map.
+ * @param sequential Advise the kernel to read ahead.
+ */
+MappedFile::MappedFile(const std::string& path, bool sequential) {
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        throw std::runtime_error("Cannot open " + path + ": " +
+                                 std::strerror(errno));
+    }
+    struct stat info;
+    if (::fstat(fd, &info) != 0) {
+        const int error = errno;
+        ::close(fd);
+        throw std::runtime_error("Cannot stat " + path + ": " +
+                                 std::strerror(error));
+    }
+    length = static_cast<size_t>(info.st_size);
+    if (length > 0) {
+        void* mapping = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapping == MAP_FAILED) {
+            const int error = errno;
+            ::close(fd);
+            throw std::runtime_error("Cannot map " + path + ": " +
+                                     std::strerror(error));
+        }
+        bytes = static_cast<const char*>(mapping);
+        if (sequential) {
+            ::madvise(mapping, length, MADV_SEQUENTIAL);
+            ::madvise(mapping, length, MADV_WILLNEED);
+        }
+    }
+    ::close(fd);  // The mapping keeps the file alive.
+}
+
+/**
+ * @brief Destructor; removes the mapping.
+ */
+MappedFile::~MappedFile() {
+    if (bytes != nullptr) {
+        ::munmap(const_cast<char*>(bytes), length);
+    }
+}
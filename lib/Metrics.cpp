@@ -0,0 +1,412 @@
+// Copyright 2026 Sai Surya Sriramoju
+
+/**
+ * @file Metrics.cpp
+ * @brief Implementation of the histograms, the registry and the exporter.
+ * @author Sai Surya Sriramoju
+ * @date 10/17/2026
+ */
+
+#include "Metrics.h"
+
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+/// Hands out shard indices in the order threads first record.
+std::atomic<size_t> nextThread{0};
+
+/**
+ * @brief Returns the shard of the calling thread.
+ */
+size_t threadShard() {
+    thread_local const size_t shard =
+        nextThread.fetch_add(1, std::memory_order_relaxed) % Histogram::kShards;
+    return shard;
+}
+
+/**
+ * @brief Formats a Prometheus series name with its labels.
+ */
+std::string seriesName(const std::string& name, const std::string& labels,
+                       const std::string& extra = "") {
+    std::string all = labels;
+    if (!extra.empty()) {
+        all += (all.empty() ? "" : ",") + extra;
+    }
+    return all.empty() ? name : name + "{" + all + "}";
+}
+}  // namespace
+
+/**
+ * @brief Estimates a quantile from the bucket counts.
+ *
+ * @param q Quantile between 0 and 1.
+ * @return double - The estimate in seconds, 0 without values.
+ */
+double HistogramSnapshot::quantile(double q) const {
+    if (count == 0) {
+        return 0.0;
+    }
+    const std::vector<uint64_t>& upper = Histogram::bounds();
+    const double rank = std::min(std::max(q, 0.0), 1.0) * count;
+    uint64_t below = 0;
+    for (size_t i = 0; i < counts.size(); ++i) {
+        if (counts[i] == 0 || below + counts[i] < rank) {
+            below += counts[i];
+            continue;
+        }
+        if (i >= upper.size()) {
+            return upper.back() * 1e-6;  // Overflow: report the last bound.
+        }
+        const double low = i == 0 ? 0.0 : static_cast<double>(upper[i - 1]);
+        const double fraction = (rank - below) / counts[i];
+        return (low + fraction * (upper[i] - low)) * 1e-6;
+    }
+    return upper.back() * 1e-6;
+}
+
+/**
+ * @brief Builds the bucket bounds once: 1, 2, 3 us, then four linear steps
+ *        per power of two up to 2^26 us.
+ *
+ * @return const std::vector<uint64_t>& - Upper bounds in microseconds.
+ */
+const std::vector<uint64_t>& Histogram::bounds() {
+    static const std::vector<uint64_t> upper = [] {
+        std::vector<uint64_t> values = {1, 2, 3};
+        for (int e = 2; e < 26; ++e) {
+            const uint64_t base = uint64_t(1) << e;
+            for (uint64_t step = 0; step < 4; ++step) {
+                values.push_back(base + step * (base >> 2));
+            }
+        }
+        values.push_back(uint64_t(1) << 26);
+        return values;
+    }();
+    return upper;
+}
+
+/**
+ * @brief Constructor; zeroes every shard.
+ */
+Histogram::Histogram() : shards(new Shard[kShards]) {
+    static_assert(kMaxBuckets >= 3 + 24 * 4 + 2, "too few buckets");
+    for (size_t s = 0; s < kShards; ++s) {
+        for (auto& count : shards[s].counts) {
+            count.store(0, std::memory_order_relaxed);
+        }
+        shards[s].sumNs.store(0, std::memory_order_relaxed);
+    }
+}
+
+/**
+ * @brief Records one duration into the calling thread's shard.
+ *
+ * @param elapsed The duration.
+ */
+void Histogram::record(std::chrono::steady_clock::duration elapsed) {
+    const int64_t ns = std::max<int64_t>(
+        0, std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+    const uint64_t us = static_cast<uint64_t>(ns + 999) / 1000;  // Round up.
+    const std::vector<uint64_t>& upper = bounds();
+    const size_t bucket = static_cast<size_t>(
+        std::lower_bound(upper.begin(), upper.end(), us) - upper.begin());
+    Shard& shard = shards[threadShard()];
+    shard.counts[bucket].fetch_add(1, std::memory_order_relaxed);
+    shard.sumNs.fetch_add(static_cast<uint64_t>(ns), std::memory_order_relaxed);
+}
+
+/**
+ * @brief Adds up the shards.
+ *
+ * @return HistogramSnapshot - Bucket counts, total count and sum. Values
+ *         recorded concurrently may or may not be included.
+ */
+HistogramSnapshot Histogram::snapshot() const {
+    HistogramSnapshot result;
+    result.counts.assign(bounds().size() + 1, 0);
+    uint64_t sumNs = 0;
+    for (size_t s = 0; s < kShards; ++s) {
+        for (size_t i = 0; i < result.counts.size(); ++i) {
+            result.counts[i] += shards[s].counts[i].load(std::memory_order_relaxed);
+        }
+        sumNs += shards[s].sumNs.load(std::memory_order_relaxed);
+    }
+    for (uint64_t count : result.counts) {
+        result.count += count;
+    }
+    result.sumSeconds = sumNs * 1e-9;
+    return result;
+}
+
+/**
+ * @brief Returns the histogram @p name{@p labels}, creating it if needed.
+ *
+ * @param name Family name.
+ * @param labels Label pairs, e.g. stage="forward".
+ * @param help HELP text of the family.
+ * @return Histogram& - Valid for the registry's lifetime.
+ */
+Histogram& Metrics::histogram(const std::string& name, const std::string& labels,
+                              const std::string& help) {
+    std::lock_guard<std::mutex> lock(guard);
+    for (const auto& entry : series) {
+        if (entry->kind == Kind::Histogram && entry->name == name &&
+            entry->labels == labels) {
+            return *entry->histogram;
+        }
+    }
+    std::unique_ptr<Series> entry(new Series());
+    entry->name = name;
+    entry->labels = labels;
+    entry->help = help;
+    entry->kind = Kind::Histogram;
+    entry->histogram.reset(new Histogram());
+    series.push_back(std::move(entry));
+    return *series.back()->histogram;
+}
+
+/**
+ * @brief Registers a counter sampled from @p read.
+ */
+void Metrics::counter(const std::string& name, const std::string& labels,
+                      const std::string& help, std::function<double()> read) {
+    add(name, labels, help, Kind::Counter, std::move(read));
+}
+
+/**
+ * @brief Registers a gauge sampled from @p read.
+ */
+void Metrics::gauge(const std::string& name, const std::string& labels,
+                    const std::string& help, std::function<double()> read) {
+    add(name, labels, help, Kind::Gauge, std::move(read));
+}
+
+/**
+ * @brief Adds a sampled series.
+ */
+void Metrics::add(const std::string& name, const std::string& labels,
+                  const std::string& help, Kind kind,
+                  std::function<double()> read) {
+    std::unique_ptr<Series> entry(new Series());
+    entry->name = name;
+    entry->labels = labels;
+    entry->help = help;
+    entry->kind = kind;
+    entry->read = std::move(read);
+    std::lock_guard<std::mutex> lock(guard);
+    series.push_back(std::move(entry));
+}
+
+/**
+ * @brief Formats p50/p95/p99 and counts of every histogram.
+ *
+ * @return std::string - One line per histogram, times in milliseconds.
+ */
+std::string Metrics::summary() const {
+    std::lock_guard<std::mutex> lock(guard);
+    std::ostringstream report;
+    report << std::fixed << std::setprecision(2);
+    for (const auto& entry : series) {
+        if (entry->kind != Kind::Histogram) {
+            continue;
+        }
+        const HistogramSnapshot snapshot = entry->histogram->snapshot();
+        report << "  " << std::left << std::setw(44)
+               << seriesName(entry->name, entry->labels) << std::right
+               << " p50 " << std::setw(8) << 1e3 * snapshot.quantile(0.50)
+               << " ms  p95 " << std::setw(8) << 1e3 * snapshot.quantile(0.95)
+               << " ms  p99 " << std::setw(8) << 1e3 * snapshot.quantile(0.99)
+               << " ms  n " << snapshot.count << "\n";
+    }
+    return report.str();
+}
+
+/**
+ * @brief Formats every series in the Prometheus text exposition format.
+ *
+ * Series of one family are written together under one HELP and TYPE line,
+ * in the order the family was first registered.
+ *
+ * @return std::string - The exposition text.
+ */
+std::string Metrics::prometheus() const {
+    static const char* const types[] = {"histogram", "counter", "gauge"};
+    std::lock_guard<std::mutex> lock(guard);
+    const std::vector<uint64_t>& upper = Histogram::bounds();
+    std::ostringstream text;
+    text << std::setprecision(9);
+    std::set<std::string> written;
+    for (const auto& family : series) {
+        if (!written.insert(family->name).second) {
+            continue;
+        }
+        text << "# HELP " << family->name << " " << family->help << "\n"
+             << "# TYPE " << family->name << " "
+             << types[static_cast<int>(family->kind)] << "\n";
+        for (const auto& entry : series) {
+            if (entry->name != family->name) {
+                continue;
+            }
+            if (entry->kind != Kind::Histogram) {
+                text << seriesName(entry->name, entry->labels) << " "
+                     << entry->read() << "\n";
+                continue;
+            }
+            const HistogramSnapshot snapshot = entry->histogram->snapshot();
+            uint64_t cumulative = 0;
+            for (size_t i = 0; i < upper.size(); ++i) {
+                cumulative += snapshot.counts[i];
+                std::ostringstream le;
+                le << "le=\"" << upper[i] * 1e-6 << "\"";
+                text << seriesName(entry->name + "_bucket", entry->labels, le.str())
+                     << " " << cumulative << "\n";
+            }
+            text << seriesName(entry->name + "_bucket", entry->labels, "le=\"+Inf\"")
+                 << " " << snapshot.count << "\n"
+                 << seriesName(entry->name + "_sum", entry->labels) << " "
+                 << snapshot.sumSeconds << "\n"
+                 << seriesName(entry->name + "_count", entry->labels) << " "
+                 << snapshot.count << "\n";
+        }
+    }
+    return text.str();
+}
+
+/**
+ * @brief Constructor; binds the endpoint and starts the thread.
+ *
+ * @param metrics The registry to publish.
+ * @param config File, port and interval.
+ */
+MetricsExporter::MetricsExporter(const Metrics& metrics,
+                                 const ExporterConfig& config)
+    : metrics(metrics), config(config) {
+    if (config.port > 0) {
+        listener = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (listener < 0) {
+            throw std::runtime_error(std::string("Cannot create socket: ") +
+                                     std::strerror(errno));
+        }
+        const int reuse = 1;
+        ::setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+        sockaddr_in address;
+        std::memset(&address, 0, sizeof(address));
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);  // Local only.
+        address.sin_port = htons(static_cast<uint16_t>(config.port));
+        if (::bind(listener, reinterpret_cast<const sockaddr*>(&address),
+                   sizeof(address)) != 0 ||
+            ::listen(listener, 4) != 0) {
+            const int error = errno;
+            ::close(listener);
+            throw std::runtime_error("Cannot listen on 127.0.0.1:" +
+                                     std::to_string(config.port) + ": " +
+                                     std::strerror(error));
+        }
+        boundPort = config.port;
+    }
+    worker = std::thread(&MetricsExporter::run, this);
+}
+
+/**
+ * @brief Destructor; stops the thread and writes the final values.
+ */
+MetricsExporter::~MetricsExporter() {
+    stopping = true;
+    if (worker.joinable()) {
+        worker.join();
+    }
+    if (listener >= 0) {
+        ::close(listener);
+    }
+    writeFile();
+}
+
+/**
+ * @brief Writes the file atomically so a scraper never sees half of it.
+ */
+void MetricsExporter::writeFile() const {
+    if (config.file.empty()) {
+        return;
+    }
+    const std::string temporary = config.file + ".tmp";
+    {
+        std::ofstream file(temporary);
+        file << metrics.prometheus();
+        if (!file) {
+            return;  // Try again on the next interval.
+        }
+    }
+    std::rename(temporary.c_str(), config.file.c_str());
+}
+
+/**
+ * @brief Accepts one connection and answers it with the exposition text.
+ *
+ * The request itself is read and ignored: every path returns the metrics.
+ */
+void MetricsExporter::serve() const {
+    const int client = ::accept4(listener, nullptr, nullptr, SOCK_CLOEXEC);
+    if (client < 0) {
+        return;
+    }
+    pollfd request = {client, POLLIN, 0};
+    if (::poll(&request, 1, 1000) > 0) {
+        char buffer[1024];
+        ::recv(client, buffer, sizeof(buffer), 0);
+    }
+    const std::string body = metrics.prometheus();
+    const std::string response =
+        "HTTP/1.0 200 OK\r\n"
+        "Content-Type: text/plain; version=0.0.4\r\n"
+        "Content-Length: " + std::to_string(body.size()) + "\r\n"
+        "Connection: close\r\n\r\n" + body;
+    size_t sent = 0;
+    while (sent < response.size()) {
+        const ssize_t n = ::send(client, response.data() + sent,
+                                 response.size() - sent, MSG_NOSIGNAL);
+        if (n <= 0) {
+            break;
+        }
+        sent += static_cast<size_t>(n);
+    }
+    ::close(client);
+}
+
+/**
+ * @brief Thread body: serves requests and rewrites the file until stopped.
+ */
+void MetricsExporter::run() {
+    // Short waits so the destructor never blocks for a whole interval.
+    const int tick = 100;
+    auto lastWrite = std::chrono::steady_clock::now();
+    while (!stopping) {
+        if (listener >= 0) {
+            pollfd pending = {listener, POLLIN, 0};
+            if (::poll(&pending, 1, tick) > 0) {
+                serve();
+            }
+        } else {
+            std::this_thread::sleep_for(std::chrono::milliseconds(tick));
+        }
+        const auto now = std::chrono::steady_clock::now();
+        if (now - lastWrite >= config.interval) {
+            writeFile();
+            lastWrite = now;
+        }
+    }
+}
@@ -0,0 +1,76 @@
+// Copyright 2026 Sai Surya Sriramoju
+
+/**
+ * @file ModelLoader.cpp
+ * @brief Implementation of the ModelLoader class.
+ * @author Sai Surya Sriramoju
+ * @date 10/17/2026
+ */
+
+#include "ModelLoader.h"
+
+#include <utility>
+
+/**
+ * @brief Constructor; the load starts immediately on its own thread.
+ *
+ * @param config The detector backend to load.
+ * @param prepare Hook run on the loaded detector before it is ready.
+ */
+ModelLoader::ModelLoader(const BackendConfig& config, Prepare prepare) {
+    result = std::async(std::launch::async, [this, config, prepare] {
+        using Clock = std::chrono::steady_clock;
+        const auto begin = Clock::now();
+        std::unique_ptr<YOLO> yolo(new YOLO(config));
+        const auto loaded = Clock::now();
+        if (prepare) {
+            prepare(*yolo);
+        }
+        timings.loadMs =
+            std::chrono::duration<double, std::milli>(loaded - begin).count();
+        timings.prepareMs =
+            std::chrono::duration<double, std::milli>(Clock::now() - loaded).count();
+        return yolo;
+    });
+}
+
+/**
+ * @brief Destructor; joins the loader thread.
+ */
+ModelLoader::~ModelLoader() {
+    if (result.valid()) {
+        result.wait();
+    }
+}
+
+/**
+ * @brief Polls the readiness signal.
+ *
+ * @return bool - True if get() would not block.
+ */
+bool ModelLoader::ready() const {
+    return waitFor(std::chrono::milliseconds(0));
+}
+
+/**
+ * @brief Waits a bounded time for the detector.
+ *
+ * @param timeout Longest wait.
+ * @return bool - True if get() would not block.
+ */
+bool ModelLoader::waitFor(std::chrono::milliseconds timeout) const {
+    return !result.valid() ||
+           result.wait_for(timeout) == std::future_status::ready;
+}
+
+/**
+ * @brief Takes the loaded detector, waiting if necessary.
+ *
+ * @return std::unique_ptr<YOLO> - The detector, or nullptr if already taken.
+ */
+std::unique_ptr<YOLO> ModelLoader::get() {
+    if (!result.valid()) {
+        return nullptr;
+    }
+    return result.get();
+}
@@ -0,0 +1,210 @@
+// Copyright 2026 Sai Surya Sriramoju
+
+/**
+ * @file NMS.cpp
+ * @brief Implementation of the NMSEngine class.
+ * @author Sai Surya Sriramoju
+ * @date 10/17/2026
+ */
+
+#include "NMS.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+#include "DecodeKernels.h"
+
+/**
+ * @brief Constructor; reserves every working buffer up front.
+ *
+ * @param capacity Expected maximum number of candidates per call.
+ */
+NMSEngine::NMSEngine(size_t capacity) {
+    order.reserve(capacity);
+    x1.reserve(capacity);
+    y1.reserve(capacity);
+    x2.reserve(capacity);
+    y2.reserve(capacity);
+    area.reserve(capacity);
+    scores.reserve(capacity);
+    classIds.reserve(capacity);
+    iou.reserve(capacity);
+}
+
+/**
+ * @brief Suppresses overlapping candidates.
+ *
+ * Candidates above the score threshold are sorted by descending score
+ * (grouped by class when class aware, ties broken by index) and laid out as
+ * corner arrays; each class segment is then suppressed independently.
+ *
+ * @param candidates Boxes to filter.
+ * @param config Thresholds and mode.
+ * @param kept Receives the surviving boxes.
+ */
+void NMSEngine::run(const Detections& candidates, const NMSConfig& config,
+                    Detections& kept) {
+    kept.clear();
+    order.clear();
+    const std::vector<float>& inScores = candidates.scores;
+    const std::vector<int>& inClasses = candidates.classIds;
+    for (size_t i = 0; i < candidates.size(); ++i) {
+        if (inScores[i] > config.scoreThreshold) {
+            order.push_back(static_cast<int>(i));
+        }
+    }
+    const bool classAware = config.classAware;
+    std::sort(order.begin(), order.end(), [&](int a, int b) {
+        if (classAware && inClasses[a] != inClasses[b]) {
+            return inClasses[a] < inClasses[b];
+        }
+        return inScores[a] > inScores[b] ||
+               (inScores[a] == inScores[b] && a < b);
+    });
+
+    const int n = static_cast<int>(order.size());
+    x1.resize(n);
+    y1.resize(n);
+    x2.resize(n);
+    y2.resize(n);
+    area.resize(n);
+    scores.resize(n);
+    classIds.resize(n);
+    iou.resize(n);
+    for (int k = 0; k < n; ++k) {
+        const int i = order[k];
+        x1[k] = candidates.x[i];
+        y1[k] = candidates.y[i];
+        x2[k] = candidates.x[i] + candidates.width[i];
+        y2[k] = candidates.y[i] + candidates.height[i];
+        area[k] = candidates.width[i] * candidates.height[i];
+        scores[k] = inScores[i];
+        classIds[k] = inClasses[i];
+    }
+
+    int begin = 0;
+    while (begin < n) {
+        int end = begin + 1;
+        if (classAware) {
+            while (end < n && classIds[end] == classIds[begin]) {
+                ++end;
+            }
+        } else {
+            end = n;
+        }
+        if (config.mode == NMSMode::Hard) {
+            hardSegment(begin, end, config, kept);
+        } else {
+            softSegment(begin, end, config, kept);
+        }
+        begin = end;
+    }
+}
+
+/**
+ * @brief Greedy hard NMS over a score-sorted segment.
+ *
+ * After each kept box the remaining boxes are compacted so later passes only
+ * stream over survivors.
+ */
+void NMSEngine::hardSegment(int begin, int end, const NMSConfig& config,
+                            Detections& kept) {
+    for (int i = begin; i < end; ++i) {
+        keep(i, kept);
+        const int rest = end - (i + 1);
+        if (rest == 0) {
+            break;
+        }
+        const float box[5] = {x1[i], y1[i], x2[i], y2[i], area[i]};
+        iouOneToMany(box, &x1[i + 1], &y1[i + 1], &x2[i + 1], &y2[i + 1],
+                     &area[i + 1], rest, iou.data());
+        int write = i + 1;
+        for (int k = 0; k < rest; ++k) {
+            if (iou[k] <= config.iouThreshold) {
+                moveBox(i + 1 + k, write++);
+            }
+        }
+        end = write;
+    }
+}
+
+/**
+ * @brief Soft-NMS over a segment.
+ *
+ * Repeatedly keeps the highest remaining score, decays the scores of the
+ * boxes overlapping it and drops the ones that fall to the score threshold.
+ */
+void NMSEngine::softSegment(int begin, int end, const NMSConfig& config,
+                            Detections& kept) {
+    for (int i = begin; i < end; ++i) {
+        float best = 0.0f;
+        const int top = i + argmaxScores(&scores[i], end - i, &best);
+        if (best <= config.scoreThreshold) {
+            break;
+        }
+        swapBoxes(i, top);
+        keep(i, kept);
+        const int rest = end - (i + 1);
+        if (rest == 0) {
+            break;
+        }
+        const float box[5] = {x1[i], y1[i], x2[i], y2[i], area[i]};
+        iouOneToMany(box, &x1[i + 1], &y1[i + 1], &x2[i + 1], &y2[i + 1],
+                     &area[i + 1], rest, iou.data());
+        int write = i + 1;
+        for (int k = 0; k < rest; ++k) {
+            const int j = i + 1 + k;
+            const float overlap = iou[k];
+            if (config.mode == NMSMode::SoftGaussian) {
+                scores[j] *= std::exp(-(overlap * overlap) / config.sigma);
+            } else if (overlap > config.iouThreshold) {
+                scores[j] *= 1.0f - overlap;
+            }
+            if (scores[j] > config.scoreThreshold) {
+                moveBox(j, write++);
+            }
+        }
+        end = write;
+    }
+}
+
+/**
+ * @brief Appends sorted box @p i to the output.
+ */
+void NMSEngine::keep(int i, Detections& kept) const {
+    kept.push(x1[i], y1[i], x2[i] - x1[i], y2[i] - y1[i], scores[i],
+              classIds[i]);
+}
+
+/**
+ * @brief Copies sorted box @p from over sorted box @p to.
+ */
+void NMSEngine::moveBox(int from, int to) {
+    if (from == to) {
+        return;
+    }
+    x1[to] = x1[from];
+    y1[to] = y1[from];
+    x2[to] = x2[from];
+    y2[to] = y2[from];
+    area[to] = area[from];
+    scores[to] = scores[from];
+    classIds[to] = classIds[from];
+}
+
+/**
+ * @brief Exchanges sorted boxes @p a and @p b.
+ */
+void NMSEngine::swapBoxes(int a, int b) {
+    if (a == b) {
+        return;
+    }
+    std::swap(x1[a], x1[b]);
+    std::swap(y1[a], y1[b]);
+    std::swap(x2[a], x2[b]);
+    std::swap(y2[a], y2[b]);
+    std::swap(area[a], area[b]);
+    std::swap(scores[a], scores[b]);
+    std::swap(classIds[a], classIds[b]);
+}
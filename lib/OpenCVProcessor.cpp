@@ -9,6 +9,8 @@
 
 #include "OpenCVProcessor.h"
 
+#include <algorithm>
+
 /**
  * @brief Processes the given frame using OpenCV functions.
  * 
@@ -19,6 +21,103 @@
  */
 void OpenCVProcessor::processImages(const cv::Mat& frame) {
     // Apply Gaussian blur as a sample image processing step
-    cv::GaussianBlur(frame, frame, cv::Size(5, 5), 0);
+    if (enabled.gaussianBlur) {
+        cv::GaussianBlur(frame, frame, cv::Size(5, 5), 0);
+    }
+}
+
+/**
+ * @brief Constructor; the gate starts without a reference frame.
+ *
+ * @param config Motion gate tunables.
+ */
+MotionGate::MotionGate(const MotionGateConfig& config) : config(config) {
+    if (config.backgroundSubtraction) {
+        background = cv::createBackgroundSubtractorMOG2(500, 16, false);
+    }
 }
 
+/**
+ * @brief Measures motion against the reference and picks a region to run on.
+ *
+ * @param frame The BGR frame.
+ * @param regions Regions to include in the crop, in frame pixels.
+ * @return GateDecision - Whether to run and where.
+ */
+GateDecision MotionGate::evaluate(const cv::Mat& frame,
+                                  const std::vector<cv::Rect>& regions) {
+    const int scale = std::max(1, config.downscale);
+    cv::resize(frame, small, cv::Size(), 1.0 / scale, 1.0 / scale, cv::INTER_AREA);
+    if (small.channels() == 3) {
+        cv::cvtColor(small, small, cv::COLOR_BGR2GRAY);
+    }
+
+    GateDecision decision;
+    const bool firstFrame = previous.empty();
+    if (background) {
+        background->apply(small, mask);
+    } else if (!firstFrame) {
+        cv::absdiff(small, previous, mask);
+    }
+    cv::swap(small, previous);
+
+    const bool refresh = firstFrame ||
+        (config.refreshEvery > 0 && ++sinceRefresh >= config.refreshEvery);
+    if (refresh) {
+        sinceRefresh = 0;
+        hitCount.fetch_add(1, std::memory_order_relaxed);
+        return decision;  // Whole frame.
+    }
+
+    cv::threshold(mask, mask, config.diffThreshold, 255, cv::THRESH_BINARY);
+    const int changed = cv::countNonZero(mask);
+    if (changed < config.minChangedFraction * mask.total()) {
+        decision.run = false;
+        skipCount.fetch_add(1, std::memory_order_relaxed);
+        return decision;
+    }
+
+    cv::findNonZero(mask, points);
+    const cv::Rect motion = cv::boundingRect(points);
+    cv::Rect roi(motion.x * scale, motion.y * scale, motion.width * scale,
+                 motion.height * scale);
+    for (const cv::Rect& region : regions) {
+        roi |= region;
+    }
+    roi.x -= config.padding;
+    roi.y -= config.padding;
+    roi.width += 2 * config.padding;
+    roi.height += 2 * config.padding;
+    roi &= cv::Rect(0, 0, frame.cols, frame.rows);
+
+    hitCount.fetch_add(1, std::memory_order_relaxed);
+    if (roi.area() < config.maxCropFraction * frame.total()) {
+        decision.roi = roi;
+        cropCount.fetch_add(1, std::memory_order_relaxed);
+    }
+    return decision;
+}
+
+/**
+ * @brief Reads the counters.
+ *
+ * @return GateStats - Hits, skips and crops so far.
+ */
+GateStats MotionGate::stats() const {
+    GateStats stats;
+    stats.hits = hitCount.load(std::memory_order_relaxed);
+    stats.skips = skipCount.load(std::memory_order_relaxed);
+    stats.cropped = cropCount.load(std::memory_order_relaxed);
+    return stats;
+}
+
+/**
+ * @brief Drops the reference frame and background model.
+ */
+void MotionGate::reset() {
+    previous.release();
+    sinceRefresh = 0;
+    if (config.backgroundSubtraction) {
+        background = cv::createBackgroundSubtractorMOG2(500, 16, false);
+    }
+}
@@ -0,0 +1,881 @@
+// Copyright 2026 Sai Surya Sriramoju
+
+/**
+ * @file Pipeline.cpp
+ * @brief Implementation of the multi-stage perception pipeline.
+ * @author Sai Surya Sriramoju
+ * @date 10/17/2026
+ */
+
+#include "Pipeline.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+#include <utility>
+
+namespace {
+/// How long a stage waits on its input queue before re-checking for stop().
+const std::chrono::milliseconds kPollInterval(50);
+/// Frames to wait after an input size change before changing it again.
+const int kResizeHoldFrames = 10;
+
+/**
+ * @brief Number of frame buffers the pipeline needs for @p config.
+ *
+ * Three queues can be full while each of the four stages holds one more.
+ */
+size_t framePoolSize(const PipelineConfig& config) {
+    return config.framePoolSize > 0 ? config.framePoolSize
+                                    : 3 * config.queueCapacity + 4;
+}
+
+/**
+ * @brief Pins the calling stage thread, reporting a failure to @p log.
+ */
+void pinStage(const CpuList& cpus, const char* stage, std::ostream* log) {
+    if (!pinCurrentThread(cpus) && log != nullptr) {
+        *log << "Cannot pin the " << stage << " stage to CPUs "
+             << formatCpuList(cpus) << "\n";
+    }
+}
+
+/**
+ * @brief Collects the (u, v) pixel coordinates of tracks into @p pixelCoords,
+ *        reusing its capacity.
+ */
+void trackCoordinates(const std::vector<Track>& tracks,
+                      std::vector<double>& pixelCoords) {
+    pixelCoords.clear();
+    pixelCoords.reserve(2 * tracks.size());
+    for (const Track& track : tracks) {
+        const cv::Rect box = track.box;
+        pixelCoords.push_back(box.x);
+        pixelCoords.push_back(box.y);
+    }
+}
+
+/**
+ * @brief Draws tracks with their ids.
+ *
+ * Uses the same palette and label style as YOLO's detection annotation, but
+ * the label number is the persistent track id.
+ */
+void drawTracks(const std::vector<Track>& tracks, const cv::Mat& frame) {
+    static const cv::Scalar colors[] = {
+      cv::Scalar(255, 255, 0), cv::Scalar(0, 255, 0), cv::Scalar(0, 255, 255),
+      cv::Scalar(255, 0, 0)};
+    const int numColors = sizeof(colors) / sizeof(colors[0]);
+
+    for (const Track& track : tracks) {
+        const cv::Rect box = track.box;
+        const cv::Scalar& color = colors[track.id % numColors];
+        cv::rectangle(frame, box, color, 3);
+        cv::rectangle(frame, cv::Point(box.x, box.y - 35),
+                      cv::Point(box.x + box.width, box.y), color, cv::FILLED);
+        cv::putText(frame, "Human_" + std::to_string(track.id),
+                    cv::Point(box.x, box.y - 5), cv::FONT_HERSHEY_SIMPLEX, 1,
+                    cv::Scalar(0, 0, 0), 2);
+    }
+}
+}  // namespace
+
+/**
+ * @brief Constructor; wires up the queues but does not start any thread.
+ */
+Pipeline::Pipeline(Camera& camera, YOLO& yolo, OpenCVProcessor& processor,
+                   CoordToWorld& world, const PipelineConfig& config)
+    : camera(&camera), yolo(yolo), processor(processor), world(world),
+      config(config), framePool(framePoolSize(config)),
+      capturedQueue(config.queueCapacity, config.overflow),
+      detectedQueue(config.queueCapacity, config.overflow),
+      projectedQueue(config.queueCapacity, config.overflow),
+      spareTasks(framePoolSize(config)) {
+    stageList = {&captureStats, &inferenceStats, &projectionStats,
+                 &outputStats};
+    if (config.schedule) {
+        scheduler.reset(new DeadlineScheduler<FrameTask>(config.scheduler));
+    }
+    registerMetrics();
+}
+
+/**
+ * @brief Constructor for a pipeline fed by a CaptureManager.
+ */
+Pipeline::Pipeline(CaptureManager& capture, YOLO& yolo,
+                   OpenCVProcessor& processor, CoordToWorld& world,
+                   const PipelineConfig& config)
+    : capture(&capture), yolo(yolo), processor(processor), world(world),
+      config(config), framePool(framePoolSize(config)),
+      capturedQueue(config.queueCapacity, config.overflow),
+      detectedQueue(config.queueCapacity, config.overflow),
+      projectedQueue(config.queueCapacity, config.overflow),
+      spareTasks(framePoolSize(config)) {
+    stageList = {&captureStats, &inferenceStats, &projectionStats,
+                 &outputStats};
+    if (config.schedule) {
+        scheduler.reset(new DeadlineScheduler<FrameTask>(config.scheduler));
+    }
+    registerMetrics();
+}
+
+/**
+ * @brief Registers the pipeline's series with config.metrics.
+ *
+ * Stage and detector step latencies share the perception_stage_seconds
+ * family so they can be compared on one chart; queue depths and drops are
+ * sampled from the queues when a report is made.
+ */
+void Pipeline::registerMetrics() {
+    Metrics* metrics = config.metrics;
+    if (metrics == nullptr) {
+        return;
+    }
+    const std::string stageFamily = "perception_stage_seconds";
+    const std::string stageHelp = "Time spent per frame in each stage.";
+    for (StageStats* stage : {&captureStats, &inferenceStats, &projectionStats,
+                              &outputStats}) {
+        stage->attach(&metrics->histogram(
+            stageFamily, "stage=\"" + stage->name() + "\"", stageHelp));
+    }
+    InferenceTimers timers;
+    timers.preprocess = &metrics->histogram(stageFamily,
+                                            "stage=\"preprocess\"", stageHelp);
+    timers.forward = &metrics->histogram(stageFamily, "stage=\"forward\"",
+                                         stageHelp);
+    timers.decode = &metrics->histogram(stageFamily, "stage=\"decode\"",
+                                        stageHelp);
+    timers.nms = &metrics->histogram(stageFamily, "stage=\"nms\"", stageHelp);
+    yolo.setTimers(timers);
+    frameLatency = &metrics->histogram(
+        "perception_frame_latency_seconds", "",
+        "Time from capture to the output stage per frame.");
+
+    const std::pair<const char*, const BoundedQueue<FrameTask>*> queues[] = {
+        {"captured", &capturedQueue},
+        {"detected", &detectedQueue},
+        {"projected", &projectedQueue}};
+    for (const auto& queue : queues) {
+        const BoundedQueue<FrameTask>* q = queue.second;
+        if (q == &capturedQueue && scheduler) {
+            continue;  // Frames wait in the scheduler instead.
+        }
+        const std::string labels = std::string("queue=\"") + queue.first + "\"";
+        metrics->gauge("perception_queue_depth", labels,
+                       "Frames waiting in each inter-stage queue.",
+                       [q]() { return static_cast<double>(q->size()); });
+        metrics->counter("perception_frames_dropped_total", labels,
+                         "Frames dropped because a queue was full.",
+                         [q]() { return static_cast<double>(q->dropped()); });
+    }
+    if (scheduler) {
+        const DeadlineScheduler<FrameTask>* pending = scheduler.get();
+        metrics->gauge("perception_queue_depth", "queue=\"captured\"",
+                       "Frames waiting in each inter-stage queue.",
+                       [pending]() { return static_cast<double>(pending->size()); });
+        metrics->counter("perception_frames_dropped_total", "queue=\"captured\"",
+                         "Frames dropped because a queue was full.",
+                         [pending]() { return static_cast<double>(pending->dropped()); });
+        const size_t streams = capture != nullptr ? capture->sourceCount() : 1;
+        for (size_t i = 0; i < streams; ++i) {
+            const std::string labels = "stream=\"" + std::to_string(i) + "\"";
+            // Reads one number of this stream from a fresh snapshot.
+            auto read = [pending, i](double (*get)(const StreamStats&)) {
+                return [pending, i, get]() {
+                    const std::vector<StreamStats> all = pending->stats();
+                    return i < all.size() ? get(all[i]) : 0.0;
+                };
+            };
+            metrics->gauge("perception_stream_fps", labels,
+                           "Inferences per second achieved by each stream.",
+                           read([](const StreamStats& s) { return s.achievedFps; }));
+            metrics->counter("perception_stream_served_total", labels,
+                             "Frames of each stream sent to the detector.",
+                             read([](const StreamStats& s) {
+                                 return static_cast<double>(s.served);
+                             }));
+            metrics->counter("perception_stream_skipped_total", labels,
+                             "Frames of each stream skipped as stale.",
+                             read([](const StreamStats& s) {
+                                 return static_cast<double>(s.skipped);
+                             }));
+            metrics->counter("perception_stream_deadline_misses_total", labels,
+                             "Target periods each stream went without inference.",
+                             read([](const StreamStats& s) {
+                                 return static_cast<double>(s.missed);
+                             }));
+        }
+    }
+    for (const StageStats* stage : stageList) {
+        metrics->counter("perception_frames_total",
+                         "stage=\"" + stage->name() + "\"",
+                         "Frames processed by each stage.",
+                         [stage]() { return static_cast<double>(stage->frames()); });
+    }
+    const std::pair<const char*, uint64_t GateStats::*> gate[] = {
+        {"run", &GateStats::hits}, {"skipped", &GateStats::skips},
+        {"cropped", &GateStats::cropped}};
+    for (const auto& outcome : gate) {
+        const uint64_t GateStats::*value = outcome.second;
+        metrics->counter("perception_motion_gate_frames_total",
+                         std::string("outcome=\"") + outcome.first + "\"",
+                         "Frames by motion gate decision.", [this, value]() {
+                             return static_cast<double>(gateStats().*value);
+                         });
+    }
+}
+
+/**
+ * @brief Destructor; stops the stages and waits for their threads.
+ */
+Pipeline::~Pipeline() {
+    stop();
+    join();
+}
+
+/**
+ * @brief Starts the worker threads and runs the output stage until done.
+ *
+ * @param output Called on this thread for every frame leaving the pipeline.
+ */
+void Pipeline::run(const OutputHandler& output) {
+    started = std::chrono::steady_clock::now();
+    maxInputSize = yolo.inputSize();
+    const CpuList callerCpus = allowedCpus();
+    if (config.detectorInstances > 1 && !asyncDetector) {
+        AsyncConfig async;
+        async.instances = config.detectorInstances;
+        async.threadsPerInstance =
+            config.threadsPerDetector > 0 ? config.threadsPerDetector : 1;
+        async.cpus = config.affinity.inference;
+        if (config.inferenceBudget.count() > 0) {
+            // The sizes adaptInputSize() may switch to, as main warms the
+            // prototype.
+            for (InputMode mode : {InputMode::Fast, InputMode::Balanced,
+                                   InputMode::Accurate}) {
+                if (static_cast<int>(mode) <= maxInputSize) {
+                    async.warmSizes.push_back(static_cast<int>(mode));
+                }
+            }
+        }
+        asyncDetector.reset(new AsyncDetector(yolo, async));
+    }
+    workers.emplace_back(&Pipeline::captureLoop, this);
+    workers.emplace_back(&Pipeline::inferenceLoop, this);
+    workers.emplace_back(&Pipeline::projectionLoop, this);
+    // Pinned only now: threads inherit their creator's mask, and the stages
+    // and instances without a list of their own must keep every CPU.
+    pinStage(config.affinity.output, "output", config.log);
+
+    auto lastReport = started;
+    FrameTask task;
+    while (!projectedQueue.drained()) {
+        if (config.stopFlag != nullptr && config.stopFlag->load()) {
+            break;
+        }
+        if (projectedQueue.pop(task, kPollInterval)) {
+            auto begin = std::chrono::steady_clock::now();
+            if (config.annotateInOutput) {
+                if (config.tracking) {
+                    drawTracks(task.tracks, task.frame);
+                } else {
+                    YOLO::annotate(task.detections, task.frame);
+                }
+            }
+            bool keepGoing = output(task);
+            const auto end = std::chrono::steady_clock::now();
+            outputStats.record(end - begin);
+            if (frameLatency != nullptr) {
+                frameLatency->record(end - task.captured);
+            }
+            recycle(task);
+            if (!keepGoing) {
+                stop();
+                break;
+            }
+        }
+        auto now = std::chrono::steady_clock::now();
+        if (config.log != nullptr && config.reportInterval.count() > 0 &&
+            now - lastReport >= config.reportInterval) {
+            *config.log << throughputReport();
+            lastReport = now;
+        }
+    }
+    stop();
+    join();
+    if (!config.affinity.output.empty()) {
+        pinCurrentThread(callerCpus);  // The caller's thread is not ours.
+    }
+}
+
+/**
+ * @brief Signals every stage to finish and unblocks their queues.
+ */
+void Pipeline::stop() {
+    stopping = true;
+    closeCaptured();
+    detectedQueue.close();
+    projectedQueue.close();
+}
+
+/**
+ * @brief Joins every worker thread that is still running.
+ */
+void Pipeline::join() {
+    for (auto& worker : workers) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+    workers.clear();
+}
+
+/**
+ * @brief Capture stage: grabs frames until the camera runs dry or stop().
+ */
+void Pipeline::captureLoop() {
+    // Pinned before the first acquire(), so the pool's buffers are
+    // allocated and first written on this thread's node.
+    pinStage(config.affinity.capture, "capture", config.log);
+    if (capture != nullptr) {
+        captureSetsLoop();
+        return;
+    }
+    uint64_t sequence = 0;
+    while (!stopping) {
+        auto begin = std::chrono::steady_clock::now();
+        FrameTask task;
+        spareTasks.pop(task, std::chrono::milliseconds(0));
+        task.buffer = framePool.acquire(kPollInterval);
+        if (!task.buffer) {
+            continue;  // Every buffer is still downstream.
+        }
+        if (!camera->read(task.buffer.image())) {
+            break;  // No more frames
+        }
+        task.frame = task.buffer.image();  // Header only, no pixel copy.
+        task.scale = camera->scale();
+        task.encoded = camera->encoded();
+        task.sequence = sequence++;
+        task.captured = begin;
+        captureStats.record(std::chrono::steady_clock::now() - begin);
+        if (!pushCaptured(std::move(task))) {
+            break;
+        }
+    }
+    closeCaptured();
+}
+
+/**
+ * @brief Capture stage for a CaptureManager: forwards every frame of each set.
+ */
+void Pipeline::captureSetsLoop() {
+    // Every source's frames may fill the queues downstream, like the
+    // Camera's pool.
+    capture->start(framePoolSize(config));
+    FrameSet set;
+    while (!stopping && !capture->finished()) {
+        auto begin = std::chrono::steady_clock::now();
+        if (!capture->nextSet(set, kPollInterval)) {
+            continue;
+        }
+        captureStats.record(std::chrono::steady_clock::now() - begin);
+        for (size_t i = 0; i < set.frames.size(); ++i) {
+            if (set.frames[i].image.empty()) {
+                continue;  // Source failed, ended or out of sync.
+            }
+            FrameTask task;
+            spareTasks.pop(task, std::chrono::milliseconds(0));
+            task.sequence = set.sequence;
+            task.source = i;
+            task.captured = set.frames[i].timestamp;
+            task.frame = std::move(set.frames[i].image);
+            task.buffer = std::move(set.frames[i].buffer);
+            task.scale = set.frames[i].scale;
+            task.encoded = std::move(set.frames[i].encoded);
+            if (!pushCaptured(std::move(task))) {
+                break;
+            }
+        }
+    }
+    capture->stop();
+    closeCaptured();
+}
+
+/**
+ * @brief Records a captured frame, then hands it to the scheduler or the
+ *        captured queue.
+ *
+ * Frames are recorded here, before any stage draws on or blurs them, and
+ * before the scheduler may skip them.
+ *
+ * @param task The frame.
+ * @return bool - False once the inference side is closed.
+ */
+bool Pipeline::pushCaptured(FrameTask task) {
+    if (config.recorder != nullptr) {
+        // A failed write is reported by the recorder's error() at the end;
+        // losing the recording is no reason to stop detecting.
+        if (!task.encoded.empty()) {
+            config.recorder->writeEncodedFrame(task.source, task.sequence,
+                                               task.captured, task.encoded);
+        } else {
+            config.recorder->writeFrame(task.source, task.sequence,
+                                        task.captured, task.frame);
+        }
+    }
+    if (scheduler) {
+        const size_t source = task.source;
+        const auto captured = task.captured;
+        return scheduler->push(source, std::move(task), captured);
+    }
+    return capturedQueue.push(std::move(task));
+}
+
+/**
+ * @brief Clears a task the output stage is done with and keeps it for the
+ *        capture stage.
+ *
+ * The pixels go back to their pool; the detection, coordinate and track
+ * vectors keep their capacity, so frames after the first few fill them
+ * without allocating.
+ *
+ * @param task The finished frame; left empty.
+ */
+void Pipeline::recycle(FrameTask& task) {
+    task.frame.release();
+    task.encoded.release();
+    task.buffer.reset();
+    task.source = 0;
+    task.scale = 1.0;
+    task.detections.clear();
+    task.pixelCoords.clear();
+    task.worldCoords.clear();
+    task.tracks.clear();
+    spareTasks.push(std::move(task));
+}
+
+/**
+ * @brief Takes the next frame to detect on, waiting up to @p wait.
+ *
+ * @param task Receives the frame.
+ * @param wait Maximum time to wait.
+ * @return bool - False on timeout or once drained.
+ */
+bool Pipeline::popCaptured(FrameTask& task, std::chrono::milliseconds wait) {
+    if (scheduler) {
+        size_t source = 0;
+        return scheduler->pop(task, source, wait);
+    }
+    return capturedQueue.pop(task, wait);
+}
+
+/**
+ * @brief Returns true once capture has finished and every frame was taken.
+ */
+bool Pipeline::capturedDrained() const {
+    return scheduler ? scheduler->drained() : capturedQueue.drained();
+}
+
+/**
+ * @brief Closes the connection between capture and inference.
+ */
+void Pipeline::closeCaptured() {
+    capturedQueue.close();
+    if (scheduler) {
+        scheduler->close();
+    }
+}
+
+/**
+ * @brief Inference stage: runs YOLO and the OpenCV post-processing.
+ */
+void Pipeline::inferenceLoop() {
+    const CpuList& cpus = cpusFor(config.affinity.inference, 0);
+    pinStage(cpus, "inference", config.log);
+    if (!asyncDetector) {
+        // Set from this thread so that OpenCV's workers, started by the
+        // next forward pass, inherit its mask. Pinned without a thread
+        // count, use one thread per CPU of the set.
+        const int threads = config.threadsPerDetector > 0
+                                ? config.threadsPerDetector
+                                : static_cast<int>(cpus.size());
+        if (threads > 0) {
+            cv::setNumThreads(threads);
+        }
+    }
+    if (asyncDetector) {
+        asyncInferenceLoop();
+        return;
+    }
+    FrameTask task;
+    while (!capturedDrained()) {
+        if (!popCaptured(task, kPollInterval)) {
+            continue;
+        }
+        auto begin = std::chrono::steady_clock::now();
+        const bool detected = detectFrame(task);
+        processor.processImages(task.frame);
+        auto busy = std::chrono::steady_clock::now() - begin;
+        inferenceStats.record(busy);
+        if (detected) {
+            adaptInputSize(busy);  // Tracker-only frames say nothing about YOLO.
+        }
+        if (!detectedQueue.push(std::move(task))) {
+            break;
+        }
+    }
+    detectedQueue.close();
+}
+
+/**
+ * @brief Inference stage keeping up to one frame per instance in flight.
+ *
+ * Frames are submitted as soon as an instance could take them and completed
+ * strictly in arrival order, so the tracker and the downstream stages see
+ * them in sequence. Busy time counts only the part of each frame's latency
+ * not overlapped by the previous frame, so utilisation stays comparable
+ * with the single-instance stage.
+ */
+void Pipeline::asyncInferenceLoop() {
+    const size_t limit = asyncDetector->instances();
+    std::deque<InFlight> inFlight;
+    auto lastDone = std::chrono::steady_clock::now();
+    FrameTask task;
+    while (!capturedDrained() || !inFlight.empty()) {
+        const bool full = inFlight.size() >= limit;
+        const bool ready = !inFlight.empty() &&
+            (!inFlight.front().detect ||
+             inFlight.front().result.wait_for(std::chrono::seconds(0)) ==
+                 std::future_status::ready);
+        if (!full && !ready) {
+            // Wait briefly for a new frame while requests are in flight.
+            const auto wait = inFlight.empty() ? kPollInterval
+                                               : std::chrono::milliseconds(1);
+            if (popCaptured(task, wait)) {
+                InFlight entry;
+                entry.begin = std::chrono::steady_clock::now();
+                entry.detect = planDetection(task, entry.roi);
+                if (entry.detect) {
+                    entry.result = asyncDetector->submit(
+                        entry.roi.area() > 0 ? task.frame(entry.roi) : task.frame,
+                        tilingFor(task.source));
+                }
+                entry.task = std::move(task);
+                inFlight.push_back(std::move(entry));
+            }
+            continue;
+        }
+
+        InFlight& front = inFlight.front();
+        if (front.detect) {
+            Detections detections = front.result.get();
+            detections.offset(static_cast<float>(front.roi.x),
+                              static_cast<float>(front.roi.y));
+            finishDetection(front.task, &detections);
+        } else {
+            finishDetection(front.task, nullptr);
+        }
+        processor.processImages(front.task.frame);
+        const auto now = std::chrono::steady_clock::now();
+        inferenceStats.record(now - std::max(front.begin, lastDone));
+        lastDone = now;
+        if (front.detect) {
+            adaptInputSize(now - front.begin);
+        }
+        const bool pushed = detectedQueue.push(std::move(front.task));
+        inFlight.pop_front();
+        if (!pushed) {
+            break;
+        }
+    }
+    detectedQueue.close();
+}
+
+/**
+ * @brief Returns the detection state of @p source, growing the list as needed.
+ *
+ * @param source Index of the frame's source.
+ * @return DetectionState& - State only ever touched by the inference stage.
+ */
+Pipeline::DetectionState& Pipeline::detectionState(size_t source) {
+    if (sources.size() <= source) {
+        std::lock_guard<std::mutex> lock(sourcesGuard);
+        while (sources.size() <= source) {
+            sources.emplace_back(config.tracker);
+        }
+    }
+    return sources[source];
+}
+
+/**
+ * @brief Sums the counters of every source's motion gate.
+ *
+ * @return GateStats - Totals; zero while no gate exists.
+ */
+GateStats Pipeline::gateStats() const {
+    GateStats total;
+    std::lock_guard<std::mutex> lock(sourcesGuard);
+    for (const DetectionState& source : sources) {
+        if (source.gate) {
+            const GateStats stats = source.gate->stats();
+            total.hits += stats.hits;
+            total.skips += stats.skips;
+            total.cropped += stats.cropped;
+        }
+    }
+    return total;
+}
+
+/**
+ * @brief Runs YOLO on a region of the frame and maps boxes back to the frame.
+ *
+ * @param frame The full frame.
+ * @param roi Region of interest; empty means the whole frame.
+ * @param source Source of the frame, selects the tile grid.
+ * @return const Detections& - Detections in frame pixels, valid until the
+ *         next call.
+ */
+const Detections& Pipeline::inferRegion(const cv::Mat& frame,
+                                        const cv::Rect& roi, size_t source) {
+    const TilingConfig& tiling = tilingFor(source);
+    if (roi.area() == 0) {
+        return tiling.enabled() ? yolo.inferTiled(frame, tiling)
+                                : yolo.infer(frame);
+    }
+    // Reuses the arrays' capacity.
+    shifted = tiling.enabled() ? yolo.inferTiled(frame(roi), tiling)
+                               : yolo.infer(frame(roi));
+    shifted.offset(static_cast<float>(roi.x), static_cast<float>(roi.y));
+    return shifted;
+}
+
+/**
+ * @brief Looks up the tile grid configured for a source.
+ *
+ * @param source Index of the frame's source.
+ * @return const TilingConfig& - The grid; 1 x 1 if none is configured.
+ */
+const TilingConfig& Pipeline::tilingFor(size_t source) const {
+    static const TilingConfig untiled;
+    if (config.tiling.empty()) {
+        return untiled;
+    }
+    return config.tiling[std::min(source, config.tiling.size() - 1)];
+}
+
+/**
+ * @brief Detects on the frame, or on the part of it that moved.
+ *
+ * @param task The frame; receives the pixel coordinates and tracks.
+ * @return bool - True if YOLO ran on this frame.
+ */
+bool Pipeline::detectFrame(FrameTask& task) {
+    cv::Rect roi;
+    const bool detect = planDetection(task, roi);
+    finishDetection(task,
+                    detect ? &inferRegion(task.frame, roi, task.source) : nullptr);
+    return detect;
+}
+
+/**
+ * @brief Applies detect-every-N and the motion gate to one frame.
+ *
+ * With tracking the detector runs on every Nth frame of a source only. With
+ * the motion gate on, unchanged frames skip the detector entirely and
+ * changed frames run on the moving region plus the current tracks.
+ *
+ * @param task The frame.
+ * @param roi Receives the region of interest; empty for the whole frame.
+ * @return bool - True if YOLO should run on this frame.
+ */
+bool Pipeline::planDetection(const FrameTask& task, cv::Rect& roi) {
+    DetectionState& source = detectionState(task.source);
+    const ProcessingOptions& options = processor.options();
+    const int every = std::max(1, config.detectEvery);
+    roi = cv::Rect();
+    if (config.tracking && source.frames++ % every != 0) {
+        return false;
+    }
+    if (!options.motionGate) {
+        return true;
+    }
+    if (!source.gate) {
+        std::lock_guard<std::mutex> lock(sourcesGuard);
+        source.gate.reset(new MotionGate(options.gate));
+    }
+    gateRegions.clear();
+    for (const Track& track : source.tracker.tracks()) {
+        gateRegions.push_back(track.box);
+    }
+    const GateDecision decision = source.gate->evaluate(task.frame, gateRegions);
+    if (!decision.run) {
+        return false;
+    }
+    if (decision.roi.area() > 0) {
+        if (scheduler) {
+            scheduler->markActivity(task.source);  // Something moved.
+        }
+    }
+    roi = decision.roi;
+    return true;
+}
+
+/**
+ * @brief Updates the source's tracker or last detections and annotates.
+ *
+ * Frames without detections coast the tracks on their motion model or,
+ * without tracking, show the detections as last seen.
+ *
+ * @param task The frame; receives the pixel coordinates and tracks.
+ * @param detections Detections in frame pixels, nullptr if none were run.
+ */
+void Pipeline::finishDetection(FrameTask& task, const Detections* detections) {
+    DetectionState& source = detectionState(task.source);
+    if (scheduler && detections != nullptr && !detections->empty()) {
+        scheduler->markActivity(task.source);
+    }
+    if (config.tracking) {
+        task.tracks = detections != nullptr ? source.tracker.update(*detections)
+                                            : source.tracker.predict();
+        trackCoordinates(task.tracks, task.pixelCoords);
+        if (yolo.postprocessOptions().annotate) {
+            drawTracks(task.tracks, task.frame);
+        }
+    } else if (!processor.options().motionGate) {
+        task.detections = *detections;
+        yolo.postprocess(task.detections, task.frame, task.pixelCoords);
+    } else {
+        if (detections != nullptr) {
+            source.last = *detections;
+        }
+        task.detections = source.last;
+        yolo.postprocess(task.detections, task.frame, task.pixelCoords);
+    }
+}
+
+/**
+ * @brief Steps the network input size to keep inference within budget.
+ *
+ * Uses an exponential moving average of the inference time and holds each
+ * size for a few frames so a single slow frame does not cause a switch.
+ *
+ * @param inferenceTime Time the last frame spent in the inference stage.
+ */
+void Pipeline::adaptInputSize(std::chrono::steady_clock::duration inferenceTime) {
+    if (config.inferenceBudget.count() <= 0 || yolo.fixedInputSize()) {
+        return;
+    }
+    const double ms =
+        std::chrono::duration<double, std::milli>(inferenceTime).count();
+    averageInferenceMs = framesSinceResize == 0
+                             ? ms : 0.8 * averageInferenceMs + 0.2 * ms;
+    if (++framesSinceResize < kResizeHoldFrames) {
+        return;
+    }
+    const double budget = static_cast<double>(config.inferenceBudget.count());
+    const int size = yolo.inputSize();
+    const int balanced = static_cast<int>(InputMode::Balanced);
+    const int accurate = static_cast<int>(InputMode::Accurate);
+    int next = size;
+    if (averageInferenceMs > budget) {
+        // Never up: a start size below Fast stays where it is.
+        next = std::min(size > balanced ? balanced
+                                        : static_cast<int>(InputMode::Fast),
+                        size);
+    } else if (averageInferenceMs < 0.5 * budget) {
+        // Back up through the modes to the size run() started at, which
+        // may lie above Accurate.
+        next = size < balanced ? balanced
+                               : size < accurate ? accurate : maxInputSize;
+        next = std::max(std::min(next, maxInputSize), size);
+    }
+    if (next != size) {
+        yolo.setInputSize(next);
+        if (asyncDetector) {
+            asyncDetector->setInputSize(next);
+        }
+        framesSinceResize = 0;
+        if (config.log != nullptr) {
+            *config.log << "Network input size " << size << " -> " << next
+                        << " (" << averageInferenceMs << " ms/frame)\n";
+        }
+    }
+}
+
+/**
+ * @brief Projection stage: converts pixel detections to world coordinates.
+ */
+void Pipeline::projectionLoop() {
+    pinStage(config.affinity.projection, "projection", config.log);
+    WorldProjector projector(world.projection());
+    FrameTask task;
+    while (!detectedQueue.drained()) {
+        if (!detectedQueue.pop(task, kPollInterval)) {
+            continue;
+        }
+        auto begin = std::chrono::steady_clock::now();
+        if (task.scale != 1.0) {
+            // The camera model is calibrated on full-resolution pixels.
+            for (double& coordinate : task.pixelCoords) {
+                coordinate *= task.scale;
+            }
+        }
+        projector.project(task.pixelCoords, task.worldCoords);
+        projectionStats.record(std::chrono::steady_clock::now() - begin);
+        if (!projectedQueue.push(std::move(task))) {
+            break;
+        }
+    }
+    projectedQueue.close();
+}
+
+/**
+ * @brief Formats throughput, utilisation and queue drops for every stage.
+ *
+ * @return std::string - One line per stage.
+ */
+std::string Pipeline::throughputReport() const {
+    double elapsed = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - started).count();
+    if (elapsed <= 0.0) {
+        elapsed = 1e-9;
+    }
+    // Frames dropped on the queue feeding each stage, in stage order.
+    const size_t dropped[] = {0, scheduler ? scheduler->dropped()
+                                           : capturedQueue.dropped(),
+                              detectedQueue.dropped(),
+                              projectedQueue.dropped()};
+
+    std::ostringstream report;
+    report << std::fixed << std::setprecision(1);
+    report << "Pipeline throughput after " << elapsed << " s:\n";
+    for (size_t i = 0; i < stageList.size(); ++i) {
+        const StageStats& stage = *stageList[i];
+        report << "  " << std::setw(10) << std::left << stage.name()
+               << std::right << std::setw(8) << stage.frames() / elapsed
+               << " fps  " << std::setw(5)
+               << 100.0 * stage.busySeconds() / elapsed << "% busy  "
+               << dropped[i] << " dropped\n";
+    }
+    const GateStats gate = gateStats();
+    if (gate.hits + gate.skips > 0) {
+        report << "  motion gate: " << gate.hits << " run (" << gate.cropped
+               << " cropped), " << gate.skips << " skipped\n";
+    }
+    if (scheduler) {
+        const std::vector<StreamStats> streams = scheduler->stats();
+        for (size_t i = 0; i < streams.size(); ++i) {
+            const StreamStats& stream = streams[i];
+            report << "  stream " << i << ": " << stream.achievedFps << " of "
+                   << stream.policy.targetFps << " fps (priority "
+                   << stream.policy.priority << "), " << stream.missed
+                   << " deadlines missed, " << stream.skipped << " of "
+                   << stream.offered << " frames skipped\n";
+        }
+    }
+    if (config.metrics != nullptr) {
+        report << "  latency:\n" << config.metrics->summary();
+    }
+    return report.str();
+}
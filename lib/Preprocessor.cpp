@@ -0,0 +1,414 @@
+// Copyright 2026 Sai Surya Sriramoju
+
+/**
+ * @file Preprocessor.cpp
+ * @brief Implementation of the Preprocessor class.
+ * @author Sai Surya Sriramoju
+ * @date 10/17/2026
+ */
+
+#include "Preprocessor.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+
+namespace {
+/// Grey used for the letterbox border, the mid-level Darknet pads with.
+const cv::Scalar kPadColor(127, 127, 127);
+/// The same grey after 1/255 scaling, as written by the fused pass.
+const float kPadValue = 127.0f / 255.0f;
+/// Image rows per tile of the fused pass; a tile plus its blur halo of
+/// blurred float rows stays resident in L2.
+const int kTileRows = 16;
+
+/**
+ * @brief Runs a lambda as a cv::ParallelLoopBody.
+ *
+ * Passing the lambda itself would wrap it in a std::function, which
+ * allocates on every frame.
+ */
+template <typename Body>
+class LoopBody : public cv::ParallelLoopBody {
+ public:
+    explicit LoopBody(const Body& body) : body(body) {}
+    void operator()(const cv::Range& range) const override { body(range); }
+
+ private:
+    const Body& body;  ///< The lambda, owned by the caller.
+};
+
+/**
+ * @brief Reflects index @p i into [0, n) like BORDER_REFLECT_101.
+ */
+inline int reflect101(int i, int n) {
+    if (n == 1) {
+        return 0;
+    }
+    while (i < 0 || i >= n) {
+        i = i < 0 ? -i : 2 * n - 2 - i;
+    }
+    return i;
+}
+
+/**
+ * @brief Bilinearly samples one letterbox row into interleaved BGR floats.
+ *
+ * Uses the same pixel-centre mapping as cv::resize with INTER_LINEAR.
+ */
+void sampleRow(const cv::Mat& frame, float scaleY, int row, const int* offset0,
+               const int* offset1, const float* weight, int width, float* out) {
+    float sy = (row + 0.5f) / scaleY - 0.5f;
+    sy = std::max(sy, 0.0f);
+    int y0 = static_cast<int>(sy);
+    float wy = sy - y0;
+    if (y0 >= frame.rows - 1) {
+        y0 = frame.rows - 1;
+        wy = 0.0f;
+    }
+    const uchar* top = frame.ptr<uchar>(y0);
+    const uchar* bottom = frame.ptr<uchar>(std::min(y0 + 1, frame.rows - 1));
+    for (int x = 0; x < width; ++x) {
+        const int a = offset0[x];
+        const int b = offset1[x];
+        const float wx = weight[x];
+        for (int c = 0; c < 3; ++c) {
+            const float t = top[a + c] + wx * (top[b + c] - top[a + c]);
+            const float d = bottom[a + c] + wx * (bottom[b + c] - bottom[a + c]);
+            out[3 * x + c] = t + wy * (d - t);
+        }
+    }
+}
+
+/**
+ * @brief Applies the 5-tap binomial kernel [1 4 6 4 1] / 16 along a row.
+ *
+ * This is the kernel cv::GaussianBlur uses for a 5x5 size with sigma 0.
+ */
+void blurRow(const float* in, int width, float* out) {
+    for (int x = 0; x < width; ++x) {
+        const int xm2 = reflect101(x - 2, width);
+        const int xm1 = reflect101(x - 1, width);
+        const int xp1 = reflect101(x + 1, width);
+        const int xp2 = reflect101(x + 2, width);
+        for (int c = 0; c < 3; ++c) {
+            out[3 * x + c] = (in[3 * xm2 + c] + 4 * in[3 * xm1 + c] +
+                              6 * in[3 * x + c] + 4 * in[3 * xp1 + c] +
+                              in[3 * xp2 + c]) * (1.0f / 16);
+        }
+    }
+}
+}  // namespace
+
+/**
+ * @brief Constructor; validates the input size.
+ *
+ * @param inputSize Side of the square network input.
+ */
+Preprocessor::Preprocessor(int inputSize) : side(0), letterboxed(1) {
+    setInputSize(inputSize);
+}
+
+/**
+ * @brief Changes the network input size.
+ *
+ * @param size Side of the square input; a positive multiple of 32.
+ */
+void Preprocessor::setInputSize(int size) {
+    if (size <= 0 || size % 32 != 0) {
+        throw std::invalid_argument(
+            "Network input size must be a positive multiple of 32, got " +
+            std::to_string(size));
+    }
+    side = size;
+}
+
+/**
+ * @brief Computes scale and padding that fit @p frameSize into the input square.
+ *
+ * @param frameSize Size of the frame to letterbox.
+ * @return LetterboxTransform - The mapping between frame and network pixels.
+ */
+LetterboxTransform Preprocessor::computeTransform(cv::Size frameSize) const {
+    LetterboxTransform transform;
+    transform.inputSize = cv::Size(side, side);
+    const float scale = std::min(static_cast<float>(side) / frameSize.width,
+                                 static_cast<float>(side) / frameSize.height);
+    const int width = std::max(1, static_cast<int>(std::round(frameSize.width * scale)));
+    const int height = std::max(1, static_cast<int>(std::round(frameSize.height * scale)));
+    transform.scaleX = static_cast<float>(width) / frameSize.width;
+    transform.scaleY = static_cast<float>(height) / frameSize.height;
+    transform.padX = static_cast<float>((side - width) / 2);
+    transform.padY = static_cast<float>((side - height) / 2);
+    return transform;
+}
+
+/**
+ * @brief Scales @p frame to fit the input square and pads the rest with grey.
+ *
+ * The frame is resized straight into a sub-rectangle of @p dst and only the
+ * border strips are filled, so no intermediate image is allocated.
+ *
+ * @param frame The BGR frame to letterbox.
+ * @param dst Receives the input-size image.
+ * @return LetterboxTransform - How to map outputs back onto @p frame.
+ */
+LetterboxTransform Preprocessor::letterbox(const cv::Mat& frame,
+                                           cv::Mat& dst) const {
+    const LetterboxTransform transform = computeTransform(frame.size());
+    const int width = static_cast<int>(std::lround(transform.scaleX * frame.cols));
+    const int height = static_cast<int>(std::lround(transform.scaleY * frame.rows));
+    const int left = static_cast<int>(transform.padX);
+    const int top = static_cast<int>(transform.padY);
+
+    dst.create(side, side, frame.type());
+    cv::Mat inner = dst(cv::Rect(left, top, width, height));
+    cv::resize(frame, inner, inner.size(), 0, 0, cv::INTER_LINEAR);
+    if (top > 0) {
+        dst(cv::Rect(0, 0, side, top)).setTo(kPadColor);
+    }
+    if (top + height < side) {
+        dst(cv::Rect(0, top + height, side, side - top - height)).setTo(kPadColor);
+    }
+    if (left > 0) {
+        dst(cv::Rect(0, top, left, height)).setTo(kPadColor);
+    }
+    if (left + width < side) {
+        dst(cv::Rect(left + width, top, side - left - width, height)).setTo(kPadColor);
+    }
+    return transform;
+}
+
+/**
+ * @brief Letterboxes one frame and packs it as a normalised RGB blob.
+ *
+ * @param frame The BGR frame.
+ * @param transform Receives the mapping back onto @p frame.
+ * @return const cv::Mat& - The blob.
+ */
+const cv::Mat& Preprocessor::blobFromFrame(const cv::Mat& frame,
+                                           LetterboxTransform& transform) {
+    if (settings.fused && frame.type() == CV_8UC3) {
+        const int shape[] = {1, 3, side, side};
+        blob.create(4, shape, CV_32F);
+        transform = computeTransform(frame.size());
+        fusedLetterbox(frame, transform, blob.ptr<float>());
+        return blob;
+    }
+    transform = letterbox(frame, letterboxed[0]);
+    cv::dnn::blobFromImage(letterboxed[0], blob, 1/255.0, cv::Size(),
+                           cv::Scalar(0, 0, 0), true, false);
+    return blob;
+}
+
+/**
+ * @brief Letterboxes several frames and packs them as one batched blob.
+ *
+ * @param frames The BGR frames.
+ * @param transforms Receives one mapping per frame.
+ * @return const cv::Mat& - The blob.
+ */
+const cv::Mat& Preprocessor::blobFromFrames(
+    const std::vector<cv::Mat>& frames,
+    std::vector<LetterboxTransform>& transforms) {
+    transforms.resize(frames.size());
+    if (settings.fused) {
+        bool allBgr = true;
+        for (const cv::Mat& frame : frames) {
+            allBgr = allBgr && frame.type() == CV_8UC3;
+        }
+        if (allBgr) {
+            const int shape[] = {static_cast<int>(frames.size()), 3, side, side};
+            blob.create(4, shape, CV_32F);
+            for (size_t i = 0; i < frames.size(); ++i) {
+                transforms[i] = computeTransform(frames[i].size());
+                fusedLetterbox(frames[i], transforms[i],
+                               blob.ptr<float>(static_cast<int>(i)));
+            }
+            return blob;
+        }
+    }
+    if (letterboxed.size() < frames.size()) {
+        letterboxed.resize(frames.size());
+    }
+    for (size_t i = 0; i < frames.size(); ++i) {
+        transforms[i] = letterbox(frames[i], letterboxed[i]);
+    }
+    const std::vector<cv::Mat> batch(letterboxed.begin(),
+                                     letterboxed.begin() + frames.size());
+    cv::dnn::blobFromImages(batch, blob, 1/255.0, cv::Size(),
+                            cv::Scalar(0, 0, 0), true, false);
+    return blob;
+}
+
+/**
+ * @brief Letterboxes a frame straight into planar, normalised RGB floats.
+ *
+ * Border rows are filled directly; the image rows are split into one stripe
+ * per worker thread, each processed tile by tile with its own scratch rows.
+ *
+ * @param frame The CV_8UC3 BGR frame.
+ * @param transform Mapping from computeTransform(frame.size()).
+ * @param dst The 3 x S x S destination planes.
+ */
+void Preprocessor::fusedLetterbox(const cv::Mat& frame,
+                                  const LetterboxTransform& transform,
+                                  float* dst) {
+    CV_Assert(frame.type() == CV_8UC3 && !frame.empty());
+    const int width = static_cast<int>(std::lround(transform.scaleX * frame.cols));
+    const int height = static_cast<int>(std::lround(transform.scaleY * frame.rows));
+    const int top = static_cast<int>(transform.padY);
+    const size_t plane = static_cast<size_t>(side) * side;
+    buildColumnTables(frame.cols, width);
+
+    // Border rows above and below the image.
+    for (int c = 0; c < 3; ++c) {
+        float* p = dst + c * plane;
+        std::fill(p, p + static_cast<size_t>(top) * side, kPadValue);
+        std::fill(p + static_cast<size_t>(top + height) * side, p + plane,
+                  kPadValue);
+    }
+
+    const int tiles = (height + kTileRows - 1) / kTileRows;
+    const int stripes = std::max(1, std::min(cv::getNumThreads(), tiles));
+    const size_t stripeScratch = static_cast<size_t>(kTileRows + 5) * width * 3;
+    if (settings.gaussianBlur) {
+        scratch.resize(stripeScratch * stripes);
+    }
+    const auto stripe = [&](const cv::Range& range) {
+        for (int s = range.start; s < range.end; ++s) {
+            // Stripe boundaries on tile multiples keep tiles full-sized.
+            const int begin = std::min(height, tiles * s / stripes * kTileRows);
+            const int end = std::min(height, tiles * (s + 1) / stripes * kTileRows);
+            float* rows = settings.gaussianBlur ? scratch.data() + s * stripeScratch
+                                                : nullptr;
+            fusedRows(frame, transform, begin, end, rows, dst);
+        }
+    };
+    cv::parallel_for_(cv::Range(0, stripes), LoopBody<decltype(stripe)>(stripe),
+                      stripes);
+}
+
+/**
+ * @brief Rebuilds the per-column source offsets and weights.
+ *
+ * @param frameWidth Width of the source frame.
+ * @param innerWidth Width of the image inside the letterbox.
+ */
+void Preprocessor::buildColumnTables(int frameWidth, int innerWidth) {
+    if (frameWidth == tableFrameWidth && innerWidth == tableInnerWidth) {
+        return;
+    }
+    tableFrameWidth = frameWidth;
+    tableInnerWidth = innerWidth;
+    columnOffset0.resize(innerWidth);
+    columnOffset1.resize(innerWidth);
+    columnWeight.resize(innerWidth);
+    const float ratio = static_cast<float>(frameWidth) / innerWidth;
+    for (int x = 0; x < innerWidth; ++x) {
+        float sx = std::max((x + 0.5f) * ratio - 0.5f, 0.0f);
+        int x0 = static_cast<int>(sx);
+        float wx = sx - x0;
+        if (x0 >= frameWidth - 1) {
+            x0 = frameWidth - 1;
+            wx = 0.0f;
+        }
+        columnOffset0[x] = 3 * x0;
+        columnOffset1[x] = 3 * std::min(x0 + 1, frameWidth - 1);
+        columnWeight[x] = wx;
+    }
+}
+
+/**
+ * @brief Resamples, optionally blurs, scales and packs image rows [begin, end).
+ *
+ * Without blur each row is sampled straight into the three planes. With blur
+ * every tile first samples and horizontally blurs its rows plus a two-row
+ * halo into @p rows, then applies the vertical pass while writing the planes.
+ *
+ * @param frame The CV_8UC3 BGR frame.
+ * @param transform Mapping from computeTransform(frame.size()).
+ * @param begin First image row of the stripe.
+ * @param end One past the last image row of the stripe.
+ * @param rows Scratch rows for the blur, or nullptr when not blurring.
+ * @param dst The 3 x S x S destination planes.
+ */
+void Preprocessor::fusedRows(const cv::Mat& frame,
+                             const LetterboxTransform& transform, int begin,
+                             int end, float* rows, float* dst) const {
+    const int width = tableInnerWidth;
+    const int height = static_cast<int>(std::lround(transform.scaleY * frame.rows));
+    const int left = static_cast<int>(transform.padX);
+    const int top = static_cast<int>(transform.padY);
+    const size_t plane = static_cast<size_t>(side) * side;
+    const float norm = 1.0f / 255;
+    float* red = dst;
+    float* green = dst + plane;
+    float* blue = dst + 2 * plane;
+
+    // Fills the border columns of one image row.
+    auto padRow = [&](int row) {
+        const size_t offset = static_cast<size_t>(top + row) * side;
+        for (float* p : {red, green, blue}) {
+            std::fill(p + offset, p + offset + left, kPadValue);
+            std::fill(p + offset + left + width, p + offset + side, kPadValue);
+        }
+    };
+    // Scales @p n interleaved BGR samples and scatters them into the planes.
+    auto writeSpan = [&](int row, int x0, int n, const float* bgr) {
+        const size_t offset = static_cast<size_t>(top + row) * side + left + x0;
+        float* r = red + offset;
+        float* g = green + offset;
+        float* b = blue + offset;
+        for (int x = 0; x < n; ++x) {
+            b[x] = bgr[3 * x] * norm;
+            g[x] = bgr[3 * x + 1] * norm;
+            r[x] = bgr[3 * x + 2] * norm;
+        }
+    };
+
+    if (rows == nullptr) {
+        // Sample in short column blocks so the interleaved values stay in L1.
+        const int kBlock = 64;
+        float block[3 * kBlock];
+        for (int row = begin; row < end; ++row) {
+            padRow(row);
+            for (int x0 = 0; x0 < width; x0 += kBlock) {
+                const int n = std::min(kBlock, width - x0);
+                sampleRow(frame, transform.scaleY, row, &columnOffset0[x0],
+                          &columnOffset1[x0], &columnWeight[x0], n, block);
+                writeSpan(row, x0, n, block);
+            }
+        }
+        return;
+    }
+
+    // Rows [tile - 2, tileEnd + 2) are sampled and blurred horizontally into
+    // the scratch, then the vertical taps combine them into each output row.
+    const size_t rowFloats = static_cast<size_t>(width) * 3;
+    float* sampled = rows + (kTileRows + 4) * rowFloats;
+    for (int tile = begin; tile < end; tile += kTileRows) {
+        const int tileEnd = std::min(end, tile + kTileRows);
+        const int count = tileEnd - tile + 4;
+        for (int k = 0; k < count; ++k) {
+            sampleRow(frame, transform.scaleY, reflect101(tile - 2 + k, height),
+                      columnOffset0.data(), columnOffset1.data(),
+                      columnWeight.data(), width, sampled);
+            blurRow(sampled, width, rows + k * rowFloats);
+        }
+        for (int row = tile; row < tileEnd; ++row) {
+            const float* r0 = rows + (row - tile) * rowFloats;
+            const float* r1 = r0 + rowFloats;
+            const float* r2 = r1 + rowFloats;
+            const float* r3 = r2 + rowFloats;
+            const float* r4 = r3 + rowFloats;
+            for (size_t i = 0; i < rowFloats; ++i) {
+                sampled[i] = (r0[i] + 4 * r1[i] + 6 * r2[i] + 4 * r3[i] + r4[i]) *
+                             (1.0f / 16);
+            }
+            padRow(row);
+            writeSpan(row, 0, width, sampled);
+        }
+    }
+}
@@ -0,0 +1,481 @@
+// Copyright 2026 Sai Surya Sriramoju
+
+/**
+ * @file Recording.cpp
+ * @brief Implementation of the RecordingWriter and RecordingReader classes.
+ * @author Sai Surya Sriramoju
+ * @date 10/17/2026
+ */
+
+#include "Recording.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+#include "JpegDecode.h"
+
+namespace {
+/// Zero bytes written after a payload up to the next record.
+const char kPadding[kRecordAlignment] = {};
+
+/**
+ * @brief Rounds @p offset up to the next record boundary.
+ */
+uint64_t aligned(uint64_t offset) {
+    return (offset + kRecordAlignment - 1) / kRecordAlignment *
+           kRecordAlignment;
+}
+}  // namespace
+
+/**
+ * @brief Constructor; creates the file, writes its header and starts the
+ *        writer thread.
+ *
+ * @param path The recording to create or truncate.
+ * @param config Frame encoding and queue capacity.
+ */
+RecordingWriter::RecordingWriter(const std::string& path,
+                                 const RecorderConfig& config)
+    : config(config), queue(config.queueCapacity) {
+    using namespace std::chrono;
+    fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        throw std::runtime_error("Cannot create " + path + ": " +
+                                 std::strerror(errno));
+    }
+    origin = steady_clock::now();
+    RecordingHeader header;
+    header.startNs = duration_cast<nanoseconds>(
+        system_clock::now().time_since_epoch()).count();
+    if (!writeAll(&header, sizeof(header))) {
+        ::close(fd);
+        throw std::runtime_error("Cannot write " + path + ": " + failure);
+    }
+    writer = std::thread(&RecordingWriter::writeLoop, this);
+}
+
+/**
+ * @brief Destructor; writes what is queued and the index, then closes the
+ *        file.
+ */
+RecordingWriter::~RecordingWriter() {
+    close();
+}
+
+/**
+ * @brief Copies one frame into a spare buffer and queues it.
+ *
+ * @param source Camera/source index.
+ * @param sequence Capture sequence number.
+ * @param captured Capture time.
+ * @param frame The image.
+ * @return bool - False once writing failed or the file is closed.
+ */
+bool RecordingWriter::writeFrame(size_t source, uint64_t sequence,
+                                 std::chrono::steady_clock::time_point captured,
+                                 const cv::Mat& frame) {
+    if (failed.load()) {
+        return false;
+    }
+    Pending item;
+    item.header.kind = static_cast<uint16_t>(RecordKind::Frame);
+    item.header.source = static_cast<uint16_t>(source);
+    item.header.sequence = sequence;
+    item.header.type = static_cast<uint16_t>(frame.type());
+    item.header.width = frame.cols;
+    item.header.height = frame.rows;
+    item.captured = captured;
+    // JPEG only holds 8-bit grey or colour pictures; anything else is raw.
+    item.encode = config.encoding == FrameEncoding::Jpeg &&
+                  frame.depth() == CV_8U &&
+                  (frame.channels() == 1 || frame.channels() == 3);
+    item.header.encoding = static_cast<uint16_t>(
+        item.encode ? FrameEncoding::Jpeg : FrameEncoding::Raw);
+    item.header.payloadSize = frame.total() * frame.elemSize();
+    {
+        std::lock_guard<std::mutex> lock(spareGuard);
+        if (!spare.empty()) {
+            item.image = std::move(spare.back());
+            spare.pop_back();
+        }
+    }
+    frame.copyTo(item.image);  // Reallocates only when the size changed.
+    return enqueue(std::move(item));
+}
+
+/**
+ * @brief Queues a JPEG payload to be stored as it is.
+ *
+ * @param source Camera/source index.
+ * @param sequence Capture sequence number.
+ * @param captured Capture time.
+ * @param jpeg The JPEG bytes.
+ * @return bool - False once writing failed or if @p jpeg is not a JPEG.
+ */
+bool RecordingWriter::writeEncodedFrame(
+    size_t source, uint64_t sequence,
+    std::chrono::steady_clock::time_point captured, const cv::Mat& jpeg) {
+    const size_t bytes = jpeg.total() * jpeg.elemSize();
+    cv::Size full;
+    if (!jpeg.isContinuous() || !jpegSize(jpeg.data, bytes, full)) {
+        return false;
+    }
+    Pending item;
+    item.header.kind = static_cast<uint16_t>(RecordKind::Frame);
+    item.header.source = static_cast<uint16_t>(source);
+    item.header.sequence = sequence;
+    item.header.encoding = static_cast<uint16_t>(FrameEncoding::Jpeg);
+    item.header.type = CV_8UC3;
+    item.header.width = full.width;
+    item.header.height = full.height;
+    item.header.payloadSize = bytes;
+    item.captured = captured;
+    item.image = jpeg;
+    return enqueue(std::move(item));
+}
+
+/**
+ * @brief Queues the detection records of one frame.
+ *
+ * @param source Camera/source index.
+ * @param sequence Capture sequence number of the frame.
+ * @param captured Capture time of the frame.
+ * @param records Its records.
+ * @return bool - False once writing failed or the file is closed.
+ */
+bool RecordingWriter::writeDetections(
+    size_t source, uint64_t sequence,
+    std::chrono::steady_clock::time_point captured,
+    const std::vector<StreamRecord>& records) {
+    Pending item;
+    item.header.kind = static_cast<uint16_t>(RecordKind::Detections);
+    item.header.source = static_cast<uint16_t>(source);
+    item.header.sequence = sequence;
+    item.header.payloadSize = records.size() * sizeof(StreamRecord);
+    item.captured = captured;
+    item.records = records;
+    return enqueue(std::move(item));
+}
+
+/**
+ * @brief Hands a record to the writer thread.
+ *
+ * @param item The record.
+ * @return bool - False once writing failed or the file is closed.
+ */
+bool RecordingWriter::enqueue(Pending item) {
+    if (failed.load()) {
+        return false;
+    }
+    return queue.push(std::move(item));
+}
+
+/**
+ * @brief Writer thread; encodes each queued frame without holding the lock
+ *        and appends it, until the queue is closed and drained.
+ *
+ * After a failure the remaining records are discarded.
+ */
+void RecordingWriter::writeLoop() {
+    Pending item;
+    while (!queue.drained()) {
+        if (!queue.pop(item, std::chrono::milliseconds(100)) || failed.load()) {
+            continue;
+        }
+        const bool frame =
+            item.header.kind == static_cast<uint16_t>(RecordKind::Frame);
+        const char* payload = frame
+            ? reinterpret_cast<const char*>(item.image.data)
+            : reinterpret_cast<const char*>(item.records.data());
+        if (item.encode) {
+            if (!cv::imencode(".jpg", item.image, encoded,
+                              {cv::IMWRITE_JPEG_QUALITY, config.jpegQuality})) {
+                std::lock_guard<std::mutex> lock(guard);
+                failure = "Cannot JPEG-encode frame";
+                failed.store(true);
+                continue;
+            }
+            item.header.payloadSize = encoded.size();
+            payload = reinterpret_cast<const char*>(encoded.data());
+        }
+        {
+            std::lock_guard<std::mutex> lock(guard);
+            if (!append(item.header, item.captured, payload)) {
+                failed.store(true);
+            }
+        }
+        // Copied pixels go back to the spares; JPEG payloads handed to
+        // writeEncodedFrame() are the caller's.
+        const bool copied = frame && (item.encode || item.header.encoding ==
+            static_cast<uint16_t>(FrameEncoding::Raw));
+        std::lock_guard<std::mutex> lock(spareGuard);
+        if (copied && spare.size() < queue.capacity()) {
+            spare.push_back(std::move(item.image));
+        }
+        item.image.release();
+    }
+}
+
+/**
+ * @brief Writes header, payload and padding of one record.
+ *
+ * The index entry is only added once the whole record is on disk, so the
+ * index never points past what was written.
+ */
+bool RecordingWriter::append(RecordHeader header,
+                             std::chrono::steady_clock::time_point captured,
+                             const char* payload) {
+    header.timestampNs =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(captured - origin)
+            .count();
+    IndexEntry entry;
+    entry.offset = offset;
+    entry.timestampNs = header.timestampNs;
+    entry.sequence = header.sequence;
+    entry.kind = header.kind;
+    entry.source = header.source;
+    const uint64_t end = offset + sizeof(header) + header.payloadSize;
+    if (!writeAll(&header, sizeof(header)) ||
+        !writeAll(payload, header.payloadSize) ||
+        !writeAll(kPadding, aligned(end) - end)) {
+        return false;
+    }
+    index.push_back(entry);
+    return true;
+}
+
+/**
+ * @brief Writes @p size bytes, retrying short writes.
+ */
+bool RecordingWriter::writeAll(const void* data, size_t size) {
+    const char* bytes = static_cast<const char*>(data);
+    size_t done = 0;
+    while (done < size) {
+        const ssize_t n = ::write(fd, bytes + done, size - done);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n < 0) {
+            failure = std::string("Cannot write recording: ") +
+                      std::strerror(errno);
+            return false;
+        }
+        done += static_cast<size_t>(n);
+    }
+    offset += size;
+    return true;
+}
+
+/**
+ * @brief Lets the writer thread finish the queue, then appends the index
+ *        and trailer and closes the file.
+ *
+ * After a write error the index is left out; the reader then scans the
+ * records that were completely written.
+ */
+void RecordingWriter::close() {
+    queue.close();
+    if (writer.joinable()) {
+        writer.join();
+    }
+    std::lock_guard<std::mutex> lock(guard);
+    if (fd < 0) {
+        return;
+    }
+    if (failure.empty()) {
+        IndexTrailer trailer;
+        trailer.indexOffset = offset;
+        trailer.count = index.size();
+        if (writeAll(index.data(), index.size() * sizeof(IndexEntry))) {
+            writeAll(&trailer, sizeof(trailer));
+        }
+    }
+    ::close(fd);
+    fd = -1;
+}
+
+/**
+ * @brief Returns the number of records written.
+ */
+uint64_t RecordingWriter::records() const {
+    std::lock_guard<std::mutex> lock(guard);
+    return index.size();
+}
+
+/**
+ * @brief Returns the first write error, empty while writing works.
+ */
+std::string RecordingWriter::error() const {
+    std::lock_guard<std::mutex> lock(guard);
+    return failure;
+}
+
+/**
+ * @brief Constructor; maps the file and loads its index.
+ *
+ * @param path The recording.
+ */
+RecordingReader::RecordingReader(const std::string& path) : file(path) {
+    if (file.size() < sizeof(RecordingHeader)) {
+        throw std::runtime_error(path + " is not a recording (too short)");
+    }
+    header = reinterpret_cast<const RecordingHeader*>(file.data());
+    if (header->magic != kRecordingMagic ||
+        header->version != kRecordingVersion) {
+        throw std::runtime_error(path +
+                                 " is not a recording (bad magic/version)");
+    }
+    hadIndex = readIndex();
+    if (!hadIndex) {
+        scan();
+    }
+}
+
+/**
+ * @brief Loads the index written by RecordingWriter::close().
+ *
+ * @return bool - False if the trailer is missing or the index does not fit
+ *         the file; the tables are then empty.
+ */
+bool RecordingReader::readIndex() {
+    const size_t size = file.size();
+    if (size < sizeof(RecordingHeader) + sizeof(IndexTrailer)) {
+        return false;
+    }
+    IndexTrailer trailer;
+    std::memcpy(&trailer, file.data() + size - sizeof(trailer),
+                sizeof(trailer));
+    if (trailer.magic != kIndexMagic || trailer.indexOffset > size ||
+        trailer.count > (size - trailer.indexOffset) / sizeof(IndexEntry) ||
+        trailer.indexOffset + trailer.count * sizeof(IndexEntry) +
+                sizeof(trailer) != size) {
+        return false;
+    }
+    const IndexEntry* entries =
+        reinterpret_cast<const IndexEntry*>(file.data() + trailer.indexOffset);
+    for (uint64_t i = 0; i < trailer.count; ++i) {
+        if (entries[i].offset >= trailer.indexOffset ||
+            !add(entries[i].offset)) {
+            frameRecords.clear();
+            detectionRecords.clear();
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Walks the records from the start up to the first one that is
+ *        incomplete or is not a record (e.g. the index).
+ */
+void RecordingReader::scan() {
+    uint64_t offset = sizeof(RecordingHeader);
+    while (add(offset)) {
+        const RecordHeader* record =
+            reinterpret_cast<const RecordHeader*>(file.data() + offset);
+        offset = aligned(offset + sizeof(RecordHeader) + record->payloadSize);
+    }
+}
+
+/**
+ * @brief Adds the record at @p offset to the lookup tables.
+ *
+ * @return bool - False if no complete record starts there.
+ */
+bool RecordingReader::add(uint64_t offset) {
+    const size_t size = file.size();
+    if (offset % kRecordAlignment != 0 || offset > size ||
+        size - offset < sizeof(RecordHeader)) {
+        return false;
+    }
+    RecordView view;
+    view.header = reinterpret_cast<const RecordHeader*>(file.data() + offset);
+    view.payload = file.data() + offset + sizeof(RecordHeader);
+    if (view.header->magic != kRecordMagic ||
+        view.header->payloadSize > size - offset - sizeof(RecordHeader)) {
+        return false;
+    }
+    switch (static_cast<RecordKind>(view.header->kind)) {
+    case RecordKind::Frame:
+        frameRecords.push_back(view);
+        return true;
+    case RecordKind::Detections:
+        if (view.header->payloadSize % sizeof(StreamRecord) != 0) {
+            return false;
+        }
+        detectionRecords[std::make_pair(view.header->source,
+                                        view.header->sequence)] = view;
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Returns frame @p i, a view of the mapping if it is raw.
+ *
+ * @param i Frame number in file order.
+ * @return cv::Mat - The frame; empty if its payload is corrupt.
+ */
+cv::Mat RecordingReader::frame(size_t i) const {
+    const RecordView& view = frameRecords.at(i);
+    const RecordHeader& record = *view.header;
+    // The mapping is read-only; OpenCV only needs a non-const pointer type.
+    char* payload = const_cast<char*>(view.payload);
+    if (static_cast<FrameEncoding>(record.encoding) == FrameEncoding::Jpeg) {
+        const cv::Mat encoded(1, static_cast<int>(record.payloadSize), CV_8U,
+                              payload);
+        return cv::imdecode(encoded, cv::IMREAD_UNCHANGED);
+    }
+    const size_t expected = static_cast<size_t>(record.width) * record.height *
+                            CV_ELEM_SIZE(record.type);
+    if (record.width <= 0 || record.height <= 0 ||
+        record.payloadSize != expected) {
+        return cv::Mat();
+    }
+    return cv::Mat(record.height, record.width, record.type, payload);
+}
+
+/**
+ * @brief Copies the detections recorded for frame @p i.
+ *
+ * @param i Frame number in file order.
+ * @param records Receives the records; emptied if there are none.
+ * @return bool - False if no detections were recorded for the frame.
+ */
+bool RecordingReader::detections(size_t i,
+                                 std::vector<StreamRecord>& records) const {
+    const RecordHeader& record = *frameRecords.at(i).header;
+    const auto found =
+        detectionRecords.find(std::make_pair(record.source, record.sequence));
+    if (found == detectionRecords.end()) {
+        records.clear();
+        return false;
+    }
+    records.resize(found->second.header->payloadSize / sizeof(StreamRecord));
+    std::memcpy(records.data(), found->second.payload,
+                found->second.header->payloadSize);
+    return true;
+}
+
+/**
+ * @brief Binary-searches the frames by timestamp.
+ *
+ * Frames are written as they are captured, so timestamps only go backwards
+ * by the capture jitter between cameras; seeking lands within that jitter.
+ *
+ * @param timestampNs Time since the recording start.
+ * @return size_t - First frame at or after it, or frameCount().
+ */
+size_t RecordingReader::seek(int64_t timestampNs) const {
+    const auto found = std::lower_bound(
+        frameRecords.begin(), frameRecords.end(), timestampNs,
+        [](const RecordView& view, int64_t time) {
+            return view.header->timestampNs < time;
+        });
+    return static_cast<size_t>(found - frameRecords.begin());
+}
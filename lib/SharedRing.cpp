@@ -0,0 +1,355 @@
+// Copyright 2026 Sai Surya Sriramoju
+
+/**
+ * @file SharedRing.cpp
+ * @brief Implementation of the RingPublisher and RingSubscriber classes.
+ * @author Sai Surya Sriramoju
+ * @date 10/17/2026
+ */
+
+#include "SharedRing.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <thread>
+
+namespace {
+/// Slot sections start on cache lines.
+const uint64_t kLine = 64;
+/// Polls a waiting reader spins through before it starts sleeping.
+const int kSpinPolls = 200;
+/// Sleep between polls once spinning did not find a message.
+const std::chrono::microseconds kPollSleep{50};
+
+/**
+ * @brief Rounds @p bytes up to whole cache lines.
+ */
+uint64_t lines(uint64_t bytes) {
+    return (bytes + kLine - 1) / kLine * kLine;
+}
+
+/**
+ * @brief Returns the segment name with the leading '/' POSIX requires.
+ */
+std::string segmentName(const std::string& name) {
+    return !name.empty() && name[0] == '/' ? name : "/" + name;
+}
+
+/**
+ * @brief Returns the byte offset of the records inside a slot.
+ */
+uint64_t recordsOffset() {
+    return sizeof(SlotHeader);
+}
+
+/**
+ * @brief Returns the byte offset of the pixels inside a slot.
+ */
+uint64_t pixelsOffset(uint64_t maxRecords) {
+    return recordsOffset() + lines(maxRecords * sizeof(StreamRecord));
+}
+}  // namespace
+
+/**
+ * @brief Constructor; creates, sizes and maps the segment.
+ *
+ * @param segment Segment name.
+ * @param config Slot count and capacity.
+ */
+RingPublisher::RingPublisher(const std::string& segment,
+                             const RingConfig& config)
+    : name(segmentName(segment)) {
+    using namespace std::chrono;
+    epochOffset = duration_cast<nanoseconds>(
+        system_clock::now().time_since_epoch() -
+        steady_clock::now().time_since_epoch());
+    if (config.slots == 0) {
+        throw std::invalid_argument("A ring needs at least one slot");
+    }
+    const uint64_t slotSize =
+        pixelsOffset(config.maxRecords) + lines(config.frameBytes);
+    length = static_cast<size_t>(sizeof(RingHeader) + config.slots * slotSize);
+
+    // Readers still mapping an old ring keep it; new ones find this one.
+    ::shm_unlink(name.c_str());
+    const int fd = ::shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (fd < 0) {
+        throw std::runtime_error("Cannot create shared memory " + name + ": " +
+                                 std::strerror(errno));
+    }
+    if (::ftruncate(fd, static_cast<off_t>(length)) != 0) {
+        const int error = errno;
+        ::close(fd);
+        ::shm_unlink(name.c_str());
+        throw std::runtime_error("Cannot size shared memory " + name + ": " +
+                                 std::strerror(error));
+    }
+    void* mapping =
+        ::mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        const int error = errno;
+        ::shm_unlink(name.c_str());
+        throw std::runtime_error("Cannot map shared memory " + name + ": " +
+                                 std::strerror(error));
+    }
+    // ftruncate zero-filled the slots, which is a valid idle lock state.
+    header = new (mapping) RingHeader();
+    header->magic = 0;  // Set last, so readers never see a half-made header.
+    header->slots = config.slots;
+    header->maxRecords = config.maxRecords;
+    header->slotSize = slotSize;
+    header->frameBytes = config.frameBytes;
+    header->publisherPid = static_cast<int64_t>(::getpid());
+    std::atomic_thread_fence(std::memory_order_release);
+    header->magic = kRingMagic;
+}
+
+/**
+ * @brief Destructor; unmaps and unlinks the segment.
+ */
+RingPublisher::~RingPublisher() {
+    ::munmap(header, length);
+    ::shm_unlink(name.c_str());
+}
+
+/**
+ * @brief Writes one message into the next slot under its sequence lock.
+ *
+ * @param source Camera/source index.
+ * @param sequence Capture sequence number.
+ * @param captured Capture time.
+ * @param frame Image to publish, may be empty.
+ * @param records The frame's records.
+ * @return uint64_t - Ring sequence number of the message.
+ */
+uint64_t RingPublisher::publish(size_t source, uint64_t sequence,
+                                std::chrono::steady_clock::time_point captured,
+                                const cv::Mat& frame,
+                                const std::vector<StreamRecord>& records) {
+    const uint64_t message = header->published.load(std::memory_order_relaxed);
+    char* slotStart = reinterpret_cast<char*>(header + 1) +
+                      (message % header->slots) * header->slotSize;
+    SlotHeader* slot = reinterpret_cast<SlotHeader*>(slotStart);
+
+    const uint64_t lock = slot->lock.load(std::memory_order_relaxed);
+    slot->lock.store(lock + 1, std::memory_order_relaxed);
+    // Readers must see the odd lock before any byte of the new content.
+    std::atomic_thread_fence(std::memory_order_release);
+
+    const size_t count = std::min<size_t>(records.size(), header->maxRecords);
+    slot->message = message;
+    slot->frame = StreamFrameHeader();
+    slot->frame.source = static_cast<uint16_t>(source);
+    slot->frame.count = static_cast<uint32_t>(count);
+    slot->frame.sequence = sequence;
+    slot->frame.timestampNs =
+        (captured.time_since_epoch() + epochOffset).count();
+    if (count > 0) {
+        std::memcpy(slotStart + recordsOffset(), records.data(),
+                    count * sizeof(StreamRecord));
+    }
+    const size_t bytes = frame.total() * frame.elemSize();
+    if (!frame.empty() && bytes <= header->frameBytes) {
+        slot->width = frame.cols;
+        slot->height = frame.rows;
+        slot->type = frame.type();
+        char* pixels = slotStart + pixelsOffset(header->maxRecords);
+        if (frame.isContinuous()) {
+            std::memcpy(pixels, frame.data, bytes);
+        } else {
+            const size_t row = frame.cols * frame.elemSize();
+            for (int y = 0; y < frame.rows; ++y) {
+                std::memcpy(pixels + y * row, frame.ptr(y), row);
+            }
+        }
+    } else {
+        slot->width = 0;
+        slot->height = 0;
+        slot->type = 0;
+    }
+
+    slot->lock.store(lock + 2, std::memory_order_release);
+    header->published.store(message + 1, std::memory_order_release);
+    return message;
+}
+
+/**
+ * @brief Returns the number of messages published.
+ */
+uint64_t RingPublisher::published() const {
+    return header->published.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Constructor; maps the segment and picks the first message.
+ *
+ * @param segment Segment name.
+ * @param fromStart Start with the oldest message still in the ring.
+ */
+RingSubscriber::RingSubscriber(const std::string& segment, bool fromStart) {
+    const std::string name = segmentName(segment);
+    const int fd = ::shm_open(name.c_str(), O_RDONLY, 0);
+    if (fd < 0) {
+        throw std::runtime_error("Cannot open shared memory " + name + ": " +
+                                 std::strerror(errno));
+    }
+    struct stat info;
+    if (::fstat(fd, &info) != 0 ||
+        static_cast<size_t>(info.st_size) < sizeof(RingHeader)) {
+        ::close(fd);
+        throw std::runtime_error(name + " is not a perception ring");
+    }
+    length = static_cast<size_t>(info.st_size);
+    void* mapping = ::mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        throw std::runtime_error("Cannot map shared memory " + name + ": " +
+                                 std::strerror(errno));
+    }
+    header = static_cast<const RingHeader*>(mapping);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (header->magic != kRingMagic || header->version != kRingVersion ||
+        header->slots == 0 ||
+        sizeof(RingHeader) + header->slots * header->slotSize > length) {
+        ::munmap(mapping, length);
+        throw std::runtime_error(name + " is not a perception ring");
+    }
+    const uint64_t published = header->published.load(std::memory_order_acquire);
+    nextMessage = !fromStart ? published
+                  : published > header->slots ? published - header->slots : 0;
+}
+
+/**
+ * @brief Destructor; unmaps the segment.
+ */
+RingSubscriber::~RingSubscriber() {
+    ::munmap(const_cast<RingHeader*>(header), length);
+}
+
+/**
+ * @brief Waits for the next message and returns a view of its slot.
+ *
+ * Messages the publisher overwrote before they were reached are skipped
+ * and counted as lost.
+ *
+ * @param view Receives the message.
+ * @param timeout Maximum time to wait.
+ * @return bool - False on timeout.
+ */
+bool RingSubscriber::acquire(RingView& view, std::chrono::microseconds timeout) {
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    int polls = 0;
+    while (true) {
+        const uint64_t published =
+            header->published.load(std::memory_order_acquire);
+        if (published <= nextMessage) {
+            if (std::chrono::steady_clock::now() >= deadline) {
+                return false;
+            }
+            if (++polls < kSpinPolls) {
+                std::this_thread::yield();
+            } else {
+                std::this_thread::sleep_for(kPollSleep);
+            }
+            continue;
+        }
+        if (published - nextMessage > header->slots) {
+            lostMessages += published - header->slots - nextMessage;
+            nextMessage = published - header->slots;
+        }
+        const char* slotStart = reinterpret_cast<const char*>(header + 1) +
+                                (nextMessage % header->slots) * header->slotSize;
+        const SlotHeader* slot = reinterpret_cast<const SlotHeader*>(slotStart);
+        view.lock = slot->lock.load(std::memory_order_acquire);
+        view.message = nextMessage++;
+        view.slot = slot;
+        view.frame = slot->frame;
+        if ((view.lock & 1) != 0 || slot->message != view.message ||
+            view.frame.count > header->maxRecords ||
+            static_cast<uint64_t>(slot->width) * slot->height *
+                    CV_ELEM_SIZE(slot->type) > header->frameBytes) {
+            ++lostMessages;  // Being rewritten: the publisher lapped us.
+            continue;
+        }
+        view.records = reinterpret_cast<const StreamRecord*>(
+            slotStart + recordsOffset());
+        if (slot->width > 0) {
+            view.image = cv::Mat(
+                slot->height, slot->width, slot->type,
+                const_cast<char*>(slotStart + pixelsOffset(header->maxRecords)));
+        } else {
+            view.image = cv::Mat();
+        }
+        if (!valid(view)) {
+            ++lostMessages;
+            continue;
+        }
+        return true;
+    }
+}
+
+/**
+ * @brief Checks that the slot of @p view still holds its message.
+ *
+ * @param view A view filled by acquire().
+ * @return bool - False if the publisher has started overwriting it.
+ */
+bool RingSubscriber::valid(const RingView& view) const {
+    // Order every read of the content before the second lock read.
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return view.slot->lock.load(std::memory_order_relaxed) == view.lock;
+}
+
+/**
+ * @brief Copies the next complete message out of the ring.
+ *
+ * @param frame Receives the frame header.
+ * @param records Receives the records.
+ * @param image Receives the pixels; released if there are none.
+ * @param timeout Maximum time to wait.
+ * @return bool - False on timeout.
+ */
+bool RingSubscriber::next(StreamFrameHeader& frame,
+                          std::vector<StreamRecord>& records, cv::Mat& image,
+                          std::chrono::microseconds timeout) {
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    RingView view;
+    while (true) {
+        const auto left = std::chrono::duration_cast<std::chrono::microseconds>(
+            deadline - std::chrono::steady_clock::now());
+        if (!acquire(view, std::max(left, std::chrono::microseconds(0)))) {
+            return false;
+        }
+        records.assign(view.records, view.records + view.frame.count);
+        if (view.image.empty()) {
+            image.release();
+        } else {
+            view.image.copyTo(image);
+        }
+        if (valid(view)) {
+            frame = view.frame;
+            return true;
+        }
+        ++lostMessages;  // Overwritten while copying; take the next one.
+    }
+}
+
+/**
+ * @brief Returns the slot count and capacity of the ring.
+ */
+RingConfig RingSubscriber::config() const {
+    RingConfig config;
+    config.slots = header->slots;
+    config.frameBytes = header->frameBytes;
+    config.maxRecords = header->maxRecords;
+    return config;
+}
@@ -0,0 +1,177 @@
+// Copyright 2026 Sai Surya Sriramoju
+
+/**
+ * @file Tiling.cpp
+ * @brief Implementation of tile planning and the TileMerger class.
+ * @author Sai Surya Sriramoju
+ * @date 10/17/2026
+ */
+
+#include "Tiling.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace {
+/// Distance from a tile border, as a fraction of the tile side, within which
+/// a box edge counts as cut off by the border.
+const float kBorderMargin = 0.02f;
+
+/**
+ * @brief Returns the side of @p count tiles covering @p length with
+ *        @p overlap, reducing @p count while tiles would be below @p minSide.
+ */
+int tileSide(int length, int& count, float overlap, int minSide) {
+    count = std::max(1, count);
+    while (true) {
+        const float side = length / (count - (count - 1) * overlap);
+        if (count == 1 || side >= minSide) {
+            return std::min(length, static_cast<int>(std::ceil(side)));
+        }
+        --count;
+    }
+}
+
+/**
+ * @brief Returns true if @p edge lies on the inner border at @p border.
+ */
+bool onBorder(float edge, int border, float margin, bool frameEdge) {
+    return !frameEdge && std::abs(edge - border) <= margin;
+}
+}  // namespace
+
+/**
+ * @brief Parses a "<columns>x<rows>" grid.
+ *
+ * @param grid E.g. "3x2".
+ * @return TilingConfig - The grid with default overlap and thresholds.
+ */
+TilingConfig TilingConfig::parse(const std::string& grid) {
+    TilingConfig config;
+    const size_t x = grid.find_first_of("xX");
+    try {
+        size_t used = 0;
+        config.columns = std::stoi(grid.substr(0, x), &used);
+        if (x == std::string::npos || used != x) {
+            throw std::invalid_argument(grid);
+        }
+        config.rows = std::stoi(grid.substr(x + 1), &used);
+        if (x + 1 + used != grid.size()) {
+            throw std::invalid_argument(grid);
+        }
+    } catch (const std::logic_error&) {
+        throw std::invalid_argument("Tile grid must look like 3x2, not \"" +
+                                    grid + "\"");
+    }
+    if (config.columns < 1 || config.rows < 1) {
+        throw std::invalid_argument("Tile grid " + grid + " has no tiles");
+    }
+    return config;
+}
+
+/**
+ * @brief Lays out an overlapping grid of equal tiles over a frame.
+ *
+ * @param frame Size of the frame or region to tile.
+ * @param config Grid, overlap and minimum tile side.
+ * @param tiles Receives the tiles, row by row.
+ */
+void planTiles(cv::Size frame, const TilingConfig& config,
+               std::vector<cv::Rect>& tiles) {
+    tiles.clear();
+    const float overlap = std::min(std::max(config.overlap, 0.0f), 0.9f);
+    int columns = config.columns;
+    int rows = config.rows;
+    const int width = tileSide(frame.width, columns, overlap, config.minTileSide);
+    const int height = tileSide(frame.height, rows, overlap, config.minTileSide);
+    for (int r = 0; r < rows; ++r) {
+        // Spread the tiles so the first and last sit on the frame edges.
+        const int top = rows == 1 ? 0 : (frame.height - height) * r / (rows - 1);
+        for (int c = 0; c < columns; ++c) {
+            const int left =
+                columns == 1 ? 0 : (frame.width - width) * c / (columns - 1);
+            tiles.emplace_back(left, top, width, height);
+        }
+    }
+}
+
+/**
+ * @brief Merges duplicate and border-cut boxes across tiles.
+ *
+ * Greedy in score order, like NMS: the best remaining box absorbs every
+ * box from another tile that duplicates it or continues it across a border.
+ *
+ * @param tiles Detections of each region, in frame pixels.
+ * @param regions The region each entry of @p tiles was detected on.
+ * @param frame Size of the frame.
+ * @param config Merge threshold.
+ * @param nms IoU threshold and class awareness for duplicates.
+ * @param merged Receives the merged detections.
+ */
+void TileMerger::merge(const std::vector<Detections>& tiles,
+                       const std::vector<cv::Rect>& regions, cv::Size frame,
+                       const TilingConfig& config, const NMSConfig& nms,
+                       Detections& merged) {
+    candidates.clear();
+    for (size_t t = 0; t < tiles.size() && t < regions.size(); ++t) {
+        const Detections& found = tiles[t];
+        const cv::Rect& region = regions[t];
+        const float marginX = kBorderMargin * region.width;
+        const float marginY = kBorderMargin * region.height;
+        for (size_t i = 0; i < found.size(); ++i) {
+            Candidate candidate;
+            candidate.box = cv::Rect2f(found.x[i], found.y[i], found.width[i],
+                                       found.height[i]);
+            candidate.score = found.scores[i];
+            candidate.classId = found.classIds[i];
+            candidate.tile = t;
+            const cv::Rect2f& box = candidate.box;
+            candidate.cut =
+                onBorder(box.x, region.x, marginX, region.x == 0) ||
+                onBorder(box.y, region.y, marginY, region.y == 0) ||
+                onBorder(box.x + box.width, region.x + region.width, marginX,
+                         region.x + region.width >= frame.width) ||
+                onBorder(box.y + box.height, region.y + region.height, marginY,
+                         region.y + region.height >= frame.height);
+            candidates.push_back(candidate);
+        }
+    }
+    std::sort(candidates.begin(), candidates.end(),
+              [](const Candidate& a, const Candidate& b) {
+                  return a.score > b.score;
+              });
+
+    merged.clear();
+    for (size_t i = 0; i < candidates.size(); ++i) {
+        Candidate& best = candidates[i];
+        if (best.merged) {
+            continue;
+        }
+        for (size_t j = i + 1; j < candidates.size(); ++j) {
+            Candidate& other = candidates[j];
+            if (other.merged || other.tile == best.tile ||
+                (nms.classAware && other.classId != best.classId)) {
+                continue;
+            }
+            const float overlap = (best.box & other.box).area();
+            if (overlap <= 0.0f) {
+                continue;
+            }
+            const float iou =
+                overlap / (best.box.area() + other.box.area() - overlap);
+            const float ios =
+                overlap / std::min(best.box.area(), other.box.area());
+            if ((best.cut || other.cut) && ios > config.mergeOverlap) {
+                // Two parts of one object: the union is the whole of it.
+                best.box = best.box | other.box;
+                best.cut = best.cut && other.cut;
+                other.merged = true;
+            } else if (iou > nms.iouThreshold) {
+                other.merged = true;  // The same object seen whole twice.
+            }
+        }
+        merged.push(best.box.x, best.box.y, best.box.width, best.box.height,
+                    best.score, best.classId);
+    }
+}
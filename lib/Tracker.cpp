@@ -0,0 +1,310 @@
+// Copyright 2026 Sai Surya Sriramoju
+
+/**
+ * @file Tracker.cpp
+ * @brief Implementation of the SORT-style MultiObjectTracker.
+ * @author Sai Surya Sriramoju
+ * @date 10/17/2026
+ */
+
+#include "Tracker.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+/// Cost of a pair that must not be associated.
+const double kForbidden = 1e6;
+
+using Measurement = Eigen::Matrix<double, 4, 1>;
+
+/**
+ * @brief Converts a box to the [cx, cy, area, aspect] measurement.
+ */
+Measurement toMeasurement(float x, float y, float w, float h) {
+    Measurement z;
+    z << x + w / 2.0, y + h / 2.0, static_cast<double>(w) * h,
+        w / std::max(static_cast<double>(h), 1e-6);
+    return z;
+}
+
+/**
+ * @brief Intersection over union of two boxes.
+ */
+double iou(const cv::Rect2f& a, float x, float y, float w, float h) {
+    const double left = std::max(a.x, x);
+    const double top = std::max(a.y, y);
+    const double right = std::min(a.x + a.width, x + w);
+    const double bottom = std::min(a.y + a.height, y + h);
+    const double inter = std::max(0.0, right - left) * std::max(0.0, bottom - top);
+    const double unionArea = a.area() + static_cast<double>(w) * h - inter;
+    return unionArea > 0.0 ? inter / unionArea : 0.0;
+}
+
+/**
+ * @brief Hungarian method for rows <= cols (potentials formulation).
+ */
+std::vector<int> assignRows(const std::vector<double>& cost, int rows, int cols) {
+    const double inf = std::numeric_limits<double>::infinity();
+    std::vector<double> u(rows + 1, 0.0), v(cols + 1, 0.0);
+    std::vector<int> owner(cols + 1, 0), way(cols + 1, 0);
+    for (int i = 1; i <= rows; ++i) {
+        owner[0] = i;
+        int j0 = 0;
+        std::vector<double> minv(cols + 1, inf);
+        std::vector<bool> used(cols + 1, false);
+        do {
+            used[j0] = true;
+            const int i0 = owner[j0];
+            double delta = inf;
+            int j1 = 0;
+            for (int j = 1; j <= cols; ++j) {
+                if (used[j]) {
+                    continue;
+                }
+                const double cur = cost[(i0 - 1) * cols + (j - 1)] - u[i0] - v[j];
+                if (cur < minv[j]) {
+                    minv[j] = cur;
+                    way[j] = j0;
+                }
+                if (minv[j] < delta) {
+                    delta = minv[j];
+                    j1 = j;
+                }
+            }
+            for (int j = 0; j <= cols; ++j) {
+                if (used[j]) {
+                    u[owner[j]] += delta;
+                    v[j] -= delta;
+                } else {
+                    minv[j] -= delta;
+                }
+            }
+            j0 = j1;
+        } while (owner[j0] != 0);
+        do {
+            const int j1 = way[j0];
+            owner[j0] = owner[j1];
+            j0 = j1;
+        } while (j0 != 0);
+    }
+    std::vector<int> assignment(rows, -1);
+    for (int j = 1; j <= cols; ++j) {
+        if (owner[j] != 0) {
+            assignment[owner[j] - 1] = j - 1;
+        }
+    }
+    return assignment;
+}
+}  // namespace
+
+/**
+ * @brief Minimum-cost assignment of rows to columns.
+ *
+ * @param cost Row-major cost matrix.
+ * @param rows Number of rows.
+ * @param cols Number of columns.
+ * @return std::vector<int> - Column of every row, -1 if unassigned.
+ */
+std::vector<int> solveAssignment(const std::vector<double>& cost, int rows,
+                                 int cols) {
+    if (rows == 0 || cols == 0) {
+        return std::vector<int>(rows, -1);
+    }
+    if (rows <= cols) {
+        return assignRows(cost, rows, cols);
+    }
+    // More rows than columns: solve the transpose and invert the result.
+    std::vector<double> transposed(cost.size());
+    for (int r = 0; r < rows; ++r) {
+        for (int c = 0; c < cols; ++c) {
+            transposed[c * rows + r] = cost[r * cols + c];
+        }
+    }
+    const std::vector<int> byColumn = assignRows(transposed, cols, rows);
+    std::vector<int> assignment(rows, -1);
+    for (int c = 0; c < cols; ++c) {
+        if (byColumn[c] >= 0) {
+            assignment[byColumn[c]] = c;
+        }
+    }
+    return assignment;
+}
+
+/**
+ * @brief Constructor; starts without tracks.
+ */
+MultiObjectTracker::MultiObjectTracker(const TrackerConfig& config)
+    : config(config) {}
+
+/**
+ * @brief Predicts, associates by IoU and corrects, then spawns and retires.
+ *
+ * @param detections Detections of the current frame.
+ * @return const std::vector<Track>& - The reported tracks.
+ */
+const std::vector<Track>& MultiObjectTracker::update(const Detections& detections) {
+    step();
+
+    const int rows = static_cast<int>(targets.size());
+    const int cols = static_cast<int>(detections.size());
+    cost.assign(static_cast<size_t>(rows) * cols, kForbidden);
+    for (int t = 0; t < rows; ++t) {
+        const Track& track = targets[t].track;
+        for (int d = 0; d < cols; ++d) {
+            if (config.classAware && detections.classIds[d] != track.classId) {
+                continue;
+            }
+            const double overlap = iou(track.box, detections.x[d], detections.y[d],
+                                       detections.width[d], detections.height[d]);
+            if (overlap >= config.iouThreshold) {
+                cost[t * cols + d] = 1.0 - overlap;
+            }
+        }
+    }
+    const std::vector<int> assignment = solveAssignment(cost, rows, cols);
+
+    matched.assign(cols, false);
+    for (int t = 0; t < rows; ++t) {
+        const int d = assignment[t];
+        if (d >= 0 && cost[t * cols + d] < kForbidden) {
+            correct(targets[t], detections, d);
+            matched[d] = true;
+        } else {
+            ++targets[t].misses;
+        }
+    }
+    targets.erase(std::remove_if(targets.begin(), targets.end(),
+                                 [this](const Target& target) {
+                                     return target.misses > config.maxMisses;
+                                 }),
+                  targets.end());
+    for (int d = 0; d < cols; ++d) {
+        if (!matched[d]) {
+            spawn(detections, d);
+        }
+    }
+    publish();
+    return visible;
+}
+
+/**
+ * @brief Coasts every track one frame on its motion model.
+ *
+ * @return const std::vector<Track>& - The reported tracks.
+ */
+const std::vector<Track>& MultiObjectTracker::predict() {
+    step();
+    publish();
+    return visible;
+}
+
+/**
+ * @brief Removes every track.
+ */
+void MultiObjectTracker::reset() {
+    targets.clear();
+    visible.clear();
+}
+
+/**
+ * @brief Constant-velocity Kalman prediction of every target.
+ */
+void MultiObjectTracker::step() {
+    // Process noise as in SORT: small on velocities, tiny on area change.
+    Covariance Q = Covariance::Identity();
+    Q(4, 4) = Q(5, 5) = 0.01;
+    Q(6, 6) = 1e-4;
+    for (Target& target : targets) {
+        if (target.x(2) + target.x(6) <= 0.0) {
+            target.x(6) = 0.0;  // Keep the area positive.
+        }
+        target.x.head<3>() += target.x.tail<3>();
+        // P = F P F^T + Q with F = [I I; 0 I] on the (position, velocity) pairs.
+        Covariance P = target.P;
+        P.topRows<3>() += target.P.block<3, 7>(4, 0);
+        const Covariance rows = P;
+        P.leftCols<3>() += rows.block<7, 3>(0, 4);
+        target.P = P + Q;
+        ++target.track.age;
+        refresh(target);
+    }
+}
+
+/**
+ * @brief Kalman correction with detection @p i.
+ *
+ * @param target The target to correct.
+ * @param detections The current detections.
+ * @param i Index of the matched detection.
+ */
+void MultiObjectTracker::correct(Target& target, const Detections& detections,
+                                 size_t i) const {
+    const Measurement z = toMeasurement(detections.x[i], detections.y[i],
+                                        detections.width[i], detections.height[i]);
+    Eigen::Matrix<double, 4, 4> R = Eigen::Matrix<double, 4, 4>::Identity();
+    R(2, 2) = R(3, 3) = 10.0;
+    // H = [I4 0], so H P H^T and P H^T are blocks of P.
+    const Eigen::Matrix<double, 4, 4> S = target.P.topLeftCorner<4, 4>() + R;
+    const Eigen::Matrix<double, 7, 4> K =
+        target.P.leftCols<4>() * S.inverse();
+    target.x += K * (z - target.x.head<4>());
+    target.P -= K * target.P.topRows<4>();
+
+    target.misses = 0;
+    target.track.score = detections.scores[i];
+    ++target.track.hits;
+    refresh(target);
+}
+
+/**
+ * @brief Creates a target at detection @p i with zero velocity.
+ *
+ * @param detections The current detections.
+ * @param i Index of the unmatched detection.
+ */
+void MultiObjectTracker::spawn(const Detections& detections, size_t i) {
+    Target target;
+    target.x.setZero();
+    target.x.head<4>() = toMeasurement(detections.x[i], detections.y[i],
+                                       detections.width[i], detections.height[i]);
+    // Unknown velocities start with a large variance, as in SORT.
+    target.P = Covariance::Identity() * 10.0;
+    target.P.bottomRightCorner<3, 3>() *= 1000.0;
+    target.track.id = nextId++;
+    target.track.classId = detections.classIds[i];
+    target.track.score = detections.scores[i];
+    target.track.hits = 1;
+    refresh(target);
+    targets.push_back(target);
+}
+
+/**
+ * @brief Converts the filter state back into a box and a velocity.
+ *
+ * @param target The target to refresh.
+ */
+void MultiObjectTracker::refresh(Target& target) {
+    const double area = std::max(target.x(2), 0.0);
+    const double aspect = std::max(target.x(3), 1e-6);
+    const double w = std::sqrt(area * aspect);
+    const double h = w > 0.0 ? area / w : 0.0;
+    target.track.box = cv::Rect2f(static_cast<float>(target.x(0) - w / 2),
+                                  static_cast<float>(target.x(1) - h / 2),
+                                  static_cast<float>(w), static_cast<float>(h));
+    target.track.velocity = cv::Point2f(static_cast<float>(target.x(4)),
+                                        static_cast<float>(target.x(5)));
+}
+
+/**
+ * @brief Reports confirmed tracks that were matched in the latest round.
+ */
+void MultiObjectTracker::publish() {
+    visible.clear();
+    for (const Target& target : targets) {
+        if (target.misses == 0 && target.track.hits >= config.minHits) {
+            visible.push_back(target.track);
+        }
+    }
+}
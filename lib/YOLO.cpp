@@ -9,6 +9,7 @@
  */
 
 #include "YOLO.h"
+#include <chrono>
 #include <stdexcept>
 
 // If MODELS_DIR is defined, use it. Otherwise, use "./models"
@@ -18,26 +19,175 @@
     const std::string YOLO::modelsDir = "./models";
 #endif
 
+namespace {
+/**
+ * @brief Resolves @p path against YOLO::modelsDir unless it is absolute.
+ */
+std::string modelPath(const std::string& path) {
+    if (path.empty() || path[0] == '/') {
+        return path;
+    }
+    return YOLO::modelsDir + "/" + path;
+}
+}  // namespace
+
 /**
  * @brief Constructor for YOLO class that initializes the YOLO model.
  *
- * Loads the YOLO model weights and configurations. It also sets the backend
- * and target for the DNN module in OpenCV for efficient processing.
+ * Loads the YOLOv3 weights and configuration with the default backend.
  */
-YOLO::YOLO() {
-    // Load the YOLO network
-    std::string weightsPath = modelsDir + "/yolov3.weights";
-    std::string cfgPath = modelsDir + "/yolov3.cfg";
-    net = cv::dnn::readNet(weightsPath, cfgPath);
+YOLO::YOLO() : YOLO(BackendConfig()) {}
 
-    // Error handling for network loading
-    if (net.empty()) {
-        throw std::runtime_error("Error loading YOLO model");
+/**
+ * @brief Loads the configured model into its backend.
+ *
+ * @param config Backend, model, output layout and precision.
+ */
+YOLO::YOLO(const BackendConfig& config) : settings(config) {
+    settings.model = modelPath(config.model);
+    settings.config = modelPath(config.config);
+    if (fixedInputSize()) {
+        setInputSize(settings.inputSize);
     }
+    applyInputSize();
 
-    // Set the backend and target for efficient processing
-    net.setPreferableBackend(cv::dnn::DNN_BACKEND_OPENCV);
-    net.setPreferableTarget(cv::dnn::DNN_TARGET_CPU);
+    std::vector<cv::Mat> calibration;
+    if (settings.precision == Precision::INT8 && !settings.calibration.empty()) {
+        std::vector<std::string> images;
+        cv::glob(settings.calibration, images);
+        for (const std::string& path : images) {
+            if (static_cast<int>(calibration.size()) >= settings.calibrationFrames) {
+                break;
+            }
+            const cv::Mat image = cv::imread(path);
+            if (!image.empty()) {
+                // The preprocessor reuses its blob, so keep a copy of each.
+                calibration.push_back(
+                    preprocessor.blobFromFrame(image, transform).clone());
+            }
+        }
+        if (calibration.empty()) {
+            throw std::runtime_error("No calibration images in " +
+                                     settings.calibration);
+        }
+    }
+    backend = createBackend(settings, calibration);
+    decoder.setLayout(settings.layout);
+}
+
+/**
+ * @brief Runs the network on a frame and decodes the detections.
+ *
+ * The blob, the output layers and the decoder workspace are members that are
+ * reused across calls, so steady-state frames do not reallocate them.
+ *
+ * @param frame The input frame (image) in which objects are to be detected.
+ * @return const Detections& - Detections in frame pixels, valid until the
+ *         next call.
+ */
+const Detections& YOLO::infer(const cv::Mat& frame) {
+    applyInputSize();
+    const cv::Mat* blob = nullptr;
+    {
+        // Letterbox the image into a blob for neural network preprocessing
+        ScopedTimer timer(stepTimers.preprocess);
+        blob = &preprocessor.blobFromFrame(frame, transform);
+    }
+    {
+        ScopedTimer timer(stepTimers.forward);
+        backend->forward(*blob, outputs);
+    }
+    return decoder.decode(outputs, transform);
+}
+
+/**
+ * @brief Runs the network on a tiled frame and merges the tile detections.
+ *
+ * Tile views share the frame's pixels; only the blob is built from them.
+ *
+ * @param frame The input frame.
+ * @param tiling Grid and merge settings.
+ * @return const Detections& - Merged detections in frame pixels, valid
+ *         until the next call.
+ */
+const Detections& YOLO::inferTiled(const cv::Mat& frame,
+                                   const TilingConfig& tiling) {
+    planTiles(frame.size(), tiling, tileRegions);
+    if (tileRegions.size() <= 1) {
+        return infer(frame);
+    }
+    if (tiling.fullFrame) {
+        tileRegions.emplace_back(0, 0, frame.cols, frame.rows);
+    }
+    tileViews.clear();
+    for (const cv::Rect& region : tileRegions) {
+        tileViews.push_back(frame(region));
+    }
+    tileDetections.resize(tileRegions.size());
+    if (fixedInputSize()) {
+        for (size_t n = 0; n < tileViews.size(); ++n) {
+            tileDetections[n] = infer(tileViews[n]);
+        }
+    } else {
+        applyInputSize();
+        const cv::Mat* blob = nullptr;
+        {
+            ScopedTimer timer(stepTimers.preprocess);
+            blob = &preprocessor.blobFromFrames(tileViews, batchTransforms);
+        }
+        {
+            ScopedTimer timer(stepTimers.forward);
+            backend->forward(*blob, outputs);
+        }
+        const int batchSize = static_cast<int>(tileViews.size());
+        slices.resize(outputs.size());
+        for (int n = 0; n < batchSize; ++n) {
+            for (size_t i = 0; i < outputs.size(); ++i) {
+                slices[i] = batchSlice(outputs[i], n, batchSize);
+            }
+            tileDetections[n] = decoder.decode(slices, batchTransforms[n]);
+        }
+    }
+    for (size_t n = 0; n < tileRegions.size(); ++n) {
+        tileDetections[n].offset(static_cast<float>(tileRegions[n].x),
+                                 static_cast<float>(tileRegions[n].y));
+    }
+    tileMerger.merge(tileDetections, tileRegions, frame.size(), tiling,
+                     decoder.config().nms, tiled);
+    return tiled;
+}
+
+/**
+ * @brief Times the steps of infer() into the given histograms.
+ *
+ * @param timers The histograms; nullptr entries are not timed.
+ */
+void YOLO::setTimers(const InferenceTimers& timers) {
+    stepTimers = timers;
+    decoder.setTimers(timers.decode, timers.nms);
+}
+
+/**
+ * @brief Runs one pass per input size on a mid-grey frame.
+ *
+ * @param sizes Input sizes to warm up; empty for the current one.
+ * @param frameSize Size of the blank frame.
+ * @return double - Elapsed time in milliseconds.
+ */
+double YOLO::warmUp(const std::vector<int>& sizes, cv::Size frameSize) {
+    const auto begin = std::chrono::steady_clock::now();
+    const int requested = inputSize();
+    const cv::Mat frame(frameSize, CV_8UC3, cv::Scalar::all(127));
+    for (int size : sizes) {
+        if (size != requested && !fixedInputSize()) {
+            setInputSize(size);
+            infer(frame);
+        }
+    }
+    setInputSize(requested);
+    infer(frame);  // Last, so the preprocessor ends at the requested size.
+    return std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - begin).count();
 }
 
 /**
@@ -49,76 +199,138 @@ YOLO::YOLO() {
  * @param frame The input frame (image) in which objects are to be detected.
  */
 std::vector<double> YOLO::detect(const cv::Mat& frame) {
-    // Convert the image to blob for neural network preprocessing
-    cv::Mat blob = cv::dnn::blobFromImage(
-        frame, 1/255.0, cv::Size(416, 416), cv::Scalar(0, 0, 0), true, false);
-    net.setInput(blob);
-
-    std::vector<cv::Mat> d;
-    net.forward(d, net.getUnconnectedOutLayersNames());
-    std::vector<cv::Rect> boxes;
-    std::vector<float> confidences;
-    std::vector<int> class_ids;
-
-    struct Detection {
-        int class_id;
-        float confidence;
-        cv::Rect box;
-    };
-
-
-    for (size_t i = 0; i < d.size(); ++i) {
-        float* data = reinterpret_cast<float*>(d[i].data);
-        for (int j = 0; j < d[i].rows; ++j, data += d[i].cols) {
-            cv::Mat scores = d[i].row(j).colRange(5, d[i].cols);
-            cv::Point classIdPoint;
-            double confidence;
-            cv::minMaxLoc(scores, 0, &confidence, 0, &classIdPoint);
-
-            if (confidence > 0.5) {
-                class_ids.push_back(classIdPoint.x);
-                int centerX = static_cast<int>(data[0] * frame.cols);
-                int centerY = static_cast<int>(data[1] * frame.rows);
-                int width = static_cast<int>(data[2] * frame.cols);
-                int height = static_cast<int>(data[3] * frame.rows);
-                int left = centerX - width / 2;
-                int top = centerY - height / 2;
-
-                boxes.push_back(cv::Rect(left, top, width, height));
-                confidences.push_back(confidence);
-            }
+    return postprocess(infer(frame), frame);
+}
+
+/**
+ * @brief Detects objects in several frames with a single forward pass.
+ *
+ * All frames are packed into one N x 3 x S x S blob so the network runs
+ * its convolutions as one large batched GEMM instead of N small ones. The
+ * output layers are then split back into per-frame slices and decoded exactly
+ * like detect() does. Models with a fixed input size run the frames one
+ * after another instead.
+ *
+ * @param frames The input frames; each one is annotated in place.
+ * @return std::vector<std::vector<double>> - Per-frame (u, v) pixel coordinates.
+ */
+std::vector<std::vector<double>> YOLO::detectBatch(
+    const std::vector<cv::Mat>& frames) {
+    std::vector<std::vector<double>> results;
+    if (frames.empty()) {
+        return results;
+    }
+    results.reserve(frames.size());
+    if (fixedInputSize()) {
+        // Fixed-size exports have a batch of one as well, see inferTiled().
+        for (const cv::Mat& frame : frames) {
+            results.push_back(detect(frame));
         }
+        return results;
+    }
+    applyInputSize();
+    const cv::Mat* blob = nullptr;
+    {
+        ScopedTimer timer(stepTimers.preprocess);
+        blob = &preprocessor.blobFromFrames(frames, batchTransforms);
+    }
+    {
+        ScopedTimer timer(stepTimers.forward);
+        backend->forward(*blob, outputs);
     }
 
-    // Non Maximum Suppression
-    std::vector<int> indices;
-    cv::dnn::NMSBoxes(boxes, confidences, 0.2, 0.2, indices);
-    std::vector<Detection> output;
+    const int batchSize = static_cast<int>(frames.size());
+    slices.resize(outputs.size());
+    for (int n = 0; n < batchSize; ++n) {
+        for (size_t i = 0; i < outputs.size(); ++i) {
+            slices[i] = batchSlice(outputs[i], n, batchSize);
+        }
+        results.push_back(
+            postprocess(decoder.decode(slices, batchTransforms[n]), frames[n]));
+    }
+    return results;
+}
 
-    for (size_t i=0; i < indices.size(); ++i)
-    {
-        int idx = indices[i];
-        Detection result;
-        result.class_id = class_ids[idx];
-        result.confidence = confidences[idx];
-        result.box = boxes[idx];
-        output.push_back(result);
+/**
+ * @brief Returns the 2D rows x (5 + classes) view of one image in a batched output.
+ *
+ * OpenCV's region layer emits a 2D rows x cols matrix for a single image and
+ * a 3D N x rows x cols blob for a batch. Either way the data for image @p n
+ * is contiguous, so the view is built without copying.
+ *
+ * @param output One output layer of a batched forward pass.
+ * @param n Index of the image within the batch.
+ * @param batchSize Number of images in the batch.
+ * @return cv::Mat - Header over the rows belonging to image @p n.
+ */
+cv::Mat YOLO::batchSlice(const cv::Mat& output, int n, int batchSize) {
+    if (output.dims == 3) {
+        return cv::Mat(output.size[1], output.size[2], CV_32F,
+                       const_cast<float*>(output.ptr<float>(n)));
     }
+    const int rowsPerImage = output.rows / batchSize;
+    return output.rowRange(n * rowsPerImage, (n + 1) * rowsPerImage);
+}
 
-    int no_detections = output.size();
-    std::cout << "No of human detections: " << no_detections << "\n";
+/**
+ * @brief Reports and annotates the detections of one frame.
+ *
+ * @param detections The decoded detections of @p frame.
+ * @param frame The frame the detections belong to; annotated in place.
+ * @return std::vector<double> - (u, v) pixel coordinates of every detection.
+ */
+std::vector<double> YOLO::postprocess(const Detections& detections,
+                                      const cv::Mat& frame) {
     std::vector<double> pixel_coords;
-    const std::vector<cv::Scalar> colors = {
+    postprocess(detections, frame, pixel_coords);
+    return pixel_coords;
+}
+
+/**
+ * @brief Reports and annotates the detections of one frame into a buffer.
+ *
+ * Prints the number of detections, draws the boxes on the frame and collects
+ * their pixel coordinates; printing and drawing can be switched off.
+ *
+ * @param detections The decoded detections of @p frame.
+ * @param frame The frame the detections belong to; annotated in place.
+ * @param pixelCoords Receives the (u, v) pixel coordinates of every
+ *        detection; its capacity is reused.
+ */
+void YOLO::postprocess(const Detections& detections, const cv::Mat& frame,
+                       std::vector<double>& pixelCoords) {
+    int no_detections = static_cast<int>(detections.size());
+    if (reporting.print) {
+        std::cout << "No of human detections: " << no_detections << "\n";
+    }
+    pixelCoords.clear();
+    pixelCoords.reserve(2 * detections.size());
+
+    for (int i = 0; i < no_detections; ++i) {
+        const cv::Rect box = detections.box(i);
+        pixelCoords.push_back(box.x);
+        pixelCoords.push_back(box.y);
+    }
+    if (reporting.annotate) {
+        annotate(detections, frame);
+    }
+}
+
+/**
+ * @brief Draws detections onto a frame.
+ *
+ * @param detections Detections in @p frame pixels.
+ * @param frame The frame to annotate in place.
+ */
+void YOLO::annotate(const Detections& detections, const cv::Mat& frame) {
+    static const cv::Scalar colors[] = {
       cv::Scalar(255, 255, 0), cv::Scalar(0, 255, 0), cv::Scalar(0, 255, 255),
       cv::Scalar(255, 0, 0)};
+    const int numColors = sizeof(colors) / sizeof(colors[0]);
 
-    for (int i = 0; i < no_detections; ++i) {
-        auto detection_params = output[i];
-        auto box = detection_params.box;
-        auto classIdx = detection_params.class_id;
-        const auto color = colors[classIdx % colors.size()];
-        pixel_coords.push_back(box.x);
-        pixel_coords.push_back(box.y);
+    for (int i = 0; i < static_cast<int>(detections.size()); ++i) {
+        const cv::Rect box = detections.box(i);
+        const auto color = colors[detections.classIds[i] % numColors];
         cv::rectangle(frame, box, (color), 3);
         cv::rectangle(frame, cv::Point(box.x, box.y - 35), cv::Point(box.x + box.width, box.y), color, cv::FILLED);
         cv::putText(frame,
@@ -126,9 +338,80 @@ std::vector<double> YOLO::detect(const cv::Mat& frame) {
                 cv::Point(box.x, box.y - 5), cv::FONT_HERSHEY_SIMPLEX, 1,
                 cv::Scalar(0, 0, 0), 2);
     }
+}
 
-    return pixel_coords;
+/**
+ * @brief Requests a new network input size for the next frame.
+ *
+ * @param size Side of the square network input; a positive multiple of 32.
+ */
+void YOLO::setInputSize(int size) {
+    if (size <= 0 || size % 32 != 0) {
+        throw std::invalid_argument(
+            "Network input size must be a positive multiple of 32, got " +
+            std::to_string(size));
+    }
+    if (fixedInputSize() && size != settings.inputSize) {
+        throw std::invalid_argument(
+            settings.model + " only accepts an input size of " +
+            std::to_string(settings.inputSize));
+    }
+    requestedInputSize.store(size, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Requests one of the named latency/accuracy input sizes.
+ *
+ * @param mode The input mode to switch to.
+ */
+void YOLO::setMode(InputMode mode) {
+    setInputSize(static_cast<int>(mode));
+}
+
+/**
+ * @brief Returns the network input size frames are currently run at.
+ *
+ * @return int - Side of the square network input.
+ */
+int YOLO::inputSize() const {
+    return requestedInputSize.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Selects how frames are turned into network input blobs.
+ *
+ * @param options The preprocessing options.
+ */
+void YOLO::setPreprocessOptions(const PreprocessOptions& options) {
+    preprocessor.setOptions(options);
+}
+
+/**
+ * @brief Applies a pending input size change before preprocessing a frame.
+ */
+void YOLO::applyInputSize() {
+    const int size = requestedInputSize.load(std::memory_order_relaxed);
+    if (size != preprocessor.inputSize()) {
+        preprocessor.setInputSize(size);
+    }
+}
 
+/**
+ * @brief Replaces the thresholds and class filter used by the decoder.
+ *
+ * @param config The new decoder configuration.
+ */
+void YOLO::setDecoderConfig(const DecoderConfig& config) {
+    decoder.configure(config);
+}
+
+/**
+ * @brief Changes the NMS settings used from the next decoded frame on.
+ *
+ * @param config The new NMS settings.
+ */
+void YOLO::setNMSConfig(const NMSConfig& config) {
+    decoder.setNMSConfig(config);
 }
 
 /**
@@ -13,64 +13,622 @@
  * human detection using YOLO.
  */
 
+#include "Affinity.h"
+#include "BatchProcessor.h"
 #include "Camera.h"
+#include "CaptureManager.h"
 #include "YOLO.h"
 #include "OpenCVProcessor.h"
 #include "CoordToWorld.h"
+#include "DetectionStream.h"
+#include "Metrics.h"
+#include "ModelLoader.h"
+#include "Pipeline.h"
+#include "Recording.h"
+#include "SharedRing.h"
+
+#include <algorithm>
+#include <atomic>
+#include <csignal>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Command line options understood by PerceptionModule.
+ */
+static const char* kOptions =
+    "{help h       |      | print this message}"
+    "{sources      |      | comma separated camera indices, video files, image directories or recordings (<file>.prec#<source>)}"
+    "{sync-tolerance | 20 | largest capture time difference within a frame set, in ms}"
+    "{queue        | 2    | capacity of every inter-stage queue}"
+    "{block        |      | block producers instead of dropping the oldest frame}"
+    "{report       | 5000 | throughput report interval in ms, 0 disables it}"
+    "{backend      | yolov3 | model preset (yolov3, yolov3-tiny, yolov5s, yolov8n) or a .yml/.json backend config}"
+    "{precision    |      | override the model precision: fp32, fp16 or int8}"
+    "{calibration  |      | image directory to calibrate int8 quantisation with}"
+    "{no-warm-up   |      | skip the warm-up passes before the first frame}"
+    "{detectors    | 1    | network instances running in parallel, frames in flight}"
+    "{threads-per-detector | 0 | OpenCV threads per forward pass; 0 for one per instance with --detectors > 1, else OpenCV's default or one per --pin-inference CPU}"
+    "{pin-capture  |      | CPUs of the capture stage, e.g. 0-1,8 or node0}"
+    "{pin-sources  |      | CPUs of each source's grab thread, ';' separated, e.g. 'node0;node1'; the last one repeats}"
+    "{pin-inference |     | CPUs of each detector instance, ';' separated like --pin-sources}"
+    "{pin-projection |    | CPUs of the projection stage}"
+    "{pin-output   |      | CPUs of the output stage, the main thread}"
+    "{input-size   | 416  | network input side, a multiple of 32 (320, 416, 608)}"
+    "{latency-budget | 0  | inference ms per frame; adapts the input size when set}"
+    "{classes      | 0    | comma separated COCO class ids to detect, empty for all}"
+    "{nms-iou      | 0.2  | IoU above which overlapping boxes are suppressed}"
+    "{nms-score    | 0.2  | minimum score kept by NMS}"
+    "{soft-nms     |      | soft-NMS decay: linear or gaussian}"
+    "{class-agnostic |    | let boxes of different classes suppress each other}"
+    "{track        |      | report tracks with persistent ids instead of raw detections}"
+    "{detect-every | 1    | run YOLO on every Nth frame and track in between; implies --track}"
+    "{separate-preprocess | | build the network input with resize + blobFromImage}"
+    "{fused-blur   |      | blur the network input inside the fused pass instead of the full frame}"
+    "{motion-gate  |      | skip YOLO on unchanged frames and run it on the moving region only}"
+    "{gate-threshold | 25 | grey level change that counts as motion}"
+    "{gate-min-area | 0.002 | fraction of changed pixels needed to run YOLO}"
+    "{gate-refresh | 30   | run on the whole frame at least every N frames, 0 never}"
+    "{gate-mog2    |      | detect motion against a MOG2 background model}"
+    "{output       |      | write binary detection records to a file, a pipe, - (stdout) or unix:<socket path>}"
+    "{headless     |      | no windows and no per-frame console output}"
+    "{publish      |      | publish frames and detections to this POSIX shared-memory ring for local readers, e.g. /perception}"
+    "{publish-slots | 8   | messages the --publish ring keeps for slow readers}"
+    "{record       |      | record captured frames and their detections to this .prec file for replay with --sources}"
+    "{record-raw   |      | record frames uncompressed: no decoding on replay, but ~6 MB per 1080p frame}"
+    "{replay-fast  |      | replay .prec sources as fast as the pipeline runs instead of at the recorded pace}"
+    "{compressed-capture | | grab MJPEG from cameras and decode JPEG frames at 1/2, 1/4 or 1/8 scale, just above --input-size}"
+    "{batch        |      | process the --sources files as fast as possible and write <dir>/<name>.dets for each}"
+    "{decoders     | 0    | decode threads in --batch mode, 0 for one per core}"
+    "{stream-fps   |      | target detections per second per source, e.g. 15,5; schedules sources by deadline}"
+    "{stream-priority |   | weight per source when the detector cannot keep up, e.g. 2,1; implies scheduling}"
+    "{tiles        |      | tile grid per source for high-resolution frames, e.g. 3x2 or 3x2,1x1; the last one repeats}"
+    "{tile-overlap | 0.2  | overlap between neighbouring tiles, per source like --tiles}"
+    "{metrics      |      | record per-stage latency histograms and add p50/p95/p99 to the reports}"
+    "{metrics-file |      | rewrite this file with Prometheus metrics every few seconds; implies --metrics}"
+    "{metrics-port | 0    | serve Prometheus metrics on 127.0.0.1:<port>; implies --metrics}";
+
+/// Set by SIGINT/SIGTERM; the output handler stops the pipeline.
+static std::atomic<bool> interrupted(false);
+
+/**
+ * @brief Signal handler asking the pipeline to stop.
+ */
+static void onSignal(int) {
+    interrupted.store(true);
+}
+
+/**
+ * @brief Splits a comma separated list such as "0,video.mp4", skipping blanks.
+ *
+ * @param list The text to split.
+ * @return std::vector<std::string> - The items; empty for an empty list.
+ */
+static std::vector<std::string> splitList(const std::string& list) {
+    std::vector<std::string> items;
+    std::stringstream stream(list);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        if (!item.empty()) {
+            items.push_back(item);
+        }
+    }
+    return items;
+}
+
+/**
+ * @brief Parses a comma separated list of integers such as "0,2,3".
+ *
+ * @param list The text to parse.
+ * @return std::vector<int> - The parsed values; empty for an empty list.
+ * @throws std::invalid_argument if an item is not a non-negative integer.
+ */
+static std::vector<int> parseIdList(const std::string& list) {
+    std::vector<int> ids;
+    for (const std::string& item : splitList(list)) {
+        size_t end = 0;
+        int id = -1;
+        try {
+            id = std::stoi(item, &end);
+        } catch (const std::exception&) {
+        }
+        if (id < 0 || end != item.size()) {
+            throw std::invalid_argument("Bad id '" + item + "' in '" + list + "'");
+        }
+        ids.push_back(id);
+    }
+    return ids;
+}
+
+/**
+ * @brief Builds the per-source tile grids from --tiles and --tile-overlap.
+ *
+ * @param parser The parsed command line.
+ * @return std::vector<TilingConfig> - One grid per listed source; empty
+ *         without --tiles.
+ * @throws std::invalid_argument if a grid is malformed.
+ */
+static std::vector<TilingConfig> tilingConfig(const cv::CommandLineParser& parser) {
+    std::vector<TilingConfig> grids;
+    if (!parser.has("tiles")) {
+        return grids;
+    }
+    const std::vector<std::string> overlaps =
+        splitList(parser.get<std::string>("tile-overlap"));
+    for (const std::string& grid : splitList(parser.get<std::string>("tiles"))) {
+        grids.push_back(TilingConfig::parse(grid));
+        if (!overlaps.empty()) {
+            const size_t i = std::min(grids.size(), overlaps.size()) - 1;
+            grids.back().overlap = std::stof(overlaps[i]);
+        }
+    }
+    return grids;
+}
+
+/**
+ * @brief Parses a --pin-* option and checks that this process may run on
+ *        every CPU it names.
+ *
+ * @param parser The parsed command line.
+ * @param name The option.
+ * @return std::vector<CpuList> - One list per ';' separated entry; empty
+ *         without the option.
+ * @throws std::invalid_argument if a list is malformed or names a CPU
+ *         outside the process's affinity mask.
+ */
+static std::vector<CpuList> pinOption(const cv::CommandLineParser& parser,
+                                      const std::string& name) {
+    std::vector<CpuList> lists;
+    if (!parser.has(name)) {
+        return lists;
+    }
+    lists = parseCpuLists(parser.get<std::string>(name));
+    const CpuList allowed = allowedCpus();
+    for (const CpuList& cpus : lists) {
+        for (int cpu : cpus) {
+            if (!std::binary_search(allowed.begin(), allowed.end(), cpu)) {
+                throw std::invalid_argument("CPU " + std::to_string(cpu) +
+                                            " of --" + name +
+                                            " is not available to this process");
+            }
+        }
+    }
+    return lists;
+}
+
+/**
+ * @brief Builds the stage and detector placement from the --pin-* options.
+ *
+ * @param parser The parsed command line.
+ * @return AffinityConfig - Empty lists for stages left unpinned.
+ * @throws std::invalid_argument if a list is malformed.
+ */
+static AffinityConfig affinityConfig(const cv::CommandLineParser& parser) {
+    AffinityConfig affinity;
+    affinity.capture = cpusFor(pinOption(parser, "pin-capture"), 0);
+    affinity.inference = pinOption(parser, "pin-inference");
+    affinity.projection = cpusFor(pinOption(parser, "pin-projection"), 0);
+    affinity.output = cpusFor(pinOption(parser, "pin-output"), 0);
+    return affinity;
+}
+
+/**
+ * @brief Builds the per-source rates and priorities from --stream-fps and
+ *        --stream-priority; the last value of each list repeats.
+ *
+ * @param parser The parsed command line.
+ * @return SchedulerConfig - One policy per listed source.
+ */
+static SchedulerConfig schedulerConfig(const cv::CommandLineParser& parser) {
+    SchedulerConfig config;
+    const std::vector<std::string> rates =
+        splitList(parser.get<std::string>("stream-fps"));
+    const std::vector<std::string> priorities =
+        splitList(parser.get<std::string>("stream-priority"));
+    for (size_t i = 0; i < std::max(rates.size(), priorities.size()); ++i) {
+        StreamPolicy policy;
+        if (!rates.empty()) {
+            policy.targetFps = std::stod(rates[std::min(i, rates.size() - 1)]);
+        }
+        if (!priorities.empty()) {
+            policy.priority =
+                std::stod(priorities[std::min(i, priorities.size() - 1)]);
+        }
+        config.streams.push_back(policy);
+    }
+    return config;
+}
+
+/**
+ * @brief Builds the detector backend configuration from the command line.
+ *
+ * @param parser The parsed command line.
+ * @return BackendConfig - A preset or the contents of a config file, with
+ *         the precision options applied on top.
+ */
+static BackendConfig backendConfig(const cv::CommandLineParser& parser) {
+    const std::string backend = parser.get<std::string>("backend");
+    const bool file = backend.find('.') != std::string::npos;
+    BackendConfig config = file ? BackendConfig::load(backend)
+                                : BackendConfig::preset(backend);
+    if (parser.has("precision")) {
+        config.precision = parsePrecision(parser.get<std::string>("precision"));
+    }
+    if (parser.has("calibration")) {
+        config.calibration = parser.get<std::string>("calibration");
+    }
+    return config;
+}
 
 /**
  * @brief Main function to run the AcmeRobotics-PerceptionModule project.
  * 
- * Initializes the Camera, YOLO, and OpenCVProcessor classes. Captures video frames
- * from the camera, detects humans using the YOLO model, processes the frames using
- * OpenCV functions, and displays the processed frames in a window.
+ * Initializes the Camera, YOLO, OpenCVProcessor and CoordToWorld classes and
+ * connects them in a Pipeline: frames are captured, run through YOLO and
+ * OpenCV processing, projected to world coordinates and displayed, with each
+ * stage on its own thread so capture continues while YOLO is busy.
  * 
+ * @param argc Number of command line arguments.
+ * @param argv Command line arguments, see kOptions.
  * @return int - Returns 0 on successful execution.
  */
-int main() {
-    // Camera object to capture video frames.
-    Camera camera;
-    // YOLO object for human detection.
-    YOLO yolo;
+int main(int argc, char** argv) {
+    const auto processStart = std::chrono::steady_clock::now();
+    cv::CommandLineParser parser(argc, argv, kOptions);
+    if (parser.has("help")) {
+        parser.printMessage();
+        return 0;
+    }
+    PipelineConfig config;
+    config.queueCapacity = static_cast<size_t>(parser.get<int>("queue"));
+    config.overflow = parser.has("block") ? OverflowPolicy::Block
+                                          : OverflowPolicy::DropOldest;
+    config.reportInterval = std::chrono::milliseconds(parser.get<int>("report"));
+    config.inferenceBudget =
+        std::chrono::milliseconds(parser.get<int>("latency-budget"));
+    config.detectEvery = std::max(1, parser.get<int>("detect-every"));
+    config.tracking = parser.has("track") || config.detectEvery > 1;
+    config.detectorInstances = std::max(1, parser.get<int>("detectors"));
+    config.threadsPerDetector = parser.get<int>("threads-per-detector");
+    std::vector<CpuList> sourceCpus;
+    DecoderConfig decoderConfig;
+    try {
+        decoderConfig.classes = parseIdList(parser.get<std::string>("classes"));
+        config.tiling = tilingConfig(parser);
+        config.affinity = affinityConfig(parser);
+        sourceCpus = pinOption(parser, "pin-sources");
+        config.schedule = parser.has("stream-fps") || parser.has("stream-priority");
+        config.scheduler = schedulerConfig(parser);
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+    const bool headless = parser.has("headless");
+    const std::string outputTarget =
+        parser.has("output") ? parser.get<std::string>("output") : "";
+    // With the stream on stdout, everything for humans goes to stderr.
+    std::ostream& console = outputTarget == "-" ? std::cerr : std::cout;
+    config.log = &console;
+    // Ctrl-C also stops a pipeline whose frames never reach the output.
+    config.stopFlag = &interrupted;
+    // Boxes are drawn on the output thread, and only if someone looks.
+    config.annotateInOutput = !headless;
+    // Latency histograms; registered by the pipeline, exported while it runs.
+    Metrics metrics;
+    ExporterConfig exporterConfig;
+    exporterConfig.file =
+        parser.has("metrics-file") ? parser.get<std::string>("metrics-file") : "";
+    exporterConfig.port = parser.get<int>("metrics-port");
+    const bool exportMetrics =
+        !exporterConfig.file.empty() || exporterConfig.port > 0;
+    if (parser.has("metrics") || exportMetrics) {
+        config.metrics = &metrics;
+    }
+    PostprocessOptions postprocessOptions;
+    postprocessOptions.print = false;
+    postprocessOptions.annotate = false;
+
+    decoderConfig.nms.iouThreshold = parser.get<float>("nms-iou");
+    decoderConfig.nms.scoreThreshold = parser.get<float>("nms-score");
+    decoderConfig.nms.classAware = !parser.has("class-agnostic");
+    if (parser.has("soft-nms")) {
+        decoderConfig.nms.mode =
+            parser.get<std::string>("soft-nms") == "gaussian"
+                ? NMSMode::SoftGaussian : NMSMode::SoftLinear;
+    }
     // OpenCVProcessor object for image processing.
     OpenCVProcessor opencvProcessor;
+    PreprocessOptions preprocessOptions;
+    preprocessOptions.fused = !parser.has("separate-preprocess");
+    if (preprocessOptions.fused && parser.has("fused-blur")) {
+        // Blur once at network resolution instead of on every full frame.
+        ProcessingOptions processingOptions = opencvProcessor.options();
+        preprocessOptions.gaussianBlur = processingOptions.gaussianBlur;
+        processingOptions.gaussianBlur = false;
+        opencvProcessor.setOptions(processingOptions);
+    }
+    if (parser.has("motion-gate")) {
+        ProcessingOptions processingOptions = opencvProcessor.options();
+        processingOptions.motionGate = true;
+        processingOptions.gate.diffThreshold = parser.get<double>("gate-threshold");
+        processingOptions.gate.minChangedFraction =
+            parser.get<double>("gate-min-area");
+        processingOptions.gate.refreshEvery = parser.get<int>("gate-refresh");
+        processingOptions.gate.backgroundSubtraction = parser.has("gate-mog2");
+        opencvProcessor.setOptions(processingOptions);
+    }
+    const int inputSize = parser.get<int>("input-size");
+    const bool warmUp = !parser.has("no-warm-up");
+    // Sizes the latency budget may switch to must be warm as well.
+    std::vector<int> warmSizes;
+    if (config.inferenceBudget.count() > 0) {
+        for (InputMode mode : {InputMode::Fast, InputMode::Balanced,
+                               InputMode::Accurate}) {
+            if (static_cast<int>(mode) <= inputSize) {
+                warmSizes.push_back(static_cast<int>(mode));
+            }
+        }
+    }
+    // YOLO object for human detection, loaded and warmed up in the
+    // background while the cameras open.
+    auto prepare = [&](YOLO& yolo) {
+        yolo.setDecoderConfig(decoderConfig);
+        yolo.setPreprocessOptions(preprocessOptions);
+        yolo.setPostprocessOptions(postprocessOptions);
+        if (!yolo.fixedInputSize()) {
+            yolo.setInputSize(inputSize);
+        }
+        if (warmUp) {
+            yolo.warmUp(warmSizes);
+        }
+    };
+    std::unique_ptr<ModelLoader> loader;
+
+    // Either the default camera or a synchronised set of sources.
+    std::unique_ptr<Camera> camera;
+    std::unique_ptr<CaptureManager> capture;
+    // YOLO object for human detection.
+    std::unique_ptr<YOLO> detector;
+    // Where detection records go, if anywhere.
+    std::unique_ptr<DetectionStreamWriter> stream;
+    // Where captured frames and detections are recorded, if anywhere.
+    std::unique_ptr<RecordingWriter> recorder;
+    // Where frames and detections are shared with local readers, if anywhere.
+    std::unique_ptr<RingPublisher> publisher;
+    try {
+        loader.reset(new ModelLoader(backendConfig(parser), prepare));
+        const std::vector<std::string> uris =
+            splitList(parser.get<std::string>("sources"));
+        if (parser.has("batch")) {
+            // Offline footage is read by the BatchProcessor itself.
+        } else if (uris.empty()) {
+            camera.reset(new Camera());
+            if (parser.has("compressed-capture") &&
+                !camera->setCompressedCapture(inputSize)) {
+                console << "Camera does not hand over MJPEG, decoding in full\n";
+            }
+        } else {
+            std::vector<SourceSpec> specs;
+            bool live = false;
+            for (const std::string& uri : uris) {
+                specs.push_back(SourceSpec::parse(uri));
+                specs.back().realtime = !parser.has("replay-fast");
+                if (parser.has("compressed-capture")) {
+                    specs.back().decodeSide = inputSize;
+                }
+                specs.back().cpus = cpusFor(sourceCpus, specs.size() - 1);
+                live = live || specs.back().kind == SourceKind::Device;
+            }
+            CaptureConfig captureConfig;
+            captureConfig.tolerance =
+                std::chrono::milliseconds(parser.get<int>("sync-tolerance"));
+            if (!live) {
+                // Files have no capture clock: read them in lockstep instead.
+                captureConfig.sync = SyncMode::Index;
+                captureConfig.dropOldest = false;
+            }
+            capture.reset(new CaptureManager(specs, captureConfig));
+        }
+        if (!outputTarget.empty()) {
+            // A reader going away must not kill us with SIGPIPE; the write
+            // fails with EPIPE instead and the pipeline stops cleanly.
+            std::signal(SIGPIPE, SIG_IGN);
+            stream.reset(new DetectionStreamWriter(outputTarget));
+        }
+        if (parser.has("record") && !parser.has("batch")) {
+            RecorderConfig recorderConfig;
+            if (parser.has("record-raw")) {
+                recorderConfig.encoding = FrameEncoding::Raw;
+            }
+            recorder.reset(new RecordingWriter(parser.get<std::string>("record"),
+                                               recorderConfig));
+            config.recorder = recorder.get();
+        }
+        if (parser.has("publish") && !parser.has("batch")) {
+            RingConfig ringConfig;
+            ringConfig.slots =
+                static_cast<uint32_t>(std::max(1, parser.get<int>("publish-slots")));
+            publisher.reset(new RingPublisher(parser.get<std::string>("publish"),
+                                              ringConfig));
+        }
+        if (!loader->ready()) {
+            console << "Waiting for the detector to load..." << std::endl;
+        }
+        detector = loader->get();
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+    YOLO& yolo = *detector;
+    const LoadTimes loadTimes = loader->times();
+    console << "Detector: " << yolo.backendName() << ", loaded in "
+            << loadTimes.loadMs << " ms, warmed up in " << loadTimes.prepareMs
+            << " ms\n";
     // CoordToWorld object for coordinate transformation.
     CoordToWorld world_coord;
-    
-    while (true) {  // Continuous loop to process video frames
-        // Capture image using Camera class.
-        cv::Mat frame = camera.captureImage();
-        if (frame.empty()) {
-            break;  // Break the loop if no more frames
-        }
-        
-        // Detect humans using YOLO.
-        std::vector<double> pixel_coords = yolo.detect(frame);
-        // Process the captured frame.
-        opencvProcessor.processImages(frame);
-        // Compute the transformation matrix.
-        MatrixXf TM(3, 4);
-        TM = world_coord.transMat();
-        // Compute real world coordinates.
-        std::vector<double> real_world = world_coord.worldPoints(TM, pixel_coords);
-        int count = 1;  // Counter for number of persons detected
-        for (long unsigned int i = 0; i < 2; i = i + 3) {
-            std::cout << "Person " << count
-                      << " world coordinates :" << real_world.at(i) << ", "
-                      << real_world.at(i + 1) << ", " << real_world.at(i + 2) << "\n";
-            count++;
+
+    if (parser.has("batch")) {
+        BatchConfig batch;
+        batch.decoders = parser.get<int>("decoders");
+        batch.detectors.instances = config.detectorInstances;
+        batch.detectors.threadsPerInstance =
+            config.threadsPerDetector > 0 ? config.threadsPerDetector : 1;
+        batch.detectors.cpus = config.affinity.inference;
+        batch.detectors.warmUp = warmUp;
+        batch.tiling = config.tiling;
+        batch.outputDir = parser.get<std::string>("batch");
+        batch.reportInterval = config.reportInterval;
+        std::vector<SourceSpec> inputs;
+        for (const std::string& uri : splitList(parser.get<std::string>("sources"))) {
+            inputs.push_back(SourceSpec::parse(uri));
         }
-        // @brief Display the processed frame.
-        cv::imshow("Camera", frame);
-        if (cv::waitKey(1) == 'q') {
-            break;  // Break the loop if 'q' is pressed
+        try {
+            std::unique_ptr<MetricsExporter> exporter;
+            if (config.metrics != nullptr) {
+                InferenceTimers timers;
+                const std::string help = "Time spent per frame in each stage.";
+                timers.preprocess = &metrics.histogram(
+                    "perception_stage_seconds", "stage=\"preprocess\"", help);
+                timers.forward = &metrics.histogram(
+                    "perception_stage_seconds", "stage=\"forward\"", help);
+                timers.decode = &metrics.histogram(
+                    "perception_stage_seconds", "stage=\"decode\"", help);
+                timers.nms = &metrics.histogram(
+                    "perception_stage_seconds", "stage=\"nms\"", help);
+                yolo.setTimers(timers);
+            }
+            if (exportMetrics) {
+                exporter.reset(new MetricsExporter(metrics, exporterConfig));
+            }
+            BatchProcessor processor(yolo, world_coord, batch);
+            const BatchSummary summary = processor.run(inputs);
+            std::cout << "Batch: " << summary.frames << " frames, "
+                      << summary.detections << " detections in "
+                      << summary.seconds << " s (" << summary.fps()
+                      << " fps)\n";
+            for (size_t i = 0; i < inputs.size(); ++i) {
+                if (!summary.outputs[i].empty()) {
+                    std::cout << "  " << inputs[i].name() << " -> "
+                              << summary.outputs[i] << "\n";
+                }
+            }
+            if (config.metrics != nullptr) {
+                std::cout << metrics.summary();
+            }
+            return summary.failedInputs == 0 ? 0 : 1;
+        } catch (const std::exception& e) {
+            std::cerr << e.what() << std::endl;
+            return 1;
         }
+    }
 
+    std::unique_ptr<Pipeline> pipeline(
+        camera ? new Pipeline(*camera, yolo, opencvProcessor, world_coord, config)
+               : new Pipeline(*capture, yolo, opencvProcessor, world_coord, config));
+    // Declared after the pipeline so it stops before the series it samples go.
+    std::unique_ptr<MetricsExporter> exporter;
+    if (exportMetrics) {
+        try {
+            exporter.reset(new MetricsExporter(metrics, exporterConfig));
+        } catch (const std::exception& e) {
+            std::cerr << e.what() << std::endl;
+            return 1;
+        }
+        if (exporter->port() > 0) {
+            console << "Metrics on http://127.0.0.1:" << exporter->port()
+                    << "/metrics\n";
+        }
     }
+    std::signal(SIGINT, onSignal);
+    std::signal(SIGTERM, onSignal);
+    bool first = true;
+    std::vector<StreamRecord> records;
+    pipeline->run([&](FrameTask& task) {
+        if (first) {
+            first = false;
+            console << "Time to first detection: "
+                    << std::chrono::duration<double, std::milli>(
+                           std::chrono::steady_clock::now() - processStart).count()
+                    << " ms\n";
+        }
+        if (stream || recorder || publisher) {
+            if (config.tracking) {
+                makeRecords(task.tracks, task.worldCoords, records, task.scale);
+            } else {
+                makeRecords(task.detections, task.worldCoords, records,
+                            task.scale);
+            }
+        }
+        if (recorder) {
+            recorder->writeDetections(task.source, task.sequence, task.captured,
+                                      records);
+        }
+        if (publisher) {
+            publisher->publish(task.source, task.sequence, task.captured,
+                               task.frame, records);
+        }
+        if (stream && !stream->write(task.source, task.sequence, task.captured,
+                                     records)) {
+            return false;
+        }
+        if (headless) {
+            return !interrupted.load();
+        }
+        if (!stream) {
+            const std::vector<double>& real_world = task.worldCoords;
+            int count = 1;  // Counter for number of persons detected
+            for (size_t i = 0; i + 2 < real_world.size(); i = i + 3) {
+                std::cout << "Person " << count
+                          << " world coordinates :" << real_world.at(i) << ", "
+                          << real_world.at(i + 1) << ", " << real_world.at(i + 2) << "\n";
+                count++;
+            }
+        }
+        // @brief Display the processed frame.
+        cv::imshow("Camera " + std::to_string(task.source), task.frame);
+        // Stop if 'q' is pressed
+        return cv::waitKey(1) != 'q' && !interrupted.load();
+    });
+    console << pipeline->throughputReport();
+    if (stream) {
+        console << "Wrote " << stream->frames() << " frames of detections\n";
+        if (!stream->error().empty()) {
+            std::cerr << stream->error() << std::endl;
+        }
+    }
+    if (recorder) {
+        recorder->close();
+        console << "Recorded " << recorder->records() << " records to "
+                << parser.get<std::string>("record") << " ("
+                << recorder->dropped() << " dropped: disk too slow)\n";
+        if (!recorder->error().empty()) {
+            std::cerr << recorder->error() << std::endl;
+        }
+    }
+    if (publisher) {
+        console << "Published " << publisher->published() << " messages to "
+                << parser.get<std::string>("publish") << "\n";
+    }
+    if (capture) {
+        for (size_t i = 0; i < capture->sourceCount(); ++i) {
+            if (capture->state(i) == SourceState::Failed) {
+                std::cerr << "Source " << i << " failed: "
+                          << capture->lastError(i) << std::endl;
+            }
+        }
+    }
+
     // Release the camera.
-    camera.release();
+    if (camera) {
+        camera->release();
+    }
     // Destroy all OpenCV windows.
-    cv::destroyAllWindows();
+    if (!headless) {
+        cv::destroyAllWindows();
+    }
 
     return 0;
 }
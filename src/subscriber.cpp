@@ -0,0 +1,192 @@
+// Copyright 2026 Sai Surya Sriramoju
+
+/**
+ * @file subscriber.cpp
+ * @brief Reads the frames and detections PerceptionModule publishes with
+ *        --publish and prints them, their rate and their latency.
+ * @author Sai Surya Sriramoju
+ * @date 10/17/2026
+ */
+
+#include <opencv2/opencv.hpp>
+#include "Metrics.h"
+#include "SharedRing.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+/// Command line options.
+static const char* kOptions =
+    "{help h usage ? |    | print this message}"
+    "{@name        | /perception | ring name given to PerceptionModule --publish}"
+    "{from-start   |      | read the messages still in the ring before new ones}"
+    "{stats        |      | print rate, loss and latency every --report ms instead of every message}"
+    "{report       | 1000 | interval of --stats reports in ms}"
+    "{count        | 0    | stop after this many messages, 0 never}"
+    "{copy         |      | copy each message out instead of reading it in place}"
+    "{show         |      | display the frames with their boxes}";
+
+/// Set by SIGINT/SIGTERM to stop reading.
+static std::atomic<bool> interrupted(false);
+
+/**
+ * @brief Signal handler asking the reader to stop.
+ */
+static void onSignal(int) {
+    interrupted.store(true);
+}
+
+/**
+ * @brief Returns the time since the epoch, the clock of the ring timestamps.
+ */
+static int64_t nowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * @brief Prints one message on a line.
+ */
+static void printMessage(const StreamFrameHeader& frame,
+                         const StreamRecord* records, int64_t latencyNs) {
+    std::printf("source %u frame %llu: %u records, %.3f ms\n", frame.source,
+                static_cast<unsigned long long>(frame.sequence), frame.count,
+                latencyNs / 1e6);
+    for (uint32_t i = 0; i < frame.count; ++i) {
+        const StreamRecord& r = records[i];
+        std::printf("  track %d class %d %.3f at (%.0f, %.0f, %.0f x %.0f) "
+                    "world (%.2f, %.2f, %.2f)\n",
+                    r.trackId, r.classId, r.confidence, r.x, r.y, r.width,
+                    r.height, r.worldX, r.worldY, r.worldZ);
+    }
+}
+
+/**
+ * @brief Draws the boxes on a copy of the frame and shows it.
+ */
+static void showMessage(const StreamFrameHeader& frame,
+                        const StreamRecord* records, const cv::Mat& image) {
+    if (image.empty()) {
+        return;
+    }
+    cv::Mat canvas = image.clone();
+    for (uint32_t i = 0; i < frame.count; ++i) {
+        const StreamRecord& r = records[i];
+        cv::rectangle(canvas, cv::Rect2f(r.x, r.y, r.width, r.height),
+                      cv::Scalar(0, 255, 0), 2);
+    }
+    cv::imshow("Source " + std::to_string(frame.source), canvas);
+    if (cv::waitKey(1) == 'q') {
+        interrupted.store(true);
+    }
+}
+
+/**
+ * @brief Subscribes to a ring and reports what arrives.
+ *
+ * The latency printed is from frame capture in the publisher to the moment
+ * the message was read here, so it covers the whole pipeline plus the ring.
+ *
+ * @param argc Number of command line arguments.
+ * @param argv Command line arguments, see kOptions.
+ * @return int - 0 on success, 1 if the ring cannot be opened.
+ */
+int main(int argc, char** argv) {
+    cv::CommandLineParser parser(argc, argv, kOptions);
+    if (parser.has("help")) {
+        parser.printMessage();
+        return 0;
+    }
+    const bool stats = parser.has("stats");
+    const bool copy = parser.has("copy");
+    const bool show = parser.has("show");
+    const uint64_t count =
+        static_cast<uint64_t>(std::max(0, parser.get<int>("count")));
+    const auto reportInterval =
+        std::chrono::milliseconds(std::max(1, parser.get<int>("report")));
+
+    std::unique_ptr<RingSubscriber> subscriber;
+    try {
+        subscriber.reset(new RingSubscriber(parser.get<std::string>("@name"),
+                                            parser.has("from-start")));
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+    const RingConfig ring = subscriber->config();
+    std::cerr << "Attached to " << parser.get<std::string>("@name") << ": "
+              << ring.slots << " slots of " << ring.frameBytes
+              << " pixel bytes and " << ring.maxRecords << " records\n";
+    std::signal(SIGINT, onSignal);
+    std::signal(SIGTERM, onSignal);
+
+    std::unique_ptr<Histogram> latency(new Histogram());
+    uint64_t received = 0;
+    uint64_t intervalReceived = 0;
+    uint64_t intervalLost = 0;
+    auto intervalStart = std::chrono::steady_clock::now();
+    RingView view;
+    StreamFrameHeader frame;
+    std::vector<StreamRecord> records;
+    cv::Mat image;
+    const std::chrono::microseconds timeout(100000);
+    while (!interrupted.load() && (count == 0 || received < count)) {
+        bool got = false;
+        if (copy) {
+            got = subscriber->next(frame, records, image, timeout);
+        } else if (subscriber->acquire(view, timeout)) {
+            // Work on the slot in place, then make sure it was not
+            // overwritten meanwhile; if it was, what we read is discarded.
+            frame = view.frame;
+            if (!stats || show) {
+                records.assign(view.records, view.records + frame.count);
+            }
+            if (show) {
+                view.image.copyTo(image);
+            }
+            got = subscriber->valid(view);
+        }
+        const auto now = std::chrono::steady_clock::now();
+        if (got) {
+            const int64_t latencyNs = nowNs() - frame.timestampNs;
+            ++received;
+            ++intervalReceived;
+            latency->record(
+                std::chrono::nanoseconds(std::max<int64_t>(latencyNs, 0)));
+            if (!stats) {
+                printMessage(frame, records.data(), latencyNs);
+            }
+            if (show) {
+                showMessage(frame, records.data(), image);
+            }
+        }
+        if (stats && now - intervalStart >= reportInterval) {
+            const double seconds =
+                std::chrono::duration<double>(now - intervalStart).count();
+            const HistogramSnapshot snapshot = latency->snapshot();
+            const uint64_t lost = subscriber->lost() - intervalLost;
+            std::printf("%.1f msgs/s, %llu lost, latency p50 %.3f ms "
+                        "p95 %.3f ms p99 %.3f ms\n",
+                        intervalReceived / seconds,
+                        static_cast<unsigned long long>(lost),
+                        snapshot.quantile(0.50) * 1e3,
+                        snapshot.quantile(0.95) * 1e3,
+                        snapshot.quantile(0.99) * 1e3);
+            std::fflush(stdout);
+            latency.reset(new Histogram());
+            intervalReceived = 0;
+            intervalLost = subscriber->lost();
+            intervalStart = now;
+        }
+    }
+    std::cerr << "Received " << received << " messages, lost "
+              << subscriber->lost() << "\n";
+    return 0;
+}
@@ -8,10 +8,81 @@
  */
 
 #include <gtest/gtest.h>
+#include "Affinity.h"
 #include "Camera.h"
+#include "CaptureManager.h"
+#include "FramePool.h"
+#include "JpegDecode.h"
 #include "OpenCVProcessor.h"
 #include "YOLO.h"
+#include "CoordToWorld.h"
+#include "DeadlineScheduler.h"
+#include "BoundedQueue.h"
+#include "AsyncDetector.h"
+#include "BatchProcessor.h"
+#include "MappedFile.h"
+#include "Metrics.h"
+#include "ModelLoader.h"
+#include "Pipeline.h"
+#include "DecodeKernels.h"
+#include "DetectionDecoder.h"
+#include "DetectorBackend.h"
+#include "DetectionStream.h"
+#include "NMS.h"
+#include "Preprocessor.h"
+#include "Recording.h"
+#include "SharedRing.h"
+#include "Tiling.h"
+#include "Tracker.h"
 #include <Eigen/Dense>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <sched.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <mutex>
+#include <new>
+#include <set>
+#include <sstream>
+#include <thread>
+
+/**
+ * @brief Number of global operator new calls, used by allocation tests.
+ */
+static std::atomic<size_t> g_allocations(0);
+
+void* operator new(size_t size) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](size_t size) {
+    return operator new(size);
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p, size_t) noexcept {
+    std::free(p);
+}
 
 /**
  * @brief Test suite for the Camera class.
@@ -154,6 +225,2336 @@ TEST_F(MainApplicationTest, MainLoop) {
     ASSERT_TRUE(true);
 }
 
+/**
+ * @brief Test suite for the BoundedQueue connecting pipeline stages.
+ */
+TEST(BoundedQueueTest, DropOldestKeepsNewestItems) {
+    BoundedQueue<int> queue(2, OverflowPolicy::DropOldest);
+    ASSERT_TRUE(queue.push(1));
+    ASSERT_TRUE(queue.push(2));
+    ASSERT_TRUE(queue.push(3));  // Evicts 1.
+    ASSERT_EQ(queue.size(), 2u);
+    ASSERT_EQ(queue.dropped(), 1u);
+
+    int item = 0;
+    ASSERT_TRUE(queue.pop(item, std::chrono::milliseconds(0)));
+    ASSERT_EQ(item, 2);
+    ASSERT_TRUE(queue.pop(item, std::chrono::milliseconds(0)));
+    ASSERT_EQ(item, 3);
+    ASSERT_FALSE(queue.pop(item, std::chrono::milliseconds(1)));
+}
+
+TEST(BoundedQueueTest, BlockWaitsForConsumer) {
+    BoundedQueue<int> queue(1, OverflowPolicy::Block);
+    ASSERT_TRUE(queue.push(1));
+    std::thread producer([&queue] { queue.push(2); });
+
+    int item = 0;
+    ASSERT_TRUE(queue.pop(item, std::chrono::seconds(1)));
+    ASSERT_EQ(item, 1);
+    ASSERT_TRUE(queue.pop(item, std::chrono::seconds(1)));
+    ASSERT_EQ(item, 2);
+    producer.join();
+    ASSERT_EQ(queue.dropped(), 0u);
+}
+
+TEST(BoundedQueueTest, CloseDrainsAndRejects) {
+    BoundedQueue<int> queue(4);
+    queue.push(7);
+    queue.close();
+    ASSERT_FALSE(queue.push(8));
+    ASSERT_FALSE(queue.drained());
+
+    int item = 0;
+    ASSERT_TRUE(queue.pop(item, std::chrono::milliseconds(0)));
+    ASSERT_EQ(item, 7);
+    ASSERT_TRUE(queue.drained());
+}
+
+/**
+ * @brief Builds a synthetic YOLO output layer with a few confident rows.
+ */
+static cv::Mat makeYoloOutput(int rows, int seed) {
+    cv::Mat output = cv::Mat::zeros(rows, 85, CV_32F);
+    for (int j = seed % 7; j < rows; j += 37) {
+        float* data = output.ptr<float>(j);
+        data[0] = 0.1f + 0.8f * (j % 11) / 11.0f;   // centre x
+        data[1] = 0.1f + 0.8f * (j % 13) / 13.0f;   // centre y
+        data[2] = 0.05f + 0.1f * (j % 3);           // width
+        data[3] = 0.1f + 0.1f * (j % 5);            // height
+        data[4] = 0.9f;                             // objectness
+        data[5 + (j % 80)] = 0.6f + 0.3f * (j % 4) / 4.0f;
+    }
+    return output;
+}
+
+/**
+ * @brief Test suite for the DetectionDecoder workspace.
+ */
+TEST(DetectionDecoderTest, DecodesAndSuppressesOverlaps) {
+    cv::Mat output = cv::Mat::zeros(3, 85, CV_32F);
+    const float rows[3][6] = {{0.5f, 0.5f, 0.2f, 0.4f, 0.9f, 0.9f},
+                              {0.51f, 0.5f, 0.2f, 0.4f, 0.9f, 0.8f},
+                              {0.1f, 0.1f, 0.1f, 0.1f, 0.2f, 0.3f}};
+    for (int j = 0; j < 3; ++j) {
+        std::copy(rows[j], rows[j] + 6, output.ptr<float>(j));
+    }
+
+    DetectionDecoder decoder;
+    const Detections& detections =
+        decoder.decode({output}, cv::Size(640, 480));
+    ASSERT_EQ(detections.size(), 1u);  // Row 1 overlaps row 0, row 2 is weak.
+    EXPECT_FLOAT_EQ(detections.scores[0], 0.9f);
+    EXPECT_EQ(detections.classIds[0], 0);
+    EXPECT_NEAR(detections.x[0], 0.5f * 640 - 0.1f * 640, 1e-3);
+    EXPECT_NEAR(detections.height[0], 0.4f * 480, 1e-3);
+}
+
+TEST(DetectionDecoderTest, NoAllocationsAfterWarmUp) {
+    const std::vector<cv::Mat> outputs = {makeYoloOutput(507, 1),
+                                          makeYoloOutput(2028, 2),
+                                          makeYoloOutput(8112, 3)};
+    DetectionDecoder decoder;
+    for (int i = 0; i < 3; ++i) {  // Warm-up grows the workspace.
+        decoder.decode(outputs, cv::Size(640, 480));
+    }
+    const size_t before = g_allocations.load();
+    size_t total = 0;
+    for (int i = 0; i < 10; ++i) {
+        total += decoder.decode(outputs, cv::Size(640, 480)).size();
+    }
+    const size_t allocations = g_allocations.load() - before;
+    EXPECT_GT(total, 0u);
+    EXPECT_EQ(allocations, 0u);
+}
+
+/**
+ * @brief Test suite for the SIMD decode kernels against the original path.
+ */
+TEST(DecodeKernelsTest, ArgmaxMatchesMinMaxLoc) {
+    cv::RNG rng(42);
+    for (int n = 1; n <= 96; ++n) {
+        cv::Mat scores(1, n, CV_32F);
+        for (int trial = 0; trial < 20; ++trial) {
+            // Coarse values so that ties are common.
+            for (int c = 0; c < n; ++c) {
+                scores.at<float>(c) = rng.uniform(0, 8) / 8.0f;
+            }
+            double expected = 0.0;
+            cv::Point expectedLoc;
+            cv::minMaxLoc(scores, 0, &expected, 0, &expectedLoc);
+
+            float best = 0.0f;
+            int index = argmaxScores(scores.ptr<float>(), n, &best);
+            ASSERT_EQ(index, expectedLoc.x) << "n=" << n << " " << decodeKernelIsa();
+            ASSERT_FLOAT_EQ(best, static_cast<float>(expected));
+        }
+    }
+}
+
+TEST(DecodeKernelsTest, DecoderMatchesReferenceScan) {
+    cv::RNG rng(7);
+    cv::Mat output(2028, 85, CV_32F);
+    for (int j = 0; j < output.rows; ++j) {
+        float* data = output.ptr<float>(j);
+        data[0] = rng.uniform(0.1f, 0.9f);
+        data[1] = rng.uniform(0.1f, 0.9f);
+        data[2] = rng.uniform(0.01f, 0.05f);
+        data[3] = rng.uniform(0.01f, 0.05f);
+        data[4] = rng.uniform(0.0f, 1.0f) < 0.05f ? rng.uniform(0.5f, 1.0f) : 0.0f;
+        for (int c = 5; c < 85; ++c) {
+            data[c] = data[4] * rng.uniform(0.0f, 1.0f);
+        }
+    }
+
+    // The pre-kernel scan: minMaxLoc over all classes, no early reject.
+    size_t expectedAll = 0;
+    size_t expectedPerson = 0;
+    for (int j = 0; j < output.rows; ++j) {
+        cv::Mat scores = output.row(j).colRange(5, output.cols);
+        cv::Point classIdPoint;
+        double confidence;
+        cv::minMaxLoc(scores, 0, &confidence, 0, &classIdPoint);
+        expectedAll += confidence > 0.5;
+        expectedPerson += output.at<float>(j, 5) > 0.5f;
+    }
+
+    DecoderConfig config;
+    config.nms.iouThreshold = 1.0f;  // Keep every candidate.
+    DetectionDecoder all(config);
+    EXPECT_EQ(all.decode({output}, cv::Size(416, 416)).size(), expectedAll);
+
+    config.classes = {0};
+    DetectionDecoder person(config);
+    const Detections& people = person.decode({output}, cv::Size(416, 416));
+    EXPECT_EQ(people.size(), expectedPerson);
+    for (size_t i = 0; i < people.size(); ++i) {
+        EXPECT_EQ(people.classIds[i], 0);
+    }
+}
+
+/**
+ * @brief Test suite for the NMSEngine.
+ */
+TEST(NMSTest, IoUKernelMatchesScalar) {
+    cv::RNG rng(3);
+    const int n = 37;
+    std::vector<float> x1(n), y1(n), x2(n), y2(n), area(n);
+    for (int j = 0; j < n; ++j) {
+        x1[j] = rng.uniform(0.0f, 100.0f);
+        y1[j] = rng.uniform(0.0f, 100.0f);
+        x2[j] = x1[j] + rng.uniform(0.0f, 50.0f);
+        y2[j] = y1[j] + rng.uniform(0.0f, 50.0f);
+        area[j] = (x2[j] - x1[j]) * (y2[j] - y1[j]);
+    }
+    const float box[5] = {20.0f, 30.0f, 70.0f, 90.0f, 50.0f * 60.0f};
+    std::vector<float> simd(n), scalar(n);
+    iouOneToMany(box, x1.data(), y1.data(), x2.data(), y2.data(), area.data(),
+                 n, simd.data());
+    iouOneToManyScalar(box, x1.data(), y1.data(), x2.data(), y2.data(),
+                       area.data(), n, scalar.data());
+    for (int j = 0; j < n; ++j) {
+        EXPECT_NEAR(simd[j], scalar[j], 1e-6) << j;
+    }
+}
+
+TEST(NMSTest, HardMatchesNMSBoxes) {
+    cv::RNG rng(11);
+    Detections candidates;
+    std::vector<cv::Rect> boxes;
+    std::vector<float> scores;
+    for (int i = 0; i < 300; ++i) {
+        cv::Rect box(rng.uniform(0, 600), rng.uniform(0, 440),
+                     rng.uniform(10, 80), rng.uniform(10, 80));
+        float score = rng.uniform(0.0f, 1.0f);
+        boxes.push_back(box);
+        scores.push_back(score);
+        candidates.push(box.x, box.y, box.width, box.height, score, i % 3);
+    }
+    std::vector<int> indices;
+    cv::dnn::NMSBoxes(boxes, scores, 0.2f, 0.4f, indices);
+
+    NMSConfig config;
+    config.iouThreshold = 0.4f;
+    config.classAware = false;
+    Detections kept;
+    NMSEngine engine;
+    engine.run(candidates, config, kept);
+    ASSERT_EQ(kept.size(), indices.size());
+    for (size_t k = 0; k < indices.size(); ++k) {
+        EXPECT_FLOAT_EQ(kept.scores[k], scores[indices[k]]);
+    }
+}
+
+TEST(NMSTest, ClassAwareAndSoftModes) {
+    Detections candidates;
+    candidates.push(0, 0, 100, 100, 0.9f, 0);
+    candidates.push(10, 0, 100, 100, 0.8f, 0);  // Overlaps the first box.
+    candidates.push(5, 0, 100, 100, 0.7f, 1);   // Same place, other class.
+
+    NMSEngine engine;
+    Detections kept;
+    NMSConfig config;
+    config.iouThreshold = 0.5f;
+    engine.run(candidates, config, kept);
+    ASSERT_EQ(kept.size(), 2u);
+    EXPECT_EQ(kept.classIds[0], 0);
+    EXPECT_EQ(kept.classIds[1], 1);
+
+    config.classAware = false;
+    engine.run(candidates, config, kept);
+    ASSERT_EQ(kept.size(), 1u);
+
+    // Soft-NMS keeps the overlapping box with a decayed score.
+    config.mode = NMSMode::SoftLinear;
+    config.classAware = true;
+    config.scoreThreshold = 0.05f;
+    engine.run(candidates, config, kept);
+    ASSERT_EQ(kept.size(), 3u);
+    EXPECT_FLOAT_EQ(kept.scores[0], 0.9f);
+    EXPECT_LT(kept.scores[1], 0.8f);
+    EXPECT_GT(kept.scores[1], 0.05f);
+}
+
+/**
+ * @brief Test suite for letterbox preprocessing.
+ */
+TEST(PreprocessorTest, LetterboxKeepsAspectRatio) {
+    Preprocessor preprocessor(416);
+    cv::Mat frame(480, 640, CV_8UC3, cv::Scalar(0, 0, 255));
+    cv::Mat letterboxed;
+    LetterboxTransform transform = preprocessor.letterbox(frame, letterboxed);
+
+    ASSERT_EQ(letterboxed.rows, 416);
+    ASSERT_EQ(letterboxed.cols, 416);
+    EXPECT_FLOAT_EQ(transform.scaleX, transform.scaleY);
+    EXPECT_FLOAT_EQ(transform.padX, 0.0f);
+    EXPECT_FLOAT_EQ(transform.padY, 52.0f);  // (416 - 312) / 2
+    EXPECT_EQ(letterboxed.at<cv::Vec3b>(10, 200)[2], 127);   // Border.
+    EXPECT_EQ(letterboxed.at<cv::Vec3b>(208, 200)[2], 255);  // Image.
+
+    const cv::Mat& blob = preprocessor.blobFromFrame(frame, transform);
+    ASSERT_EQ(blob.size[2], 416);
+    ASSERT_EQ(blob.size[3], 416);
+}
+
+TEST(PreprocessorTest, RejectsSizesNotMultipleOf32) {
+    Preprocessor preprocessor;
+    EXPECT_THROW(preprocessor.setInputSize(400), std::invalid_argument);
+    EXPECT_NO_THROW(preprocessor.setInputSize(320));
+    EXPECT_NO_THROW(preprocessor.setInputSize(608));
+    EXPECT_EQ(preprocessor.inputSize(), 608);
+}
+
+TEST(PreprocessorTest, DecoderUndoesLetterbox) {
+    Preprocessor preprocessor(320);
+    cv::Mat frame(720, 1280, CV_8UC3);
+    cv::Mat letterboxed;
+    const LetterboxTransform transform = preprocessor.letterbox(frame, letterboxed);
+
+    // A 100 x 200 box at (600, 300) in the frame, expressed as network output.
+    const cv::Rect2f box(600, 300, 100, 200);
+    cv::Mat output = cv::Mat::zeros(1, 85, CV_32F);
+    float* data = output.ptr<float>(0);
+    data[0] = ((box.x + box.width / 2) * transform.scaleX + transform.padX) / 320;
+    data[1] = ((box.y + box.height / 2) * transform.scaleY + transform.padY) / 320;
+    data[2] = box.width * transform.scaleX / 320;
+    data[3] = box.height * transform.scaleY / 320;
+    data[4] = 0.9f;
+    data[5] = 0.9f;
+
+    DetectionDecoder decoder;
+    const Detections& detections = decoder.decode({output}, transform);
+    ASSERT_EQ(detections.size(), 1u);
+    EXPECT_NEAR(detections.x[0], box.x, 0.5);
+    EXPECT_NEAR(detections.y[0], box.y, 0.5);
+    EXPECT_NEAR(detections.width[0], box.width, 0.5);
+    EXPECT_NEAR(detections.height[0], box.height, 0.5);
+}
+
+/**
+ * @brief Test suite for the fused preprocessing pass.
+ */
+TEST(PreprocessorTest, FusedMatchesSeparatePath) {
+    cv::Mat frame(480, 640, CV_8UC3);
+    cv::RNG rng(7);
+    rng.fill(frame, cv::RNG::UNIFORM, 0, 256);
+    cv::GaussianBlur(frame, frame, cv::Size(9, 9), 0);  // Natural-ish content.
+
+    Preprocessor separate(416);
+    PreprocessOptions options;
+    options.fused = false;
+    separate.setOptions(options);
+    LetterboxTransform expectedTransform;
+    const cv::Mat expected = separate.blobFromFrame(frame, expectedTransform).clone();
+
+    Preprocessor fused(416);
+    LetterboxTransform transform;
+    const cv::Mat& blob = fused.blobFromFrame(frame, transform);
+    ASSERT_EQ(blob.size[1], 3);
+    EXPECT_FLOAT_EQ(transform.scaleX, expectedTransform.scaleX);
+    EXPECT_FLOAT_EQ(transform.padY, expectedTransform.padY);
+    // Fixed-point vs float bilinear weights differ by at most a grey level.
+    EXPECT_LE(cv::norm(blob, expected, cv::NORM_INF), 2.0 / 255);
+}
+
+TEST(PreprocessorTest, FusedBlurMatchesGaussianBlur) {
+    cv::Mat frame(416, 416, CV_8UC3);  // Same size: the resize is a copy.
+    cv::RNG rng(11);
+    rng.fill(frame, cv::RNG::UNIFORM, 0, 256);
+
+    Preprocessor preprocessor(416);
+    PreprocessOptions options;
+    options.gaussianBlur = true;
+    preprocessor.setOptions(options);
+    LetterboxTransform transform;
+    const cv::Mat& blob = preprocessor.blobFromFrame(frame, transform);
+
+    cv::Mat blurred;
+    cv::GaussianBlur(frame, blurred, cv::Size(5, 5), 0);
+    const cv::Mat expected = cv::dnn::blobFromImage(blurred, 1/255.0, cv::Size(),
+                                                    cv::Scalar(), true, false);
+    EXPECT_LE(cv::norm(blob, expected, cv::NORM_INF), 1.0 / 255 + 1e-6);
+}
+
+TEST(PreprocessorTest, FusedBatchMatchesSingleFrames) {
+    std::vector<cv::Mat> frames = {cv::Mat(480, 640, CV_8UC3, cv::Scalar(10, 20, 30)),
+                                   cv::Mat(720, 1280, CV_8UC3, cv::Scalar(200, 100, 0))};
+    Preprocessor preprocessor(320);
+    std::vector<LetterboxTransform> transforms;
+    const cv::Mat batch = preprocessor.blobFromFrames(frames, transforms).clone();
+    ASSERT_EQ(batch.size[0], 2);
+    for (int n = 0; n < 2; ++n) {
+        LetterboxTransform transform;
+        const cv::Mat& single = preprocessor.blobFromFrame(frames[n], transform);
+        EXPECT_EQ(std::memcmp(batch.ptr<float>(n), single.ptr<float>(0),
+                              3 * 320 * 320 * sizeof(float)), 0);
+        EXPECT_FLOAT_EQ(transforms[n].padY, transform.padY);
+    }
+}
+
+/**
+ * @brief Writes @p count solid frames named frame_NN.png into a new directory.
+ *
+ * Frame n is filled with the grey level 10 * n so sets can be checked.
+ */
+static std::string writeImageDirectory(int count, std::vector<std::string>& files) {
+    char pattern[] = "/tmp/capture_test_XXXXXX";
+    const std::string dir = mkdtemp(pattern);
+    for (int n = 0; n < count; ++n) {
+        char name[32];
+        snprintf(name, sizeof(name), "/frame_%02d.png", n);
+        files.push_back(dir + name);
+        cv::imwrite(files.back(), cv::Mat(48, 64, CV_8UC3, cv::Scalar::all(10 * n)));
+    }
+    return dir;
+}
+
+/**
+ * @brief Test suite for the multi-source CaptureManager.
+ */
+TEST(CaptureManagerTest, ParsesSourceSpecs) {
+    EXPECT_EQ(SourceSpec::parse("2").kind, SourceKind::Device);
+    EXPECT_EQ(SourceSpec::parse("2").device, 2);
+    EXPECT_EQ(SourceSpec::parse("/tmp").kind, SourceKind::ImageDirectory);
+    EXPECT_EQ(SourceSpec::parse("clip.mp4").kind, SourceKind::Video);
+    EXPECT_THROW(CaptureManager({}), std::invalid_argument);
+}
+
+TEST(CaptureManagerTest, SynchronisesFileSourcesAndSurvivesFailure) {
+    std::vector<std::string> files;
+    const std::string left = writeImageDirectory(5, files);
+    const std::string right = writeImageDirectory(5, files);
+
+    CaptureConfig config;
+    config.sync = SyncMode::Index;
+    config.dropOldest = false;
+    config.maxReopenAttempts = 1;
+    config.reopenDelay = std::chrono::milliseconds(5);
+    CaptureManager capture({SourceSpec::parse(left), SourceSpec::parse(right),
+                            SourceSpec::parse("/nonexistent/clip.avi")},
+                           config);
+    capture.start();
+
+    FrameSet set;
+    int sets = 0;
+    while (capture.nextSet(set, std::chrono::milliseconds(2000))) {
+        ASSERT_EQ(set.frames.size(), 3u);
+        ASSERT_FALSE(set.frames[0].image.empty());
+        ASSERT_FALSE(set.frames[1].image.empty());
+        EXPECT_TRUE(set.frames[2].image.empty());
+        EXPECT_FALSE(set.complete());
+        EXPECT_EQ(set.frames[0].index, set.frames[1].index);
+        EXPECT_EQ(set.frames[0].image.at<cv::Vec3b>(0, 0)[0], 10 * sets);
+        EXPECT_EQ(set.frames[1].image.at<cv::Vec3b>(0, 0)[0], 10 * sets);
+        EXPECT_EQ(set.sequence, static_cast<uint64_t>(sets));
+        ++sets;
+    }
+    EXPECT_EQ(sets, 5);
+    EXPECT_TRUE(capture.finished());
+    EXPECT_EQ(capture.state(0), SourceState::Finished);
+    EXPECT_EQ(capture.state(2), SourceState::Failed);
+    EXPECT_FALSE(capture.lastError(2).empty());
+    capture.stop();
+
+    for (const std::string& file : files) {
+        std::remove(file.c_str());
+    }
+    rmdir(left.c_str());
+    rmdir(right.c_str());
+}
+
+TEST(CaptureManagerTest, TimestampModeMatchesWithinTolerance) {
+    std::vector<std::string> files;
+    const std::string dir = writeImageDirectory(3, files);
+    CaptureConfig config;
+    config.dropOldest = false;
+    config.tolerance = std::chrono::milliseconds(1000);
+    CaptureManager capture({SourceSpec::parse(dir), SourceSpec::parse(dir)}, config);
+    capture.start();
+
+    FrameSet set;
+    ASSERT_TRUE(capture.nextSet(set, std::chrono::milliseconds(2000)));
+    ASSERT_TRUE(set.complete());
+    for (const TimedFrame& frame : set.frames) {
+        const auto offset = frame.timestamp > set.timestamp
+                                ? frame.timestamp - set.timestamp
+                                : set.timestamp - frame.timestamp;
+        EXPECT_LE(offset, config.tolerance);
+    }
+    capture.stop();
+
+    for (const std::string& file : files) {
+        std::remove(file.c_str());
+    }
+    rmdir(dir.c_str());
+}
+
+TEST(CaptureManagerTest, DecodesIntoPerSourcePools) {
+    std::vector<std::string> files;
+    const std::string dir = writeImageDirectory(20, files);
+    CaptureConfig config;
+    config.sync = SyncMode::Index;
+    config.dropOldest = false;
+    config.bufferDepth = 2;
+    CaptureManager capture({SourceSpec::parse(dir)}, config);
+    capture.start(1);  // One frame is kept besides the last set.
+
+    FrameSet set;
+    TimedFrame kept;
+    std::set<const uchar*> buffers;
+    int sets = 0;
+    while (capture.nextSet(set, std::chrono::milliseconds(2000))) {
+        const TimedFrame& frame = set.frames[0];
+        ASSERT_TRUE(frame.buffer);
+        EXPECT_EQ(frame.image.data, frame.buffer.image().data);
+        EXPECT_EQ(frame.image.at<cv::Vec3b>(0, 0)[0], 10 * sets);
+        buffers.insert(frame.image.data);
+        if (sets == 5) {
+            kept = frame;
+        }
+        ++sets;
+    }
+    EXPECT_EQ(sets, 20);
+    // Buffers are recycled, and a frame still held is never reused.
+    EXPECT_LE(buffers.size(), config.bufferDepth + 3);
+    EXPECT_EQ(kept.image.at<cv::Vec3b>(0, 0)[0], 50);
+    capture.stop();
+
+    for (const std::string& file : files) {
+        std::remove(file.c_str());
+    }
+    rmdir(dir.c_str());
+}
+
+/**
+ * @brief Test suite for the frame buffer pool.
+ */
+TEST(FramePoolTest, RecyclesWhenLastHandleIsReleased) {
+    FramePool pool(2, cv::Size(64, 48));
+    FrameHandle first = pool.acquire();
+    ASSERT_TRUE(first);
+    EXPECT_EQ(first.image().size(), cv::Size(64, 48));
+    const uchar* pixels = first.image().data;
+
+    FrameHandle shared = first;  // No copy of the pixels.
+    EXPECT_EQ(first.useCount(), 2);
+    EXPECT_EQ(shared.image().data, pixels);
+    EXPECT_EQ(pool.available(), 1u);
+
+    first.reset();
+    EXPECT_EQ(pool.available(), 1u);  // Still referenced by shared.
+    shared = FrameHandle();
+    EXPECT_EQ(pool.available(), 2u);
+
+    FrameHandle again = pool.acquire();
+    EXPECT_EQ(again.image().data, pixels);  // Most recently freed buffer.
+}
+
+TEST(FramePoolTest, ExhaustedPoolTimesOutAndWakesOnRelease) {
+    FramePool pool(1);
+    FrameHandle held = pool.acquire();
+    ASSERT_TRUE(held);
+    EXPECT_FALSE(pool.acquire(std::chrono::milliseconds(5)));
+    EXPECT_EQ(pool.exhausted(), 1u);
+
+    std::thread releaser([&held] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        held.reset();
+    });
+    EXPECT_TRUE(pool.acquire(std::chrono::milliseconds(2000)));
+    releaser.join();
+}
+
+TEST(FramePoolTest, HandOffDoesNotAllocate) {
+    FramePool pool(3, cv::Size(1920, 1080));
+    FrameHandle warmUp = pool.acquire();
+    warmUp.reset();
+
+    const size_t before = g_allocations.load();
+    for (int i = 0; i < 100; ++i) {
+        FrameHandle frame = pool.acquire();
+        frame.image().at<cv::Vec3b>(0, 0)[0] = static_cast<uchar>(i);
+        FrameHandle consumer = frame;
+        frame.reset();
+        EXPECT_EQ(consumer.image().at<cv::Vec3b>(0, 0)[0], static_cast<uchar>(i));
+    }
+    EXPECT_EQ(g_allocations.load(), before);
+}
+
+/**
+ * @brief Test suite for the batched WorldProjector.
+ */
+TEST(WorldProjectorTest, MatchesPerPointWorldPoints) {
+    CoordToWorld world;
+    WorldProjector projector(world.projection());
+    std::vector<double> pixels;
+    for (int i = 0; i < 257; ++i) {
+        pixels.push_back(3.0 * i);
+        pixels.push_back(480.0 - 1.5 * i);
+    }
+    const std::vector<double> expected = world.worldPoints(world.transMat(), pixels);
+    std::vector<double> actual;
+    projector.project(pixels, actual);
+    ASSERT_EQ(actual.size(), expected.size());
+    for (size_t i = 0; i < actual.size(); ++i) {
+        EXPECT_NEAR(actual[i], expected[i], 1e-4 * (1.0 + std::abs(expected[i])));
+    }
+}
+
+TEST(WorldProjectorTest, ReusesOutputBuffers) {
+    CoordToWorld world;
+    WorldProjector projector(world.projection());
+    std::vector<double> pixels(2 * 100, 10.0);
+    std::vector<double> output;
+    projector.project(pixels, output);  // Sizes the buffers.
+
+    const size_t before = g_allocations.load();
+    for (int i = 0; i < 10; ++i) {
+        projector.project(pixels, output);
+    }
+    pixels.resize(2 * 50);
+    projector.project(pixels, output);
+    EXPECT_EQ(g_allocations.load(), before);
+    EXPECT_EQ(output.size(), 150u);
+}
+
+/**
+ * @brief Test suite for the SORT-style tracker.
+ */
+TEST(TrackerTest, AssignmentIsOptimal) {
+    // Greedy would pair row 0 with column 0 (cost 1) and pay 10 for row 1.
+    const std::vector<double> cost = {1, 2,
+                                      2, 10};
+    const std::vector<int> assignment = solveAssignment(cost, 2, 2);
+    EXPECT_EQ(assignment[0], 1);
+    EXPECT_EQ(assignment[1], 0);
+
+    // More rows than columns leaves the most expensive row unassigned.
+    const std::vector<int> tall = solveAssignment({5, 1, 3}, 3, 1);
+    EXPECT_EQ(tall[0], -1);
+    EXPECT_EQ(tall[1], 0);
+    EXPECT_EQ(tall[2], -1);
+}
+
+TEST(TrackerTest, KeepsIdsAndPredictsBetweenDetections) {
+    MultiObjectTracker tracker;
+    const int detectEvery = 3;
+    int leftId = 0;
+    int rightId = 0;
+    for (int frame = 0; frame < 30; ++frame) {
+        const float leftX = 10.0f + 4.0f * frame;
+        const float rightX = 400.0f - 5.0f * frame;
+        const std::vector<Track>* tracks;
+        if (frame % detectEvery == 0) {
+            Detections detections;
+            detections.push(leftX, 50, 40, 80, 0.9f, 0);
+            detections.push(rightX, 60, 40, 80, 0.8f, 0);
+            tracks = &tracker.update(detections);
+        } else {
+            tracks = &tracker.predict();
+        }
+        if (frame < 2 * detectEvery) {
+            continue;  // Not confirmed yet.
+        }
+        ASSERT_EQ(tracks->size(), 2u);
+        for (const Track& track : *tracks) {
+            const bool left = track.velocity.x > 0;
+            int& id = left ? leftId : rightId;
+            if (id == 0) {
+                id = track.id;
+            }
+            EXPECT_EQ(track.id, id);
+            if (frame > 12) {
+                // Predicted frames follow the motion, not the last detection.
+                EXPECT_NEAR(track.box.x, left ? leftX : rightX, 2.0);
+                EXPECT_NEAR(track.velocity.x, left ? 4.0 : -5.0, 0.5);
+            }
+        }
+    }
+    EXPECT_NE(leftId, rightId);
+}
+
+TEST(TrackerTest, RetiresUnmatchedTracks) {
+    TrackerConfig config;
+    config.minHits = 1;
+    config.maxMisses = 1;
+    MultiObjectTracker tracker(config);
+    Detections detections;
+    detections.push(100, 100, 50, 100, 0.9f, 0);
+    ASSERT_EQ(tracker.update(detections).size(), 1u);
+    const int id = tracker.tracks()[0].id;
+
+    const Detections none;
+    EXPECT_TRUE(tracker.update(none).empty());  // Missed once: hidden.
+    EXPECT_TRUE(tracker.update(none).empty());  // Missed twice: retired.
+    ASSERT_EQ(tracker.update(detections).size(), 1u);
+    EXPECT_NE(tracker.tracks()[0].id, id);  // A new track, a new id.
+}
+
+TEST(MotionGateTest, SkipsStaticFramesAfterTheFirst) {
+    MotionGateConfig config;
+    config.refreshEvery = 0;
+    MotionGate gate(config);
+    cv::Mat frame(480, 640, CV_8UC3, cv::Scalar(40, 80, 120));
+    EXPECT_TRUE(gate.evaluate(frame).run);  // No reference yet.
+    for (int i = 0; i < 5; ++i) {
+        EXPECT_FALSE(gate.evaluate(frame).run);
+    }
+    const GateStats stats = gate.stats();
+    EXPECT_EQ(stats.hits, 1u);
+    EXPECT_EQ(stats.skips, 5u);
+    EXPECT_EQ(stats.cropped, 0u);
+}
+
+TEST(MotionGateTest, CropsToTheMovingRegion) {
+    MotionGateConfig config;
+    config.refreshEvery = 0;
+    MotionGate gate(config);
+    cv::Mat frame(480, 640, CV_8UC3, cv::Scalar::all(0));
+    gate.evaluate(frame);
+
+    const cv::Rect square(300, 200, 60, 60);
+    frame(square).setTo(cv::Scalar::all(255));
+    GateDecision decision = gate.evaluate(frame);
+    ASSERT_TRUE(decision.run);
+    EXPECT_EQ(decision.roi & square, square);
+    EXPECT_LT(decision.roi.area(), frame.total() / 4);
+
+    // A track region elsewhere is covered too.
+    frame.setTo(cv::Scalar::all(0));
+    const cv::Rect track(20, 20, 40, 80);
+    decision = gate.evaluate(frame, {track});
+    ASSERT_TRUE(decision.run);
+    EXPECT_EQ(decision.roi & track, track);
+    EXPECT_EQ(decision.roi & square, square);
+    EXPECT_EQ(gate.stats().cropped, 2u);
+}
+
+TEST(DetectionDecoderTest, DecodesOnnxExportLayouts) {
+    // The same box in every layout: centre (320, 240), 64 x 128 pixels on a
+    // 640 x 640 input, class 2.
+    const int rows = 4;
+    const int v5Size[] = {1, rows, 85};
+    cv::Mat v5(3, v5Size, CV_32F, cv::Scalar(0));
+    float* row = v5.ptr<float>() + 85;  // Anchor 1.
+    row[0] = 320; row[1] = 240; row[2] = 64; row[3] = 128;
+    row[4] = 0.9f;      // Objectness
+    row[5 + 2] = 0.8f;  // Class score, not yet times objectness.
+
+    const int v8Size[] = {1, 84, rows};
+    cv::Mat v8(3, v8Size, CV_32F, cv::Scalar(0));
+    float* data = v8.ptr<float>();
+    const float values[] = {320, 240, 64, 128};
+    for (int k = 0; k < 4; ++k) {
+        data[k * rows + 1] = values[k];
+    }
+    data[(4 + 2) * rows + 1] = 0.8f;
+
+    DetectionDecoder decoder;
+    decoder.setLayout(OutputLayout::YoloV5);
+    const Detections& fromV5 = decoder.decode({v5}, cv::Size(640, 640));
+    ASSERT_EQ(fromV5.size(), 1u);
+    EXPECT_NEAR(fromV5.scores[0], 0.72f, 1e-5);
+    EXPECT_EQ(fromV5.classIds[0], 2);
+    EXPECT_NEAR(fromV5.x[0], 288.0f, 1e-3);
+    EXPECT_NEAR(fromV5.height[0], 128.0f, 1e-3);
+
+    decoder.setLayout(OutputLayout::YoloV8);
+    const Detections& fromV8 = decoder.decode({v8}, cv::Size(640, 640));
+    ASSERT_EQ(fromV8.size(), 1u);
+    EXPECT_NEAR(fromV8.scores[0], 0.8f, 1e-5);
+    EXPECT_EQ(fromV8.classIds[0], 2);
+    EXPECT_NEAR(fromV8.y[0], 176.0f, 1e-3);
+    EXPECT_NEAR(fromV8.width[0], 64.0f, 1e-3);
+}
+
+/**
+ * @brief Test suite for detector backend selection.
+ */
+TEST(BackendConfigTest, PresetsAndConfigFiles) {
+    const BackendConfig tiny = BackendConfig::preset("yolov3-tiny");
+    EXPECT_EQ(tiny.model, "yolov3-tiny.weights");
+    EXPECT_FALSE(tiny.isOnnx());
+    EXPECT_EQ(tiny.inputSize, 0);
+    const BackendConfig v8 = BackendConfig::preset("yolov8n");
+    EXPECT_TRUE(v8.isOnnx());
+    EXPECT_EQ(v8.layout, OutputLayout::YoloV8);
+    EXPECT_EQ(v8.inputSize, 640);
+    EXPECT_THROW(BackendConfig::preset("yolov9"), std::invalid_argument);
+    EXPECT_EQ(parsePrecision("int8"), Precision::INT8);
+    EXPECT_THROW(parsePrecision("int4"), std::invalid_argument);
+
+    char path[] = "/tmp/backendXXXXXX.yml";
+    const int fd = mkstemps(path, 4);
+    ASSERT_GE(fd, 0);
+    close(fd);
+    {
+        std::ofstream file(path);
+        file << "%YAML:1.0\n---\npreset: yolov5s\nprecision: int8\n"
+                "input_size: 320\ncalibration: \"calib/\"\n";
+    }
+    const BackendConfig loaded = BackendConfig::load(path);
+    EXPECT_EQ(loaded.model, "yolov5s.onnx");
+    EXPECT_EQ(loaded.layout, OutputLayout::YoloV5);
+    EXPECT_EQ(loaded.precision, Precision::INT8);
+    EXPECT_EQ(loaded.inputSize, 320);
+    EXPECT_EQ(loaded.calibration, "calib/");
+    {
+        std::ofstream file(path);
+        file << "%YAML:1.0\n---\nlayout: yolov7\n";
+    }
+    EXPECT_THROW(BackendConfig::load(path), std::runtime_error);
+    unlink(path);
+}
+
+/**
+ * @brief Backend that sleeps, records its concurrency and reports one box
+ *        per blob image whose width encodes that image's first value.
+ */
+class SleepyBackend : public DetectorBackend {
+ public:
+    static std::atomic<int> active;
+    static std::atomic<int> peak;
+    static std::atomic<int> passes;
+
+    void forward(const cv::Mat& blob, std::vector<cv::Mat>& outputs) override {
+        ++passes;
+        const int now = ++active;
+        int seen = peak.load();
+        while (now > seen && !peak.compare_exchange_weak(seen, now)) {
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        // Reuses the outputs like a real backend, so that callers can count
+        // their own allocations.
+        const int batch = blob.size[0];
+        outputs.resize(1);
+        outputs[0].create(batch, 85, CV_32F);
+        for (int n = 0; n < batch; ++n) {
+            float* row = outputs[0].ptr<float>(n);
+            std::fill(row, row + 85, 0.0f);
+            row[0] = 0.5f;
+            row[1] = 0.5f;
+            row[2] = 0.1f + blob.ptr<float>(n)[0];  // Frame value / 255.
+            row[3] = 0.2f;
+            row[4] = 0.9f;
+            row[5] = 0.9f;
+        }
+        --active;
+    }
+
+    std::string describe() const override { return "sleepy"; }
+};
+std::atomic<int> SleepyBackend::active{0};
+std::atomic<int> SleepyBackend::peak{0};
+std::atomic<int> SleepyBackend::passes{0};
+
+/**
+ * @brief Test suite for the AsyncDetector.
+ */
+TEST(AsyncDetectorTest, RunsInstancesInParallel) {
+    registerBackend("sleepy", [](const BackendConfig&, const std::vector<cv::Mat>&) {
+        return std::unique_ptr<DetectorBackend>(new SleepyBackend());
+    });
+    BackendConfig config;
+    config.engine = "sleepy";
+    YOLO prototype(config);
+    AsyncConfig async;
+    async.instances = 3;
+    async.threadsPerInstance = 0;
+    async.warmUp = false;  // Only requests may overlap.
+    AsyncDetector detector(prototype, async);
+    ASSERT_EQ(detector.instances(), 3u);
+
+    std::vector<std::future<Detections>> results;
+    for (int i = 0; i < 6; ++i) {
+        const cv::Mat frame(416, 416, CV_8UC3, cv::Scalar::all(40 * i));
+        results.push_back(detector.submit(frame));
+    }
+    for (int i = 0; i < 6; ++i) {
+        const Detections detections = results[i].get();
+        ASSERT_EQ(detections.size(), 1u);
+        EXPECT_NEAR(detections.width[0], (0.1f + 40 * i / 255.0f) * 416, 1.0f);
+    }
+    EXPECT_GE(SleepyBackend::peak.load(), 2);
+
+    detector.shutdown();
+    EXPECT_THROW(detector.submit(cv::Mat(416, 416, CV_8UC3)), std::runtime_error);
+}
+
+TEST(AsyncDetectorTest, ForwardsNMSConfigAndWarmSizes) {
+    registerBackend("sleepy", [](const BackendConfig&, const std::vector<cv::Mat>&) {
+        return std::unique_ptr<DetectorBackend>(new SleepyBackend());
+    });
+    BackendConfig config;
+    config.engine = "sleepy";
+    YOLO prototype(config);
+    // Not applied by the prototype yet, but copied to the other instances.
+    NMSConfig strict = prototype.nmsConfig();
+    strict.scoreThreshold = 0.95f;  // The fake box scores 0.9 x 0.9.
+    prototype.setNMSConfig(strict);
+    EXPECT_FLOAT_EQ(prototype.nmsConfig().scoreThreshold, 0.95f);
+
+    SleepyBackend::passes = 0;
+    AsyncConfig async;
+    async.instances = 2;
+    async.threadsPerInstance = 0;
+    async.warmSizes = {320, 416};
+    {
+        AsyncDetector detector(prototype, async);
+        const cv::Mat frame(416, 416, CV_8UC3, cv::Scalar::all(40));
+        std::vector<std::future<Detections>> results;
+        for (int i = 0; i < 4; ++i) {
+            results.push_back(detector.submit(frame));
+        }
+        for (auto& result : results) {
+            EXPECT_EQ(result.get().size(), 0u);
+        }
+
+        NMSConfig loose = strict;
+        loose.scoreThreshold = 0.5f;
+        detector.setNMSConfig(loose);
+        results.clear();
+        for (int i = 0; i < 4; ++i) {
+            results.push_back(detector.submit(frame));
+        }
+        for (auto& result : results) {
+            EXPECT_EQ(result.get().size(), 1u);
+        }
+    }
+    // The second instance warmed up at 320 and at its own 416.
+    EXPECT_EQ(SleepyBackend::passes.load(), 8 + 2);
+}
+
+/**
+ * @brief Test suite for YOLO on the fake backend.
+ */
+TEST(YOLOTest, InferAndPostprocessDoNotAllocateAfterWarmUp) {
+    registerBackend("sleepy", [](const BackendConfig&, const std::vector<cv::Mat>&) {
+        return std::unique_ptr<DetectorBackend>(new SleepyBackend());
+    });
+    BackendConfig config;
+    config.engine = "sleepy";
+    YOLO yolo(config);
+    PostprocessOptions quiet;
+    quiet.print = false;
+    quiet.annotate = false;
+    yolo.setPostprocessOptions(quiet);
+    // A single stripe letterboxes inline instead of on OpenCV's pool, whose
+    // task bookkeeping is not ours to count.
+    const int threads = cv::getNumThreads();
+    cv::setNumThreads(1);
+
+    const cv::Mat frame(480, 640, CV_8UC3, cv::Scalar::all(40));
+    std::vector<double> pixelCoords;
+    for (int i = 0; i < 3; ++i) {  // Warm-up sizes the blob and workspaces.
+        yolo.postprocess(yolo.infer(frame), frame, pixelCoords);
+    }
+    const size_t before = g_allocations.load();
+    for (int i = 0; i < 5; ++i) {
+        yolo.postprocess(yolo.infer(frame), frame, pixelCoords);
+    }
+    const size_t allocations = g_allocations.load() - before;
+    cv::setNumThreads(threads);
+    EXPECT_EQ(pixelCoords.size(), 2u);
+    EXPECT_EQ(allocations, 0u);
+}
+
+TEST(YOLOTest, AppliesNMSConfigBetweenFrames) {
+    registerBackend("sleepy", [](const BackendConfig&, const std::vector<cv::Mat>&) {
+        return std::unique_ptr<DetectorBackend>(new SleepyBackend());
+    });
+    BackendConfig config;
+    config.engine = "sleepy";
+    YOLO yolo(config);
+    const cv::Mat frame(416, 416, CV_8UC3, cv::Scalar::all(40));
+    ASSERT_EQ(yolo.infer(frame).size(), 1u);
+
+    NMSConfig nms = yolo.nmsConfig();
+    nms.scoreThreshold = 0.95f;  // The fake box scores 0.9 x 0.9.
+    yolo.setNMSConfig(nms);
+    EXPECT_EQ(yolo.infer(frame).size(), 0u);
+    EXPECT_FLOAT_EQ(yolo.nmsConfig().scoreThreshold, 0.95f);
+
+    nms.scoreThreshold = 0.5f;
+    yolo.setNMSConfig(nms);
+    const Detections& detections = yolo.infer(frame);
+    ASSERT_EQ(detections.size(), 1u);
+    EXPECT_NEAR(detections.scores[0], 0.81f, 1e-4f);
+
+    // Reconfiguring the decoder keeps settings queued before it.
+    nms.scoreThreshold = 0.95f;
+    yolo.setNMSConfig(nms);
+    const DecoderConfig decoding = yolo.decoderConfig();
+    EXPECT_FLOAT_EQ(decoding.nms.scoreThreshold, 0.5f);
+    yolo.setDecoderConfig(decoding);
+    EXPECT_FLOAT_EQ(yolo.nmsConfig().scoreThreshold, 0.95f);
+    EXPECT_EQ(yolo.infer(frame).size(), 0u);
+}
+
+/**
+ * @brief Backend that emits two rows per blob image, the first a box whose
+ *        width encodes that image's centre value, in the 2D N*rows x cols
+ *        layout of OpenCV's region layer or the 3D N x rows x cols one.
+ */
+class BatchBackend : public DetectorBackend {
+ public:
+    static bool threeDimensional;
+    static int passes;
+    static int largestBatch;
+
+    void forward(const cv::Mat& blob, std::vector<cv::Mat>& outputs) override {
+        const int batch = blob.size[0];
+        const int side = blob.size[2];
+        ++passes;
+        largestBatch = std::max(largestBatch, batch);
+        outputs.resize(1);
+        if (threeDimensional) {
+            const int shape[] = {batch, 2, 85};
+            outputs[0].create(3, shape, CV_32F);
+        } else {
+            outputs[0].create(2 * batch, 85, CV_32F);
+        }
+        float* rows = outputs[0].ptr<float>();
+        std::fill(rows, rows + 2 * batch * 85, 0.0f);
+        for (int n = 0; n < batch; ++n) {
+            const float* image = blob.ptr<float>(n);
+            float* row = rows + 2 * n * 85;
+            row[0] = 0.5f;
+            row[1] = 0.5f;
+            row[2] = 0.1f + image[(side / 2) * side + side / 2];
+            row[3] = 0.2f;
+            row[4] = 0.9f;
+            row[5] = 0.9f;
+        }
+    }
+
+    std::string describe() const override { return "batch"; }
+};
+bool BatchBackend::threeDimensional = false;
+int BatchBackend::passes = 0;
+int BatchBackend::largestBatch = 0;
+
+/**
+ * @brief Creates a quiet YOLO on the batch backend.
+ */
+static std::unique_ptr<YOLO> makeBatchYolo(int inputSize) {
+    registerBackend("batch", [](const BackendConfig&, const std::vector<cv::Mat>&) {
+        return std::unique_ptr<DetectorBackend>(new BatchBackend());
+    });
+    BackendConfig config;
+    config.engine = "batch";
+    config.inputSize = inputSize;
+    std::unique_ptr<YOLO> yolo(new YOLO(config));
+    PostprocessOptions quiet;
+    quiet.print = false;
+    quiet.annotate = false;
+    yolo->setPostprocessOptions(quiet);
+    return yolo;
+}
+
+TEST(YOLOTest, DetectBatchSplitsOutputsPerFrame) {
+    std::unique_ptr<YOLO> yolo = makeBatchYolo(0);
+    // Different shapes and grey levels: every frame has its own letterbox
+    // and its own box width.
+    const std::vector<cv::Mat> frames = {
+        cv::Mat(480, 640, CV_8UC3, cv::Scalar::all(40)),
+        cv::Mat(640, 480, CV_8UC3, cv::Scalar::all(120)),
+        cv::Mat(300, 300, CV_8UC3, cv::Scalar::all(200))};
+    for (bool threeDimensional : {false, true}) {
+        BatchBackend::threeDimensional = threeDimensional;
+        BatchBackend::passes = 0;
+        const std::vector<std::vector<double>> batched = yolo->detectBatch(frames);
+        EXPECT_EQ(BatchBackend::passes, 1);
+        ASSERT_EQ(batched.size(), frames.size());
+        for (size_t n = 0; n < frames.size(); ++n) {
+            // A single-frame pass maps the box through the same letterbox.
+            const std::vector<double> alone = yolo->detect(frames[n]);
+            ASSERT_EQ(alone.size(), 2u);
+            ASSERT_EQ(batched[n].size(), 2u);
+            EXPECT_DOUBLE_EQ(batched[n][0], alone[0]);
+            EXPECT_DOUBLE_EQ(batched[n][1], alone[1]);
+        }
+        EXPECT_NE(batched[0][0], batched[1][0]);
+        EXPECT_NE(batched[1][0], batched[2][0]);
+    }
+}
+
+TEST(YOLOTest, DetectBatchRunsFramesOneByOneAtAFixedInputSize) {
+    std::unique_ptr<YOLO> yolo = makeBatchYolo(416);
+    ASSERT_TRUE(yolo->fixedInputSize());
+    BatchBackend::threeDimensional = false;
+    BatchBackend::passes = 0;
+    BatchBackend::largestBatch = 0;
+    const std::vector<cv::Mat> frames(3, cv::Mat(480, 640, CV_8UC3,
+                                                 cv::Scalar::all(40)));
+    const std::vector<std::vector<double>> results = yolo->detectBatch(frames);
+    ASSERT_EQ(results.size(), 3u);
+    for (const std::vector<double>& coordinates : results) {
+        EXPECT_EQ(coordinates.size(), 2u);
+    }
+    EXPECT_EQ(BatchBackend::passes, 3);
+    EXPECT_EQ(BatchBackend::largestBatch, 1);
+}
+
+/**
+ * @brief Returns the value of one series in a Prometheus dump of @p metrics,
+ *        -1 if it is missing.
+ */
+static double metricValue(const Metrics& metrics, const std::string& series) {
+    std::istringstream lines(metrics.prometheus());
+    std::string line;
+    while (std::getline(lines, line)) {
+        if (line.compare(0, series.size() + 1, series + " ") == 0) {
+            return std::stod(line.substr(series.size() + 1));
+        }
+    }
+    return -1.0;
+}
+
+/**
+ * @brief Image-directory capture, sleepy detector and quiet output for
+ *        pipeline tests.
+ */
+struct PipelineFixture {
+    explicit PipelineFixture(int frames)
+        : directory(writeImageDirectory(frames, files)) {
+        registerBackend("sleepy", [](const BackendConfig&, const std::vector<cv::Mat>&) {
+            return std::unique_ptr<DetectorBackend>(new SleepyBackend());
+        });
+        BackendConfig backend;
+        backend.engine = "sleepy";
+        yolo.reset(new YOLO(backend));
+        PostprocessOptions quiet;
+        quiet.print = false;
+        quiet.annotate = false;
+        yolo->setPostprocessOptions(quiet);
+        capture.sync = SyncMode::Index;
+        capture.dropOldest = false;  // Files: only the pipeline may drop.
+        capture.bufferDepth = 2;
+        config.log = nullptr;
+        config.metrics = &metrics;
+        SleepyBackend::passes = 0;
+    }
+
+    ~PipelineFixture() {
+        for (const std::string& file : files) {
+            std::remove(file.c_str());
+        }
+        rmdir(directory.c_str());
+    }
+
+    /**
+     * @brief Runs the pipeline to the end and returns the output sequences.
+     */
+    std::vector<uint64_t> run(Pipeline& pipeline) {
+        std::vector<uint64_t> sequences;
+        pipeline.run([this, &sequences](FrameTask& task) {
+            sequences.push_back(task.sequence);
+            detections.push_back(task.pixelCoords.size() / 2);
+            EXPECT_EQ(task.worldCoords.size(), 3 * task.pixelCoords.size() / 2);
+            return true;
+        });
+        return sequences;
+    }
+
+    std::vector<std::string> files;
+    std::string directory;          ///< The frames, 10 grey levels apart.
+    std::unique_ptr<YOLO> yolo;
+    OpenCVProcessor processor;
+    CoordToWorld world;
+    Metrics metrics;
+    CaptureConfig capture;
+    PipelineConfig config;
+    std::vector<size_t> detections;  ///< Detections per output frame.
+};
+
+/**
+ * @brief Test suite for the staged Pipeline on an image directory.
+ */
+TEST(PipelineTest, DropsOldestFramesAndKeepsOrder) {
+    const int count = 30;
+    PipelineFixture fixture(count);
+    fixture.config.queueCapacity = 1;
+    fixture.config.overflow = OverflowPolicy::DropOldest;
+    CaptureManager capture({SourceSpec::parse(fixture.directory)}, fixture.capture);
+    Pipeline pipeline(capture, *fixture.yolo, fixture.processor, fixture.world,
+                      fixture.config);
+    const std::vector<uint64_t> sequences = fixture.run(pipeline);
+
+    // Capture outruns the 20 ms detector, so frames are dropped, but what
+    // comes out is in order and ends with the last frame once drained.
+    ASSERT_FALSE(sequences.empty());
+    EXPECT_LT(sequences.size(), static_cast<size_t>(count));
+    EXPECT_TRUE(std::is_sorted(sequences.begin(), sequences.end()));
+    EXPECT_EQ(std::adjacent_find(sequences.begin(), sequences.end()),
+              sequences.end());
+    EXPECT_EQ(sequences.back(), static_cast<uint64_t>(count - 1));
+    for (size_t found : fixture.detections) {
+        EXPECT_EQ(found, 1u);
+    }
+
+    double dropped = 0.0;
+    for (const char* queue : {"captured", "detected", "projected"}) {
+        const double value = metricValue(
+            fixture.metrics,
+            std::string("perception_frames_dropped_total{queue=\"") + queue + "\"}");
+        ASSERT_GE(value, 0.0);
+        dropped += value;
+    }
+    EXPECT_GT(dropped, 0.0);
+    EXPECT_EQ(sequences.size() + static_cast<size_t>(dropped),
+              static_cast<size_t>(count));
+
+    const std::vector<const StageStats*>& stages = pipeline.stages();
+    ASSERT_EQ(stages.size(), 4u);
+    EXPECT_EQ(stages[0]->name(), "capture");
+    EXPECT_EQ(stages[0]->frames(), static_cast<uint64_t>(count));
+    EXPECT_EQ(stages[1]->frames(), static_cast<uint64_t>(SleepyBackend::passes));
+    EXPECT_EQ(stages[3]->frames(), sequences.size());
+    const std::string report = pipeline.throughputReport();
+    EXPECT_NE(report.find("inference"), std::string::npos);
+    EXPECT_NE(report.find("dropped"), std::string::npos);
+}
+
+TEST(PipelineTest, DetectsEveryNthFrameAndAdaptsInputSize) {
+    const int count = 36;
+    PipelineFixture fixture(count);
+    fixture.config.overflow = OverflowPolicy::Block;
+    fixture.config.tracking = true;
+    fixture.config.detectEvery = 3;
+    // Every 20 ms pass is over budget, so the input steps down once the
+    // first ten detections have been averaged.
+    fixture.config.inferenceBudget = std::chrono::milliseconds(5);
+    ASSERT_EQ(fixture.yolo->inputSize(), static_cast<int>(InputMode::Balanced));
+    CaptureManager capture({SourceSpec::parse(fixture.directory)}, fixture.capture);
+    Pipeline pipeline(capture, *fixture.yolo, fixture.processor, fixture.world,
+                      fixture.config);
+    const std::vector<uint64_t> sequences = fixture.run(pipeline);
+
+    ASSERT_EQ(sequences.size(), static_cast<size_t>(count));  // Nothing dropped.
+    for (int i = 0; i < count; ++i) {
+        EXPECT_EQ(sequences[i], static_cast<uint64_t>(i));
+    }
+    EXPECT_EQ(SleepyBackend::passes.load(), count / 3);
+    EXPECT_EQ(fixture.yolo->inputSize(), static_cast<int>(InputMode::Fast));
+    // Tracks are reported once confirmed, and coast between detections.
+    EXPECT_EQ(fixture.detections.back(), 1u);
+}
+
+TEST(PipelineTest, AdaptsOnlyTowardsTheStartingInputSize) {
+    // Over budget below Fast, and under budget above Accurate: neither
+    // start size has a mode to step to.
+    const struct {
+        int size;
+        int budgetMs;
+    } cases[] = {{288, 5}, {640, 1000}};
+    for (const auto& run : cases) {
+        PipelineFixture fixture(12);
+        fixture.config.overflow = OverflowPolicy::Block;
+        fixture.config.inferenceBudget = std::chrono::milliseconds(run.budgetMs);
+        fixture.yolo->setInputSize(run.size);
+        CaptureManager capture({SourceSpec::parse(fixture.directory)},
+                               fixture.capture);
+        Pipeline pipeline(capture, *fixture.yolo, fixture.processor,
+                          fixture.world, fixture.config);
+        ASSERT_EQ(fixture.run(pipeline).size(), 12u);
+        EXPECT_EQ(fixture.yolo->inputSize(), run.size);
+    }
+}
+
+TEST(PipelineTest, MotionGateSkipsStillFrames) {
+    const int count = 12;
+    PipelineFixture fixture(count);
+    fixture.config.overflow = OverflowPolicy::Block;
+    ProcessingOptions options = fixture.processor.options();
+    options.motionGate = true;
+    options.gate.refreshEvery = 0;  // Only the first frame must run.
+    fixture.processor.setOptions(options);
+    CaptureManager capture({SourceSpec::parse(fixture.directory)}, fixture.capture);
+    Pipeline pipeline(capture, *fixture.yolo, fixture.processor, fixture.world,
+                      fixture.config);
+    const std::vector<uint64_t> sequences = fixture.run(pipeline);
+
+    // A 10 grey level step is below the gate's threshold: no motion.
+    ASSERT_EQ(sequences.size(), static_cast<size_t>(count));
+    EXPECT_EQ(SleepyBackend::passes.load(), 1);
+    for (size_t found : fixture.detections) {
+        EXPECT_EQ(found, 1u);  // Gated frames show the last detections.
+    }
+    EXPECT_EQ(metricValue(fixture.metrics,
+                          "perception_motion_gate_frames_total{outcome=\"run\"}"),
+              1.0);
+    EXPECT_EQ(metricValue(fixture.metrics,
+                          "perception_motion_gate_frames_total{outcome=\"skipped\"}"),
+              count - 1.0);
+}
+
+TEST(PipelineTest, StopFlagEndsRunWithoutOutput) {
+    PipelineFixture fixture(5);
+    const std::atomic<bool> stop(true);
+    fixture.config.stopFlag = &stop;
+    CaptureManager capture({SourceSpec::parse(fixture.directory)}, fixture.capture);
+    Pipeline pipeline(capture, *fixture.yolo, fixture.processor, fixture.world,
+                      fixture.config);
+    EXPECT_TRUE(fixture.run(pipeline).empty());
+}
+
+/**
+ * @brief Test suite for start-up helpers.
+ */
+TEST(MappedFileTest, MapsWholeFile) {
+    char path[] = "/tmp/mappedXXXXXX";
+    const int fd = mkstemp(path);
+    ASSERT_GE(fd, 0);
+    const std::string content(10000, 'x');
+    ASSERT_EQ(write(fd, content.data(), content.size()),
+              static_cast<ssize_t>(content.size()));
+    close(fd);
+    {
+        const MappedFile file(path);
+        ASSERT_EQ(file.size(), content.size());
+        EXPECT_EQ(std::string(file.data(), file.size()), content);
+    }
+    unlink(path);
+    EXPECT_THROW(MappedFile("/nonexistent/model.weights"), std::runtime_error);
+}
+
+TEST(ModelLoaderTest, LoadsInBackgroundAndReportsErrors) {
+    registerBackend("sleepy", [](const BackendConfig&, const std::vector<cv::Mat>&) {
+        return std::unique_ptr<DetectorBackend>(new SleepyBackend());
+    });
+    BackendConfig config;
+    config.engine = "sleepy";
+    std::atomic<bool> prepared{false};
+    ModelLoader loader(config, [&prepared](YOLO& yolo) {
+        yolo.warmUp();
+        prepared = true;
+    });
+    ASSERT_TRUE(loader.waitFor(std::chrono::seconds(5)));
+    EXPECT_TRUE(loader.ready());
+    std::unique_ptr<YOLO> yolo = loader.get();
+    ASSERT_NE(yolo, nullptr);
+    EXPECT_TRUE(prepared);
+    EXPECT_GE(loader.times().prepareMs, 20.0);  // One 20 ms forward pass.
+    EXPECT_EQ(loader.get(), nullptr);
+
+    config.engine = "missing";
+    ModelLoader failing(config);
+    EXPECT_THROW(failing.get(), std::invalid_argument);
+}
+
+/**
+ * @brief Test suite for the binary detection stream.
+ */
+TEST(DetectionStreamTest, RoundTripsDetectionsAndTracks) {
+    char path[] = "/tmp/detectionsXXXXXX";
+    const int fd = mkstemp(path);
+    ASSERT_GE(fd, 0);
+    close(fd);
+
+    Detections detections;
+    detections.push(10.0f, 20.0f, 30.0f, 40.0f, 0.9f, 0);
+    detections.push(50.0f, 60.0f, 70.0f, 80.0f, 0.5f, 2);
+    Track track;
+    track.id = 7;
+    track.classId = 0;
+    track.score = 0.8f;
+    track.box = cv::Rect2f(1.0f, 2.0f, 3.0f, 4.0f);
+    const auto captured = std::chrono::steady_clock::now();
+    {
+        DetectionStreamWriter writer(path);
+        std::vector<StreamRecord> records;
+        makeRecords(detections, {1.0, 2.0, 3.0}, records);
+        EXPECT_TRUE(writer.write(1, 42, captured, records));
+        makeRecords(std::vector<Track>{track}, {4.0, 5.0, 6.0}, records);
+        EXPECT_TRUE(writer.write(0, 43, captured, records));
+        EXPECT_TRUE(writer.write(0, 44, captured, {}));
+        EXPECT_EQ(writer.frames(), 3u);
+    }
+
+    DetectionStreamReader reader(path);
+    StreamFrameHeader header;
+    std::vector<StreamRecord> records;
+    ASSERT_TRUE(reader.next(header, records));
+    EXPECT_EQ(header.source, 1);
+    EXPECT_EQ(header.sequence, 42u);
+    const int64_t now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    EXPECT_NEAR(static_cast<double>(header.timestampNs),
+                static_cast<double>(now), 1e9);
+    ASSERT_EQ(records.size(), 2u);
+    EXPECT_EQ(records[0].trackId, -1);
+    EXPECT_FLOAT_EQ(records[0].x, 10.0f);
+    EXPECT_FLOAT_EQ(records[0].worldZ, 3.0f);
+    EXPECT_EQ(records[1].classId, 2);
+    EXPECT_FLOAT_EQ(records[1].height, 80.0f);
+    EXPECT_FLOAT_EQ(records[1].worldX, 0.0f);  // No world coordinates given.
+
+    ASSERT_TRUE(reader.next(header, records));
+    ASSERT_EQ(records.size(), 1u);
+    EXPECT_EQ(records[0].trackId, 7);
+    EXPECT_FLOAT_EQ(records[0].confidence, 0.8f);
+    EXPECT_FLOAT_EQ(records[0].worldY, 5.0f);
+
+    ASSERT_TRUE(reader.next(header, records));
+    EXPECT_EQ(header.sequence, 44u);
+    EXPECT_TRUE(records.empty());
+    EXPECT_FALSE(reader.next(header, records));
+    unlink(path);
+}
+
+/**
+ * @brief Test suite for the offline BatchProcessor.
+ */
+TEST(BatchProcessorTest, WritesImageDirectoryDetectionsInOrder) {
+    registerBackend("sleepy", [](const BackendConfig&, const std::vector<cv::Mat>&) {
+        return std::unique_ptr<DetectorBackend>(new SleepyBackend());
+    });
+    char images[] = "/tmp/batchinXXXXXX";
+    char results[] = "/tmp/batchoutXXXXXX";
+    ASSERT_NE(mkdtemp(images), nullptr);
+    ASSERT_NE(mkdtemp(results), nullptr);
+    const int count = 6;
+    std::vector<std::string> written;
+    for (int i = 0; i < count; ++i) {
+        written.push_back(std::string(images) + "/frame" + std::to_string(i) + ".png");
+        ASSERT_TRUE(cv::imwrite(written.back(),
+                                cv::Mat(416, 416, CV_8UC3, cv::Scalar::all(40 * i))));
+    }
+
+    BackendConfig backend;
+    backend.engine = "sleepy";
+    YOLO yolo(backend);
+    CoordToWorld world;
+    BatchConfig config;
+    config.decoders = 3;
+    config.detectors.instances = 2;
+    config.detectors.threadsPerInstance = 0;
+    config.detectors.warmUp = false;
+    config.outputDir = results;
+    config.log = nullptr;
+    BatchProcessor processor(yolo, world, config);
+    const BatchSummary summary = processor.run({SourceSpec::parse(images)});
+    EXPECT_EQ(summary.frames, static_cast<uint64_t>(count));
+    EXPECT_EQ(summary.detections, static_cast<uint64_t>(count));
+    EXPECT_EQ(summary.failedInputs, 0u);
+    ASSERT_EQ(summary.outputs.size(), 1u);
+
+    DetectionStreamReader reader(summary.outputs[0]);
+    StreamFrameHeader header;
+    std::vector<StreamRecord> records;
+    for (int i = 0; i < count; ++i) {
+        ASSERT_TRUE(reader.next(header, records));
+        EXPECT_EQ(header.sequence, static_cast<uint64_t>(i));
+        ASSERT_EQ(records.size(), 1u);
+        EXPECT_NEAR(records[0].width, (0.1f + 40 * i / 255.0f) * 416, 1.0f);
+    }
+    EXPECT_FALSE(reader.next(header, records));
+
+    EXPECT_THROW(processor.run({SourceSpec::parse("0")}), std::invalid_argument);
+    for (const std::string& path : written) {
+        unlink(path.c_str());
+    }
+    unlink(summary.outputs[0].c_str());
+    rmdir(images);
+    rmdir(results);
+}
+
+TEST(BatchProcessorTest, StepsOverUnreadableImages) {
+    registerBackend("sleepy", [](const BackendConfig&, const std::vector<cv::Mat>&) {
+        return std::unique_ptr<DetectorBackend>(new SleepyBackend());
+    });
+    char images[] = "/tmp/batchinXXXXXX";
+    char results[] = "/tmp/batchoutXXXXXX";
+    ASSERT_NE(mkdtemp(images), nullptr);
+    ASSERT_NE(mkdtemp(results), nullptr);
+    const int count = 8;
+    const std::set<int> broken = {2, 3, 6};
+    std::vector<std::string> written;
+    for (int i = 0; i < count; ++i) {
+        written.push_back(std::string(images) + "/frame" + std::to_string(i) + ".png");
+        if (broken.count(i) > 0) {
+            std::ofstream(written.back()) << "not an image";
+        } else {
+            ASSERT_TRUE(cv::imwrite(written.back(),
+                                    cv::Mat(416, 416, CV_8UC3, cv::Scalar::all(20 * i))));
+        }
+    }
+
+    BackendConfig backend;
+    backend.engine = "sleepy";
+    YOLO yolo(backend);
+    CoordToWorld world;
+    BatchConfig config;
+    config.detectors.instances = 2;
+    config.detectors.threadsPerInstance = 0;
+    config.detectors.warmUp = false;
+    config.outputDir = results;
+    config.log = nullptr;
+    for (int decoders : {1, 3}) {
+        config.decoders = decoders;
+        BatchProcessor processor(yolo, world, config);
+        const BatchSummary summary = processor.run({SourceSpec::parse(images)});
+        EXPECT_EQ(summary.frames, static_cast<uint64_t>(count - broken.size()));
+        ASSERT_EQ(summary.outputs.size(), 1u);
+
+        DetectionStreamReader reader(summary.outputs[0]);
+        StreamFrameHeader header;
+        std::vector<StreamRecord> records;
+        for (int i = 0; i < count; ++i) {
+            if (broken.count(i) > 0) {
+                continue;
+            }
+            ASSERT_TRUE(reader.next(header, records));
+            EXPECT_EQ(header.sequence, static_cast<uint64_t>(i));
+            ASSERT_EQ(records.size(), 1u);
+            EXPECT_NEAR(records[0].width, (0.1f + 20 * i / 255.0f) * 416, 1.0f);
+        }
+        EXPECT_FALSE(reader.next(header, records));
+        unlink(summary.outputs[0].c_str());
+    }
+    for (const std::string& path : written) {
+        unlink(path.c_str());
+    }
+    rmdir(images);
+    rmdir(results);
+}
+
+/**
+ * @brief Test suite for latency instrumentation.
+ */
+TEST(MetricsTest, HistogramQuantilesAcrossThreads) {
+    Histogram histogram;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&histogram]() {
+            // 1..1000 us, uniformly.
+            for (int us = 1; us <= 1000; ++us) {
+                histogram.record(std::chrono::microseconds(us));
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    const HistogramSnapshot snapshot = histogram.snapshot();
+    EXPECT_EQ(snapshot.count, 4000u);
+    EXPECT_NEAR(snapshot.sumSeconds, 4 * 500500e-6, 1e-9);
+    // Buckets are at most 25 % wide.
+    EXPECT_NEAR(snapshot.quantile(0.50), 500e-6, 125e-6);
+    EXPECT_NEAR(snapshot.quantile(0.99), 990e-6, 250e-6);
+    EXPECT_LE(snapshot.quantile(0.50), snapshot.quantile(0.95));
+
+    // A null histogram makes the timer a no-op.
+    { ScopedTimer idle(nullptr); }
+    { ScopedTimer timed(&histogram); }
+    EXPECT_EQ(histogram.snapshot().count, 4001u);
+}
+
+TEST(MetricsTest, ExportsPrometheusText) {
+    Metrics metrics;
+    Histogram& forward =
+        metrics.histogram("test_stage_seconds", "stage=\"forward\"", "Stage time.");
+    EXPECT_EQ(&forward, &metrics.histogram("test_stage_seconds",
+                                           "stage=\"forward\"", "Stage time."));
+    metrics.histogram("test_stage_seconds", "stage=\"nms\"", "Stage time.")
+        .record(std::chrono::milliseconds(2));
+    forward.record(std::chrono::milliseconds(30));
+    int dropped = 3;
+    metrics.counter("test_dropped_total", "", "Drops.",
+                    [&dropped]() { return static_cast<double>(dropped); });
+    dropped = 5;  // Sampled when formatted.
+
+    const std::string text = metrics.prometheus();
+    EXPECT_EQ(text.find("# TYPE test_stage_seconds histogram"),
+              text.rfind("# TYPE test_stage_seconds histogram"));
+    EXPECT_NE(text.find("test_stage_seconds_bucket{stage=\"forward\",le=\"+Inf\"} 1\n"),
+              std::string::npos);
+    EXPECT_NE(text.find("test_stage_seconds_count{stage=\"nms\"} 1\n"),
+              std::string::npos);
+    EXPECT_NE(text.find("# TYPE test_dropped_total counter\ntest_dropped_total 5\n"),
+              std::string::npos);
+    EXPECT_NE(metrics.summary().find("test_stage_seconds{stage=\"forward\"}"),
+              std::string::npos);
+
+    char path[] = "/tmp/metricsXXXXXX";
+    const int fd = mkstemp(path);
+    ASSERT_GE(fd, 0);
+    close(fd);
+    {
+        ExporterConfig config;
+        config.file = path;
+        MetricsExporter exporter(metrics, config);
+        EXPECT_EQ(exporter.port(), 0);
+    }  // Writes the file on the way out.
+    std::ifstream file(path);
+    const std::string written((std::istreambuf_iterator<char>(file)),
+                              std::istreambuf_iterator<char>());
+    EXPECT_EQ(written, metrics.prometheus());
+    unlink(path);
+}
+
+TEST(MetricsTest, TimesDetectorSteps) {
+    registerBackend("sleepy", [](const BackendConfig&, const std::vector<cv::Mat>&) {
+        return std::unique_ptr<DetectorBackend>(new SleepyBackend());
+    });
+    BackendConfig backend;
+    backend.engine = "sleepy";
+    YOLO yolo(backend);
+    Metrics metrics;
+    InferenceTimers timers;
+    timers.forward = &metrics.histogram("forward_seconds", "", "Forward pass.");
+    timers.nms = &metrics.histogram("nms_seconds", "", "NMS.");
+    yolo.setTimers(timers);
+    cv::Mat frame(416, 416, CV_8UC3, cv::Scalar::all(0));
+    yolo.infer(frame);
+    yolo.infer(frame);
+    EXPECT_EQ(timers.forward->snapshot().count, 2u);
+    EXPECT_EQ(timers.nms->snapshot().count, 2u);
+    // SleepyBackend sleeps in forward().
+    EXPECT_GT(timers.forward->snapshot().quantile(0.5), 1e-3);
+}
+
+/**
+ * @brief Test suite for tiled inference.
+ */
+TEST(TilingTest, PlansOverlappingTilesCoveringTheFrame) {
+    TilingConfig config = TilingConfig::parse("3x2");
+    EXPECT_EQ(config.columns, 3);
+    EXPECT_EQ(config.rows, 2);
+    EXPECT_TRUE(config.enabled());
+    EXPECT_FALSE(TilingConfig::parse("1x1").enabled());
+    EXPECT_THROW(TilingConfig::parse("3"), std::invalid_argument);
+    EXPECT_THROW(TilingConfig::parse("3x2x1"), std::invalid_argument);
+    EXPECT_THROW(TilingConfig::parse("0x2"), std::invalid_argument);
+
+    std::vector<cv::Rect> tiles;
+    planTiles(cv::Size(3840, 2160), config, tiles);
+    ASSERT_EQ(tiles.size(), 6u);
+    const cv::Rect frame(0, 0, 3840, 2160);
+    for (const cv::Rect& tile : tiles) {
+        EXPECT_EQ(tile & frame, tile);
+        EXPECT_EQ(tile.size(), tiles[0].size());
+    }
+    EXPECT_EQ(tiles[0].x + tiles[0].y, 0);
+    EXPECT_EQ(tiles[5].x + tiles[5].width, frame.width);
+    EXPECT_EQ(tiles[5].y + tiles[5].height, frame.height);
+    // Neighbours share about config.overlap of a tile.
+    const int shared = (tiles[0] & tiles[1]).width;
+    EXPECT_NEAR(shared, config.overlap * tiles[0].width, 2);
+    EXPECT_GT((tiles[0] & tiles[3]).height, 0);
+
+    // Too small to tile: one tile covering everything.
+    planTiles(cv::Size(640, 480), config, tiles);
+    ASSERT_EQ(tiles.size(), 1u);
+    EXPECT_EQ(tiles[0], cv::Rect(0, 0, 640, 480));
+}
+
+TEST(TilingTest, MergesBoxesAcrossTileBorders) {
+    const std::vector<cv::Rect> regions = {cv::Rect(0, 0, 600, 600),
+                                           cv::Rect(500, 0, 600, 600)};
+    std::vector<Detections> tiles(2);
+    // A person crossing x = 600, the right border of the first tile: the
+    // first tile sees its left part, the second the whole of it.
+    tiles[0].push(560, 100, 40, 200, 0.8f, 0);
+    tiles[1].push(560, 102, 90, 198, 0.9f, 0);
+    // A person inside the overlap, found whole by both tiles.
+    tiles[0].push(510, 400, 40, 120, 0.7f, 0);
+    tiles[1].push(512, 402, 40, 118, 0.6f, 0);
+    // Two people side by side within one tile stay apart.
+    tiles[1].push(900, 100, 50, 150, 0.9f, 0);
+    tiles[1].push(940, 100, 50, 150, 0.8f, 0);
+
+    TilingConfig config;
+    NMSConfig nms;
+    nms.iouThreshold = 0.5f;
+    TileMerger merger;
+    Detections merged;
+    merger.merge(tiles, regions, cv::Size(1100, 600), config, nms, merged);
+    ASSERT_EQ(merged.size(), 4u);
+    int crossing = -1;
+    for (size_t i = 0; i < merged.size(); ++i) {
+        if (merged.x[i] == 560.0f && merged.y[i] == 100.0f) {
+            crossing = static_cast<int>(i);
+        }
+    }
+    ASSERT_GE(crossing, 0);
+    EXPECT_FLOAT_EQ(merged.width[crossing], 90.0f);
+    EXPECT_FLOAT_EQ(merged.height[crossing], 200.0f);
+    EXPECT_FLOAT_EQ(merged.scores[crossing], 0.9f);
+}
+
+/**
+ * @brief Backend that reports the bounding box of the white pixels of each
+ *        blob image, so that boxes follow the content of every tile.
+ */
+class SpotBackend : public DetectorBackend {
+ public:
+    static int passes;
+    static int largestBatch;
+
+    void forward(const cv::Mat& blob, std::vector<cv::Mat>& outputs) override {
+        const int batch = blob.size[0];
+        const int height = blob.size[2];
+        const int width = blob.size[3];
+        ++passes;
+        largestBatch = std::max(largestBatch, batch);
+        outputs.resize(1);
+        outputs[0].create(batch, 85, CV_32F);
+        outputs[0].setTo(cv::Scalar::all(0));
+        for (int n = 0; n < batch; ++n) {
+            // The first channel is enough: white is 1 in all three, the
+            // letterbox padding is 127 / 255.
+            const float* plane = blob.ptr<float>(n);
+            int left = width, top = height, right = -1, bottom = -1;
+            for (int y = 0; y < height; ++y) {
+                for (int x = 0; x < width; ++x) {
+                    if (plane[y * width + x] > 0.75f) {
+                        left = std::min(left, x);
+                        top = std::min(top, y);
+                        right = std::max(right, x + 1);
+                        bottom = std::max(bottom, y + 1);
+                    }
+                }
+            }
+            if (right < 0) {
+                continue;
+            }
+            float* row = outputs[0].ptr<float>(n);
+            row[0] = 0.5f * (left + right) / width;
+            row[1] = 0.5f * (top + bottom) / height;
+            row[2] = static_cast<float>(right - left) / width;
+            row[3] = static_cast<float>(bottom - top) / height;
+            row[4] = 0.9f;
+            row[5] = 0.9f;
+        }
+    }
+
+    std::string describe() const override { return "spot"; }
+};
+int SpotBackend::passes = 0;
+int SpotBackend::largestBatch = 0;
+
+/**
+ * @brief Creates a YOLO on the spot backend.
+ */
+static std::unique_ptr<YOLO> makeSpotYolo(int inputSize) {
+    registerBackend("spot", [](const BackendConfig&, const std::vector<cv::Mat>&) {
+        return std::unique_ptr<DetectorBackend>(new SpotBackend());
+    });
+    BackendConfig config;
+    config.engine = "spot";
+    config.inputSize = inputSize;
+    std::unique_ptr<YOLO> yolo(new YOLO(config));
+    SpotBackend::passes = 0;
+    SpotBackend::largestBatch = 0;
+    return yolo;
+}
+
+/**
+ * @brief Expects one detection in @p detections, at @p expected give or
+ *        take the resolution of a tile squeezed into the network input.
+ */
+static void expectSingleBox(const Detections& detections, cv::Rect expected) {
+    ASSERT_EQ(detections.size(), 1u);
+    EXPECT_NEAR(detections.x[0], expected.x, 4.0f);
+    EXPECT_NEAR(detections.y[0], expected.y, 4.0f);
+    EXPECT_NEAR(detections.width[0], expected.width, 4.0f);
+    EXPECT_NEAR(detections.height[0], expected.height, 4.0f);
+}
+
+TEST(TilingTest, InferTiledMapsTileDetectionsBackToTheFrame) {
+    std::unique_ptr<YOLO> yolo = makeSpotYolo(0);
+    ASSERT_FALSE(yolo->fixedInputSize());
+    TilingConfig tiling = TilingConfig::parse("2x1");
+    tiling.fullFrame = false;
+    // Tiles of 925 x 832 at x = 0 and x = 739.
+    const cv::Mat black(832, 1664, CV_8UC3, cv::Scalar::all(0));
+
+    // Inside the overlap: both tiles find it whole, at the same place in
+    // the frame once the second one is offset by its left edge.
+    cv::Mat frame = black.clone();
+    const cv::Rect shared(780, 300, 100, 100);
+    frame(shared).setTo(cv::Scalar::all(255));
+    expectSingleBox(yolo->inferTiled(frame, tiling), shared);
+    EXPECT_EQ(SpotBackend::passes, 1);
+    EXPECT_EQ(SpotBackend::largestBatch, 2);
+
+    // Across x = 925, the right edge of the first tile: its part there is
+    // merged into the whole box found by the second tile.
+    frame = black.clone();
+    const cv::Rect crossing(880, 500, 100, 80);
+    frame(crossing).setTo(cv::Scalar::all(255));
+    expectSingleBox(yolo->inferTiled(frame, tiling), crossing);
+}
+
+TEST(TilingTest, InferTiledRunsTilesOneByOneAtAFixedInputSize) {
+    std::unique_ptr<YOLO> yolo = makeSpotYolo(416);
+    ASSERT_TRUE(yolo->fixedInputSize());
+    TilingConfig tiling = TilingConfig::parse("2x1");
+    tiling.fullFrame = false;
+    cv::Mat frame(832, 1664, CV_8UC3, cv::Scalar::all(0));
+    const cv::Rect shared(780, 300, 100, 100);
+    frame(shared).setTo(cv::Scalar::all(255));
+    expectSingleBox(yolo->inferTiled(frame, tiling), shared);
+    EXPECT_EQ(SpotBackend::passes, 2);
+    EXPECT_EQ(SpotBackend::largestBatch, 1);
+}
+
+/**
+ * @brief Test suite for the multi-camera DeadlineScheduler.
+ */
+TEST(DeadlineSchedulerTest, ServesDueStreamsByPriority) {
+    using Clock = std::chrono::steady_clock;
+    using std::chrono::milliseconds;
+    SchedulerConfig config;
+    StreamPolicy slow;  // 10 fps.
+    StreamPolicy important;
+    important.priority = 5.0;
+    StreamPolicy fast;
+    fast.targetFps = 20.0;
+    config.streams = {slow, important, fast};
+    DeadlineScheduler<int> scheduler(config);
+    const Clock::time_point t0 = Clock::now();
+    int frame = 0;
+    size_t stream = 0;
+
+    // Everything is due at first; the heavier weight goes first.
+    ASSERT_TRUE(scheduler.push(0, 100, t0));
+    ASSERT_TRUE(scheduler.push(1, 200, t0));
+    ASSERT_TRUE(scheduler.tryPop(frame, stream, t0));
+    EXPECT_EQ(stream, 1u);
+    EXPECT_EQ(frame, 200);
+    ASSERT_TRUE(scheduler.push(2, 300, t0));
+    ASSERT_TRUE(scheduler.tryPop(frame, stream, t0));
+    EXPECT_EQ(stream, 0u);  // Equal weights: in stream order.
+    ASSERT_TRUE(scheduler.tryPop(frame, stream, t0));
+    EXPECT_EQ(stream, 2u);
+    EXPECT_FALSE(scheduler.tryPop(frame, stream, t0));
+
+    // 50 ms later only the 20 fps stream is due; it beats the heavier
+    // stream that is still within its period.
+    const Clock::time_point t1 = t0 + milliseconds(50);
+    scheduler.push(1, 201, t1);
+    scheduler.push(2, 301, t1);
+    ASSERT_TRUE(scheduler.tryPop(frame, stream, t1));
+    EXPECT_EQ(stream, 2u);
+    ASSERT_TRUE(scheduler.tryPop(frame, stream, t1));  // Spare budget.
+    EXPECT_EQ(stream, 1u);
+
+    // Recent detections put the stream 2.5 periods behind ahead of the
+    // one 4 periods behind.
+    const Clock::time_point t2 = t0 + milliseconds(100);
+    scheduler.markActivity(0, t2);
+    scheduler.push(0, 101, t2);
+    scheduler.push(2, 302, t2 + milliseconds(50));
+    ASSERT_TRUE(scheduler.tryPop(frame, stream, t2 + milliseconds(150)));
+    EXPECT_EQ(stream, 0u);
+}
+
+TEST(DeadlineSchedulerTest, SkipsStaleFramesAndCountsMisses) {
+    using Clock = std::chrono::steady_clock;
+    using std::chrono::milliseconds;
+    DeadlineScheduler<int> scheduler;  // 10 fps, stale after 500 ms.
+    const Clock::time_point t0 = Clock::now();
+    int frame = 0;
+    size_t stream = 0;
+    scheduler.push(0, 1, t0);
+    ASSERT_TRUE(scheduler.tryPop(frame, stream, t0));
+
+    // A newer frame replaces the one waiting.
+    scheduler.push(0, 2, t0 + milliseconds(10));
+    scheduler.push(0, 3, t0 + milliseconds(350));
+    EXPECT_EQ(scheduler.size(), 1u);
+    ASSERT_TRUE(scheduler.tryPop(frame, stream, t0 + milliseconds(350)));
+    EXPECT_EQ(frame, 3);
+
+    // 3.5 periods since the last frame: two whole periods went unserved.
+    std::vector<StreamStats> stats = scheduler.stats(t0 + milliseconds(350));
+    ASSERT_EQ(stats.size(), 1u);
+    EXPECT_EQ(stats[0].offered, 3u);
+    EXPECT_EQ(stats[0].served, 2u);
+    EXPECT_EQ(stats[0].skipped, 1u);
+    EXPECT_EQ(stats[0].missed, 2u);
+    EXPECT_NEAR(stats[0].achievedFps, 2 / 0.35, 1e-6);
+
+    // A frame older than staleAfter is dropped instead of run.
+    scheduler.push(0, 4, t0 + milliseconds(400));
+    EXPECT_FALSE(scheduler.tryPop(frame, stream, t0 + milliseconds(1000)));
+    EXPECT_EQ(scheduler.dropped(), 2u);
+
+    scheduler.push(0, 5, t0 + milliseconds(1000));
+    scheduler.close();
+    EXPECT_FALSE(scheduler.drained());
+    EXPECT_FALSE(scheduler.push(0, 6, t0 + milliseconds(1000)));
+    ASSERT_TRUE(scheduler.pop(frame, stream, milliseconds(0)));
+    EXPECT_EQ(frame, 5);
+    EXPECT_TRUE(scheduler.drained());
+}
+
+/**
+ * @brief Test suite for the record/replay file format.
+ */
+TEST(RecordingTest, RoundTripsFramesAndDetectionsWithAndWithoutIndex) {
+    using std::chrono::milliseconds;
+    char path[] = "/tmp/recordingXXXXXX";
+    const int fd = mkstemp(path);
+    ASSERT_GE(fd, 0);
+    close(fd);
+
+    RecorderConfig config;
+    config.encoding = FrameEncoding::Raw;
+    {
+        RecordingWriter writer(path, config);
+        const auto t0 = std::chrono::steady_clock::now();
+        for (int i = 0; i < 3; ++i) {
+            for (size_t source = 0; source < 2; ++source) {
+                cv::Mat frame(6, 8, CV_8UC3);
+                std::memset(frame.ptr(0), 10 * i + static_cast<int>(source),
+                            frame.total() * frame.elemSize());
+                EXPECT_TRUE(writer.writeFrame(source, i, t0 + milliseconds(100 * i),
+                                              frame));
+            }
+        }
+        StreamRecord record;
+        record.trackId = 3;
+        record.x = 12.5f;
+        EXPECT_TRUE(writer.writeDetections(1, 1, t0 + milliseconds(100),
+                                           {record, record}));
+        writer.close();  // Waits for the writer thread.
+        EXPECT_EQ(writer.records(), 7u);
+        EXPECT_EQ(writer.dropped(), 0u);
+        EXPECT_TRUE(writer.error().empty());
+        EXPECT_FALSE(writer.writeDetections(1, 2, t0, {record}));
+    }
+
+    std::vector<StreamRecord> records;
+    {
+        RecordingReader reader(path);
+        EXPECT_TRUE(reader.indexed());
+        ASSERT_EQ(reader.frameCount(), 6u);
+        const cv::Mat frame = reader.frame(3);  // Source 1 of the second frame.
+        ASSERT_FALSE(frame.empty());
+        EXPECT_EQ(frame.rows, 6);
+        EXPECT_EQ(frame.cols, 8);
+        EXPECT_EQ(frame.type(), CV_8UC3);
+        EXPECT_EQ(frame.ptr(5)[23], 11);
+        EXPECT_EQ(reader.frameRecord(3).header->source, 1);
+        EXPECT_EQ(reader.frameRecord(3).header->sequence, 1u);
+        // Raw pixels are read in place, cache-line aligned.
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(frame.data) % kRecordAlignment, 0u);
+
+        ASSERT_TRUE(reader.detections(3, records));
+        ASSERT_EQ(records.size(), 2u);
+        EXPECT_EQ(records[1].trackId, 3);
+        EXPECT_FLOAT_EQ(records[1].x, 12.5f);
+        EXPECT_FALSE(reader.detections(2, records));
+
+        EXPECT_EQ(reader.seek(0), 0u);
+        EXPECT_EQ(reader.seek(150 * 1000000LL), 4u);
+        EXPECT_EQ(reader.seek(200 * 1000000LL), 4u);
+        EXPECT_EQ(reader.seek(1000 * 1000000LL), reader.frameCount());
+    }
+
+    // A recording that was never closed has no index and is scanned instead,
+    // up to the last complete record.
+    struct stat info;
+    ASSERT_EQ(stat(path, &info), 0);
+    ASSERT_EQ(truncate(path, info.st_size - sizeof(IndexTrailer) - 1), 0);
+    {
+        RecordingReader reader(path);
+        EXPECT_FALSE(reader.indexed());
+        EXPECT_EQ(reader.frameCount(), 6u);
+        EXPECT_TRUE(reader.detections(3, records));
+    }
+    ASSERT_EQ(truncate(path, sizeof(RecordingHeader) + 2 * kRecordAlignment), 0);
+    {
+        RecordingReader reader(path);
+        EXPECT_EQ(reader.frameCount(), 0u);  // The first frame is cut short.
+    }
+    unlink(path);
+
+    const SourceSpec spec = SourceSpec::parse("/data/lobby.prec#1");
+    EXPECT_EQ(spec.kind, SourceKind::Recording);
+    EXPECT_EQ(spec.path, "/data/lobby.prec");
+    EXPECT_EQ(spec.stream, 1);
+    EXPECT_EQ(SourceSpec::parse("lobby.prec").stream, 0);
+    EXPECT_EQ(SourceSpec::parse("lobby.precise.mp4").kind, SourceKind::Video);
+    EXPECT_THROW(SourceSpec::parse("lobby.prec#a"), std::invalid_argument);
+}
+
+TEST(RecordingTest, DropsOldestRecordsWhenTheWriterFallsBehind) {
+    char path[] = "/tmp/recordingXXXXXX";
+    const int fd = mkstemp(path);
+    ASSERT_GE(fd, 0);
+    close(fd);
+
+    RecorderConfig config;
+    config.encoding = FrameEncoding::Raw;
+    config.queueCapacity = 1;
+    const uint64_t count = 200;
+    uint64_t written = 0;
+    {
+        RecordingWriter writer(path, config);
+        cv::Mat frame(240, 320, CV_8UC3);
+        const auto t0 = std::chrono::steady_clock::now();
+        for (uint64_t i = 0; i < count; ++i) {
+            std::memset(frame.ptr(0), static_cast<int>(i % 251),
+                        frame.total() * frame.elemSize());
+            EXPECT_TRUE(writer.writeFrame(0, i, t0, frame));
+        }
+        writer.close();
+        written = writer.records();
+        EXPECT_EQ(written + writer.dropped(), count);
+    }
+    RecordingReader reader(path);
+    ASSERT_EQ(reader.frameCount(), written);
+    // The last frame is never dropped, and each frame kept its own pixels
+    // although the caller reused one buffer.
+    EXPECT_EQ(reader.frameRecord(written - 1).header->sequence, count - 1);
+    for (size_t i = 0; i < reader.frameCount(); ++i) {
+        const uint64_t sequence = reader.frameRecord(i).header->sequence;
+        EXPECT_EQ(reader.frame(i).ptr(239)[959], sequence % 251);
+    }
+    unlink(path);
+}
+
+/**
+ * @brief Test suite for reduced-scale JPEG decoding.
+ */
+TEST(JpegDecodeTest, ReadsFrameSizeAndPicksReduction) {
+    // SOI, an APP0 segment, then a baseline SOF0 for 1920 x 1080.
+    const uchar header[] = {0xFF, 0xD8,
+                            0xFF, 0xE0, 0x00, 0x04, 0x4A, 0x46,
+                            0xFF, 0xC0, 0x00, 0x11, 0x08, 0x04, 0x38, 0x07,
+                            0x80, 0x03, 0x01, 0x22, 0x00, 0x02, 0x11, 0x01,
+                            0x03, 0x11, 0x01};
+    cv::Size full;
+    ASSERT_TRUE(jpegSize(header, sizeof(header), full));
+    EXPECT_EQ(full.width, 1920);
+    EXPECT_EQ(full.height, 1080);
+    EXPECT_FALSE(jpegSize(header, 12, full));  // Cut before the SOF.
+    const uchar png[] = {0x89, 'P', 'N', 'G', 0x0D, 0x0A, 0x1A, 0x0A};
+    EXPECT_FALSE(jpegSize(png, sizeof(png), full));
+
+    // The long side stays at or above the network input.
+    EXPECT_EQ(jpegReduction(cv::Size(1920, 1080), 416), 4);
+    EXPECT_EQ(jpegReduction(cv::Size(3840, 2160), 416), 8);
+    EXPECT_EQ(jpegReduction(cv::Size(1280, 720), 608), 2);
+    EXPECT_EQ(jpegReduction(cv::Size(640, 480), 416), 1);
+    EXPECT_EQ(jpegReduction(cv::Size(1920, 1080), 0), 1);
+
+    cv::Mat image(1200, 1600, CV_8UC3, cv::Scalar(40, 120, 200));
+    std::vector<uchar> bytes;
+    ASSERT_TRUE(cv::imencode(".jpg", image, bytes));
+    cv::Mat frame;
+    double scale = 0.0;
+    ASSERT_TRUE(decodeReduced(cv::Mat(bytes), 416, frame, scale));
+    EXPECT_EQ(frame.cols, 400);
+    EXPECT_EQ(frame.rows, 300);
+    EXPECT_DOUBLE_EQ(scale, 4.0);
+    ASSERT_TRUE(decodeReduced(cv::Mat(bytes), 0, frame, scale));
+    EXPECT_EQ(frame.cols, 1600);
+    EXPECT_DOUBLE_EQ(scale, 1.0);
+
+    // A header without scan data, or no image at all, fails even though
+    // the reused frame still holds the last image.
+    std::vector<uchar> broken(header, header + sizeof(header));
+    EXPECT_FALSE(decodeReduced(cv::Mat(broken), 416, frame, scale));
+    broken.assign(png, png + sizeof(png));
+    EXPECT_FALSE(decodeReduced(cv::Mat(broken), 416, frame, scale));
+    EXPECT_FALSE(frame.empty());
+}
+
+/**
+ * @brief Test suite for the shared-memory ring transport.
+ */
+TEST(SharedRingTest, SkipsMessagesOverwrittenBeforeTheyAreRead) {
+    const std::string name = "/perception_test_" + std::to_string(getpid());
+    RingConfig config;
+    config.slots = 4;
+    config.frameBytes = 8 * 6 * 3;
+    config.maxRecords = 2;
+    RingPublisher publisher(name, config);
+    RingSubscriber late(name);  // Starts with the next message.
+    const auto now = std::chrono::steady_clock::now();
+    StreamRecord record;
+    cv::Mat frame(6, 8, CV_8UC3);
+    for (uint64_t i = 0; i < 10; ++i) {
+        record.x = static_cast<float>(i);
+        std::memset(frame.ptr(0), static_cast<int>(i), frame.total() * 3);
+        EXPECT_EQ(publisher.publish(1, 100 + i, now, frame,
+                                    {record, record, record}), i);
+    }
+    EXPECT_EQ(publisher.published(), 10u);
+
+    RingSubscriber reader(name, true);  // The last four are still there.
+    EXPECT_EQ(reader.config().slots, 4u);
+    RingView view;
+    ASSERT_TRUE(reader.acquire(view, std::chrono::microseconds(0)));
+    EXPECT_EQ(view.message, 6u);
+    EXPECT_EQ(view.frame.source, 1);
+    EXPECT_EQ(view.frame.sequence, 106u);
+    ASSERT_EQ(view.frame.count, 2u);  // Cut to maxRecords.
+    EXPECT_FLOAT_EQ(view.records[1].x, 6.0f);
+    ASSERT_FALSE(view.image.empty());
+    EXPECT_EQ(view.image.ptr(5)[23], 6);
+    EXPECT_TRUE(reader.valid(view));
+
+    // Lapping the reader invalidates what it holds and skips what it missed.
+    for (uint64_t i = 10; i < 14; ++i) {
+        publisher.publish(0, 100 + i, now, cv::Mat(), {});
+    }
+    EXPECT_FALSE(reader.valid(view));
+    ASSERT_TRUE(reader.acquire(view, std::chrono::microseconds(0)));
+    EXPECT_EQ(view.message, 10u);
+    EXPECT_TRUE(view.image.empty());
+    EXPECT_EQ(reader.lost(), 3u);
+    ASSERT_TRUE(late.acquire(view, std::chrono::microseconds(0)));
+    EXPECT_EQ(view.message, 10u);
+    EXPECT_EQ(late.lost(), 10u);
+}
+
+TEST(SharedRingTest, StreamsBetweenProcesses) {
+    const std::string name = "/perception_test_" + std::to_string(getpid());
+    const uint64_t count = 2000;
+    RingConfig config;
+    config.slots = 64;
+    config.frameBytes = 64 * 48 * 3;
+    RingPublisher publisher(name, config);
+
+    /// What the subscriber process saw.
+    struct Summary {
+        uint64_t received = 0;
+        uint64_t lost = 0;
+        uint64_t corrupt = 0;
+        uint64_t last = 0;
+        int64_t worstLatencyNs = 0;
+        int64_t totalLatencyNs = 0;
+        double seconds = 0.0;
+    };
+    int ready[2];
+    int results[2];
+    ASSERT_EQ(pipe(ready), 0);
+    ASSERT_EQ(pipe(results), 0);
+    const pid_t child = fork();
+    ASSERT_GE(child, 0);
+    if (child == 0) {
+        Summary summary;
+        RingSubscriber subscriber(name);
+        char go = 1;
+        if (write(ready[1], &go, 1) != 1) {
+            _exit(1);
+        }
+        StreamFrameHeader frame;
+        std::vector<StreamRecord> records;
+        cv::Mat image;
+        const auto start = std::chrono::steady_clock::now();
+        while (subscriber.next(frame, records, image,
+                               std::chrono::microseconds(2000000))) {
+            const int64_t now =
+                std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::system_clock::now().time_since_epoch()).count();
+            const int64_t latency = now - frame.timestampNs;
+            summary.worstLatencyNs = std::max(summary.worstLatencyNs, latency);
+            summary.totalLatencyNs += latency;
+            ++summary.received;
+            if (records.size() != 1 ||
+                records[0].x != static_cast<float>(frame.sequence) ||
+                image.rows != 48 ||
+                image.ptr(47)[64 * 3 - 1] != static_cast<uchar>(frame.sequence)) {
+                ++summary.corrupt;
+            }
+            summary.last = frame.sequence;
+            if (frame.sequence == count - 1) {
+                break;
+            }
+        }
+        summary.seconds = std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - start).count();
+        summary.lost = subscriber.lost();
+        const bool sent = write(results[1], &summary, sizeof(summary)) ==
+                          static_cast<ssize_t>(sizeof(summary));
+        _exit(sent ? 0 : 1);
+    }
+
+    char go = 0;
+    ASSERT_EQ(read(ready[0], &go, 1), 1);
+    cv::Mat frame(48, 64, CV_8UC3);
+    StreamRecord record;
+    const auto start = std::chrono::steady_clock::now();
+    for (uint64_t i = 0; i < count; ++i) {
+        std::memset(frame.ptr(0), static_cast<int>(i & 0xFF), frame.total() * 3);
+        record.x = static_cast<float>(i);
+        publisher.publish(0, i, std::chrono::steady_clock::now(), frame, {record});
+        if (i % 64 == 63) {
+            // Give the reader a chance to keep up on a single core.
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+        }
+    }
+    const double publishSeconds = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - start).count();
+
+    Summary summary;
+    ASSERT_EQ(read(results[0], &summary, sizeof(summary)),
+              static_cast<ssize_t>(sizeof(summary)));
+    int status = 0;
+    waitpid(child, &status, 0);
+    EXPECT_TRUE(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+    for (int fd : {ready[0], ready[1], results[0], results[1]}) {
+        close(fd);
+    }
+
+    // Every message was either delivered intact or counted as lost; how
+    // many were lost depends on how busy the machine is.
+    EXPECT_EQ(summary.corrupt, 0u);
+    EXPECT_EQ(summary.received + summary.lost, count);
+    EXPECT_EQ(summary.last, count - 1);
+    std::cout << "Ring: " << count / publishSeconds << " msgs/s published, "
+              << summary.received << " received, " << summary.lost
+              << " lost, mean latency "
+              << summary.totalLatencyNs / std::max<uint64_t>(summary.received, 1) / 1e3
+              << " us, worst " << summary.worstLatencyNs / 1e3 << " us\n";
+}
+
+/**
+ * @brief Test suite for CPU lists, thread pinning and the placement sweep.
+ */
+TEST(AffinityTest, ParsesAndFormatsCpuLists) {
+    EXPECT_EQ(parseCpuList("3,0-2, 8,2"), CpuList({0, 1, 2, 3, 8}));
+    EXPECT_TRUE(parseCpuList("").empty());
+    EXPECT_EQ(formatCpuList({0, 1, 2, 3, 8, 10, 11}), "0-3,8,10-11");
+    EXPECT_EQ(formatCpuList(parseCpuList("4-7,1")), "1,4-7");
+    EXPECT_EQ(parseCpuList("node0"), numaNodeCpus(0));
+    EXPECT_FALSE(numaNodeCpus(0).empty());
+    EXPECT_THROW(parseCpuList("3-1"), std::invalid_argument);
+    EXPECT_THROW(parseCpuList("a"), std::invalid_argument);
+    EXPECT_THROW(parseCpuList("node4096"), std::invalid_argument);
+
+    const std::vector<CpuList> lists = parseCpuLists("0-1;2");
+    ASSERT_EQ(lists.size(), 2u);
+    EXPECT_EQ(cpusFor(lists, 0), CpuList({0, 1}));
+    EXPECT_EQ(cpusFor(lists, 5), CpuList({2}));
+    EXPECT_TRUE(cpusFor(std::vector<CpuList>(), 0).empty());
+}
+
+TEST(AffinityTest, PinsTheCallingThread) {
+    const CpuList allowed = allowedCpus();
+    ASSERT_FALSE(allowed.empty());
+    EXPECT_TRUE(pinCurrentThread(CpuList()));  // Nothing to do.
+    const int target = allowed.back();
+    int ranOn = -1;
+    bool pinned = false;
+    std::thread worker([&]() {
+        pinned = pinCurrentThread({target});
+        std::this_thread::yield();
+        ranOn = sched_getcpu();
+    });
+    worker.join();
+    EXPECT_TRUE(pinned);
+    EXPECT_EQ(ranOn, target);
+}
+
+/**
+ * @brief Sleepy backend that records the CPUs its calling thread may use.
+ */
+class MaskRecordingBackend : public SleepyBackend {
+ public:
+    static std::mutex guard;
+    static CpuList seen;
+
+    void forward(const cv::Mat& blob, std::vector<cv::Mat>& outputs) override {
+        {
+            std::lock_guard<std::mutex> lock(guard);
+            seen = allowedCpus();
+        }
+        SleepyBackend::forward(blob, outputs);
+    }
+};
+std::mutex MaskRecordingBackend::guard;
+CpuList MaskRecordingBackend::seen;
+
+TEST(AffinityTest, PinningTheOutputStageLeavesTheOtherStagesAlone) {
+    const CpuList allowed = allowedCpus();
+    if (allowed.size() < 2) {
+        return;  // One CPU: every mask is the same.
+    }
+    registerBackend("mask", [](const BackendConfig&, const std::vector<cv::Mat>&) {
+        return std::unique_ptr<DetectorBackend>(new MaskRecordingBackend());
+    });
+    PipelineFixture fixture(3);
+    BackendConfig backend;
+    backend.engine = "mask";
+    fixture.yolo.reset(new YOLO(backend));
+    PostprocessOptions quiet;
+    quiet.print = false;
+    quiet.annotate = false;
+    fixture.yolo->setPostprocessOptions(quiet);
+    fixture.config.overflow = OverflowPolicy::Block;
+    fixture.config.affinity.output = {allowed.back()};
+    CaptureManager capture({SourceSpec::parse(fixture.directory)}, fixture.capture);
+    Pipeline pipeline(capture, *fixture.yolo, fixture.processor, fixture.world,
+                      fixture.config);
+    CpuList outputCpus;
+    pipeline.run([&outputCpus](FrameTask&) {
+        outputCpus = allowedCpus();
+        return true;
+    });
+
+    EXPECT_EQ(outputCpus, CpuList({allowed.back()}));
+    {
+        std::lock_guard<std::mutex> lock(MaskRecordingBackend::guard);
+        EXPECT_EQ(MaskRecordingBackend::seen, allowed);  // Inference stage.
+    }
+    EXPECT_EQ(allowedCpus(), allowed);  // Restored for the caller.
+}
+
+TEST(AffinityTest, SweepKeepsInstancesOnDisjointCpusOfOneNode) {
+    // Two nodes with interleaved numbering, as on many dual-socket boards.
+    const CpuList cpus = {0, 1, 2, 3, 4, 5, 6, 7};
+    const std::vector<CpuList> nodes = {{0, 2, 4, 6}, {1, 3, 5, 7}};
+    const std::vector<Placement> sweep = placementSweep(cpus, nodes);
+    ASSERT_FALSE(sweep.empty());
+    EXPECT_EQ(sweep[0].instances, 1);
+    EXPECT_EQ(sweep[0].threads, 0);  // OpenCV's default as the baseline.
+    EXPECT_TRUE(sweep[0].cpus.empty());
+
+    bool sawSpread = false;
+    for (const Placement& placement : sweep) {
+        EXPECT_LE(placement.instances * placement.threads, 8);
+        if (placement.name == "unpinned") {
+            EXPECT_TRUE(placement.cpus.empty());
+            continue;
+        }
+        ASSERT_EQ(placement.cpus.size(), static_cast<size_t>(placement.instances));
+        CpuList used;
+        for (size_t i = 0; i < placement.cpus.size(); ++i) {
+            const CpuList& mine = placement.cpus[i];
+            EXPECT_EQ(mine.size(), static_cast<size_t>(placement.threads));
+            used.insert(used.end(), mine.begin(), mine.end());
+            // Every instance that fits a node stays within it.
+            const CpuList& node = nodes[mine[0] % 2];
+            for (int cpu : placement.threads <= 4 ? mine : CpuList()) {
+                EXPECT_NE(std::find(node.begin(), node.end(), cpu), node.end());
+            }
+            if (placement.name == "spread") {
+                EXPECT_EQ(static_cast<size_t>(mine[0] % 2), i % 2);
+            }
+        }
+        std::sort(used.begin(), used.end());
+        EXPECT_EQ(std::unique(used.begin(), used.end()), used.end());
+        sawSpread = sawSpread || placement.name == "spread";
+        if (placement.name == "compact" && placement.instances == 2 &&
+            placement.threads == 2) {
+            EXPECT_EQ(placement.cpus[0], CpuList({0, 2}));
+            EXPECT_EQ(placement.cpus[1], CpuList({4, 6}));
+        }
+    }
+    EXPECT_TRUE(sawSpread);
+    EXPECT_EQ(placementSweep(cpus, nodes, 2).back().instances, 2);
+}
+
 int main(int argc, char **argv) {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();